@@ -32,23 +32,53 @@
 namespace roboptim
 {
   /// \brief Update the static variable used for Eigen::set_is_malloc_allowed.
+  ///
+  /// The value is stored per thread, so threads evaluating functions
+  /// concurrently do not see each other's updates.
   ROBOPTIM_CORE_DLLAPI
   bool is_malloc_allowed_update (bool update = false, bool new_value = false);
 
+  namespace detail
+  {
+    /// \brief Setter of the allocation flag of Eigen.
+    typedef bool (*eigenMallocSetter_t) (bool);
+
+    /// \brief Update the flag of the calling thread, then Eigen's flag.
+    ///
+    /// Eigen only has one flag for the whole process. It forbids
+    /// allocations when some thread forbids them and no thread that
+    /// updated its flag currently allows them. Threads that never
+    /// updated their flag do not count.
+    ///
+    /// \param allow whether to allow dynamic allocations.
+    /// \param setter setter of Eigen's flag (may be null).
+    /// \return Eigen's new flag.
+    ROBOPTIM_CORE_DLLAPI
+    bool set_thread_malloc_allowed (bool allow, eigenMallocSetter_t setter);
+
+    /// \brief Forget the flag of the calling thread.
+    ///
+    /// The thread stops counting until it updates its flag again, as if
+    /// it had exited. Threads kept alive between tasks (e.g. by a thread
+    /// pool) call it once a task is done.
+    ROBOPTIM_CORE_DLLAPI
+    void reset_thread_malloc_allowed ();
+  } // end of namespace detail
+
   /// \brief Manage the calls to Eigen::set_is_malloc_allowed.
   /// \param allow whether to allow dynamic allocations.
   inline bool set_is_malloc_allowed (bool allow)
   {
-    is_malloc_allowed_update (true, allow);
-
 # ifdef ROBOPTIM_CHECK_ALLOCATION
-    return Eigen::internal::set_is_malloc_allowed (allow);
+    return detail::set_thread_malloc_allowed
+      (allow, &Eigen::internal::set_is_malloc_allowed);
 # else
+    detail::set_thread_malloc_allowed (allow, 0);
     return true;
 # endif //! ROBOPTIM_CHECK_ALLOCATION
   }
 
-  /// \brief Whether dynamic allocation is allowed.
+  /// \brief Whether dynamic allocation is allowed in the calling thread.
   inline bool is_malloc_allowed ()
   {
     return is_malloc_allowed_update (false);
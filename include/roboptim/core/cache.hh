@@ -18,17 +18,298 @@
 #ifndef ROBOPTIM_CORE_CACHE_HH
 # define ROBOPTIM_CORE_CACHE_HH
 
+# include <cstring>
 # include <list>
+# include <ostream>
+# include <vector>
 # include <boost/unordered_map.hpp>
+# include <boost/utility/enable_if.hpp>
+
+# include <Eigen/Core>
+# include <Eigen/Sparse>
 
 # include <roboptim/core/detail/utility.hh>
 
 namespace roboptim
 {
+  /// \brief Statistics of a cache.
+  ///
+  /// Statistics of several caches can be accumulated, e.g. to get the
+  /// statistics of all the caches of a CachedFunction.
+  struct CacheStatistics
+  {
+    CacheStatistics ();
+
+    /// \brief Accumulate the statistics of another cache.
+    CacheStatistics& operator+= (const CacheStatistics& stats);
+
+    /// \brief Ratio of successful lookups (0 if there was no lookup).
+    double hitRate () const;
+
+    /// \brief Display the statistics on the specified output stream.
+    std::ostream& print (std::ostream& o) const;
+
+    /// \brief Maximum number of elements.
+    size_t size;
+
+    /// \brief Number of cached elements.
+    size_t elements;
+
+    /// \brief Number of successful lookups.
+    size_t hits;
+
+    /// \brief Number of unsuccessful lookups.
+    size_t misses;
+
+    /// \brief Number of elements inserted in the cache.
+    size_t insertions;
+
+    /// \brief Number of elements evicted from the cache to make room for
+    /// new ones.
+    size_t evictions;
+
+    /// \brief Estimate of the memory used by the cached values and keys,
+    /// in bytes. This covers the memory allocated for dynamic-size values,
+    /// but not the bookkeeping structures of the cache.
+    size_t bytes;
+  };
+
+  std::ostream& operator<< (std::ostream& o, const CacheStatistics& stats);
+
+  namespace detail
+  {
+    /// \brief Estimate of the memory used by a cached object, in bytes.
+    ///
+    /// By default, this is the size of the object itself.
+    ///
+    /// \tparam T type of the object.
+    template <typename T, typename Enable = void>
+    struct MemoryUsage
+    {
+      static size_t compute (const T&)
+      {
+	return sizeof (T);
+      }
+    };
+
+    /// \brief Memory used by dense Eigen objects: dynamic-size objects
+    /// only account for their heap-allocated coefficients.
+    template <typename T>
+    struct MemoryUsage<T, typename boost::enable_if<
+			    boost::is_base_of<Eigen::PlainObjectBase<T>, T> >::type>
+    {
+      static size_t compute (const T& m)
+      {
+	if (T::MaxSizeAtCompileTime != Eigen::Dynamic)
+	  return sizeof (T);
+
+	return static_cast<size_t> (m.size ()) * sizeof (typename T::Scalar);
+      }
+    };
+
+    /// \brief Memory used by sparse Eigen matrices (values, inner and outer
+    /// indices, neglecting the extra outer index).
+    template <typename S, int O, typename I>
+    struct MemoryUsage<Eigen::SparseMatrix<S, O, I> >
+    {
+      static size_t compute (const Eigen::SparseMatrix<S, O, I>& m)
+      {
+	size_t outer = static_cast<size_t> (m.outerSize ());
+	return static_cast<size_t> (m.data ().allocatedSize ())
+	  * (sizeof (S) + sizeof (I))
+	  + (m.isCompressed ()? outer : 2 * outer) * sizeof (I);
+      }
+    };
+
+    /// \brief Memory used by sparse Eigen vectors (values and indices).
+    template <typename S, int O, typename I>
+    struct MemoryUsage<Eigen::SparseVector<S, O, I> >
+    {
+      static size_t compute (const Eigen::SparseVector<S, O, I>& v)
+      {
+	return static_cast<size_t> (v.data ().allocatedSize ())
+	  * (sizeof (S) + sizeof (I));
+      }
+    };
+
+    /// \brief Estimate of the memory used by a cached object, in bytes.
+    template <typename T>
+    size_t memoryUsage (const T& t)
+    {
+      return MemoryUsage<T>::compute (t);
+    }
+
+    /// \brief Storage for the keys of a LRU cache.
+    ///
+    /// Keys are stored by index in the value pool, so that a cache hit can
+    /// be verified by comparing the key with the stored one.
+    ///
+    /// \tparam K type for keys.
+    template <typename K, typename Enable = void>
+    struct KeyArena
+    {
+      typedef typename const_ref<K>::type const_key_ref;
+
+      /// \brief Allocate memory for a given number of keys.
+      void resize (size_t size)
+      {
+	keys_.resize (size);
+      }
+
+      /// \brief Whether a key can be stored without reallocation.
+      bool compatible (const_key_ref) const
+      {
+	return true;
+      }
+
+      /// \brief Reallocate the arena for keys similar to key.
+      void reshape (const_key_ref)
+      {
+      }
+
+      /// \brief Store a key at a given index.
+      void store (size_t idx, const_key_ref key)
+      {
+	keys_[idx] = key;
+      }
+
+      /// \brief Whether the key stored at a given index is equal to key.
+      bool equal (size_t idx, const_key_ref key) const
+      {
+	return keys_[idx] == key;
+      }
+
+      /// \brief Memory used by the stored keys, in bytes.
+      size_t bytes () const
+      {
+	size_t n = 0;
+	for (size_t i = 0; i < keys_.size (); ++i)
+	  n += memoryUsage (keys_[i]);
+	return n;
+      }
+
+      typename aligned_vector_type<K>::type keys_;
+    };
+
+    /// \brief Storage for dense Eigen vector keys.
+    ///
+    /// Keys are stored contiguously as the columns of an aligned
+    /// column-major matrix. Equality is checked bitwise on the
+    /// contiguous memory, which is vectorized by the standard library.
+    /// All the keys are expected to have the same size.
+    ///
+    /// \tparam K type for keys.
+    template <typename K>
+    struct KeyArena<K, typename boost::enable_if<
+			 boost::is_base_of<Eigen::DenseBase<K>, K> >::type>
+    {
+      typedef typename const_ref<K>::type const_key_ref;
+      typedef typename K::Scalar scalar_t;
+      typedef Eigen::Matrix<scalar_t, Eigen::Dynamic, Eigen::Dynamic,
+			    Eigen::ColMajor> arena_t;
+
+      /// \brief Allocate memory for a given number of keys.
+      void resize (size_t size)
+      {
+	keys_.resize (keys_.rows (), static_cast<typename arena_t::Index> (size));
+      }
+
+      /// \brief Whether a key can be stored without reallocation.
+      bool compatible (const_key_ref key) const
+      {
+	return keys_.rows () == key.size ();
+      }
+
+      /// \brief Reallocate the arena for keys similar to key.
+      /// Note: previously stored keys are lost.
+      void reshape (const_key_ref key)
+      {
+	keys_.resize (key.size (), keys_.cols ());
+      }
+
+      /// \brief Store a key at a given index.
+      void store (size_t idx, const_key_ref key)
+      {
+	assert (compatible (key));
+	keys_.col (static_cast<typename arena_t::Index> (idx)) = key;
+      }
+
+      /// \brief Whether the key stored at a given index is equal to key.
+      bool equal (size_t idx, const_key_ref key) const
+      {
+	if (!compatible (key))
+	  return false;
+
+	return std::memcmp
+	  (keys_.col (static_cast<typename arena_t::Index> (idx)).data (),
+	   key.data (),
+	   static_cast<size_t> (key.size ()) * sizeof (scalar_t)) == 0;
+      }
+
+      /// \brief Find the nearest key among the n first stored keys, in the
+      /// sense of the infinity norm.
+      /// \param n number of keys to search.
+      /// \param key key to look for.
+      /// \param tolerance maximum distance to key.
+      /// \param idx index of the nearest key (if any).
+      /// \return whether a key was found within the given tolerance.
+      bool nearest (size_t n, const_key_ref key, scalar_t tolerance,
+		    size_t& idx) const
+      {
+	if (!compatible (key))
+	  return false;
+
+	bool found = false;
+	for (size_t i = 0; i < n; ++i)
+	  {
+	    scalar_t d = (keys_.col (static_cast<typename arena_t::Index> (i))
+			  - key).template lpNorm<Eigen::Infinity> ();
+	    if (d <= tolerance)
+	      {
+		tolerance = d;
+		idx = i;
+		found = true;
+	      }
+	  }
+	return found;
+      }
+
+      /// \brief Memory used by the stored keys, in bytes.
+      size_t bytes () const
+      {
+	return static_cast<size_t> (keys_.size ()) * sizeof (scalar_t);
+      }
+
+      arena_t keys_;
+    };
+
+    /// \brief Access to the hash function of a cache.
+    ///
+    /// This lets callers that look up the same key several times (e.g. the
+    /// CachedFunction policies) hash it once, and pass the hash to the
+    /// lookup methods, while the hash function stays out of the public
+    /// interface of the caches.
+    struct CacheHash
+    {
+      /// \brief Hash of a key, as computed by the cache.
+      template <typename C>
+      static typename C::hash_t
+      compute (const C& cache, typename C::const_key_ref key)
+      {
+	return cache.hash_function (key);
+      }
+    };
+  } // end of namespace detail
+
   /// \brief LRU (Least Recently Used) cache.
   ///
   /// Note that the cache is unidirectional, i.e. the map does not store the
   /// actual keys, since this was designed with large vectors in mind.
+  /// As a consequence, two keys with the same hash are considered equal.
+  /// If this is not acceptable, the cache can be created in verifying
+  /// mode: keys are then stored in a contiguous arena next to the value
+  /// pool, and every hit is checked against the stored key. On hash
+  /// collision, the newest key replaces the cached one.
   ///
   /// \tparam K type for keys.
   /// \tparam V type for values.
@@ -67,10 +348,17 @@ namespace roboptim
     /// allocations.
     typedef std::list<hash_t> keyTracker_t;
 
+    /// \brief Position of a key in the tracker, stored for each element of
+    /// the value pool so that the tracker can be updated in O(1).
+    typedef std::vector<typename keyTracker_t::iterator> trackerPos_t;
+
     /// \brief Key type for the underlying map.
     typedef hash_t mapKey_t;
     typedef detail::const_ref<mapKey_t>::type const_mapKey_ref;
 
+    /// \brief Storage for the keys (verifying mode).
+    typedef detail::KeyArena<key_t> keyArena_t;
+
     /// \brief Map from map's key to iterator in the value pool.
     typedef boost::unordered_map
     <mapKey_t, typename valuePool_t::iterator> map_t;
@@ -82,7 +370,15 @@ namespace roboptim
     /// \brief Constructor.
     /// Note: all the memory is allocated in the constructor.
     /// \param size maximum size of the cache.
-    LRUCache (size_t size = 10);
+    /// \param verifyKeys whether keys are stored and checked on hit.
+    LRUCache (size_t size = 10, bool verifyKeys = false);
+
+    /// \brief Copy constructor.
+    /// The internal iterators are rebuilt for the new value pool.
+    LRUCache (const LRUCache& cache);
+
+    /// \brief Assignment operator.
+    LRUCache& operator= (const LRUCache& cache);
 
     /// \brief Destructor.
     virtual ~LRUCache ();
@@ -93,9 +389,57 @@ namespace roboptim
     /// \brief Change the size of the cache.
     void resize (size_t size);
 
+    /// \brief Whether keys are verified on hit.
+    bool verifyKeys () const;
+
     /// \brief Find an element in the cache.
     const_iterator find (const_key_ref key) const;
 
+    /// \brief Find an element in the cache, given the precomputed hash of
+    /// its key.
+    /// \param key key to look for.
+    /// \param hash hash of the key (see detail::CacheHash).
+    const_iterator find (const_key_ref key, hash_t hash) const;
+
+    /// \brief Find the element whose key is the nearest to a given key,
+    /// within a given tolerance.
+    ///
+    /// Exact matches are looked for first. If there is none, the stored
+    /// keys are searched linearly for the nearest one (infinity norm).
+    /// This requires the verifying mode and dense vector keys: without
+    /// stored keys, this is equivalent to find.
+    ///
+    /// \param key key to look for.
+    /// \param tolerance maximum distance between key and the cached key.
+    /// \return iterator to the element, or end if none was found.
+    template <typename S>
+    const_iterator findNear (const_key_ref key, S tolerance) const;
+
+    /// \brief Find the element whose key is the nearest to a given key,
+    /// given the precomputed hash of the key.
+    template <typename S>
+    const_iterator findNear (const_key_ref key, hash_t hash,
+                             S tolerance) const;
+
+    /// \brief Number of successful lookups (find and findNear).
+    size_t hits () const;
+
+    /// \brief Number of unsuccessful lookups (find and findNear).
+    size_t misses () const;
+
+    /// \brief Number of elements inserted in the cache.
+    size_t insertions () const;
+
+    /// \brief Number of elements evicted to make room for new ones.
+    size_t evictions () const;
+
+    /// \brief Statistics of the cache.
+    /// Note: the memory estimate requires going through the value pool.
+    CacheStatistics statistics () const;
+
+    /// \brief Reset the lookup, insertion and eviction counters.
+    void resetStatistics ();
+
     /// \brief Iterator to the beginning of the cache.
     iterator begin ();
 
@@ -113,6 +457,30 @@ namespace roboptim
     /// \return reference to the element.
     V& operator [] (const_key_ref key);
 
+    /// \brief Access a cached element, given the precomputed hash of its
+    /// key.
+    /// \param key key to the element.
+    /// \param hash hash of the key (see detail::CacheHash).
+    /// \return reference to the element.
+    V& access (const_key_ref key, hash_t hash);
+
+    /// \brief Access a cached element, given the precomputed hash of its
+    /// key, and tell whether it is a new element.
+    /// \param key key to the element.
+    /// \param hash hash of the key (see detail::CacheHash).
+    /// \param inserted whether the element was created, or replaced an
+    /// element with a different key. In this case, its value is the one
+    /// of a previously evicted element, and should be overwritten.
+    /// \return reference to the element.
+    V& access (const_key_ref key, hash_t hash, bool& inserted);
+
+    /// \brief Access a cached element by the hash it is stored with,
+    /// without checking its key, e.g. an element found by findNear
+    /// (whose map key is the hash of its own key).
+    /// \param hash hash the element is stored with.
+    /// \return pointer to the element, null if there is none.
+    V* accessStored (hash_t hash);
+
     /// \brief Insert a value into the cache.
     /// \param key key of the element.
     /// \param value value of the element.
@@ -131,9 +499,14 @@ namespace roboptim
     hash_t hash_function (const_key_ref key) const;
 
   private:
+    friend struct detail::CacheHash;
+
     /// \brief Allocate memory based on the cache's size.
     void allocate ();
 
+    /// \brief Copy the content of another cache.
+    void copy (const LRUCache& cache);
+
     /// \brief Update an existing cached value.
     void update (iterator iter, const_value_ref value);
 
@@ -141,13 +514,26 @@ namespace roboptim
     V& update (iterator iter);
 
     /// \brief Insert a value into the cache.
-    V& insert (const_key_ref key);
+    V& emplace (const_key_ref key, hash_t hash, bool& inserted);
 
-    /// \brief Notice the tracker that the key was used.
-    void bump (const_mapKey_ref key);
+    /// \brief Notice the tracker that the element was used.
+    /// This is done in constant time.
+    void bump (const_iterator iter);
 
-    /// \brief Find Least Recently Used element.
-    const_iterator findLRU () const;
+    /// \brief Find an element in the cache, without updating the
+    /// statistics.
+    const_iterator lookup (const_key_ref key, hash_t hash) const;
+
+    /// \brief Index of a cached value in the pool.
+    size_t poolIndex (typename valuePool_t::const_iterator v_it) const;
+
+    /// \brief Whether the key matches the cached element (always true if
+    /// keys are not verified).
+    bool matches (const_iterator iter, const_key_ref key) const;
+
+    /// \brief Store the key of a cached element (verifying mode).
+    void storeKey (typename valuePool_t::const_iterator v_it,
+                   const_key_ref key);
 
   private:
     /// \brief Size of the cache.
@@ -156,6 +542,9 @@ namespace roboptim
     /// \brief Tracker for the least recently used elements.
     keyTracker_t tracker_;
 
+    /// \brief Position in the tracker for each element of the pool.
+    trackerPos_t trackerPos_;
+
     /// \brief Map containing iterators to cached values.
     map_t map_;
 
@@ -164,6 +553,24 @@ namespace roboptim
 
     /// \brief Hasher for the cache.
     hasher_t hasher_;
+
+    /// \brief Whether keys are stored and verified on hit.
+    bool verifyKeys_;
+
+    /// \brief Arena of keys, indexed as the value pool (verifying mode).
+    keyArena_t keys_;
+
+    /// \brief Number of successful lookups.
+    mutable size_t hits_;
+
+    /// \brief Number of unsuccessful lookups.
+    mutable size_t misses_;
+
+    /// \brief Number of insertions.
+    size_t insertions_;
+
+    /// \brief Number of evictions.
+    size_t evictions_;
   };
 
   template <typename K, typename V, typename H>
@@ -18,18 +18,136 @@
 #ifndef ROBOPTIM_CORE_CACHE_HXX
 # define ROBOPTIM_CORE_CACHE_HXX
 
-# include <algorithm>
-
 namespace roboptim
 {
+  inline CacheStatistics::CacheStatistics ()
+    : size (0),
+      elements (0),
+      hits (0),
+      misses (0),
+      insertions (0),
+      evictions (0),
+      bytes (0)
+  {
+  }
+
+  inline CacheStatistics&
+  CacheStatistics::operator+= (const CacheStatistics& stats)
+  {
+    size += stats.size;
+    elements += stats.elements;
+    hits += stats.hits;
+    misses += stats.misses;
+    insertions += stats.insertions;
+    evictions += stats.evictions;
+    bytes += stats.bytes;
+    return *this;
+  }
+
+  inline double CacheStatistics::hitRate () const
+  {
+    if (hits + misses == 0)
+      return 0.;
+
+    return static_cast<double> (hits) / static_cast<double> (hits + misses);
+  }
+
+  inline std::ostream& CacheStatistics::print (std::ostream& o) const
+  {
+    o << "size: " << size
+      << ", elements: " << elements
+      << ", hits: " << hits
+      << ", misses: " << misses
+      << ", insertions: " << insertions
+      << ", evictions: " << evictions
+      << ", bytes: " << bytes;
+    return o;
+  }
+
+  inline std::ostream& operator<< (std::ostream& o,
+                                   const CacheStatistics& stats)
+  {
+    return stats.print (o);
+  }
+
   template <typename K, typename V, typename H>
-  LRUCache<K,V,H>::LRUCache (size_t size)
+  LRUCache<K,V,H>::LRUCache (size_t size, bool verifyKeys)
     : size_ (size),
       tracker_ (),
+      trackerPos_ (size),
       map_ (),
       pool_ (size),
-      hasher_ ()
+      hasher_ (),
+      verifyKeys_ (verifyKeys),
+      keys_ (),
+      hits_ (0),
+      misses_ (0),
+      insertions_ (0),
+      evictions_ (0)
+  {
+    if (verifyKeys_)
+      keys_.resize (size_);
+  }
+
+  template <typename K, typename V, typename H>
+  LRUCache<K,V,H>::LRUCache (const LRUCache& cache)
+    : size_ (cache.size_),
+      tracker_ (),
+      trackerPos_ (cache.size_),
+      map_ (),
+      pool_ (cache.pool_),
+      hasher_ (cache.hasher_),
+      verifyKeys_ (cache.verifyKeys_),
+      keys_ (cache.keys_),
+      hits_ (cache.hits_),
+      misses_ (cache.misses_),
+      insertions_ (cache.insertions_),
+      evictions_ (cache.evictions_)
+  {
+    copy (cache);
+  }
+
+  template <typename K, typename V, typename H>
+  LRUCache<K,V,H>& LRUCache<K,V,H>::operator= (const LRUCache& cache)
+  {
+    if (this != &cache)
+      {
+	size_ = cache.size_;
+	tracker_.clear ();
+	trackerPos_.resize (size_);
+	map_.clear ();
+	pool_ = cache.pool_;
+	hasher_ = cache.hasher_;
+	verifyKeys_ = cache.verifyKeys_;
+	keys_ = cache.keys_;
+	hits_ = cache.hits_;
+	misses_ = cache.misses_;
+	insertions_ = cache.insertions_;
+	evictions_ = cache.evictions_;
+	copy (cache);
+      }
+    return *this;
+  }
+
+  template <typename K, typename V, typename H>
+  void LRUCache<K,V,H>::copy (const LRUCache& cache)
   {
+    // Iterators of the other cache point to its own pool and tracker, so
+    // they are rebuilt in the LRU order.
+    for (typename keyTracker_t::const_iterator
+	   t_it = cache.tracker_.begin ();
+	 t_it != cache.tracker_.end (); ++t_it)
+      {
+	const_iterator it = cache.map_.find (*t_it);
+	assert (it != cache.map_.end ());
+
+	size_t idx = cache.poolIndex (it->second);
+	typename valuePool_t::iterator v_it = pool_.begin ()
+	  + static_cast<typename valuePool_t::iterator::difference_type> (idx);
+
+	trackerPos_[idx] = tracker_.insert (tracker_.end (), *t_it);
+	map_.insert (typename map_t::value_type (*t_it, v_it));
+      }
   }
 
   template <typename K, typename V, typename H>
@@ -55,9 +173,20 @@ namespace roboptim
   template <typename K, typename V, typename H>
   void LRUCache<K,V,H>::allocate ()
   {
-    // FIXME: breaks iterators in map_?
+    // Cached values are lost when the pool is reallocated.
+    clear ();
+    pool_.resize (size_);
+    trackerPos_.resize (size_);
     map_.rehash (size_);
-    tracker_.resize (size_);
+
+    if (verifyKeys_)
+      keys_.resize (size_);
+  }
+
+  template <typename K, typename V, typename H>
+  bool LRUCache<K,V,H>::verifyKeys () const
+  {
+    return verifyKeys_;
   }
 
   template <typename K, typename V, typename H>
@@ -70,38 +199,57 @@ namespace roboptim
   template <typename K, typename V, typename H>
   void LRUCache<K,V,H>::insert (const_key_ref key, const_value_ref value)
   {
-    V& v = insert (key);
+    bool inserted;
+    V& v = emplace (key, hash_function (key), inserted);
     v = value;
   }
 
   template <typename K, typename V, typename H>
-  V& LRUCache<K,V,H>::insert (const_key_ref key)
+  V& LRUCache<K,V,H>::emplace (const_key_ref key, hash_t hash,
+                               bool& inserted)
   {
     typename valuePool_t::iterator v_it;
+    typename keyTracker_t::iterator t_it;
 
-    hash_t hash = hash_function (key);
+    // Keys of a different size cannot be stored in the arena: the arena is
+    // reallocated and the cache is cleared
+    if (verifyKeys_ && !keys_.compatible (key))
+      {
+	clear ();
+	keys_.reshape (key);
+      }
 
     // If the key is already in the map
     iterator iter = map_.find (hash);
     if (iter != map_.end ())
       {
-	bump (iter->first);
+	// On hash collision, the new key replaces the cached one
+	inserted = !matches (iter, key);
+	if (inserted)
+	  storeKey (iter->second, key);
+
+	bump (iter);
 	return *(iter->second);
       }
 
     // If the cache is full, remove the LRU element
     if (map_.size () >= size_)
       {
-	const_iterator it = findLRU ();
-
-	// Remove the key from the tracker
-	tracker_.pop_front ();
+	// The LRU element is at the front of the tracker
+	t_it = tracker_.begin ();
+	iterator lru = map_.find (*t_it);
+	assert (lru != map_.end ());
 
 	// Update the iterator for the pool
-	v_it = it->second;
+	v_it = lru->second;
 
 	// Remove the LRU element from the map
-	map_.erase (it);
+	map_.erase (lru);
+
+	// Reuse the tracker node for the new key
+	*t_it = hash;
+	tracker_.splice (tracker_.end (), tracker_, t_it);
+	++evictions_;
       }
     else // cache not full
       {
@@ -109,14 +257,22 @@ namespace roboptim
 	v_it = pool_.begin ()
 	  + static_cast<typename valuePool_t::iterator::difference_type>
 	  (tracker_.size ());
+
+	// Add the new key to the tracker
+	t_it = tracker_.insert (tracker_.end (), hash);
       }
 
-    // Add the new key to the tracker
-    tracker_.push_back (hash);
+    // Store the position of the key in the tracker
+    trackerPos_[poolIndex (v_it)] = t_it;
+
+    // Store the key itself if required
+    storeKey (v_it, key);
 
     // Add the new key to the map
     typename map_t::value_type p (hash, v_it);
     map_.insert (p);
+    ++insertions_;
+    inserted = true;
 
     return *v_it;
   }
@@ -124,14 +280,14 @@ namespace roboptim
   template <typename K, typename V, typename H>
   void LRUCache<K,V,H>::update (iterator iter, const_value_ref value)
   {
-    bump (iter->first);
+    bump (iter);
     *(iter->second) = value;
   }
 
   template <typename K, typename V, typename H>
   V& LRUCache<K,V,H>::update (iterator iter)
   {
-    bump (iter->first);
+    bump (iter);
     return *(iter->second);
   }
 
@@ -167,43 +323,196 @@ namespace roboptim
   typename LRUCache<K,V,H>::const_iterator
   LRUCache<K,V,H>::find (const_key_ref key) const
   {
-    return map_.find (hash_function (key));
+    return find (key, hash_function (key));
   }
 
   template <typename K, typename V, typename H>
-  V& LRUCache<K,V,H>::operator [] (const_key_ref key)
+  typename LRUCache<K,V,H>::const_iterator
+  LRUCache<K,V,H>::find (const_key_ref key, hash_t hash) const
   {
-    typename map_t::iterator it = map_.find (hash_function (key));
+    const_iterator it = lookup (key, hash);
 
     if (it != map_.end ())
-      return update (it);
+      ++hits_;
     else
-      return insert (key);
+      ++misses_;
+
+    return it;
+  }
+
+  template <typename K, typename V, typename H>
+  template <typename S>
+  typename LRUCache<K,V,H>::const_iterator
+  LRUCache<K,V,H>::findNear (const_key_ref key, S tolerance) const
+  {
+    return findNear (key, hash_function (key), tolerance);
   }
 
   template <typename K, typename V, typename H>
+  template <typename S>
   typename LRUCache<K,V,H>::const_iterator
-  LRUCache<K,V,H>::findLRU () const
+  LRUCache<K,V,H>::findNear (const_key_ref key, hash_t hash,
+                             S tolerance) const
   {
-    // Find the LRU element
-    return map_.find (tracker_.front ());
+    const_iterator it = lookup (key, hash);
+
+    // Look for the nearest stored key
+    size_t idx;
+    if (it == map_.end () && verifyKeys_
+	&& keys_.nearest (map_.size (), key, tolerance, idx))
+      {
+	it = map_.find (*trackerPos_[idx]);
+	assert (it != map_.end ());
+      }
+
+    if (it != map_.end ())
+      ++hits_;
+    else
+      ++misses_;
+
+    return it;
   }
 
   template <typename K, typename V, typename H>
-  void LRUCache<K,V,H>::bump (const_mapKey_ref key)
+  typename LRUCache<K,V,H>::const_iterator
+  LRUCache<K,V,H>::lookup (const_key_ref key, hash_t hash) const
   {
-    // TODO: optimize this (remove the need for a search algorithm)
-    typename keyTracker_t::iterator
-      iter = std::find (tracker_.begin (), tracker_.end (), key);
-    assert (iter != tracker_.end ());
+    const_iterator it = map_.find (hash);
 
+    if (it != map_.end () && !matches (it, key))
+      return map_.end ();
+
+    return it;
+  }
+
+  template <typename K, typename V, typename H>
+  size_t LRUCache<K,V,H>::hits () const
+  {
+    return hits_;
+  }
+
+  template <typename K, typename V, typename H>
+  size_t LRUCache<K,V,H>::misses () const
+  {
+    return misses_;
+  }
+
+  template <typename K, typename V, typename H>
+  size_t LRUCache<K,V,H>::insertions () const
+  {
+    return insertions_;
+  }
+
+  template <typename K, typename V, typename H>
+  size_t LRUCache<K,V,H>::evictions () const
+  {
+    return evictions_;
+  }
+
+  template <typename K, typename V, typename H>
+  CacheStatistics LRUCache<K,V,H>::statistics () const
+  {
+    CacheStatistics stats;
+    stats.size = size_;
+    stats.elements = map_.size ();
+    stats.hits = hits_;
+    stats.misses = misses_;
+    stats.insertions = insertions_;
+    stats.evictions = evictions_;
+
+    // Values are preallocated, so the whole pool is taken into account
+    for (typename valuePool_t::const_iterator v_it = pool_.begin ();
+	 v_it != pool_.end (); ++v_it)
+      stats.bytes += detail::memoryUsage (*v_it);
+
+    if (verifyKeys_)
+      stats.bytes += keys_.bytes ();
+
+    return stats;
+  }
+
+  template <typename K, typename V, typename H>
+  void LRUCache<K,V,H>::resetStatistics ()
+  {
+    hits_ = 0;
+    misses_ = 0;
+    insertions_ = 0;
+    evictions_ = 0;
+  }
+
+  template <typename K, typename V, typename H>
+  V& LRUCache<K,V,H>::operator [] (const_key_ref key)
+  {
+    return access (key, hash_function (key));
+  }
+
+  template <typename K, typename V, typename H>
+  V& LRUCache<K,V,H>::access (const_key_ref key, hash_t hash)
+  {
+    bool inserted;
+    return access (key, hash, inserted);
+  }
+
+  template <typename K, typename V, typename H>
+  V& LRUCache<K,V,H>::access (const_key_ref key, hash_t hash, bool& inserted)
+  {
+    typename map_t::iterator it = map_.find (hash);
+
+    if (it != map_.end () && matches (it, key))
+      {
+	inserted = false;
+	return update (it);
+      }
+    else
+      return emplace (key, hash, inserted);
+  }
+
+  template <typename K, typename V, typename H>
+  V* LRUCache<K,V,H>::accessStored (hash_t hash)
+  {
+    typename map_t::iterator it = map_.find (hash);
+
+    if (it == map_.end ())
+      return 0;
+
+    return &update (it);
+  }
+
+  template <typename K, typename V, typename H>
+  void LRUCache<K,V,H>::bump (const_iterator iter)
+  {
+    // Move the key to the back of the tracker (most recently used)
     tracker_.splice (tracker_.end (),
                      tracker_,
-                     iter);
+                     trackerPos_[poolIndex (iter->second)]);
 
     assert (tracker_.size () <= size_);
   }
 
+  template <typename K, typename V, typename H>
+  size_t
+  LRUCache<K,V,H>::poolIndex (typename valuePool_t::const_iterator v_it) const
+  {
+    return static_cast<size_t> (v_it - pool_.begin ());
+  }
+
+  template <typename K, typename V, typename H>
+  bool LRUCache<K,V,H>::matches (const_iterator iter, const_key_ref key) const
+  {
+    if (!verifyKeys_)
+      return true;
+
+    return keys_.equal (poolIndex (iter->second), key);
+  }
+
+  template <typename K, typename V, typename H>
+  void LRUCache<K,V,H>::storeKey (typename valuePool_t::const_iterator v_it,
+                                  const_key_ref key)
+  {
+    if (verifyKeys_)
+      keys_.store (poolIndex (v_it), key);
+  }
+
   template <typename K, typename V, typename H>
   typename LRUCache<K,V,H>::hash_t
   LRUCache<K,V,H>::hash_function (const_key_ref key) const
@@ -21,12 +21,15 @@
 # include <roboptim/core/debug.hh>
 
 # include <map>
+# include <vector>
 # include <ostream>
 
+# include <boost/atomic.hpp>
 # include <boost/shared_ptr.hpp>
 # include <boost/functional/hash.hpp>
 
 # include <roboptim/core/cache.hh>
+# include <roboptim/core/sharded-cache.hh>
 # include <roboptim/core/twice-differentiable-function.hh>
 
 namespace roboptim
@@ -38,27 +41,558 @@ namespace roboptim
     {
       return boost::hash_range (x.data (), x.data () + x.size ());
     }
+
+    inline std::size_t operator() (FloatFunction::const_argument_ref x) const
+    {
+      return boost::hash_range (x.data (), x.data () + x.size ());
+    }
   };
 
   namespace detail
   {
-    template <typename T>
+    template <typename T, typename P>
     struct CachedFunctionTypes;
+
+    /// \brief Entry of the cache of a CachedFunction.
+    ///
+    /// All the data computed for a given argument is stored in the same
+    /// entry, along with flags telling which data is available. Entries
+    /// are recycled by the cache, and their storage is reused.
+    ///
+    /// \tparam T function traits.
+    template <typename T>
+    class CachedFunctionEntry
+    {
+    public:
+      ROBOPTIM_TWICE_DIFFERENTIABLE_FUNCTION_FWD_TYPEDEFS_
+      (GenericTwiceDifferentiableFunction<T>);
+
+      CachedFunctionEntry ();
+
+      /// \brief Forget the cached data (memory is kept).
+      void reset ();
+
+      /// \brief Get the cached value (or derivative of a given order for
+      /// N-times derivable functions).
+      /// \return whether the value was cached.
+      template <typename O>
+      bool getValue (size_t order, O value) const;
+
+      /// \brief Cache a value (or derivative of a given order).
+      template <typename I>
+      void setValue (size_t order, I value);
+
+      /// \brief Get the cached gradient of a given output, extracted from
+      /// the cached Jacobian if needed.
+      /// \return whether the gradient was cached.
+      template <typename O>
+      bool getGradient (size_t functionId, O gradient) const;
+
+      /// \brief Cache the gradient of a given output.
+      template <typename I>
+      void setGradient (size_t functionId, I gradient);
+
+      /// \brief Get the cached Jacobian.
+      /// \return whether the Jacobian was cached.
+      template <typename O>
+      bool getJacobian (size_t, O jacobian) const;
+
+      /// \brief Cache the Jacobian.
+      template <typename I>
+      void setJacobian (size_t, I jacobian);
+
+      /// \brief Get the cached Hessian of a given output.
+      /// \return whether the Hessian was cached.
+      template <typename O>
+      bool getHessian (size_t functionId, O hessian) const;
+
+      /// \brief Cache the Hessian of a given output.
+      template <typename I>
+      void setHessian (size_t functionId, I hessian);
+
+      /// \brief Memory used by the cached data, in bytes.
+      size_t bytes () const;
+
+      /// \brief Display the list of cached data on the specified output
+      /// stream.
+      std::ostream& print (std::ostream& o) const;
+
+    private:
+      /// \brief Values (and derivatives for N-times derivable functions).
+      typename aligned_vector_type<vector_t>::type values_;
+      std::vector<bool> hasValue_;
+
+      /// \brief Gradients.
+      typename aligned_vector_type<gradient_t>::type gradients_;
+      std::vector<bool> hasGradient_;
+
+      /// \brief Jacobian.
+      jacobian_t jacobian_;
+      bool hasJacobian_;
+
+      /// \brief Hessians.
+      typename aligned_vector_type<hessian_t>::type hessians_;
+      std::vector<bool> hasHessian_;
+    };
+
+    template <typename T>
+    std::ostream&
+    operator<< (std::ostream& o, const CachedFunctionEntry<T>& entry);
+
+    /// \brief Memory used by the entries of the cache of a CachedFunction.
+    template <typename T>
+    struct MemoryUsage<CachedFunctionEntry<T> >
+    {
+      static size_t compute (const CachedFunctionEntry<T>& entry)
+      {
+	return entry.bytes ();
+      }
+    };
+
+    /// \brief Functor reading data from a cache entry.
+    /// \tparam E entry type.
+    /// \tparam O output type.
+    template <typename E, typename O>
+    struct CacheEntryReader
+    {
+      typedef bool (E::*getter_t) (size_t, O) const;
+
+      CacheEntryReader (getter_t getter, size_t index, O data)
+	: getter_ (getter),
+	  index_ (index),
+	  data_ (data)
+      {}
+
+      bool operator () (const E& entry) const
+      {
+	return (entry.*getter_) (index_, data_);
+      }
+
+      getter_t getter_;
+      size_t index_;
+      O data_;
+    };
+
+    /// \brief Functor writing data to a cache entry.
+    /// \tparam E entry type.
+    /// \tparam I input type.
+    template <typename E, typename I>
+    struct CacheEntryWriter
+    {
+      typedef void (E::*setter_t) (size_t, I);
+
+      CacheEntryWriter (setter_t setter, size_t index, I data)
+	: setter_ (setter),
+	  index_ (index),
+	  data_ (data)
+      {}
+
+      void operator () (E& entry, bool inserted) const
+      {
+	// Data of recycled entries belongs to another argument
+	if (inserted)
+	  entry.reset ();
+	(entry.*setter_) (index_, data_);
+      }
+
+      setter_t setter_;
+      size_t index_;
+      I data_;
+    };
   } // end of namespace detail
 
   /// \addtogroup roboptim_decorator
   /// @{
 
+  /// \brief Default tolerance for approximate cache keys.
+  static const double cachedFunctionTolerance = 1e-12;
+
+  /// \brief Contains cached function key policies.
+  ///
+  /// Each class of this namespace decides when a cached value can be
+  /// returned for a given argument.
+  ///
+  /// Policies compute the hash of the key of an argument with keyHash,
+  /// look for its cache entry with find and update it with insert, which
+  /// both take that hash: an argument is hashed once per evaluation,
+  /// whatever the requested data.
+  namespace cachedFunctionPolicies
+  {
+    /// \brief Cached values are returned for the exact same argument
+    /// (default).
+    template <typename T>
+    class Exact
+    {
+    public:
+      ROBOPTIM_FUNCTION_FWD_TYPEDEFS_ (GenericFunction<T>);
+
+      /// \brief Type of the statistics counters.
+      typedef size_t counter_t;
+
+      explicit Exact (const GenericFunction<T>&)
+      {}
+
+      /// \brief Whether the arguments have to be stored in the caches.
+      static bool requiresKeys ()
+      {
+	return false;
+      }
+
+      /// \brief Cache type for a given value type.
+      template <typename V>
+      struct cache
+      {
+	typedef LRUCache<argument_t, V, Hasher> type;
+      };
+
+    protected:
+      /// \brief Compute the hash of the key of an argument.
+      /// \param cache cache the key belongs to.
+      /// \param argument argument of the function.
+      /// \return hash of the key.
+      template <typename C>
+      typename C::hash_t keyHash (const C& cache,
+                                  const_argument_ref argument) const
+      {
+	return detail::CacheHash::compute (cache, argument);
+      }
+
+      /// \brief Look for a cache entry and read it.
+      /// \param cache cache to search.
+      /// \param argument argument of the function.
+      /// \param hash hash of the key, as computed by keyHash.
+      /// \param reader functor reading the entry, and returning whether
+      /// the requested data was available.
+      /// \return whether the requested data was found.
+      template <typename C, typename F>
+      bool find (const C& cache, const_argument_ref argument,
+                 typename C::hash_t hash, const F& reader) const
+      {
+	typename C::const_iterator it = cache.find (argument, hash);
+	return it != cache.cend () && reader (*(it->second));
+      }
+
+      /// \brief Update the cache entry of an argument, creating it if
+      /// necessary.
+      /// \param cache cache to update.
+      /// \param argument argument of the function.
+      /// \param hash hash of the key, as computed by keyHash.
+      /// \param writer functor updating the entry.
+      template <typename C, typename F>
+      void insert (C& cache, const_argument_ref argument,
+                   typename C::hash_t hash, const F& writer) const
+      {
+	bool inserted;
+	typename C::value_t& entry = cache.access (argument, hash, inserted);
+	writer (entry, inserted);
+      }
+    };
+
+    /// \brief Arguments are quantized before being used as keys.
+    ///
+    /// Each component of the argument is rounded to the nearest multiple
+    /// of the tolerance, so arguments lying in the same cell of this grid
+    /// share the same cached value (the one computed for the first of
+    /// them). This is as cheap as exact caching, but two arguments closer
+    /// than the tolerance can still lie in different cells.
+    template <typename T>
+    class Quantized
+    {
+    public:
+      ROBOPTIM_FUNCTION_FWD_TYPEDEFS_ (GenericFunction<T>);
+
+      /// \brief Type of the statistics counters.
+      typedef size_t counter_t;
+
+      explicit Quantized (const GenericFunction<T>& adaptee)
+	: tolerance_ (cachedFunctionTolerance),
+	  key_ (adaptee.inputSize ())
+      {}
+
+      /// \brief Get a reference to the quantization step.
+      /// A nonpositive value disables the quantization.
+      value_type& tolerance ()
+      {
+	return tolerance_;
+      }
+
+      /// \brief Whether the arguments have to be stored in the caches.
+      static bool requiresKeys ()
+      {
+	return false;
+      }
+
+      /// \brief Cache type for a given value type.
+      template <typename V>
+      struct cache
+      {
+	typedef LRUCache<argument_t, V, Hasher> type;
+      };
+
+    protected:
+      /// \brief Compute the hash of the key of an argument.
+      template <typename C>
+      typename C::hash_t keyHash (const C& cache,
+                                  const_argument_ref argument) const
+      {
+	return detail::CacheHash::compute (cache, quantize (argument));
+      }
+
+      /// \brief Look for a cache entry and read it.
+      template <typename C, typename F>
+      bool find (const C& cache, const_argument_ref argument,
+                 typename C::hash_t hash, const F& reader) const
+      {
+	const argument_t& key = quantize (argument);
+	typename C::const_iterator it = cache.find (key, hash);
+	return it != cache.cend () && reader (*(it->second));
+      }
+
+      /// \brief Update the cache entry of an argument, creating it if
+      /// necessary.
+      template <typename C, typename F>
+      void insert (C& cache, const_argument_ref argument,
+                   typename C::hash_t hash, const F& writer) const
+      {
+	bool inserted;
+	typename C::value_t& entry =
+	  cache.access (quantize (argument), hash, inserted);
+	writer (entry, inserted);
+      }
+
+    private:
+      /// \brief Compute the quantized key of an argument.
+      const argument_t& quantize (const_argument_ref argument) const;
+
+    private:
+      /// \brief Quantization step.
+      value_type tolerance_;
+
+      /// \brief Buffer storing the quantized argument.
+      mutable argument_t key_;
+    };
+
+    /// \brief Cached values are returned for the nearest cached argument
+    /// within a given tolerance (infinity norm).
+    ///
+    /// Arguments are stored in the caches, and searched linearly when no
+    /// exact match is found: this is more expensive than Quantized for
+    /// large caches, but does not suffer from grid boundary effects.
+    template <typename T>
+    class EpsilonBall
+    {
+    public:
+      ROBOPTIM_FUNCTION_FWD_TYPEDEFS_ (GenericFunction<T>);
+
+      /// \brief Type of the statistics counters.
+      typedef size_t counter_t;
+
+      explicit EpsilonBall (const GenericFunction<T>& adaptee)
+	: tolerance_ (cachedFunctionTolerance),
+	  near_ (false),
+	  nearHash_ (),
+	  nearArgument_ (adaptee.inputSize ())
+      {}
+
+      /// \brief Get a reference to the radius of the ball.
+      value_type& tolerance ()
+      {
+	return tolerance_;
+      }
+
+      /// \brief Whether the arguments have to be stored in the caches.
+      static bool requiresKeys ()
+      {
+	return true;
+      }
+
+      /// \brief Cache type for a given value type.
+      template <typename V>
+      struct cache
+      {
+	typedef LRUCache<argument_t, V, Hasher> type;
+      };
+
+    protected:
+      /// \brief Compute the hash of the key of an argument.
+      template <typename C>
+      typename C::hash_t keyHash (const C& cache,
+                                  const_argument_ref argument) const
+      {
+	return detail::CacheHash::compute (cache, argument);
+      }
+
+      /// \brief Look for a cache entry and read it.
+      template <typename C, typename F>
+      bool find (const C& cache, const_argument_ref argument,
+                 typename C::hash_t hash, const F& reader) const
+      {
+	typename C::const_iterator it =
+	  cache.findNear (argument, hash, tolerance_);
+
+	// Remember the entry found, so that the data missing from it is
+	// added to it rather than to a new entry a tolerance away.
+	near_ = it != cache.cend ();
+	if (!near_)
+	  return false;
+
+	nearHash_ = it->first;
+	nearArgument_ = argument;
+	return reader (*(it->second));
+      }
+
+      /// \brief Update the cache entry of an argument, creating it if
+      /// necessary.
+      template <typename C, typename F>
+      void insert (C& cache, const_argument_ref argument,
+                   typename C::hash_t hash, const F& writer) const
+      {
+	if (near_ && nearArgument_ == argument)
+	  {
+	    typename C::value_t* entry = cache.accessStored (nearHash_);
+	    if (entry)
+	      {
+		writer (*entry, false);
+		return;
+	      }
+	  }
+
+	bool inserted;
+	typename C::value_t& entry = cache.access (argument, hash, inserted);
+	writer (entry, inserted);
+      }
+
+    private:
+      /// \brief Radius of the ball.
+      value_type tolerance_;
+
+      /// \brief Whether the last lookup found an entry.
+      mutable bool near_;
+
+      /// \brief Hash the entry found by the last lookup is stored with.
+      mutable std::size_t nearHash_;
+
+      /// \brief Argument of the last lookup.
+      mutable argument_t nearArgument_;
+    };
+
+    /// \brief Cached values are returned for the exact same argument, and
+    /// the caches can be shared by several threads.
+    ///
+    /// Caches are ShardedLRUCache instances, so several solver threads can
+    /// evaluate the same cached function concurrently. Note that the
+    /// wrapped function itself has to be thread-safe.
+    template <typename T>
+    class Concurrent
+    {
+    public:
+      ROBOPTIM_FUNCTION_FWD_TYPEDEFS_ (GenericFunction<T>);
+
+      /// \brief Type of the statistics counters, incremented without
+      /// locking by the evaluating threads.
+      typedef boost::atomic<size_t> counter_t;
+
+      explicit Concurrent (const GenericFunction<T>&)
+      {}
+
+      /// \brief Whether the arguments have to be stored in the caches.
+      static bool requiresKeys ()
+      {
+	return false;
+      }
+
+      /// \brief Cache type for a given value type.
+      template <typename V>
+      struct cache
+      {
+	typedef ShardedLRUCache<argument_t, V, Hasher> type;
+      };
+
+    protected:
+      /// \brief Compute the hash of the key of an argument.
+      template <typename C>
+      typename C::hash_t keyHash (const C& cache,
+                                  const_argument_ref argument) const
+      {
+	return detail::CacheHash::compute (cache, argument);
+      }
+
+      /// \brief Look for a cache entry and read it.
+      template <typename C, typename F>
+      bool find (const C& cache, const_argument_ref argument,
+                 typename C::hash_t hash, const F& reader) const
+      {
+	return cache.read (argument, hash, reader);
+      }
+
+      /// \brief Update the cache entry of an argument, creating it if
+      /// necessary.
+      template <typename C, typename F>
+      void insert (C& cache, const_argument_ref argument,
+                   typename C::hash_t hash, const F& writer) const
+      {
+	cache.write (argument, hash, writer);
+      }
+    };
+  } // end of namespace cachedFunctionPolicies
+
+  /// \brief Statistics of the caches of a CachedFunction.
+  ///
+  /// All the data is stored in a single cache, whose statistics are given
+  /// by cache. The other members only count the lookups (hits and misses)
+  /// and the insertions of each kind of data. Gradient and Hessian
+  /// statistics are accumulated over all the output indices.
+  struct CachedFunctionStatistics
+  {
+    /// \brief Statistics of the cache of the function. Hits and misses
+    /// are those of all the lookups.
+    CacheStatistics cache;
+
+    /// \brief Lookups of function values (including the derivatives of
+    /// N-times derivable functions).
+    CacheStatistics function;
+
+    /// \brief Lookups of gradients.
+    CacheStatistics gradient;
+
+    /// \brief Lookups of Jacobians.
+    CacheStatistics jacobian;
+
+    /// \brief Lookups of Hessians.
+    CacheStatistics hessian;
+  };
+
   /// \brief Store previous function computation.
   ///
   /// When an expensive function is called several times at the same
   /// point (exactly!), the cached function prevents useless
   /// computation by caching the function result.
   ///
+  /// All the data computed at a given point (value, gradients, Jacobian,
+  /// Hessians) is stored in the same cache entry, so that the argument is
+  /// hashed once per evaluation. Gradients are also extracted from the
+  /// cached Jacobian when available.
+  ///
+  /// By default, cached results are identified by the hash of the
+  /// argument, so two arguments with the same hash share the same
+  /// result. If keys are verified, arguments are also stored in the
+  /// cache and compared on every hit, which makes large caches safe at
+  /// the cost of a comparison per hit.
+  ///
+  /// The key policy can relax the "exactly" above: see
+  /// cachedFunctionPolicies for the available policies, and hits/misses
+  /// to tune their tolerance.
+  ///
+  /// Cache usage can be monitored with statistics, which is useful to
+  /// tune the size of the cache.
+  ///
   /// This decorator is experimental in this release.
   /// \tparam T input function type.
-  template <typename T>
-  class CachedFunction : public T
+  /// \tparam CachePolicy cache key policy.
+  template <typename T,
+	    typename CachePolicy =
+	    cachedFunctionPolicies::Exact<typename T::traits_t> >
+  class CachedFunction : public T, public CachePolicy
   {
   public:
     /// \brief Import traits type.
@@ -74,21 +608,39 @@ namespace roboptim
     /// \brief Key type for the cache.
     typedef argument_t cacheKey_t;
 
-    typedef LRUCache<cacheKey_t, vector_t, Hasher>   functionCache_t;
-    typedef LRUCache<cacheKey_t, gradient_t, Hasher> gradientCache_t;
-    typedef LRUCache<cacheKey_t, jacobian_t, Hasher> jacobianCache_t;
-    typedef LRUCache<cacheKey_t, hessian_t, Hasher>  hessianCache_t;
+    /// \brief Entry of the cache.
+    typedef detail::CachedFunctionEntry<traits_t> cacheEntry_t;
+
+    /// \brief Cache type.
+    typedef typename CachePolicy::template cache<cacheEntry_t>::type cache_t;
 
     /// \brief Cache a RobOptim function.
     /// \param fct function to cache.
     /// \param size size of the LRU cache.
+    /// \param verifyKeys whether arguments are stored and checked on hit
+    /// to prevent returning wrong results on hash collisions. This is
+    /// always the case if the cache policy requires it.
     explicit CachedFunction (boost::shared_ptr<T> fct,
-                             size_t size = 10);
+                             size_t size = 10,
+                             bool verifyKeys = false);
     ~CachedFunction ();
 
-    /// \brief Reset the caches.
+    /// \brief Reset the cache.
     void reset ();
 
+    /// \brief Number of cache hits (all lookups).
+    size_t hits () const;
+
+    /// \brief Number of cache misses (all lookups).
+    size_t misses () const;
+
+    /// \brief Statistics of the cache, and of the lookups of function
+    /// values, gradients, Jacobians and Hessians.
+    CachedFunctionStatistics statistics () const;
+
+    /// \brief Reset the cache statistics.
+    void resetStatistics ();
+
     /// \brief Display the cached function on the specified output stream.
     ///
     /// \param o output stream used for display
@@ -99,8 +651,49 @@ namespace roboptim
     const boost::shared_ptr<const T> function () const;
 
   protected:
+    /// \brief Kinds of cached data, for statistics.
+    enum cachedData_t
+      {
+	FUNCTION_DATA = 0,
+	GRADIENT_DATA,
+	JACOBIAN_DATA,
+	HESSIAN_DATA,
+	CACHED_DATA
+      };
+
+    /// \brief Hash type of the cache.
+    typedef typename cache_t::hash_t hash_t;
+
+    /// \brief Counter type of the statistics.
+    typedef typename CachePolicy::counter_t counter_t;
+
+    /// \brief Look for cached data, and update the statistics.
+    /// \param argument argument of the function.
+    /// \param hash hash of the key, as computed by keyHash.
+    /// \param getter member of the entry reading the data.
+    /// \param index index of the data (derivation order, function id).
+    /// \param data output data.
+    /// \param kind kind of data.
+    /// \return whether the data was found.
+    template <typename O>
+    bool lookup (const_argument_ref argument, hash_t hash,
+                 bool (cacheEntry_t::*getter) (size_t, O) const,
+                 size_t index, O data, cachedData_t kind) const;
+
+    /// \brief Store data in the cache, and update the statistics.
+    /// \param argument argument of the function.
+    /// \param hash hash of the key, as computed by keyHash.
+    /// \param setter member of the entry storing the data.
+    /// \param index index of the data (derivation order, function id).
+    /// \param data data to store.
+    /// \param kind kind of data.
+    template <typename I>
+    void store (const_argument_ref argument, hash_t hash,
+                void (cacheEntry_t::*setter) (size_t, I),
+                size_t index, I data, cachedData_t kind) const;
+
     /// \internal
-    /// The four following pairs function definitions should be put in the .hxx 
+    /// The six following pairs function definitions should be put in the .hxx 
     /// file. However, msvc compilers (at least up to Visual Sutdio 2015 Update 
     /// 1)  fails in this case: it tries to match the definitions with the 
     /// declarations but since it does so before any substitution of any 
@@ -109,35 +702,26 @@ namespace roboptim
     void cachedFunctionGradient(gradient_ref gradient,
       const_argument_ref argument,
       size_type functionId,
-      typename detail::CachedFunctionTypes<U>::isDifferentiable_t::type* = 0)
+      typename detail::CachedFunctionTypes<U, CachePolicy>::isDifferentiable_t::type* = 0)
       const
     {
-      typename gradientCache_t::const_iterator it = gradientCache_
-        [static_cast<std::size_t> (functionId)].find(argument);
-      if (it != gradientCache_[static_cast<std::size_t> (functionId)].end())
-      {
-        gradient = *(it->second);
+      hash_t hash = this->keyHash (cache_, argument);
+      std::size_t id = static_cast<std::size_t> (functionId);
+      if (lookup<gradient_ref>
+          (argument, hash, &cacheEntry_t::template getGradient<gradient_ref>,
+           id, gradient, GRADIENT_DATA))
         return;
-      }
       function_->gradient(gradient, argument, functionId);
-
-#ifndef ROBOPTIM_DO_NOT_CHECK_ALLOCATION
-      bool cur_malloc_allowed = is_malloc_allowed();
-      set_is_malloc_allowed(true);
-#endif //! ROBOPTIM_DO_NOT_CHECK_ALLOCATION
-
-      gradientCache_[static_cast<std::size_t> (functionId)][argument] = gradient;
-
-#ifndef ROBOPTIM_DO_NOT_CHECK_ALLOCATION
-      set_is_malloc_allowed(cur_malloc_allowed);
-#endif //! ROBOPTIM_DO_NOT_CHECK_ALLOCATION
+      store<const_gradient_ref>
+        (argument, hash, &cacheEntry_t::template setGradient<const_gradient_ref>,
+         id, gradient, GRADIENT_DATA);
     }
 
     template <typename U>
     void cachedFunctionGradient(gradient_ref,
       const_argument_ref,
       size_type,
-      typename detail::CachedFunctionTypes<U>::isNotDifferentiable_t::type* = 0)
+      typename detail::CachedFunctionTypes<U, CachePolicy>::isNotDifferentiable_t::type* = 0)
       const
     {
       // Not differentiable
@@ -147,34 +731,88 @@ namespace roboptim
     template <typename U>
     void cachedFunctionJacobian(jacobian_ref jacobian,
       const_argument_ref argument,
-      typename detail::CachedFunctionTypes<U>::isDifferentiable_t::type* = 0)
+      typename detail::CachedFunctionTypes<U, CachePolicy>::isDifferentiable_t::type* = 0)
       const
     {
-      typename CachedFunction<T>::jacobianCache_t::
-        const_iterator it = jacobianCache_.find(argument);
-      if (it != jacobianCache_.end())
-      {
-        jacobian = *(it->second);
+      hash_t hash = this->keyHash (cache_, argument);
+      if (lookup<jacobian_ref>
+          (argument, hash, &cacheEntry_t::template getJacobian<jacobian_ref>,
+           0, jacobian, JACOBIAN_DATA))
         return;
-      }
       function_->jacobian(jacobian, argument);
+      store<const_jacobian_ref>
+        (argument, hash, &cacheEntry_t::template setJacobian<const_jacobian_ref>,
+         0, jacobian, JACOBIAN_DATA);
+    }
 
-#ifndef ROBOPTIM_DO_NOT_CHECK_ALLOCATION
-      bool cur_malloc_allowed = is_malloc_allowed();
-      set_is_malloc_allowed(true);
-#endif //! ROBOPTIM_DO_NOT_CHECK_ALLOCATION
+    template <typename U>
+    void cachedFunctionJacobian(jacobian_ref,
+      const_argument_ref,
+      typename detail::CachedFunctionTypes<U, CachePolicy>::isNotDifferentiable_t::type* = 0)
+      const
+    {
+      // Not differentiable
+      assert(0);
+    }
 
-      jacobianCache_[argument] = jacobian;
+    template <typename U>
+    void cachedFunctionValueAndJacobian(result_ref result,
+      jacobian_ref jacobian,
+      const_argument_ref argument,
+      typename detail::CachedFunctionTypes<U, CachePolicy>::isDifferentiable_t::type* = 0)
+      const
+    {
+      hash_t hash = this->keyHash (cache_, argument);
+      bool hasValue = lookup<result_ref>
+        (argument, hash, &cacheEntry_t::template getValue<result_ref>,
+         0, result, FUNCTION_DATA);
+      bool hasJacobian = lookup<jacobian_ref>
+        (argument, hash, &cacheEntry_t::template getJacobian<jacobian_ref>,
+         0, jacobian, JACOBIAN_DATA);
+      if (hasValue && hasJacobian)
+        return;
 
-#ifndef ROBOPTIM_DO_NOT_CHECK_ALLOCATION
-      set_is_malloc_allowed(cur_malloc_allowed);
-#endif //! ROBOPTIM_DO_NOT_CHECK_ALLOCATION
+      // Only compute the missing data, in a single call if possible
+      if (hasValue)
+        function_->jacobian(jacobian, argument);
+      else if (hasJacobian)
+        (*function_)(result, argument);
+      else
+        function_->valueAndJacobian(result, jacobian, argument);
+
+      if (!hasValue)
+        store<const_result_ref>
+          (argument, hash, &cacheEntry_t::template setValue<const_result_ref>,
+           0, result, FUNCTION_DATA);
+      if (!hasJacobian)
+        store<const_jacobian_ref>
+          (argument, hash, &cacheEntry_t::template setJacobian<const_jacobian_ref>,
+           0, jacobian, JACOBIAN_DATA);
     }
 
     template <typename U>
-    void cachedFunctionJacobian(jacobian_ref,
+    void cachedFunctionValueAndJacobian(result_ref,
+      jacobian_ref,
       const_argument_ref,
-      typename detail::CachedFunctionTypes<U>::isNotDifferentiable_t::type* = 0)
+      typename detail::CachedFunctionTypes<U, CachePolicy>::isNotDifferentiable_t::type* = 0)
+      const
+    {
+      // Not differentiable
+      assert(0);
+    }
+
+    template <typename U>
+    void cachedFunctionJacobianStructure(sparsityPattern_t& pattern,
+      typename detail::CachedFunctionTypes<U, CachePolicy>::isDifferentiable_t::type* = 0)
+      const
+    {
+      // The pattern does not depend on the argument: nothing to cache.
+      function_->jacobianStructure(pattern);
+    }
+
+    template <typename U>
+    void cachedFunctionJacobianStructure(sparsityPattern_t&,
+      typename detail::CachedFunctionTypes<U, CachePolicy>::isNotDifferentiable_t::type* = 0)
       const
     {
       // Not differentiable
@@ -185,32 +823,22 @@ namespace roboptim
     void cachedFunctionHessian(hessian_ref hessian,
       const_argument_ref argument,
       size_type functionId,
-      typename detail::CachedFunctionTypes<U>::isTwiceDifferentiable_t::type* = 0)
+      typename detail::CachedFunctionTypes<U, CachePolicy>::isTwiceDifferentiable_t::type* = 0)
       const
     {
+      hash_t hash = this->keyHash (cache_, argument);
+      std::size_t id = static_cast<std::size_t> (functionId);
       //FIXME: bug detected by Clang. To be fixed.
 #ifdef ROBOPTIM_CORE_THIS_DOES_NOT_WORK
-      typename CachedFunction<T>::functionCache_t::
-        const_iterator it = hessianCache_
-        [static_cast<std::size_t> (functionId)].find(argument);
-      if (it != hessianCache_[functionId].end())
-      {
-        hessian = *(it->second);
+      if (lookup<hessian_ref>
+          (argument, hash, &cacheEntry_t::template getHessian<hessian_ref>,
+           id, hessian, HESSIAN_DATA))
         return;
-      }
 #endif
       function_->hessian(hessian, argument, functionId);
-
-#ifndef ROBOPTIM_DO_NOT_CHECK_ALLOCATION
-      bool cur_malloc_allowed = is_malloc_allowed();
-      set_is_malloc_allowed(true);
-#endif //! ROBOPTIM_DO_NOT_CHECK_ALLOCATION
-
-      hessianCache_[static_cast<std::size_t> (functionId)][argument] = hessian;
-
-#ifndef ROBOPTIM_DO_NOT_CHECK_ALLOCATION
-      set_is_malloc_allowed(cur_malloc_allowed);
-#endif //! ROBOPTIM_DO_NOT_CHECK_ALLOCATION
+      store<const_hessian_ref>
+        (argument, hash, &cacheEntry_t::template setHessian<const_hessian_ref>,
+         id, hessian, HESSIAN_DATA);
     }
 
 
@@ -218,7 +846,7 @@ namespace roboptim
     void cachedFunctionHessian(hessian_ref,
       const_argument_ref,
       size_type,
-      typename detail::CachedFunctionTypes<U>::isNotTwiceDifferentiable_t::type* = 0)
+      typename detail::CachedFunctionTypes<U, CachePolicy>::isNotTwiceDifferentiable_t::type* = 0)
       const
     {
       // Not twice-differentiable
@@ -230,20 +858,21 @@ namespace roboptim
     void cachedFunctionDerivative(gradient_ref derivative,
       value_type argument,
       size_type order,
-      typename detail::CachedFunctionTypes<U>::isNTimesDerivable_t::type*)
+      typename detail::CachedFunctionTypes<U, CachePolicy>::isNTimesDerivable_t::type*)
       const
     {
       typename T::vector_t x(1);
       x[0] = argument;
-      typename CachedFunction<T>::functionCache_t::
-        const_iterator it = cache_[order].find(x);
-      if (it != cache_[order].end())
-      {
-        derivative = *(it->second);
+      hash_t hash = this->keyHash (cache_, x);
+      std::size_t o = static_cast<std::size_t> (order);
+      if (lookup<gradient_ref>
+          (x, hash, &cacheEntry_t::template getValue<gradient_ref>,
+           o, derivative, FUNCTION_DATA))
         return;
-      }
       function_->derivative(derivative, x, order);
-      cache_[order][x] = derivative;
+      store<const_gradient_ref>
+        (x, hash, &cacheEntry_t::template setValue<const_gradient_ref>,
+         o, derivative, FUNCTION_DATA);
     }
 
 
@@ -251,7 +880,7 @@ namespace roboptim
     void cachedFunctionDerivative(gradient_ref,
       value_type,
       size_type,
-      typename detail::CachedFunctionTypes<U>::isNotNTimesDerivable_t::type* = 0)
+      typename detail::CachedFunctionTypes<U, CachePolicy>::isNotNTimesDerivable_t::type* = 0)
       const
     {
       // Not n-times derivable
@@ -272,6 +901,13 @@ namespace roboptim
     virtual void impl_jacobian (jacobian_ref jacobian, const_argument_ref arg)
       const;
 
+    virtual void impl_value_and_jacobian (result_ref result,
+					  jacobian_ref jacobian,
+					  const_argument_ref argument)
+      const;
+
+    virtual void impl_jacobian_structure (sparsityPattern_t& pattern) const;
+
     virtual void impl_hessian (hessian_ref hessian,
     			       const_argument_ref argument,
     			       size_type functionId = 0) const;
@@ -282,10 +918,16 @@ namespace roboptim
 
   protected:
     boost::shared_ptr<T> function_;
-    mutable std::vector<functionCache_t> cache_;
-    mutable std::vector<gradientCache_t> gradientCache_;
-    mutable jacobianCache_t jacobianCache_;
-    mutable std::vector<hessianCache_t> hessianCache_;
+    mutable cache_t cache_;
+
+    /// \brief Number of hits for each kind of data.
+    mutable counter_t hits_[CACHED_DATA];
+
+    /// \brief Number of misses for each kind of data.
+    mutable counter_t misses_[CACHED_DATA];
+
+    /// \brief Number of insertions for each kind of data.
+    mutable counter_t insertions_[CACHED_DATA];
   };
 
   /// @}
@@ -18,6 +18,9 @@
 #ifndef ROBOPTIM_CORE_DECORATOR_CACHED_FUNCTION_HXX
 # define ROBOPTIM_CORE_DECORATOR_CACHED_FUNCTION_HXX
 
+# include <algorithm>
+# include <cmath>
+
 # include <boost/format.hpp>
 # include <boost/utility/enable_if.hpp>
 
@@ -43,11 +46,11 @@ namespace roboptim
 
   namespace detail
   {
-    template <typename T>
+    template <typename T, typename P>
     struct CachedFunctionTypes
     {
       typedef typename T::traits_t traits_t;
-      typedef CachedFunction<T> cachedFunction_t;
+      typedef CachedFunction<T, P> cachedFunction_t;
 
       ROBOPTIM_TWICE_DIFFERENTIABLE_FUNCTION_FWD_TYPEDEFS_
       (GenericTwiceDifferentiableFunction<traits_t>);
@@ -76,103 +79,371 @@ namespace roboptim
 					 derives_from_ntimes_derivable_function<T> >
       isNotNTimesDerivable_t;
     };
+
+    template <typename T>
+    CachedFunctionEntry<T>::CachedFunctionEntry ()
+      : values_ (),
+	hasValue_ (),
+	gradients_ (),
+	hasGradient_ (),
+	jacobian_ (),
+	hasJacobian_ (false),
+	hessians_ (),
+	hasHessian_ ()
+    {
+    }
+
+    template <typename T>
+    void CachedFunctionEntry<T>::reset ()
+    {
+      std::fill (hasValue_.begin (), hasValue_.end (), false);
+      std::fill (hasGradient_.begin (), hasGradient_.end (), false);
+      hasJacobian_ = false;
+      std::fill (hasHessian_.begin (), hasHessian_.end (), false);
+    }
+
+    template <typename T>
+    template <typename O>
+    bool CachedFunctionEntry<T>::getValue (size_t order, O value) const
+    {
+      if (order >= hasValue_.size () || !hasValue_[order])
+	return false;
+
+      value = values_[order];
+      return true;
+    }
+
+    template <typename T>
+    template <typename I>
+    void CachedFunctionEntry<T>::setValue (size_t order, I value)
+    {
+      if (order >= values_.size ())
+	{
+	  values_.resize (order + 1);
+	  hasValue_.resize (order + 1, false);
+	}
+
+      values_[order] = value;
+      hasValue_[order] = true;
+    }
+
+    template <typename T>
+    template <typename O>
+    bool CachedFunctionEntry<T>::getGradient (size_t functionId,
+                                              O gradient) const
+    {
+      if (functionId < hasGradient_.size () && hasGradient_[functionId])
+	{
+	  gradient = gradients_[functionId];
+	  return true;
+	}
+
+      // The gradient is a row of the Jacobian
+      if (hasJacobian_)
+	{
+	  gradient = jacobian_.row
+	    (static_cast<typename jacobian_t::Index> (functionId));
+	  return true;
+	}
+
+      return false;
+    }
+
+    template <typename T>
+    template <typename I>
+    void CachedFunctionEntry<T>::setGradient (size_t functionId, I gradient)
+    {
+      if (functionId >= gradients_.size ())
+	{
+	  gradients_.resize (functionId + 1);
+	  hasGradient_.resize (functionId + 1, false);
+	}
+
+      gradients_[functionId] = gradient;
+      hasGradient_[functionId] = true;
+    }
+
+    template <typename T>
+    template <typename O>
+    bool CachedFunctionEntry<T>::getJacobian (size_t, O jacobian) const
+    {
+      if (!hasJacobian_)
+	return false;
+
+      jacobian = jacobian_;
+      return true;
+    }
+
+    template <typename T>
+    template <typename I>
+    void CachedFunctionEntry<T>::setJacobian (size_t, I jacobian)
+    {
+      jacobian_ = jacobian;
+      hasJacobian_ = true;
+    }
+
+    template <typename T>
+    template <typename O>
+    bool CachedFunctionEntry<T>::getHessian (size_t functionId,
+                                             O hessian) const
+    {
+      if (functionId >= hasHessian_.size () || !hasHessian_[functionId])
+	return false;
+
+      hessian = hessians_[functionId];
+      return true;
+    }
+
+    template <typename T>
+    template <typename I>
+    void CachedFunctionEntry<T>::setHessian (size_t functionId, I hessian)
+    {
+      if (functionId >= hessians_.size ())
+	{
+	  hessians_.resize (functionId + 1);
+	  hasHessian_.resize (functionId + 1, false);
+	}
+
+      hessians_[functionId] = hessian;
+      hasHessian_[functionId] = true;
+    }
+
+    template <typename T>
+    size_t CachedFunctionEntry<T>::bytes () const
+    {
+      size_t n = memoryUsage (jacobian_);
+      for (size_t i = 0; i < values_.size (); ++i)
+	n += memoryUsage (values_[i]);
+      for (size_t i = 0; i < gradients_.size (); ++i)
+	n += memoryUsage (gradients_[i]);
+      for (size_t i = 0; i < hessians_.size (); ++i)
+	n += memoryUsage (hessians_[i]);
+      return n;
+    }
+
+    template <typename T>
+    std::ostream& CachedFunctionEntry<T>::print (std::ostream& o) const
+    {
+      const char* sep = "";
+      o << "(";
+      for (size_t i = 0; i < hasValue_.size (); ++i)
+	if (hasValue_[i])
+	  {
+	    o << sep << "value " << i;
+	    sep = ", ";
+	  }
+      for (size_t i = 0; i < hasGradient_.size (); ++i)
+	if (hasGradient_[i])
+	  {
+	    o << sep << "gradient " << i;
+	    sep = ", ";
+	  }
+      if (hasJacobian_)
+	{
+	  o << sep << "jacobian";
+	  sep = ", ";
+	}
+      for (size_t i = 0; i < hasHessian_.size (); ++i)
+	if (hasHessian_[i])
+	  {
+	    o << sep << "hessian " << i;
+	    sep = ", ";
+	  }
+      return o << ")";
+    }
+
+    template <typename T>
+    std::ostream&
+    operator<< (std::ostream& o, const CachedFunctionEntry<T>& entry)
+    {
+      return entry.print (o);
+    }
   } // end of namespace detail
 
-  template <typename T>
-  CachedFunction<T>::CachedFunction (boost::shared_ptr<T> fct,
-                                     size_t size)
+  namespace cachedFunctionPolicies
+  {
+    template <typename T>
+    const typename Quantized<T>::argument_t&
+    Quantized<T>::quantize (const_argument_ref argument) const
+    {
+      if (tolerance_ <= 0.)
+	{
+	  key_ = argument;
+	  return key_;
+	}
+
+      key_.resize (argument.size ());
+      for (size_type i = 0; i < argument.size (); ++i)
+	key_[i] = std::floor (argument[i] / tolerance_ + .5) * tolerance_;
+
+      return key_;
+    }
+  } // end of namespace cachedFunctionPolicies
+
+  template <typename T, typename P>
+  CachedFunction<T, P>::CachedFunction (boost::shared_ptr<T> fct,
+                                     size_t size,
+                                     bool verifyKeys)
     : T (fct->inputSize (), fct->outputSize (), cachedFunctionName (*fct)),
+      P (*fct),
       function_ (fct),
-      cache_ (derivativeSize<T>::value, size),
-      gradientCache_ (static_cast<std::size_t> (fct->outputSize ()), size),
-      hessianCache_ (static_cast<std::size_t> (fct->outputSize ()), size)
+      cache_ (size, verifyKeys || P::requiresKeys ())
   {
+    resetStatistics ();
   }
 
-  template <typename T>
-  CachedFunction<T>::~CachedFunction ()
+  template <typename T, typename P>
+  CachedFunction<T, P>::~CachedFunction ()
   {
   }
 
-  template <typename T>
+  template <typename T, typename P>
   void
-  CachedFunction<T>::reset ()
+  CachedFunction<T, P>::reset ()
   {
-    for (typename std::vector<functionCache_t>::iterator
-	   iter  = cache_.begin ();
-         iter != cache_.end ();
-         ++iter)
-      {
-	iter->clear ();
-      }
+    cache_.clear ();
+  }
 
-    for (typename std::vector<gradientCache_t>::iterator
-	   iter  = gradientCache_.begin ();
-         iter != gradientCache_.end ();
-         ++iter)
+  template <typename T, typename P>
+  size_t
+  CachedFunction<T, P>::hits () const
+  {
+    size_t n = 0;
+    for (size_t i = 0; i < CACHED_DATA; ++i)
+      n += hits_[i];
+    return n;
+  }
+
+  template <typename T, typename P>
+  size_t
+  CachedFunction<T, P>::misses () const
+  {
+    size_t n = 0;
+    for (size_t i = 0; i < CACHED_DATA; ++i)
+      n += misses_[i];
+    return n;
+  }
+
+  template <typename T, typename P>
+  CachedFunctionStatistics
+  CachedFunction<T, P>::statistics () const
+  {
+    CachedFunctionStatistics stats;
+    CacheStatistics* data[CACHED_DATA] =
+      {&stats.function, &stats.gradient, &stats.jacobian, &stats.hessian};
+
+    for (size_t i = 0; i < CACHED_DATA; ++i)
       {
-	iter->clear ();
+	data[i]->hits = hits_[i];
+	data[i]->misses = misses_[i];
+	data[i]->insertions = insertions_[i];
       }
 
-    jacobianCache_.clear ();
+    stats.cache = cache_.statistics ();
+    stats.cache.hits = hits ();
+    stats.cache.misses = misses ();
+    return stats;
+  }
 
-    for (typename std::vector<hessianCache_t>::iterator
-	   iter  = hessianCache_.begin ();
-         iter != hessianCache_.end ();
-         ++iter)
+  template <typename T, typename P>
+  void
+  CachedFunction<T, P>::resetStatistics ()
+  {
+    cache_.resetStatistics ();
+    for (size_t i = 0; i < CACHED_DATA; ++i)
       {
-	iter->clear ();
+	hits_[i] = 0;
+	misses_[i] = 0;
+	insertions_[i] = 0;
       }
   }
 
-  template <typename T>
+  template <typename T, typename P>
   std::ostream&
-  CachedFunction<T>::print (std::ostream& o) const
+  CachedFunction<T, P>::print (std::ostream& o) const
   {
+    CacheStatistics stats = statistics ().cache;
+
     o << this->getName () << ":" << incindent
       << iendl << *function_
-      << iendl << "Cache size: " << cache_[0].size ()
+      << iendl << "Cache size: " << stats.size
+      << iendl << "Cache hits: " << stats.hits
+      << iendl << "Cache misses: " << stats.misses
+      << iendl << "Cache insertions: " << stats.insertions
+      << iendl << "Cache evictions: " << stats.evictions
+      << iendl << "Cache memory: " << stats.bytes << " bytes"
       << decindent;
     return o;
   }
 
-  template <typename T>
+  template <typename T, typename P>
   const boost::shared_ptr<const T>
-  CachedFunction<T>::function () const
+  CachedFunction<T, P>::function () const
   {
     return function_;
   }
 
-  template <typename T>
-  void
-  CachedFunction<T>::impl_compute (result_ref result,
-				   const_argument_ref argument)
-    const
+  template <typename T, typename P>
+  template <typename O>
+  bool
+  CachedFunction<T, P>::lookup (const_argument_ref argument, hash_t hash,
+                                bool (cacheEntry_t::*getter) (size_t, O) const,
+                                size_t index, O data, cachedData_t kind) const
   {
-    typename CachedFunction<T>::functionCache_t::
-      const_iterator it = cache_[0].find (argument);
-    if (it != cache_[0].end ())
+    if (this->find (cache_, argument, hash,
+                    detail::CacheEntryReader<cacheEntry_t, O>
+                    (getter, index, data)))
       {
-        result = *(it->second);
-        return;
+	++hits_[kind];
+	return true;
       }
-    (*function_) (result, argument);
 
+    ++misses_[kind];
+    return false;
+  }
+
+  template <typename T, typename P>
+  template <typename I>
+  void
+  CachedFunction<T, P>::store (const_argument_ref argument, hash_t hash,
+                               void (cacheEntry_t::*setter) (size_t, I),
+                               size_t index, I data, cachedData_t kind) const
+  {
 #ifndef ROBOPTIM_DO_NOT_CHECK_ALLOCATION
     bool cur_malloc_allowed = is_malloc_allowed ();
     set_is_malloc_allowed (true);
 #endif //! ROBOPTIM_DO_NOT_CHECK_ALLOCATION
 
-    cache_[0][argument] = result;
+    this->insert (cache_, argument, hash,
+                  detail::CacheEntryWriter<cacheEntry_t, I>
+                  (setter, index, data));
+    ++insertions_[kind];
 
 #ifndef ROBOPTIM_DO_NOT_CHECK_ALLOCATION
     set_is_malloc_allowed (cur_malloc_allowed);
 #endif //! ROBOPTIM_DO_NOT_CHECK_ALLOCATION
   }
 
-  template <typename T>
+  template <typename T, typename P>
+  void
+  CachedFunction<T, P>::impl_compute (result_ref result,
+				   const_argument_ref argument)
+    const
+  {
+    hash_t hash = this->keyHash (cache_, argument);
+    if (lookup<result_ref>
+        (argument, hash, &cacheEntry_t::template getValue<result_ref>,
+         0, result, FUNCTION_DATA))
+      return;
+    (*function_) (result, argument);
+    store<const_result_ref>
+      (argument, hash, &cacheEntry_t::template setValue<const_result_ref>,
+       0, result, FUNCTION_DATA);
+  }
+
+  template <typename T, typename P>
   void
-  CachedFunction<T>::impl_gradient (gradient_ref gradient,
+  CachedFunction<T, P>::impl_gradient (gradient_ref gradient,
                                     const_argument_ref argument,
                                     size_type functionId)
     const
@@ -181,9 +452,9 @@ namespace roboptim
   }
 
 
-  template <typename T>
+  template <typename T, typename P>
   void
-    CachedFunction<T>::impl_jacobian
+    CachedFunction<T, P>::impl_jacobian
     (jacobian_ref jacobian,
       const_argument_ref argument) const
   {
@@ -191,9 +462,29 @@ namespace roboptim
   }
 
 
-  template <typename T>
+  template <typename T, typename P>
+  void
+  CachedFunction<T, P>::impl_value_and_jacobian (result_ref result,
+						 jacobian_ref jacobian,
+						 const_argument_ref argument)
+    const
+  {
+    cachedFunctionValueAndJacobian<T> (result, jacobian, argument);
+  }
+
+
+  template <typename T, typename P>
+  void
+  CachedFunction<T, P>::impl_jacobian_structure (sparsityPattern_t& pattern)
+    const
+  {
+    cachedFunctionJacobianStructure<T> (pattern);
+  }
+
+
+  template <typename T, typename P>
   void
-  CachedFunction<T>::impl_hessian (hessian_ref hessian,
+  CachedFunction<T, P>::impl_hessian (hessian_ref hessian,
   				   const_argument_ref argument,
   				   size_type functionId)
     const
@@ -202,9 +493,9 @@ namespace roboptim
   }
 
 
-  template <typename T>
+  template <typename T, typename P>
   void
-  CachedFunction<T>::impl_derivative (gradient_ref derivative,
+  CachedFunction<T, P>::impl_derivative (gradient_ref derivative,
   				      value_type argument,
   				      size_type order)
     const
@@ -0,0 +1,234 @@
+// Copyright (C) 2026 by the RobOptim contributors.
+//
+// This file is part of the roboptim.
+//
+// roboptim is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// roboptim is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with roboptim.  If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef ROBOPTIM_CORE_DECORATOR_COMPILED_FUNCTION_HH
+# define ROBOPTIM_CORE_DECORATOR_COMPILED_FUNCTION_HH
+# include <roboptim/core/sys.hh>
+# include <roboptim/core/debug.hh>
+
+# include <ostream>
+# include <vector>
+
+# include <boost/shared_ptr.hpp>
+# include <boost/make_shared.hpp>
+# include <boost/static_assert.hpp>
+
+# include <roboptim/core/differentiable-function.hh>
+# include <roboptim/core/detail/function-compiler.hh>
+
+namespace roboptim
+{
+  /// \addtogroup roboptim_decorator
+  /// @{
+
+  /// \brief Evaluate an expression of operators with a flat list of
+  /// instructions.
+  ///
+  /// Each operator (see roboptim_operator) owns its own buffers, and
+  /// evaluating a deep expression mostly goes through virtual calls and
+  /// copies between these buffers. The expression is compiled once, when
+  /// the function is built (see detail::FunctionCompiler): every
+  /// intermediate value and jacobian gets a place in a single arena
+  /// allocated once, and evaluations simply run a loop over the
+  /// instructions. Functions that are not operators are still evaluated
+  /// through their own interface, and subexpressions shared by several
+  /// operators are only evaluated once.
+  ///
+  /// Intermediate jacobians are dense and computed with respect to the
+  /// argument of the whole expression, so this is meant for dense
+  /// expressions whose input size is moderate.
+  ///
+  /// When enabled with the cacheJacobian constructor argument, gradients
+  /// are read from the jacobian of the last run: computing the gradients
+  /// of all the outputs at the same argument then runs the instructions
+  /// once. This must not be enabled if a function of the expression may
+  /// change without the argument changing, unless #invalidate is called
+  /// after each change.
+  ///
+  /// \warning operator parameters (e.g. bound values) are copied during
+  /// the compilation: the expression must not be modified afterwards.
+  ///
+  /// \tparam T function traits (dense).
+  template <typename T>
+  class GenericCompiledFunction : public GenericDifferentiableFunction<T>
+  {
+  public:
+    ROBOPTIM_DIFFERENTIABLE_FUNCTION_FWD_TYPEDEFS_
+    (GenericDifferentiableFunction<T>);
+
+    BOOST_STATIC_ASSERT (StorageTraits<T>::isDense);
+
+    /// \brief Type of the root of the expression.
+    typedef GenericDifferentiableFunction<T> root_t;
+
+    /// \brief Compiler type.
+    typedef detail::FunctionCompiler<T> compiler_t;
+
+    typedef typename compiler_t::slot_t slot_t;
+    typedef typename compiler_t::Slot slotData_t;
+    typedef typename compiler_t::Instruction instruction_t;
+    typedef typename compiler_t::slots_t slots_t;
+    typedef typename compiler_t::instructions_t instructions_t;
+
+    /// \brief Compile an expression.
+    ///
+    /// \throw std::runtime_error if a function evaluated as a whole is
+    /// not differentiable.
+    /// \param root root of the expression.
+    /// \param cacheJacobian whether the jacobian of the last run is
+    /// reused by gradient computations at the same argument.
+    explicit GenericCompiledFunction (boost::shared_ptr<root_t> root,
+				      bool cacheJacobian = false);
+    ~GenericCompiledFunction ();
+
+    const boost::shared_ptr<root_t>& root () const
+    {
+      return root_;
+    }
+
+    /// \brief Compiled instructions, in evaluation order.
+    const instructions_t& instructions () const
+    {
+      return instructions_;
+    }
+
+    /// \brief Whether the jacobian of the last run is reused across
+    /// gradient computations.
+    bool cacheJacobian () const
+    {
+      return cacheJacobian_;
+    }
+
+    /// \brief Discard the jacobian of the last run.
+    ///
+    /// To be called when a function of the expression changes while the
+    /// jacobian is cached.
+    void invalidate ()
+    {
+      jacobianValid_ = false;
+    }
+
+    /// \brief Number of values in the arena.
+    size_type arenaSize () const
+    {
+      return arena_.size ();
+    }
+
+    /// \brief Display the function on the specified output stream.
+    ///
+    /// \param o output stream used for display
+    /// \return output stream
+    virtual std::ostream& print (std::ostream& o) const;
+
+  protected:
+    void impl_compute (result_ref result, const_argument_ref argument) const;
+
+    void impl_gradient (gradient_ref gradient,
+			const_argument_ref argument,
+			size_type functionId = 0) const;
+
+    void impl_jacobian (jacobian_ref jacobian,
+			const_argument_ref argument) const;
+
+    void impl_value_and_jacobian (result_ref result,
+				  jacobian_ref jacobian,
+				  const_argument_ref argument) const;
+
+    void impl_jacobian_structure (sparsityPattern_t& pattern) const;
+
+  private:
+    typedef Eigen::Map<vector_t> valueMap_t;
+    typedef Eigen::Map<matrix_t> jacobianMap_t;
+
+    /// \brief Run the instructions.
+    /// \param argument argument of the expression.
+    /// \param derivatives whether jacobians are computed.
+    void run (const_argument_ref argument, bool derivatives) const;
+
+    /// \brief Evaluate a function that is not compiled.
+    void leaf (const instruction_t& instruction, bool derivatives) const;
+
+    /// \brief Build a result from rows of another one.
+    void gather (const instruction_t& instruction, bool derivatives) const;
+
+    /// \brief Value of a slot.
+    valueMap_t slotValue (slot_t slot) const;
+
+    /// \brief Jacobian of a slot (not the argument).
+    jacobianMap_t slotJacobian (slot_t slot) const;
+
+  private:
+    /// \brief Root of the expression.
+    boost::shared_ptr<root_t> root_;
+
+    /// \brief Intermediate results.
+    slots_t slots_;
+
+    /// \brief Instructions, in evaluation order.
+    instructions_t instructions_;
+
+    /// \brief Row indices of GATHER instructions.
+    std::vector<int> indices_;
+
+    /// \brief Constants of GATHER instructions.
+    std::vector<value_type> constants_;
+
+    /// \brief Slot of the result.
+    slot_t output_;
+
+    /// \brief Memory holding the slots.
+    mutable vector_t arena_;
+
+    /// \brief Jacobians of the functions applying the chain rule.
+    mutable vector_t scratch_;
+
+    /// \brief Whether the jacobian of the last run is reused.
+    bool cacheJacobian_;
+
+    /// \brief Whether the arena holds the jacobians at
+    /// jacobianArgument_.
+    mutable bool jacobianValid_;
+
+    /// \brief Argument of the last run computing the jacobians.
+    mutable argument_t jacobianArgument_;
+  };
+
+  /// \brief Compiled dense expression.
+  /// \see GenericCompiledFunction
+  typedef GenericCompiledFunction<EigenMatrixDense> CompiledFunction;
+
+  /// \brief Compile an expression.
+  ///
+  /// \tparam T function traits.
+  /// \param root root of the expression.
+  /// \param cacheJacobian whether the jacobian of the last run is reused
+  /// by gradient computations at the same argument.
+  template <typename T>
+  boost::shared_ptr<GenericCompiledFunction<T> >
+  compiledFunction (boost::shared_ptr<GenericDifferentiableFunction<T> > root,
+		    bool cacheJacobian = false)
+  {
+    return boost::make_shared<GenericCompiledFunction<T> >
+      (root, cacheJacobian);
+  }
+
+  /// @}
+
+} // end of namespace roboptim
+
+# include <roboptim/core/decorator/compiled-function.hxx>
+#endif //! ROBOPTIM_CORE_DECORATOR_COMPILED_FUNCTION_HH
@@ -0,0 +1,290 @@
+// Copyright (C) 2026 by the RobOptim contributors.
+//
+// This file is part of the roboptim.
+//
+// roboptim is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// roboptim is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with roboptim.  If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef ROBOPTIM_CORE_DECORATOR_COMPILED_FUNCTION_HXX
+# define ROBOPTIM_CORE_DECORATOR_COMPILED_FUNCTION_HXX
+
+# include <roboptim/core/indent.hh>
+
+namespace roboptim
+{
+  template <typename T>
+  GenericCompiledFunction<T>::GenericCompiledFunction
+  (boost::shared_ptr<root_t> root, bool cacheJacobian)
+    : GenericDifferentiableFunction<T>
+      (root->inputSize (), root->outputSize (), root->getName ()),
+      root_ (root),
+      slots_ (),
+      instructions_ (),
+      indices_ (),
+      constants_ (),
+      output_ (-1),
+      arena_ (),
+      scratch_ (),
+      cacheJacobian_ (cacheJacobian),
+      jacobianValid_ (false),
+      jacobianArgument_ (root->inputSize ())
+  {
+    compiler_t compiler (root_->inputSize ());
+    output_ = compiler.compile (root_.get (), 0);
+    assert (output_ > 0);
+
+    slots_ = compiler.slots ();
+    instructions_ = compiler.instructions ();
+    indices_ = compiler.indices ();
+    constants_ = compiler.constants ();
+
+    arena_.resize (compiler.arenaSize ());
+    arena_.setZero ();
+    scratch_.resize (compiler.scratchSize ());
+    scratch_.setZero ();
+    jacobianArgument_.setZero ();
+  }
+
+  template <typename T>
+  GenericCompiledFunction<T>::~GenericCompiledFunction ()
+  {
+  }
+
+  template <typename T>
+  typename GenericCompiledFunction<T>::valueMap_t
+  GenericCompiledFunction<T>::slotValue (slot_t slot) const
+  {
+    const slotData_t& s = slots_[static_cast<std::size_t> (slot)];
+    return valueMap_t (arena_.data () + s.value, s.size);
+  }
+
+  template <typename T>
+  typename GenericCompiledFunction<T>::jacobianMap_t
+  GenericCompiledFunction<T>::slotJacobian (slot_t slot) const
+  {
+    const slotData_t& s = slots_[static_cast<std::size_t> (slot)];
+    assert (s.jacobian >= 0);
+    return jacobianMap_t (arena_.data () + s.jacobian,
+			  s.size, this->inputSize ());
+  }
+
+  template <typename T>
+  void
+  GenericCompiledFunction<T>::leaf (const instruction_t& instruction,
+				    bool derivatives) const
+  {
+    const root_t& f = static_cast<const root_t&> (*instruction.function);
+    valueMap_t result = slotValue (instruction.result);
+    valueMap_t argument = slotValue (instruction.lhs);
+
+    if (!derivatives)
+      {
+	f (result, argument);
+	return;
+      }
+
+    jacobianMap_t jacobian = slotJacobian (instruction.result);
+    if (slots_[static_cast<std::size_t> (instruction.lhs)].jacobian < 0)
+      {
+	f.valueAndJacobian (result, jacobian, argument);
+	return;
+      }
+
+    // Chain rule.
+    jacobianMap_t local (scratch_.data (), f.outputSize (), f.inputSize ());
+    f.valueAndJacobian (result, local, argument);
+    jacobian.noalias () = local * slotJacobian (instruction.lhs);
+  }
+
+  template <typename T>
+  void
+  GenericCompiledFunction<T>::gather (const instruction_t& instruction,
+				      bool derivatives) const
+  {
+    valueMap_t result = slotValue (instruction.result);
+    valueMap_t origin = slotValue (instruction.lhs);
+    const int* indices = &indices_[static_cast<std::size_t>
+				   (instruction.data)];
+    const value_type* constants = &constants_[static_cast<std::size_t>
+					      (instruction.data)];
+
+    for (size_type i = 0; i < result.size (); ++i)
+      result[i] = indices[i] < 0 ? constants[i] : origin[indices[i]];
+
+    if (!derivatives)
+      return;
+
+    jacobianMap_t jacobian = slotJacobian (instruction.result);
+    const bool identity =
+      slots_[static_cast<std::size_t> (instruction.lhs)].jacobian < 0;
+    for (size_type i = 0; i < result.size (); ++i)
+      {
+	if (indices[i] < 0 || identity)
+	  jacobian.row (i).setZero ();
+	if (indices[i] < 0)
+	  continue;
+
+	if (identity)
+	  jacobian (i, indices[i]) = 1.;
+	else
+	  jacobian.row (i) = slotJacobian (instruction.lhs).row (indices[i]);
+      }
+  }
+
+  template <typename T>
+  void
+  GenericCompiledFunction<T>::run (const_argument_ref argument,
+				   bool derivatives) const
+  {
+    arena_.head (this->inputSize ()) = argument;
+    jacobianValid_ = false;
+
+    for (typename instructions_t::const_iterator it = instructions_.begin ();
+	 it != instructions_.end (); ++it)
+      {
+	switch (it->op)
+	  {
+	  case detail::CompiledOperation::LEAF:
+	    leaf (*it, derivatives);
+	    break;
+
+	  case detail::CompiledOperation::ADD:
+	    slotValue (it->result) = slotValue (it->lhs) + slotValue (it->rhs);
+	    if (derivatives)
+	      slotJacobian (it->result) =
+		slotJacobian (it->lhs) + slotJacobian (it->rhs);
+	    break;
+
+	  case detail::CompiledOperation::SUB:
+	    slotValue (it->result) = slotValue (it->lhs) - slotValue (it->rhs);
+	    if (derivatives)
+	      slotJacobian (it->result) =
+		slotJacobian (it->lhs) - slotJacobian (it->rhs);
+	    break;
+
+	  case detail::CompiledOperation::MUL:
+	    slotValue (it->result) =
+	      slotValue (it->lhs).cwiseProduct (slotValue (it->rhs));
+	    if (derivatives)
+	      {
+		// (u v)' = diag (v) u' + diag (u) v'
+		slotJacobian (it->result).noalias () =
+		  slotValue (it->rhs).asDiagonal () * slotJacobian (it->lhs);
+		slotJacobian (it->result).noalias () +=
+		  slotValue (it->lhs).asDiagonal () * slotJacobian (it->rhs);
+	      }
+	    break;
+
+	  case detail::CompiledOperation::SCALE:
+	    slotValue (it->result) = it->constant * slotValue (it->lhs);
+	    if (derivatives)
+	      slotJacobian (it->result) = it->constant * slotJacobian (it->lhs);
+	    break;
+
+	  case detail::CompiledOperation::CONCATENATE:
+	    {
+	      const size_type left =
+		slots_[static_cast<std::size_t> (it->lhs)].size;
+	      const size_type right =
+		slots_[static_cast<std::size_t> (it->rhs)].size;
+	      slotValue (it->result).head (left) = slotValue (it->lhs);
+	      slotValue (it->result).tail (right) = slotValue (it->rhs);
+	      if (derivatives)
+		{
+		  slotJacobian (it->result).topRows (left) =
+		    slotJacobian (it->lhs);
+		  slotJacobian (it->result).bottomRows (right) =
+		    slotJacobian (it->rhs);
+		}
+	    }
+	    break;
+
+	  case detail::CompiledOperation::GATHER:
+	    gather (*it, derivatives);
+	    break;
+
+	  default:
+	    assert (0 && "unknown compiled operation");
+	  }
+      }
+
+    if (!derivatives)
+      return;
+
+    jacobianArgument_ = argument;
+    jacobianValid_ = true;
+  }
+
+  template <typename T>
+  void
+  GenericCompiledFunction<T>::impl_compute (result_ref result,
+					    const_argument_ref argument) const
+  {
+    run (argument, false);
+    result = slotValue (output_);
+  }
+
+  template <typename T>
+  void
+  GenericCompiledFunction<T>::impl_gradient (gradient_ref gradient,
+					     const_argument_ref argument,
+					     size_type functionId) const
+  {
+    // When cached, gradients of the other outputs at the same argument
+    // come from the same run.
+    if (!cacheJacobian_ || !jacobianValid_ || jacobianArgument_ != argument)
+      run (argument, true);
+    gradient = slotJacobian (output_).row (functionId);
+  }
+
+  template <typename T>
+  void
+  GenericCompiledFunction<T>::impl_jacobian (jacobian_ref jacobian,
+					     const_argument_ref argument) const
+  {
+    run (argument, true);
+    jacobian = slotJacobian (output_);
+  }
+
+  template <typename T>
+  void
+  GenericCompiledFunction<T>::impl_value_and_jacobian
+  (result_ref result, jacobian_ref jacobian,
+   const_argument_ref argument) const
+  {
+    run (argument, true);
+    result = slotValue (output_);
+    jacobian = slotJacobian (output_);
+  }
+
+  template <typename T>
+  void
+  GenericCompiledFunction<T>::impl_jacobian_structure
+  (sparsityPattern_t& pattern) const
+  {
+    root_->jacobianStructure (pattern);
+  }
+
+  template <typename T>
+  std::ostream&
+  GenericCompiledFunction<T>::print (std::ostream& o) const
+  {
+    o << "Compiled function (" << instructions_.size ()
+      << " instructions, " << arena_.size () << " values):"
+      << incindent << iendl << *root_ << decindent;
+    return o;
+  }
+
+} // end of namespace roboptim
+
+#endif //! ROBOPTIM_CORE_DECORATOR_COMPILED_FUNCTION_HXX
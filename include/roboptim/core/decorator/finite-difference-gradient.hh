@@ -18,16 +18,24 @@
 #ifndef ROBOPTIM_CORE_DECORATOR_FINITE_DIFFERENCE_GRADIENT_HH
 # define ROBOPTIM_CORE_DECORATOR_FINITE_DIFFERENCE_GRADIENT_HH
 
+# include <cmath>
+# include <complex>
+# include <limits>
 # include <stdexcept>
 # include <string>
 # include <ostream>
+# include <vector>
 
+# include <boost/make_shared.hpp>
+# include <boost/mpl/bool.hpp>
 # include <boost/shared_ptr.hpp>
+# include <boost/thread/thread.hpp>
 
 # include <roboptim/core/fwd.hh>
 # include <roboptim/core/differentiable-function.hh>
 # include <roboptim/core/portability.hh>
 # include <roboptim/core/deprecated.hh>
+# include <roboptim/core/detail/thread-pool.hh>
 
 namespace roboptim
 {
@@ -140,6 +148,185 @@ namespace roboptim
   std::ostream& operator<< (std::ostream& o,
 			    const BadJacobian<T>& f);
 
+  /// \brief Interface of the functions that can be evaluated with complex
+  /// arguments, as required by the complex-step policy.
+  ///
+  /// \tparam T function traits.
+  template <typename T>
+  class ComplexEvaluation
+  {
+  public:
+    typedef typename GenericFunctionTraits<T>::value_type value_type;
+
+    /// \brief Complex scalar type.
+    typedef std::complex<value_type> complex_t;
+
+    /// \brief Complex vector type.
+    typedef Eigen::Matrix<complex_t, Eigen::Dynamic, 1> complexVector_t;
+
+    /// \brief Virtual destructor.
+    virtual ~ComplexEvaluation () {}
+
+    /// \brief Evaluate the function with complex arguments.
+    ///
+    /// \param result result vector (already sized)
+    /// \param argument complex argument
+    virtual void complexCompute (complexVector_t& result,
+				 const complexVector_t& argument) const = 0;
+  };
+
+  /// \brief Function implemented by a functor written generically over
+  /// the scalar type, that can be differentiated with the complex-step
+  /// policy.
+  ///
+  /// The functor follows the same contract as for
+  /// GenericForwardModeDifferentiation. It is evaluated with real numbers
+  /// for the function values, and with complex numbers by the complex-step
+  /// policy. The functor should thus be analytic: functions such as
+  /// \c abs or comparisons should only involve the real part of the
+  /// arguments.
+  ///
+  /// \tparam T function traits.
+  /// \tparam F functor type.
+  template <typename T, typename F>
+  class GenericComplexStepFunction
+    : public GenericFunction<T>,
+      public ComplexEvaluation<T>
+  {
+  public:
+    ROBOPTIM_FUNCTION_FWD_TYPEDEFS_ (GenericFunction<T>);
+
+    typedef typename ComplexEvaluation<T>::complexVector_t complexVector_t;
+
+    /// \brief Wrap a functor.
+    /// \param functor generic implementation of the function.
+    /// \param inputSize input size (argument size)
+    /// \param outputSize output size (result size)
+    /// \param name function's name
+    GenericComplexStepFunction (const F& functor,
+				size_type inputSize,
+				size_type outputSize = 1,
+				std::string name = std::string ())
+      : GenericFunction<T> (inputSize, outputSize, name),
+	functor_ (functor)
+    {}
+
+    const F& functor () const
+    {
+      return functor_;
+    }
+
+    void complexCompute (complexVector_t& result,
+			 const complexVector_t& argument) const
+    {
+      functor_ (result, argument);
+    }
+
+  protected:
+    void impl_compute (result_ref result, const_argument_ref argument) const
+    {
+      functor_ (result, argument);
+    }
+
+  private:
+    /// \brief Generic implementation of the function.
+    F functor_;
+  };
+
+  /// \brief Wrap a generic functor, so that it can be differentiated with
+  /// the complex-step policy.
+  ///
+  /// \tparam T function traits.
+  /// \param functor generic implementation of the function.
+  /// \param inputSize input size (argument size)
+  /// \param outputSize output size (result size)
+  /// \param name function's name
+  template <typename T, typename F>
+  boost::shared_ptr<GenericComplexStepFunction<T, F> >
+  complexStepFunction
+  (const F& functor,
+   typename GenericFunction<T>::size_type inputSize,
+   typename GenericFunction<T>::size_type outputSize = 1,
+   std::string name = std::string ())
+  {
+    return boost::make_shared<GenericComplexStepFunction<T, F> >
+      (functor, inputSize, outputSize, name);
+  }
+
+  namespace detail
+  {
+    /// \brief Five-point rule shared by the finite difference policies.
+    ///
+    /// Algorithm from the GNU Scientific Library: the derivative is
+    /// estimated from f(x-h), f(x-h/2), f(x+h/2) and f(x+h), and its
+    /// truncation error from the difference with the three-point rule.
+    ///
+    /// \tparam V value type.
+    template <typename V>
+    struct FivePointsStencil
+    {
+      /// \brief Estimate a derivative and its errors.
+      ///
+      /// \param fm1 f(x-h).
+      /// \param fp1 f(x+h).
+      /// \param fmh f(x-h/2).
+      /// \param fph f(x+h/2).
+      /// \param x input the derivative is taken with respect to.
+      /// \param h step.
+      /// \param derivative estimated derivative.
+      /// \param round estimated rounding error (cancellations), O(1/h).
+      /// \param trunc estimated truncation error, O(h^2).
+      static void estimate (V fm1, V fp1, V fmh, V fph, V x, V h,
+			    V& derivative, V& round, V& trunc)
+      {
+	const V eps = std::numeric_limits<V>::epsilon ();
+
+	V r3 = V (.5) * (fp1 - fm1);
+	V r5 = (V (4) / V (3)) * (fph - fmh) - (V (1) / V (3)) * r3;
+
+	V e3 = (std::fabs (fp1) + std::fabs (fm1)) * eps;
+	V e5 = V (2) * (std::fabs (fph) + std::fabs (fmh)) * eps + e3;
+
+	// The next term is due to finite precision in x+h = O (eps * x).
+	V dy = std::max (std::fabs (r3 / h), std::fabs (r5 / h))
+	  * (std::fabs (x) / h) * eps;
+
+	// The truncation error of r5 is O(h^4) but, for safety, it is
+	// estimated from r5-r3, which is O(h^2). Scaling h minimizes this
+	// estimated error, not the actual truncation error of r5.
+	derivative = r5 / h;
+	trunc = std::fabs ((r5 - r3) / h);
+	round = std::fabs (e5 / h) + dy;
+      }
+
+      /// \brief Whether the step should be optimized, i.e. whether the
+      /// truncation error dominates.
+      static bool optimizable (V round, V trunc)
+      {
+	return round < trunc && (round > 0 && trunc > 0);
+      }
+
+      /// \brief Step minimizing the total error, given the errors of the
+      /// estimate with step h.
+      static V optimalStep (V h, V round, V trunc)
+      {
+	return h * std::pow (round / (V (2) * trunc), V (1) / V (3));
+      }
+
+      /// \brief Whether the estimate with the optimal step is kept: its
+      /// error must be smaller, and it must be consistent with the error
+      /// bounds of the original estimate.
+      ///
+      /// \param error total error of the original estimate.
+      /// \param errorOpt total error with the optimal step.
+      /// \param change difference between the two estimates.
+      static bool accept (V error, V errorOpt, V change)
+      {
+	return errorOpt < error && change < V (4) * error;
+      }
+    };
+  } // end of namespace detail
+
   /// \brief Contains finite difference gradients policies.
   ///
   /// Each class of this algorithm implements a finite difference
@@ -158,7 +345,8 @@ namespace roboptim
 	: adaptee_ (adaptee),
 	  column_ (adaptee.outputSize ()),
 	  gradient_ (adaptee.inputSize ()),
-	  sparseEps_ (-1.)
+	  sparseEps_ (-1.),
+	  reusePattern_ (false)
       {}
 
       /// \brief Virtual destructor.
@@ -173,6 +361,27 @@ namespace roboptim
         return sparseEps_;
       }
 
+      /// \brief Get a reference to the flag enabling the reuse of the
+      /// sparsity pattern. This is only relevant when dealing with sparse
+      /// functions.
+      ///
+      /// When enabled, the structure of the first sparse Jacobian computed
+      /// is recorded. Later Jacobian computations on a matrix that has the
+      /// same compressed structure write the values directly in place,
+      /// without any dynamic allocation. Entries that are not part of the
+      /// recorded pattern are ignored, so this should be used along with a
+      /// sparse epsilon that keeps the whole structure of the Jacobian
+      /// (e.g. the default negative value). If the structure of the
+      /// matrix differs, the Jacobian is computed as usual and its new
+      /// structure is recorded.
+      ///
+      /// Only the Simple and ColumnColoring policies support this: the
+      /// other policies ignore the flag and always build the Jacobian.
+      bool& reuseSparsityPattern ()
+      {
+        return reusePattern_;
+      }
+
     protected:
 
       virtual void computeGradient
@@ -195,6 +404,46 @@ namespace roboptim
        const_argument_ref argument,
        argument_ref xEps) const;
 
+      /// \brief Column by column Jacobian of a dense function.
+      void computeJacobian
+      (value_type epsilon,
+       jacobian_ref jacobian,
+       const_argument_ref argument,
+       argument_ref xEps,
+       boost::mpl::true_) const;
+
+      /// \brief Column by column Jacobian of a sparse function.
+      void computeJacobian
+      (value_type epsilon,
+       jacobian_ref jacobian,
+       const_argument_ref argument,
+       argument_ref xEps,
+       boost::mpl::false_) const;
+
+      /// \brief Record the compressed structure of a sparse Jacobian.
+      void recordSparsityPattern (const_jacobian_ref jacobian) const;
+
+      /// \brief Whether a sparse Jacobian has the recorded structure.
+      bool matchesSparsityPattern (const_jacobian_ref jacobian) const;
+
+      /// \brief Set a gradient coefficient (dense gradient).
+      static void setCoefficient (gradient_ref gradient, size_type j,
+				  value_type value, boost::mpl::true_);
+
+      /// \brief Set a gradient coefficient (sparse gradient).
+      static void setCoefficient (gradient_ref gradient, size_type j,
+				  value_type value, boost::mpl::false_);
+
+      /// \brief Set a Jacobian column from dense derivatives (dense
+      /// column).
+      void copyColumn (gradient_ref column, const vector_t& derivative,
+		       boost::mpl::true_) const;
+
+      /// \brief Set a Jacobian column from dense derivatives (sparse
+      /// column).
+      void copyColumn (gradient_ref column, const vector_t& derivative,
+		       boost::mpl::false_) const;
+
     protected:
       /// \brief Wrapped function.
       const GenericFunction<T>& adaptee_;
@@ -207,6 +456,26 @@ namespace roboptim
 
       /// \brief Threshold used for the conversion from dense to sparse matrix.
       value_type sparseEps_;
+
+      /// \brief Whether the sparsity pattern should be reused.
+      bool reusePattern_;
+
+      /// \brief Recorded outer indices of the sparse Jacobian.
+      mutable std::vector<size_type> patternOuter_;
+
+      /// \brief Recorded inner indices of the sparse Jacobian.
+      mutable std::vector<size_type> patternInner_;
+
+      /// \brief Start of each column in patternRows_ and
+      /// patternPositions_.
+      mutable std::vector<size_type> patternColOuter_;
+
+      /// \brief Row of each nonzero, sorted by column.
+      mutable std::vector<size_type> patternRows_;
+
+      /// \brief Position in the value array of each nonzero, sorted by
+      /// column.
+      mutable std::vector<size_type> patternPositions_;
     };
 
     /// \brief Fast finite difference gradient computation.
@@ -247,9 +516,35 @@ namespace roboptim
        const_argument_ref argument,
        argument_ref xEps) const;
 
-    private:
+    protected:
       mutable result_t result_;
       mutable result_t resultEps_;
+
+    private:
+      /// \brief Set a Jacobian column from resultEps_ (dense column).
+      void setColumn (gradient_ref column, value_type epsilon,
+		      boost::mpl::true_) const;
+
+      /// \brief Set a Jacobian column from resultEps_ (sparse column).
+      void setColumn (gradient_ref column, value_type epsilon,
+		      boost::mpl::false_) const;
+
+      /// \brief Jacobian of a dense function.
+      void computeJacobian
+      (value_type epsilon,
+       jacobian_ref jacobian,
+       const_argument_ref argument,
+       argument_ref xEps,
+       boost::mpl::true_) const;
+
+      /// \brief Jacobian of a sparse function, updated in place when the
+      /// sparsity pattern is reused.
+      void computeJacobian
+      (value_type epsilon,
+       jacobian_ref jacobian,
+       const_argument_ref argument,
+       argument_ref xEps,
+       boost::mpl::false_) const;
     };
 
     /// \brief Precise finite difference gradient computation.
@@ -290,19 +585,504 @@ namespace roboptim
 
       void
       compute_deriv (typename GenericFunction<T>::size_type j,
-		     double h,
-		     double& result,
-		     double& round,
-		     double& trunc,
+		     typename GenericFunction<T>::value_type h,
+		     typename GenericFunction<T>::value_type& result,
+		     typename GenericFunction<T>::value_type& round,
+		     typename GenericFunction<T>::value_type& trunc,
 		     typename GenericFunction<T>::const_argument_ref argument,
 		     typename GenericFunction<T>::size_type idFunction,
 		     typename GenericFunction<T>::argument_ref xEps)
 	const;
 
+    private:
+      /// \brief Row by row Jacobian of a dense function.
+      void computeJacobian
+      (value_type epsilon,
+       jacobian_ref jacobian,
+       const_argument_ref argument,
+       argument_ref xEps,
+       boost::mpl::true_) const;
+
+      /// \brief Row by row Jacobian of a sparse function.
+      void computeJacobian
+      (value_type epsilon,
+       jacobian_ref jacobian,
+       const_argument_ref argument,
+       argument_ref xEps,
+       boost::mpl::false_) const;
+
+      /// \brief Derivative of an output with respect to an input, with
+      /// the step optimized for the total error.
+      value_type derivative
+      (value_type h,
+       const_argument_ref argument,
+       size_type j,
+       size_type idFunction,
+       argument_ref xEps) const;
+
     private:
       mutable result_t tmpResult_;
 
     };
+
+    /// \brief Sparse finite difference Jacobian computation.
+    ///
+    /// Columns that do not share any nonzero row (structurally orthogonal
+    /// columns) can be perturbed simultaneously, since their finite
+    /// differences do not overlap. The columns are partitioned in groups
+    /// of structurally orthogonal columns with a greedy coloring
+    /// (Curtis, Powell and Reid), and the Jacobian is then recovered with
+    /// one forward difference per color instead of one per column. For a
+    /// banded Jacobian, the number of colors is the bandwidth.
+    ///
+    /// The sparsity pattern can be given with setSparsityPattern. If it is
+    /// not, it is detected during the first Jacobian evaluation with a
+    /// column-by-column forward difference: every entry that is not
+    /// exactly zero at that point is considered as a structural nonzero.
+    /// Providing the pattern is safer when some derivatives may vanish at
+    /// the first evaluation point.
+    template <typename T>
+    class ColumnColoring : public Simple<T>
+    {
+    public:
+      ROBOPTIM_DIFFERENTIABLE_FUNCTION_FWD_TYPEDEFS_
+      (GenericDifferentiableFunction<T>);
+
+      typedef Simple<T> simple_t;
+
+      /// \brief Sparse matrix type used to describe a sparsity pattern.
+      typedef typename detail::SparseFunctionTraits<value_type>::matrix_t
+      pattern_t;
+
+      explicit ColumnColoring (const GenericFunction<T>& adaptee)
+	: Simple<T> (adaptee),
+	hasPattern_ (false),
+	nColors_ (0)
+      {}
+
+      /// \brief Set the sparsity pattern of the Jacobian.
+      ///
+      /// Every stored entry of the matrix is considered as a structural
+      /// nonzero, whatever its value.
+      ///
+      /// \param pattern matrix with the Jacobian sparsity pattern.
+      void setSparsityPattern (const pattern_t& pattern);
+
+      /// \brief Forget the sparsity pattern, so that it is detected again
+      /// during the next Jacobian evaluation.
+      void resetSparsityPattern ();
+
+      /// \brief Whether a sparsity pattern is available.
+      bool hasSparsityPattern () const
+      {
+	return hasPattern_;
+      }
+
+      /// \brief Number of colors, i.e. number of perturbed function
+      /// evaluations per Jacobian evaluation.
+      size_type colors () const
+      {
+	return nColors_;
+      }
+
+      /// \brief Color of each input column.
+      const std::vector<size_type>& coloring () const
+      {
+	return colors_;
+      }
+
+      void computeJacobian
+      (value_type epsilon,
+       jacobian_ref jacobian,
+       const_argument_ref argument,
+       argument_ref xEps) const;
+
+    private:
+      /// \brief Detect the sparsity pattern column by column, and store
+      /// the associated Jacobian values.
+      void detectSparsityPattern
+      (value_type epsilon,
+       const_argument_ref argument,
+       argument_ref xEps) const;
+
+      /// \brief Compute the coloring of the columns from the pattern.
+      void computeColoring () const;
+
+      /// \brief Write the stored values to a dense Jacobian matrix.
+      void assemble (jacobian_ref jacobian, boost::mpl::true_) const;
+
+      /// \brief Write the stored values to a sparse Jacobian matrix.
+      void assemble (jacobian_ref jacobian, boost::mpl::false_) const;
+
+    private:
+      /// \brief Whether the pattern is known.
+      mutable bool hasPattern_;
+
+      /// \brief Column-compressed sparsity pattern (start of each column).
+      mutable std::vector<size_type> colOuter_;
+      /// \brief Column-compressed sparsity pattern (row indices).
+      mutable std::vector<size_type> colInner_;
+
+      /// \brief Number of colors.
+      mutable size_type nColors_;
+      /// \brief Color of each column.
+      mutable std::vector<size_type> colors_;
+      /// \brief Start of each color in colorColumns_.
+      mutable std::vector<size_type> colorOuter_;
+      /// \brief Columns sorted by color.
+      mutable std::vector<size_type> colorColumns_;
+
+      /// \brief Jacobian values, in the order of colInner_.
+      mutable std::vector<value_type> values_;
+    };
+
+    /// \brief Parallel finite difference gradient computation.
+    ///
+    /// Finite difference is computed using forward difference, as with
+    /// the Simple policy, but the perturbed evaluations (Jacobian columns
+    /// or gradient entries) are distributed among a pool of threads. Each
+    /// thread has its own perturbation and result buffers, and works on a
+    /// fixed subset of the inputs, so the result does not depend on the
+    /// scheduling and is identical to the one of the Simple policy.
+    ///
+    /// Note: the wrapped function is evaluated concurrently, so it must be
+    /// safe to call from several threads at once (i.e. it must not rely on
+    /// mutable buffers).
+    template <typename T>
+    class Parallel : public Simple<T>
+    {
+    public:
+      ROBOPTIM_DIFFERENTIABLE_FUNCTION_FWD_TYPEDEFS_
+      (GenericDifferentiableFunction<T>);
+
+      typedef Simple<T> simple_t;
+
+      /// \brief Dense matrix used to gather the Jacobian columns.
+      typedef Eigen::Matrix<value_type, Eigen::Dynamic, Eigen::Dynamic>
+      denseMatrix_t;
+
+      /// \brief Dense row vector used to gather the gradient entries.
+      typedef Eigen::Matrix<value_type, 1, Eigen::Dynamic> denseGradient_t;
+
+      /// \brief Constructor.
+      ///
+      /// The number of threads defaults to the number of hardware threads.
+      explicit Parallel (const GenericFunction<T>& adaptee)
+	: Simple<T> (adaptee),
+	pool_ (),
+	argument_ (adaptee.inputSize ()),
+	step_ (),
+	idFunction_ (),
+	jacobianBuffer_ (adaptee.outputSize (), adaptee.inputSize ()),
+	gradientBuffer_ (adaptee.inputSize ())
+      {
+	setThreads (0);
+      }
+
+      /// \brief Set the number of threads used for the computation.
+      ///
+      /// \param n number of threads, including the calling thread. If 0,
+      /// the number of hardware threads is used.
+      void setThreads (size_t n);
+
+      /// \brief Number of threads used for the computation.
+      size_t threads () const
+      {
+	return pool_->size ();
+      }
+
+      void computeGradient
+      (value_type epsilon,
+       gradient_ref gradient,
+       const_argument_ref argument,
+       size_type idFunction,
+       argument_ref xEps) const;
+
+      void computeJacobian
+      (value_type epsilon,
+       jacobian_ref jacobian,
+       const_argument_ref argument,
+       argument_ref xEps) const;
+
+    private:
+      /// \brief Compute the gradient entries assigned to a thread.
+      void gradientTask (size_t thread) const;
+
+      /// \brief Compute the Jacobian columns assigned to a thread.
+      void jacobianTask (size_t thread) const;
+
+      /// \brief Copy the gathered gradient entries to the gradient (dense
+      /// gradient).
+      void assembleGradient (gradient_ref gradient, boost::mpl::true_) const;
+
+      /// \brief Copy the gathered gradient entries to the gradient
+      /// (sparse gradient).
+      void assembleGradient (gradient_ref gradient, boost::mpl::false_) const;
+
+      /// \brief Copy the gathered Jacobian columns to the Jacobian (dense
+      /// Jacobian).
+      void assembleJacobian (jacobian_ref jacobian, boost::mpl::true_) const;
+
+      /// \brief Copy the gathered Jacobian columns to the Jacobian
+      /// (sparse Jacobian).
+      void assembleJacobian (jacobian_ref jacobian, boost::mpl::false_) const;
+
+    private:
+      /// \brief Thread pool.
+      boost::shared_ptr<detail::ThreadPool> pool_;
+
+      /// \brief Per-thread perturbed arguments.
+      mutable std::vector<argument_t> xEpsPerThread_;
+
+      /// \brief Per-thread perturbed results.
+      mutable std::vector<result_t> resultEpsPerThread_;
+
+      /// \brief Point where the derivatives are computed.
+      mutable argument_t argument_;
+
+      /// \brief Epsilon of the current computation.
+      mutable value_type step_;
+
+      /// \brief Function index of the current gradient computation.
+      mutable size_type idFunction_;
+
+      /// \brief Jacobian columns computed by the threads.
+      mutable denseMatrix_t jacobianBuffer_;
+
+      /// \brief Gradient entries computed by the threads.
+      mutable denseGradient_t gradientBuffer_;
+    };
+
+    /// \brief Adaptive finite difference gradient computation.
+    ///
+    /// A step is chosen for each input during the first evaluation, from
+    /// the truncation and rounding error estimates of the five-point rule
+    /// (see FivePointsRule):
+    ///   - if a forward difference with an optimal step is expected to be
+    ///     accurate enough (see tolerance), it is used for this input,
+    ///     which costs one evaluation per input,
+    ///   - otherwise, the five-point rule is used with the step minimizing
+    ///     the estimated error, which costs four evaluations per input.
+    ///
+    /// The chosen steps are kept for the next evaluations, until
+    /// resetSteps is called. The estimated error bound of each input can
+    /// be retrieved with errors: it is updated on each evaluation for the
+    /// five-point rule, and estimated during the step selection for the
+    /// forward difference.
+    ///
+    /// The epsilon given to the finite difference decorator is not used,
+    /// since the steps are chosen for each input.
+    template <typename T>
+    class Adaptive : public Policy<T>
+    {
+    public:
+      ROBOPTIM_DIFFERENTIABLE_FUNCTION_FWD_TYPEDEFS_
+      (GenericDifferentiableFunction<T>);
+
+      typedef Policy<T> policy_t;
+
+      explicit Adaptive (const GenericFunction<T>& adaptee)
+	: Policy<T> (adaptee),
+	tolerance_ (1e-6),
+	result_ (adaptee.outputSize ()),
+	fm1_ (adaptee.outputSize ()),
+	fp1_ (adaptee.outputSize ()),
+	fmh_ (adaptee.outputSize ()),
+	fph_ (adaptee.outputSize ()),
+	derivative_ (adaptee.outputSize ()),
+	previous_ (adaptee.outputSize ()),
+	steps_ (vector_t::Zero (adaptee.inputSize ())),
+	errors_ (vector_t::Zero (adaptee.inputSize ())),
+	selected_ (static_cast<size_t> (adaptee.inputSize ()), false),
+	central_ (static_cast<size_t> (adaptee.inputSize ()), false)
+      {}
+
+      /// \brief Get a reference to the maximum error tolerated for forward
+      /// differences. Inputs whose estimated forward difference error is
+      /// larger use the five-point rule.
+      value_type& tolerance ()
+      {
+	return tolerance_;
+      }
+
+      /// \brief Steps chosen for each input (0 if not chosen yet).
+      const vector_t& steps () const
+      {
+	return steps_;
+      }
+
+      /// \brief Estimated error bound of the derivatives with respect to
+      /// each input (maximum over the outputs).
+      const vector_t& errors () const
+      {
+	return errors_;
+      }
+
+      /// \brief Whether the five-point rule is used for an input.
+      bool centralDifference (size_type j) const
+      {
+	return central_[static_cast<size_t> (j)];
+      }
+
+      /// \brief Forget the chosen steps, so that they are chosen again
+      /// during the next evaluation.
+      void resetSteps ();
+
+      void computeColumn
+      (value_type epsilon,
+       gradient_ref column,
+       const_argument_ref argument,
+       size_type colIdx,
+       argument_ref xEps) const;
+
+      void computeGradient
+      (value_type epsilon,
+       gradient_ref gradient,
+       const_argument_ref argument,
+       size_type idFunction,
+       argument_ref xEps) const;
+
+      void computeJacobian
+      (value_type epsilon,
+       jacobian_ref jacobian,
+       const_argument_ref argument,
+       argument_ref xEps) const;
+
+    private:
+      /// \brief Compute the derivatives with respect to an input, and
+      /// store them in derivative_.
+      ///
+      /// Note: result_ = f(x) should have been computed already.
+      void computeDerivative
+      (value_type epsilon,
+       const_argument_ref argument,
+       size_type j,
+       argument_ref xEps) const;
+
+      /// \brief Five-point rule for all the outputs, with the
+      /// associated error estimates (maximum over the outputs).
+      void fivePointsRule
+      (const_argument_ref argument,
+       size_type j,
+       value_type h,
+       value_type& round,
+       value_type& trunc,
+       argument_ref xEps) const;
+
+      /// \brief Choose the step and the rule used for an input.
+      void selectStep
+      (value_type epsilon,
+       const_argument_ref argument,
+       size_type j,
+       argument_ref xEps) const;
+
+    private:
+      /// \brief Maximum error tolerated for forward differences.
+      value_type tolerance_;
+
+      /// \brief f(x).
+      mutable result_t result_;
+
+      /// \brief f(x - h), f(x + h), f(x - h/2) and f(x + h/2).
+      mutable result_t fm1_;
+      mutable result_t fp1_;
+      mutable result_t fmh_;
+      mutable result_t fph_;
+
+      /// \brief Derivatives with respect to the current input.
+      mutable vector_t derivative_;
+
+      /// \brief Derivatives computed with the initial step, during the
+      /// step selection.
+      mutable vector_t previous_;
+
+      /// \brief Chosen step for each input.
+      mutable vector_t steps_;
+
+      /// \brief Estimated error bound for each input.
+      mutable vector_t errors_;
+
+      /// \brief Whether the step of each input has been chosen.
+      mutable std::vector<bool> selected_;
+
+      /// \brief Whether the five-point rule is used for each input.
+      mutable std::vector<bool> central_;
+    };
+
+    /// \brief Complex-step derivative computation.
+    ///
+    /// For an analytic function, the derivative with respect to the j-th
+    /// input is given by
+    /// \f[\frac{\partial f}{\partial x_j}(x) \approx
+    /// \frac{\mathrm{Im}(f(x + i h e_j))}{h}\f]
+    /// Contrary to finite differences, there is no subtraction, hence no
+    /// cancellation error: the step can be chosen tiny (1e-20 by default)
+    /// and the derivatives are accurate up to machine precision, at the
+    /// cost of one complex evaluation per input.
+    ///
+    /// The wrapped function has to implement ComplexEvaluation, e.g. using
+    /// GenericComplexStepFunction. The epsilon given to the finite
+    /// difference decorator is not used.
+    template <typename T>
+    class ComplexStep : public Policy<T>
+    {
+    public:
+      ROBOPTIM_DIFFERENTIABLE_FUNCTION_FWD_TYPEDEFS_
+      (GenericDifferentiableFunction<T>);
+
+      typedef Policy<T> policy_t;
+      typedef typename ComplexEvaluation<T>::complex_t complex_t;
+      typedef typename ComplexEvaluation<T>::complexVector_t complexVector_t;
+
+      /// \brief Constructor.
+      ///
+      /// \throw std::runtime_error if the function does not implement
+      /// ComplexEvaluation.
+      explicit ComplexStep (const GenericFunction<T>& adaptee);
+
+      /// \brief Get a reference to the imaginary step.
+      value_type& step ()
+      {
+	return step_;
+      }
+
+      void computeColumn
+      (value_type epsilon,
+       gradient_ref column,
+       const_argument_ref argument,
+       size_type colIdx,
+       argument_ref xEps) const;
+
+      void computeGradient
+      (value_type epsilon,
+       gradient_ref gradient,
+       const_argument_ref argument,
+       size_type idFunction,
+       argument_ref xEps) const;
+
+    private:
+      /// \brief Compute the derivatives with respect to an input, and
+      /// store them in derivative_.
+      void computeDerivative
+      (const_argument_ref argument,
+       size_type j) const;
+
+    private:
+      /// \brief Wrapped function, seen as a complex function.
+      const ComplexEvaluation<T>* complex_;
+
+      /// \brief Imaginary step.
+      value_type step_;
+
+      /// \brief Complex argument.
+      mutable complexVector_t complexArgument_;
+
+      /// \brief Complex result.
+      mutable complexVector_t complexResult_;
+
+      /// \brief Derivatives with respect to the current input.
+      mutable vector_t derivative_;
+    };
   } // end of namespace policy.
 
   /// \brief Compute automatically a gradient with finite differences.
@@ -342,7 +1122,7 @@ namespace roboptim
     /// \param e epsilon used in finite difference computation
     GenericFiniteDifferenceGradient
     (const boost::shared_ptr<const GenericFunction<T> >& f,
-     value_type e = finiteDifferenceEpsilon);
+     value_type e = static_cast<value_type> (finiteDifferenceEpsilon));
 
     /// \brief Instantiate a finite differences gradient.
     /// WARNING: deprecated version. Prefer the shared_ptr alternative.
@@ -355,7 +1135,7 @@ namespace roboptim
     // TODO: remove after enough releases (deprecated in 3.3).
     ROBOPTIM_CORE_DEPRECATED GenericFiniteDifferenceGradient
     (const GenericFunction<T>& f,
-     value_type e = finiteDifferenceEpsilon);
+     value_type e = static_cast<value_type> (finiteDifferenceEpsilon));
 
     ~GenericFiniteDifferenceGradient ();
 
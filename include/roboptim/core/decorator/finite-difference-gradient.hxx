@@ -18,8 +18,12 @@
 #ifndef ROBOPTIM_CORE_DECORATOR_FINITE_DIFFERENCE_GRADIENT_HXX
 # define ROBOPTIM_CORE_DECORATOR_FINITE_DIFFERENCE_GRADIENT_HXX
 
+# include <algorithm>
 # include <stdexcept>
+# include <vector>
 
+# include <boost/bind.hpp>
+# include <boost/make_shared.hpp>
 # include <boost/type_traits/is_same.hpp>
 # include <boost/mpl/same_as.hpp>
 # include <boost/format.hpp>
@@ -29,38 +33,6 @@
 
 namespace roboptim
 {
-  template <>
-  inline BadGradient<EigenMatrixSparse>::BadGradient
-  (const_argument_ref x,
-   const_gradient_ref analyticalGradient,
-   const_gradient_ref finiteDifferenceGradient,
-   const value_type& threshold)
-    : std::runtime_error ("bad gradient"),
-      x_ (x),
-      analyticalGradient_ (analyticalGradient),
-      finiteDifferenceGradient_ (finiteDifferenceGradient),
-      maxDelta_ (),
-      maxDeltaComponent_ (),
-      threshold_ (threshold)
-  {
-    assert (analyticalGradient.size () ==
-	    finiteDifferenceGradient.size ());
-
-    maxDelta_ = -std::numeric_limits<Function::value_type>::infinity ();
-    for (size_type i = 0; i < analyticalGradient.size (); ++i)
-      {
-	value_type delta =
-	  std::fabs (analyticalGradient.coeff (i)
-		     - finiteDifferenceGradient.coeff (i));
-
-	if (delta > maxDelta_)
-	  {
-	    maxDelta_ = delta;
-	    maxDeltaComponent_ = i;
-	  }
-      }
-  }
-
   template <typename T>
   BadGradient<T>::BadGradient (const_argument_ref x,
 			       const_gradient_ref analyticalGradient,
@@ -77,11 +49,12 @@ namespace roboptim
     assert (analyticalGradient.size () ==
 	    finiteDifferenceGradient.size ());
 
-    maxDelta_ = -std::numeric_limits<Function::value_type>::infinity ();
+    maxDelta_ = -std::numeric_limits<value_type>::infinity ();
     for (size_type i = 0; i < analyticalGradient.size (); ++i)
       {
 	value_type delta =
-	  std::fabs (analyticalGradient[i] - finiteDifferenceGradient[i]);
+	  std::fabs (analyticalGradient.coeff (i)
+		     - finiteDifferenceGradient.coeff (i));
 
 	if (delta > maxDelta_)
 	  {
@@ -147,43 +120,6 @@ namespace roboptim
     assert (epsilon != 0. && epsilon == epsilon);
   }
 
-  template <>
-  inline
-  BadJacobian<EigenMatrixSparse>::BadJacobian
-  (const_argument_ref x,
-   const_jacobian_ref analyticalJacobian,
-   const_jacobian_ref finiteDifferenceJacobian,
-   const value_type& threshold)
-    : std::runtime_error ("bad jacobian"),
-      x_ (x),
-      analyticalJacobian_ (analyticalJacobian),
-      finiteDifferenceJacobian_ (finiteDifferenceJacobian),
-      maxDelta_ (),
-      maxDeltaRow_ (),
-      maxDeltaCol_ (),
-      threshold_ (threshold)
-  {
-    assert (analyticalJacobian.rows () == finiteDifferenceJacobian.rows ());
-    assert (analyticalJacobian.cols () == finiteDifferenceJacobian.cols ());
-
-    maxDelta_ = -std::numeric_limits<Function::value_type>::infinity ();
-    for (size_type i = 0; i < analyticalJacobian.rows (); ++i)
-      for (size_type j = 0; j < analyticalJacobian.cols (); ++j)
-	{
-          value_type delta =
-	    std::fabs (analyticalJacobian.coeff (i,j)
-		       - finiteDifferenceJacobian.coeff (i,j));
-
-          if (delta > maxDelta_)
-	    {
-              maxDelta_ = delta;
-              maxDeltaRow_ = i;
-              maxDeltaCol_ = j;
-	    }
-	}
-  }
-
-
   template <typename T>
   BadJacobian<T>::BadJacobian (const_argument_ref x,
                                const_jacobian_ref analyticalJacobian,
@@ -201,13 +137,13 @@ namespace roboptim
     assert (analyticalJacobian.rows () == finiteDifferenceJacobian.rows ());
     assert (analyticalJacobian.cols () == finiteDifferenceJacobian.cols ());
 
-    maxDelta_ = -std::numeric_limits<Function::value_type>::infinity ();
+    maxDelta_ = -std::numeric_limits<value_type>::infinity ();
     for (size_type i = 0; i < analyticalJacobian.rows (); ++i)
       for (size_type j = 0; j < analyticalJacobian.cols (); ++j)
 	{
           value_type delta =
-	    std::fabs (analyticalJacobian (i,j)
-		       - finiteDifferenceJacobian (i,j));
+	    std::fabs (analyticalJacobian.coeff (i,j)
+		       - finiteDifferenceJacobian.coeff (i,j));
 
           if (delta > maxDelta_)
 	    {
@@ -393,97 +329,102 @@ namespace roboptim
     void
     FivePointsRule<T>::compute_deriv
     (typename GenericFunction<T>::size_type j,
-     double h,
-     double& result,
-     double& round,
-     double& trunc,
+     typename GenericFunction<T>::value_type h,
+     typename GenericFunction<T>::value_type& result,
+     typename GenericFunction<T>::value_type& round,
+     typename GenericFunction<T>::value_type& trunc,
      typename GenericFunction<T>::const_argument_ref argument,
      typename GenericFunction<T>::size_type idFunction,
      typename GenericFunction<T>::argument_ref xEps) const
     {
-      /* Compute the derivative using the 5-point rule (x-h, x-h/2, x,
-	 x+h/2, x+h). Note that the central point is not used.
-
-	 Compute the error using the difference between the 5-point and
-	 the 3-point rule (x-h,x,x+h). Again the central point is not
-	 used. */
-
+      // 5-point rule (x-h, x-h/2, x, x+h/2, x+h), whose central point is
+      // not used.
       xEps = argument;
 
       xEps[j] = argument[j] - h;
       this->adaptee_ (tmpResult_, xEps);
-      double fm1 = tmpResult_[idFunction];
+      value_type fm1 = tmpResult_[idFunction];
 
       xEps[j] = argument[j] + h;
       this->adaptee_ (tmpResult_, xEps);
-      double fp1 = tmpResult_[idFunction];
+      value_type fp1 = tmpResult_[idFunction];
 
-      xEps[j] = argument[j] - (h / 2.);
+      xEps[j] = argument[j] - (h / value_type (2));
       this->adaptee_ (tmpResult_, xEps);
-      double fmh = tmpResult_[idFunction];
+      value_type fmh = tmpResult_[idFunction];
 
-      xEps[j] = argument[j] + (h / 2.);
+      xEps[j] = argument[j] + (h / value_type (2));
       this->adaptee_ (tmpResult_, xEps);
-      double fph = tmpResult_[idFunction];
+      value_type fph = tmpResult_[idFunction];
 
-      double r3 = .5 * (fp1 - fm1);
-      double r5 = (4. / 3.) * (fph - fmh) - (1. / 3.) * r3;
-
-      double e3 = (std::fabs (fp1) + std::fabs (fm1))
-	* std::numeric_limits<double>::epsilon ();
-      double e5 = 2. * (std::fabs (fph) + std::fabs (fmh))
-	* std::numeric_limits<double>::epsilon () + e3;
-
-      /* The next term is due to finite precision in x+h = O (eps * x) */
-
-      double dy =
-	std::max (std::fabs (r3 / h), std::fabs (r5 / h))
-	* (std::fabs (argument[j]) / h)
-	* std::numeric_limits<double>::epsilon ();
+      ::roboptim::detail::FivePointsStencil<value_type>::estimate
+	(fm1, fp1, fmh, fph, argument[j], h, result, round, trunc);
+    }
 
-      /* The truncation error in the r5 approximation itself is O(h^4).
-	 However, for safety, we estimate the error from r5-r3, which is
-	 O(h^2).  By scaling h we will minimise this estimated error, not
-	 the actual truncation error in r5. */
 
-      result = r5 / h;
-      trunc = std::fabs ((r5 - r3) / h); // Estimated truncation error O(h^2)
-      round = std::fabs (e5 / h) + dy; // Rounding error (cancellations)
+    template <typename T>
+    void
+    Policy<T>::computeJacobian
+    (value_type epsilon,
+     jacobian_ref jacobian,
+     const_argument_ref argument,
+     argument_ref xEps) const
+    {
+      computeJacobian (epsilon, jacobian, argument, xEps,
+		       boost::mpl::bool_<StorageTraits<T>::isDense> ());
     }
 
+    template <typename T>
+    void
+    Policy<T>::computeJacobian
+    (value_type epsilon,
+     jacobian_ref jacobian,
+     const_argument_ref argument,
+     argument_ref xEps,
+     boost::mpl::true_) const
+    {
+      // For each Jacobian column
+      for (typename jacobian_t::Index j = 0;
+	   j < this->adaptee_.inputSize(); ++j)
+	{
+          column_.setZero();
+          computeColumn (epsilon, column_, argument, j, xEps);
+          jacobian.col (j) = column_;
+	}
+    }
 
-    template <>
-    inline void
-    Policy<EigenMatrixSparse>::computeJacobian
+    template <typename T>
+    void
+    Policy<T>::computeJacobian
     (value_type epsilon,
      jacobian_ref jacobian,
      const_argument_ref argument,
-     argument_ref xEps) const
+     argument_ref xEps,
+     boost::mpl::false_) const
     {
 #ifndef ROBOPTIM_DO_NOT_CHECK_ALLOCATION
       bool cur_malloc_allowed = is_malloc_allowed ();
       set_is_malloc_allowed (true);
 #endif //! ROBOPTIM_DO_NOT_CHECK_ALLOCATION
 
-      typedef Eigen::Triplet<double> triplet_t;
+      typedef Eigen::Triplet<value_type> triplet_t;
 
       std::vector<triplet_t> coefficients;
 
       // For each column
-      for (jacobian_t::Index j = 0; j < this->adaptee_.inputSize (); ++j)
+      for (typename jacobian_t::Index j = 0;
+	   j < this->adaptee_.inputSize (); ++j)
         {
           gradient_t col (this->adaptee_.outputSize ());
 
-          computeColumn (epsilon, col, argument, j, xEps);
+          this->computeColumn (epsilon, col, argument, j, xEps);
 
-          const matrix_t::Index j_ = static_cast<const matrix_t::Index> (j);
-          for (gradient_t::InnerIterator it (col); it; ++it)
+          const int j_ = static_cast<int> (j);
+          for (typename gradient_t::InnerIterator it (col); it; ++it)
             {
-              const matrix_t::Index idx =
-                static_cast<const matrix_t::Index> (it.index ());
+              const int idx = static_cast<int> (it.index ());
 
-              assert (idx < static_cast<const matrix_t::Index>
-                      (this->adaptee_.outputSize ()));
+              assert (idx < this->adaptee_.outputSize ());
 
               coefficients.push_back
 		(triplet_t (idx, j_, it.value ()));
@@ -498,41 +439,116 @@ namespace roboptim
 
     template <typename T>
     void
-    Policy<T>::computeJacobian
-    (value_type epsilon,
-     jacobian_ref jacobian,
-     const_argument_ref argument,
-     argument_ref xEps) const
+    Policy<T>::recordSparsityPattern (const_jacobian_ref jacobian) const
     {
-      // For each Jacobian column
-      for (typename jacobian_t::Index j = 0;
-	   j < this->adaptee_.inputSize(); ++j)
-	{
-          column_.setZero();
-          computeColumn (epsilon, column_, argument, j, xEps);
-          jacobian.col (j) = column_;
-	}
+      patternOuter_.clear ();
+      patternInner_.clear ();
+      patternColOuter_.clear ();
+      patternRows_.clear ();
+      patternPositions_.clear ();
+
+      // Only compressed matrices can be updated in place.
+      if (!jacobian.isCompressed ())
+	return;
+
+      const size_type outerSize = jacobian.outerSize ();
+      const size_type nnz = jacobian.nonZeros ();
+      const bool rowMajor = jacobian_t::IsRowMajor;
+
+      patternOuter_.assign (jacobian.outerIndexPtr (),
+			    jacobian.outerIndexPtr () + outerSize + 1);
+      patternInner_.assign (jacobian.innerIndexPtr (),
+			    jacobian.innerIndexPtr () + nnz);
+
+      // Sort the nonzeros by column, to update the Jacobian column by
+      // column.
+      const size_type n = jacobian.cols ();
+      patternColOuter_.assign (static_cast<size_t> (n + 1), 0);
+      for (size_type o = 0; o < outerSize; ++o)
+	for (size_type k = patternOuter_[static_cast<size_t> (o)];
+	     k < patternOuter_[static_cast<size_t> (o + 1)]; ++k)
+	  {
+	    size_type col = rowMajor? patternInner_[static_cast<size_t> (k)] : o;
+	    ++patternColOuter_[static_cast<size_t> (col + 1)];
+	  }
+      for (size_type j = 0; j < n; ++j)
+	patternColOuter_[static_cast<size_t> (j + 1)]
+	  += patternColOuter_[static_cast<size_t> (j)];
+
+      patternRows_.resize (static_cast<size_t> (nnz));
+      patternPositions_.resize (static_cast<size_t> (nnz));
+      std::vector<size_type> pos (patternColOuter_.begin (),
+				  patternColOuter_.end () - 1);
+      for (size_type o = 0; o < outerSize; ++o)
+	for (size_type k = patternOuter_[static_cast<size_t> (o)];
+	     k < patternOuter_[static_cast<size_t> (o + 1)]; ++k)
+	  {
+	    size_type inner = patternInner_[static_cast<size_t> (k)];
+	    size_type row = rowMajor? o : inner;
+	    size_type col = rowMajor? inner : o;
+	    size_t idx = static_cast<size_t> (pos[static_cast<size_t> (col)]++);
+	    patternRows_[idx] = row;
+	    patternPositions_[idx] = k;
+	  }
     }
 
-    template <>
-    inline void
-    Simple<EigenMatrixSparse>::computeGradient
-    (value_type epsilon,
-     gradient_ref gradient,
-     const_argument_ref argument,
-     size_type idFunction,
-     argument_ref xEps) const
+    template <typename T>
+    bool
+    Policy<T>::matchesSparsityPattern (const_jacobian_ref jacobian) const
     {
-      assert (adaptee_.outputSize () - idFunction > 0);
-      adaptee_ (result_, argument);
-      for (size_type j = 0; j < adaptee_.inputSize (); ++j)
-	{
-	  xEps = argument;
-	  xEps[j] += epsilon;
-	  adaptee_ (resultEps_, xEps);
-	  gradient.insert (j) =
-	    (resultEps_[idFunction] - result_[idFunction]) / epsilon;
-	}
+      if (patternOuter_.empty () || !jacobian.isCompressed ())
+	return false;
+
+      const size_type outerSize = jacobian.outerSize ();
+      const size_type nnz = jacobian.nonZeros ();
+
+      if (static_cast<size_type> (patternOuter_.size ()) != outerSize + 1
+	  || static_cast<size_type> (patternInner_.size ()) != nnz)
+	return false;
+
+      for (size_type o = 0; o <= outerSize; ++o)
+	if (jacobian.outerIndexPtr ()[o] != patternOuter_[static_cast<size_t> (o)])
+	  return false;
+
+      for (size_type k = 0; k < nnz; ++k)
+	if (jacobian.innerIndexPtr ()[k] != patternInner_[static_cast<size_t> (k)])
+	  return false;
+
+      return true;
+    }
+
+    template <typename T>
+    void
+    Policy<T>::setCoefficient (gradient_ref gradient, size_type j,
+			       value_type value, boost::mpl::true_)
+    {
+      gradient (j) = value;
+    }
+
+    template <typename T>
+    void
+    Policy<T>::setCoefficient (gradient_ref gradient, size_type j,
+			       value_type value, boost::mpl::false_)
+    {
+      gradient.insert (j) = value;
+    }
+
+    template <typename T>
+    void
+    Policy<T>::copyColumn (gradient_ref column, const vector_t& derivative,
+			   boost::mpl::true_) const
+    {
+      column = derivative;
+    }
+
+    template <typename T>
+    void
+    Policy<T>::copyColumn (gradient_ref column, const vector_t& derivative,
+			   boost::mpl::false_) const
+    {
+      // Note: actual zeros may also be added to the sparse matrix to keep the
+      // sparse pattern constant.
+      column = derivative.sparseView (-1., sparseEps_);
     }
 
     template <typename T>
@@ -552,34 +568,13 @@ namespace roboptim
 	  xEps = argument;
 	  xEps[j] += epsilon;
 	  this->adaptee_ (resultEps_, xEps);
-	  gradient (j) =
-	    (resultEps_[idFunction] - result_[idFunction]) / epsilon;
+	  this->setCoefficient (gradient, j,
+				(resultEps_[idFunction] - result_[idFunction])
+				/ epsilon,
+				boost::mpl::bool_<StorageTraits<T>::isDense> ());
 	}
     }
 
-
-    template <>
-    inline void
-    Simple<EigenMatrixSparse>::computeColumn
-    (value_type epsilon,
-     gradient_ref column,
-     const_argument_ref argument,
-     size_type colIdx,
-     argument_ref xEps) const
-    {
-      assert (adaptee_.inputSize () - colIdx > 0);
-      assert (resultEps_.size () == adaptee_.outputSize ());
-      assert (result_.size () == adaptee_.outputSize ());
-
-      // Note: result_ = f(x) should have been called already
-      xEps = argument;
-      xEps[colIdx] += epsilon;
-      adaptee_ (resultEps_, xEps);
-      // Note: actual zeros may also be added to the sparse matrix to keep the
-      // sparse pattern constant.
-      column = ((resultEps_ - result_) / epsilon).sparseView (-1., this->sparseEps_);
-    }
-
     template <typename T>
     void
     Simple<T>::computeColumn
@@ -597,9 +592,29 @@ namespace roboptim
       xEps = argument;
       xEps[colIdx] += epsilon;
       this->adaptee_ (resultEps_, xEps);
+      setColumn (column, epsilon,
+		 boost::mpl::bool_<StorageTraits<T>::isDense> ());
+    }
+
+    template <typename T>
+    void
+    Simple<T>::setColumn (gradient_ref column, value_type epsilon,
+			  boost::mpl::true_) const
+    {
       column = (resultEps_ - result_) / epsilon;
     }
 
+    template <typename T>
+    void
+    Simple<T>::setColumn (gradient_ref column, value_type epsilon,
+			  boost::mpl::false_) const
+    {
+      // Note: actual zeros may also be added to the sparse matrix to keep the
+      // sparse pattern constant.
+      column = ((resultEps_ - result_) / epsilon).sparseView
+	(-1., this->sparseEps_);
+    }
+
     template <typename T>
     void
     Simple<T>::computeJacobian
@@ -611,152 +626,171 @@ namespace roboptim
       // Data used by each computeColumn
       this->adaptee_ (result_, argument);
 
+      computeJacobian (epsilon, jacobian, argument, xEps,
+		       boost::mpl::bool_<StorageTraits<T>::isDense> ());
+    }
+
+    template <typename T>
+    void
+    Simple<T>::computeJacobian
+    (value_type epsilon,
+     jacobian_ref jacobian,
+     const_argument_ref argument,
+     argument_ref xEps,
+     boost::mpl::true_) const
+    {
       // Call parent Jacobian
       policy_t::computeJacobian (epsilon, jacobian, argument, xEps);
     }
 
-    template <>
-    inline void
-    FivePointsRule<EigenMatrixSparse>::computeGradient
+    template <typename T>
+    void
+    Simple<T>::computeJacobian
     (value_type epsilon,
-     gradient_ref gradient,
+     jacobian_ref jacobian,
      const_argument_ref argument,
-     size_type idFunction,
-     argument_ref xEps) const
+     argument_ref xEps,
+     boost::mpl::false_) const
     {
-      assert (this->adaptee_.outputSize () - idFunction > 0);
-
-      value_type h = epsilon / 2.;
-      value_type r_0 = 0.;
-      value_type round = 0.;
-      value_type trunc = 0.;
-      value_type error = 0.;
-
-      for (size_type j = 0; j < argument.size (); ++j)
+      if (this->reusePattern_ && this->matchesSparsityPattern (jacobian))
 	{
-	  this->compute_deriv (j, h,
-			       r_0, round, trunc,
-			       argument, idFunction, xEps);
-	  error = round + trunc;
+	  // The structure is known: update the values in place.
+	  value_type* values = jacobian.valuePtr ();
 
-	  if (round < trunc && (round > 0 && trunc > 0))
+	  for (size_type j = 0; j < this->adaptee_.inputSize (); ++j)
 	    {
-	      value_type r_opt = 0., round_opt = 0., trunc_opt = 0.,
-		error_opt = 0.;
-
-	      /* Compute an optimised stepsize to minimize the total error,
-		 using the scaling of the truncation error (O(h^2)) and
-		 rounding error (O(1/h)). */
-
-	      value_type h_opt =
-		h * std::pow (round / (2. * trunc), 1. / 3.);
+	      const size_t begin = static_cast<size_t>
+		(this->patternColOuter_[static_cast<size_t> (j)]);
+	      const size_t end = static_cast<size_t>
+		(this->patternColOuter_[static_cast<size_t> (j + 1)]);
 
-	      this->compute_deriv (j, h_opt,
-				   r_opt, round_opt, trunc_opt,
-				   argument, idFunction,
-				   xEps);
-	      error_opt = round_opt + trunc_opt;
+	      // Structurally empty column: nothing to compute.
+	      if (begin == end)
+		continue;
 
-	      /* Check that the new error is smaller, and that the new
-		 derivative is consistent with the error bounds of the
-		 original estimate. */
+	      xEps = argument;
+	      xEps[j] += epsilon;
+	      this->adaptee_ (resultEps_, xEps);
 
-	      if (error_opt < error && std::fabs (r_opt - r_0) < 4. * error)
+	      for (size_t k = begin; k < end; ++k)
 		{
-		  r_0 = r_opt;
+		  size_type i = this->patternRows_[k];
+		  values[this->patternPositions_[k]] =
+		    (resultEps_[i] - result_[i]) / epsilon;
 		}
 	    }
+	  return;
+	}
+
+      // Call parent Jacobian
+      policy_t::computeJacobian (epsilon, jacobian, argument, xEps);
+
+      if (this->reusePattern_)
+	{
+#ifndef ROBOPTIM_DO_NOT_CHECK_ALLOCATION
+	  bool cur_malloc_allowed = is_malloc_allowed ();
+	  set_is_malloc_allowed (true);
+#endif //! ROBOPTIM_DO_NOT_CHECK_ALLOCATION
 
-	  gradient.insert (j) = r_0;
+	  this->recordSparsityPattern (jacobian);
+
+#ifndef ROBOPTIM_DO_NOT_CHECK_ALLOCATION
+	  set_is_malloc_allowed (cur_malloc_allowed);
+#endif //! ROBOPTIM_DO_NOT_CHECK_ALLOCATION
 	}
     }
 
     template <typename T>
-    void
-    FivePointsRule<T>::computeGradient
-    (value_type epsilon,
-     gradient_ref gradient,
+    typename FivePointsRule<T>::value_type
+    FivePointsRule<T>::derivative
+    (value_type h,
      const_argument_ref argument,
+     size_type j,
      size_type idFunction,
      argument_ref xEps) const
     {
-      assert (this->adaptee_.outputSize () - idFunction > 0);
+      typedef ::roboptim::detail::FivePointsStencil<value_type> stencil_t;
 
-      value_type h = epsilon / 2.;
       value_type r_0 = 0.;
       value_type round = 0.;
       value_type trunc = 0.;
-      value_type error = 0.;
+      this->compute_deriv (j, h, r_0, round, trunc,
+			   argument, idFunction, xEps);
 
-      for (size_type j = 0; j < argument.size (); ++j)
+      if (stencil_t::optimizable (round, trunc))
 	{
-	  this->compute_deriv (j, h,
-			       r_0, round, trunc,
+	  value_type r_opt = 0., round_opt = 0., trunc_opt = 0.;
+	  this->compute_deriv (j, stencil_t::optimalStep (h, round, trunc),
+			       r_opt, round_opt, trunc_opt,
 			       argument, idFunction, xEps);
-	  error = round + trunc;
-
-	  if (round < trunc && (round > 0 && trunc > 0))
-	    {
-	      value_type r_opt = 0., round_opt = 0., trunc_opt = 0.,
-		error_opt = 0.;
-
-	      /* Compute an optimised stepsize to minimize the total error,
-		 using the scaling of the truncation error (O(h^2)) and
-		 rounding error (O(1/h)). */
-
-	      value_type h_opt =
-		h * std::pow (round / (2. * trunc), 1. / 3.);
-
-	      this->compute_deriv (j, h_opt,
-				   r_opt, round_opt, trunc_opt,
-				   argument, idFunction,
-				   xEps);
-	      error_opt = round_opt + trunc_opt;
-
-	      /* Check that the new error is smaller, and that the new
-		 derivative is consistent with the error bounds of the
-		 original estimate. */
-
-	      if (error_opt < error && std::fabs (r_opt - r_0) < 4. * error)
-		{
-		  r_0 = r_opt;
-		}
-	    }
 
-	  gradient[j] = r_0;
+	  if (stencil_t::accept (round + trunc, round_opt + trunc_opt,
+				 std::fabs (r_opt - r_0)))
+	    r_0 = r_opt;
 	}
+      return r_0;
     }
 
+    template <typename T>
+    void
+    FivePointsRule<T>::computeGradient
+    (value_type epsilon,
+     gradient_ref gradient,
+     const_argument_ref argument,
+     size_type idFunction,
+     argument_ref xEps) const
+    {
+      assert (this->adaptee_.outputSize () - idFunction > 0);
+
+      for (size_type j = 0; j < argument.size (); ++j)
+	this->setCoefficient
+	  (gradient, j,
+	   derivative (epsilon / value_type (2), argument, j, idFunction, xEps),
+	   boost::mpl::bool_<StorageTraits<T>::isDense> ());
+    }
 
-    template <>
-    inline void FivePointsRule<EigenMatrixSparse>::computeJacobian
+    template <typename T>
+    void
+    FivePointsRule<T>::computeJacobian
     (value_type epsilon,
      jacobian_ref jacobian,
      const_argument_ref argument,
      argument_ref xEps) const
     {
+      computeJacobian (epsilon, jacobian, argument, xEps,
+		       boost::mpl::bool_<StorageTraits<T>::isDense> ());
+    }
+
+    template <typename T>
+    void
+    FivePointsRule<T>::computeJacobian
+    (value_type epsilon,
+     jacobian_ref jacobian,
+     const_argument_ref argument,
+     argument_ref xEps,
+     boost::mpl::false_) const
+    {
 #ifndef ROBOPTIM_DO_NOT_CHECK_ALLOCATION
       bool cur_malloc_allowed = is_malloc_allowed ();
       set_is_malloc_allowed (true);
 #endif //! ROBOPTIM_DO_NOT_CHECK_ALLOCATION
 
-      typedef Eigen::Triplet<double> triplet_t;
+      typedef Eigen::Triplet<value_type> triplet_t;
 
       std::vector<triplet_t> coefficients;
-      for (jacobian_t::Index i = 0; i < this->adaptee_.outputSize (); ++i)
+      for (typename jacobian_t::Index i = 0;
+	   i < this->adaptee_.outputSize (); ++i)
         {
           gradient_t grad (this->adaptee_.inputSize ());
 
           computeGradient (epsilon, grad, argument, i, xEps);
 
-          const matrix_t::Index i_ = static_cast<const matrix_t::Index> (i);
-          for (gradient_t::InnerIterator it (grad); it; ++it)
+          const int i_ = static_cast<int> (i);
+          for (typename gradient_t::InnerIterator it (grad); it; ++it)
             {
-              const matrix_t::Index idx =
-                static_cast<const matrix_t::Index> (it.index ());
+              const int idx = static_cast<int> (it.index ());
 
-              assert (idx < static_cast<const matrix_t::Index>
-                      (this->adaptee_.inputSize ()));
+              assert (idx < this->adaptee_.inputSize ());
 
               coefficients.push_back
 		(triplet_t (i_, idx, it.value ()));
@@ -770,11 +804,13 @@ namespace roboptim
     }
 
     template <typename T>
-    void FivePointsRule<T>::computeJacobian
+    void
+    FivePointsRule<T>::computeJacobian
     (value_type epsilon,
      jacobian_ref jacobian,
      const_argument_ref argument,
-     argument_ref xEps) const
+     argument_ref xEps,
+     boost::mpl::true_) const
     {
       for (typename jacobian_t::Index i = 0;
 	   i < this->adaptee_.outputSize(); ++i)
@@ -786,9 +822,9 @@ namespace roboptim
     }
 
 
-    template <>
-    inline void
-    FivePointsRule<EigenMatrixSparse>::computeColumn
+    template <typename T>
+    void
+    FivePointsRule<T>::computeColumn
     (value_type /*epsilon*/,
      gradient_ref /*column*/,
      const_argument_ref /*argument*/,
@@ -799,18 +835,690 @@ namespace roboptim
       throw std::runtime_error ("not implemented");
     }
 
+    template <typename T>
+    void
+    ColumnColoring<T>::setSparsityPattern (const pattern_t& pattern)
+    {
+      assert (pattern.rows () == this->adaptee_.outputSize ());
+      assert (pattern.cols () == this->adaptee_.inputSize ());
+
+      typedef typename pattern_t::Index index_t;
+      const size_type n = this->adaptee_.inputSize ();
+
+      // Count the nonzeros of each column.
+      colOuter_.assign (static_cast<size_t> (n + 1), 0);
+      for (index_t k = 0; k < pattern.outerSize (); ++k)
+	for (typename pattern_t::InnerIterator it (pattern, k); it; ++it)
+	  ++colOuter_[static_cast<size_t> (it.col () + 1)];
+      for (size_type j = 0; j < n; ++j)
+	colOuter_[static_cast<size_t> (j + 1)]
+	  += colOuter_[static_cast<size_t> (j)];
+
+      // Fill the row indices of each column.
+      colInner_.resize (static_cast<size_t> (colOuter_.back ()));
+      std::vector<size_type> pos (colOuter_.begin (), colOuter_.end () - 1);
+      for (index_t k = 0; k < pattern.outerSize (); ++k)
+	for (typename pattern_t::InnerIterator it (pattern, k); it; ++it)
+	  colInner_[static_cast<size_t>
+		    (pos[static_cast<size_t> (it.col ())]++)] = it.row ();
+
+      values_.assign (colInner_.size (), 0.);
+      computeColoring ();
+      hasPattern_ = true;
+    }
 
     template <typename T>
     void
-    FivePointsRule<T>::computeColumn
-    (value_type /*epsilon*/,
-     gradient_ref /*column*/,
-     const_argument_ref /*argument*/,
-     size_type /*colIdx*/,
-     argument_ref /*xEps*/) const
+    ColumnColoring<T>::resetSparsityPattern ()
     {
-      // TODO: implement for the column-wise Jacobian computation
-      throw std::runtime_error ("not implemented");
+      hasPattern_ = false;
+      nColors_ = 0;
+      colOuter_.clear ();
+      colInner_.clear ();
+      colors_.clear ();
+      colorOuter_.clear ();
+      colorColumns_.clear ();
+      values_.clear ();
+    }
+
+    template <typename T>
+    void
+    ColumnColoring<T>::detectSparsityPattern
+    (value_type epsilon,
+     const_argument_ref argument,
+     argument_ref xEps) const
+    {
+      const size_type n = this->adaptee_.inputSize ();
+      const size_type m = this->adaptee_.outputSize ();
+
+      colOuter_.assign (1, 0);
+      colInner_.clear ();
+      values_.clear ();
+
+      // Note: result_ = f(x) should have been called already
+      for (size_type j = 0; j < n; ++j)
+	{
+	  xEps = argument;
+	  xEps[j] += epsilon;
+	  this->adaptee_ (this->resultEps_, xEps);
+
+	  for (size_type i = 0; i < m; ++i)
+	    {
+	      value_type d = (this->resultEps_[i] - this->result_[i]) / epsilon;
+	      if (d != 0.)
+		{
+		  colInner_.push_back (i);
+		  values_.push_back (d);
+		}
+	    }
+	  colOuter_.push_back (static_cast<size_type> (colInner_.size ()));
+	}
+
+      computeColoring ();
+      hasPattern_ = true;
+    }
+
+    template <typename T>
+    void
+    ColumnColoring<T>::computeColoring () const
+    {
+      const size_type n = this->adaptee_.inputSize ();
+      const size_type m = this->adaptee_.outputSize ();
+
+      // Row-compressed copy of the pattern, to find the columns sharing a
+      // row with a given column.
+      std::vector<size_type> rowOuter (static_cast<size_t> (m + 1), 0);
+      for (size_t k = 0; k < colInner_.size (); ++k)
+	++rowOuter[static_cast<size_t> (colInner_[k] + 1)];
+      for (size_type i = 0; i < m; ++i)
+	rowOuter[static_cast<size_t> (i + 1)]
+	  += rowOuter[static_cast<size_t> (i)];
+
+      std::vector<size_type> rowInner (colInner_.size ());
+      std::vector<size_type> pos (rowOuter.begin (), rowOuter.end () - 1);
+      for (size_type j = 0; j < n; ++j)
+	for (size_type k = colOuter_[static_cast<size_t> (j)];
+	     k < colOuter_[static_cast<size_t> (j + 1)]; ++k)
+	  rowInner[static_cast<size_t>
+		   (pos[static_cast<size_t>
+			(colInner_[static_cast<size_t> (k)])]++)] = j;
+
+      // Greedy coloring: each column gets the smallest color that is not
+      // used by an already colored column sharing one of its rows.
+      // forbidden[c] == j means that color c cannot be used for column j.
+      colors_.assign (static_cast<size_t> (n), -1);
+      std::vector<size_type> forbidden (static_cast<size_t> (n), -1);
+      nColors_ = 0;
+
+      for (size_type j = 0; j < n; ++j)
+	{
+	  for (size_type k = colOuter_[static_cast<size_t> (j)];
+	       k < colOuter_[static_cast<size_t> (j + 1)]; ++k)
+	    {
+	      size_type i = colInner_[static_cast<size_t> (k)];
+	      for (size_type l = rowOuter[static_cast<size_t> (i)];
+		   l < rowOuter[static_cast<size_t> (i + 1)]; ++l)
+		{
+		  size_type c = colors_[static_cast<size_t>
+					(rowInner[static_cast<size_t> (l)])];
+		  if (c >= 0)
+		    forbidden[static_cast<size_t> (c)] = j;
+		}
+	    }
+
+	  size_type c = 0;
+	  while (forbidden[static_cast<size_t> (c)] == j)
+	    ++c;
+	  colors_[static_cast<size_t> (j)] = c;
+	  nColors_ = std::max (nColors_, c + 1);
+	}
+
+      // Group the columns by color.
+      colorOuter_.assign (static_cast<size_t> (nColors_ + 1), 0);
+      for (size_type j = 0; j < n; ++j)
+	++colorOuter_[static_cast<size_t> (colors_[static_cast<size_t> (j)] + 1)];
+      for (size_type c = 0; c < nColors_; ++c)
+	colorOuter_[static_cast<size_t> (c + 1)]
+	  += colorOuter_[static_cast<size_t> (c)];
+
+      colorColumns_.resize (static_cast<size_t> (n));
+      pos.assign (colorOuter_.begin (), colorOuter_.end () - 1);
+      for (size_type j = 0; j < n; ++j)
+	colorColumns_[static_cast<size_t>
+		      (pos[static_cast<size_t>
+			   (colors_[static_cast<size_t> (j)])]++)] = j;
+    }
+
+    template <typename T>
+    void
+    ColumnColoring<T>::assemble (jacobian_ref jacobian,
+				 boost::mpl::false_) const
+    {
+      // The recorded structure matches the colored pattern: update the
+      // values in place. Both are sorted by column, then by row, so the
+      // column starts and the rows of the nonzeros have to match.
+      if (this->reusePattern_ && this->matchesSparsityPattern (jacobian)
+	  && this->patternColOuter_ == colOuter_ && this->patternRows_ == colInner_)
+	{
+	  value_type* values = jacobian.valuePtr ();
+	  for (size_t k = 0; k < values_.size (); ++k)
+	    values[this->patternPositions_[k]] = values_[k];
+	  return;
+	}
+
+#ifndef ROBOPTIM_DO_NOT_CHECK_ALLOCATION
+      bool cur_malloc_allowed = is_malloc_allowed ();
+      set_is_malloc_allowed (true);
+#endif //! ROBOPTIM_DO_NOT_CHECK_ALLOCATION
+
+      typedef Eigen::Triplet<value_type> triplet_t;
+      typedef int index_t;
+
+      std::vector<triplet_t> coefficients;
+      coefficients.reserve (colInner_.size ());
+
+      for (size_type j = 0; j < this->adaptee_.inputSize (); ++j)
+	{
+	  const index_t j_ = static_cast<index_t> (j);
+	  for (size_type k = colOuter_[static_cast<size_t> (j)];
+	       k < colOuter_[static_cast<size_t> (j + 1)]; ++k)
+	    {
+	      const index_t idx =
+		static_cast<index_t> (colInner_[static_cast<size_t> (k)]);
+	      coefficients.push_back
+		(triplet_t (idx, j_, values_[static_cast<size_t> (k)]));
+	    }
+	}
+
+      jacobian.setFromTriplets (coefficients.begin (), coefficients.end ());
+
+      if (this->reusePattern_)
+	this->recordSparsityPattern (jacobian);
+
+#ifndef ROBOPTIM_DO_NOT_CHECK_ALLOCATION
+      set_is_malloc_allowed (cur_malloc_allowed);
+#endif //! ROBOPTIM_DO_NOT_CHECK_ALLOCATION
+    }
+
+    template <typename T>
+    void
+    ColumnColoring<T>::assemble (jacobian_ref jacobian,
+				 boost::mpl::true_) const
+    {
+      jacobian.setZero ();
+
+      for (size_type j = 0; j < this->adaptee_.inputSize (); ++j)
+	for (size_type k = colOuter_[static_cast<size_t> (j)];
+	     k < colOuter_[static_cast<size_t> (j + 1)]; ++k)
+	  jacobian (colInner_[static_cast<size_t> (k)], j) =
+	    values_[static_cast<size_t> (k)];
+    }
+
+    template <typename T>
+    void
+    ColumnColoring<T>::computeJacobian
+    (value_type epsilon,
+     jacobian_ref jacobian,
+     const_argument_ref argument,
+     argument_ref xEps) const
+    {
+      this->adaptee_ (this->result_, argument);
+
+      if (!hasPattern_)
+	{
+#ifndef ROBOPTIM_DO_NOT_CHECK_ALLOCATION
+	  bool cur_malloc_allowed = is_malloc_allowed ();
+	  set_is_malloc_allowed (true);
+#endif //! ROBOPTIM_DO_NOT_CHECK_ALLOCATION
+
+	  detectSparsityPattern (epsilon, argument, xEps);
+
+#ifndef ROBOPTIM_DO_NOT_CHECK_ALLOCATION
+	  set_is_malloc_allowed (cur_malloc_allowed);
+#endif //! ROBOPTIM_DO_NOT_CHECK_ALLOCATION
+	}
+      else
+	{
+	  // One evaluation per color: all the columns of a given color are
+	  // perturbed at once.
+	  for (size_type c = 0; c < nColors_; ++c)
+	    {
+	      const size_t begin = static_cast<size_t>
+		(colorOuter_[static_cast<size_t> (c)]);
+	      const size_t end = static_cast<size_t>
+		(colorOuter_[static_cast<size_t> (c + 1)]);
+
+	      xEps = argument;
+	      for (size_t l = begin; l < end; ++l)
+		xEps[colorColumns_[l]] += epsilon;
+
+	      this->adaptee_ (this->resultEps_, xEps);
+
+	      // Since the columns are structurally orthogonal, each row
+	      // only depends on one perturbed column.
+	      for (size_t l = begin; l < end; ++l)
+		{
+		  size_type j = colorColumns_[l];
+		  for (size_type k = colOuter_[static_cast<size_t> (j)];
+		       k < colOuter_[static_cast<size_t> (j + 1)]; ++k)
+		    {
+		      size_type i = colInner_[static_cast<size_t> (k)];
+		      values_[static_cast<size_t> (k)] =
+			(this->resultEps_[i] - this->result_[i]) / epsilon;
+		    }
+		}
+	    }
+	}
+
+      assemble (jacobian, boost::mpl::bool_<StorageTraits<T>::isDense> ());
+    }
+
+    template <typename T>
+    void
+    Parallel<T>::setThreads (size_t n)
+    {
+      if (n == 0)
+	n = std::max (boost::thread::hardware_concurrency (), 1u);
+
+      pool_ = boost::make_shared<detail::ThreadPool> (n);
+      xEpsPerThread_.assign (n, argument_t (this->adaptee_.inputSize ()));
+      resultEpsPerThread_.assign (n, result_t (this->adaptee_.outputSize ()));
+    }
+
+    template <typename T>
+    void
+    Parallel<T>::gradientTask (size_t thread) const
+    {
+      argument_t& xEps = xEpsPerThread_[thread];
+      result_t& resultEps = resultEpsPerThread_[thread];
+      const size_type n = this->adaptee_.inputSize ();
+      const size_type nThreads = static_cast<size_type> (pool_->size ());
+
+      for (size_type j = static_cast<size_type> (thread); j < n; j += nThreads)
+	{
+	  xEps = argument_;
+	  xEps[j] += step_;
+	  this->adaptee_ (resultEps, xEps);
+	  gradientBuffer_[j] =
+	    (resultEps[idFunction_] - this->result_[idFunction_]) / step_;
+	}
+    }
+
+    template <typename T>
+    void
+    Parallel<T>::jacobianTask (size_t thread) const
+    {
+      argument_t& xEps = xEpsPerThread_[thread];
+      result_t& resultEps = resultEpsPerThread_[thread];
+      const size_type n = this->adaptee_.inputSize ();
+      const size_type nThreads = static_cast<size_type> (pool_->size ());
+
+      for (size_type j = static_cast<size_type> (thread); j < n; j += nThreads)
+	{
+	  xEps = argument_;
+	  xEps[j] += step_;
+	  this->adaptee_ (resultEps, xEps);
+	  jacobianBuffer_.col (j) = (resultEps - this->result_) / step_;
+	}
+    }
+
+    template <typename T>
+    void
+    Parallel<T>::assembleGradient (gradient_ref gradient,
+				   boost::mpl::true_) const
+    {
+      gradient = gradientBuffer_;
+    }
+
+    template <typename T>
+    void
+    Parallel<T>::assembleGradient (gradient_ref gradient,
+				   boost::mpl::false_) const
+    {
+      for (size_type j = 0; j < this->adaptee_.inputSize (); ++j)
+	gradient.insert (j) = gradientBuffer_[j];
+    }
+
+    template <typename T>
+    void
+    Parallel<T>::assembleJacobian (jacobian_ref jacobian,
+				   boost::mpl::true_) const
+    {
+      jacobian = jacobianBuffer_;
+    }
+
+    template <typename T>
+    void
+    Parallel<T>::assembleJacobian (jacobian_ref jacobian,
+				   boost::mpl::false_) const
+    {
+#ifndef ROBOPTIM_DO_NOT_CHECK_ALLOCATION
+      bool cur_malloc_allowed = is_malloc_allowed ();
+      set_is_malloc_allowed (true);
+#endif //! ROBOPTIM_DO_NOT_CHECK_ALLOCATION
+
+      // Note: actual zeros may also be added to the sparse matrix to keep the
+      // sparse pattern constant.
+      jacobian = jacobianBuffer_.sparseView (-1., this->sparseEps_);
+
+#ifndef ROBOPTIM_DO_NOT_CHECK_ALLOCATION
+      set_is_malloc_allowed (cur_malloc_allowed);
+#endif //! ROBOPTIM_DO_NOT_CHECK_ALLOCATION
+    }
+
+    template <typename T>
+    void
+    Parallel<T>::computeGradient
+    (value_type epsilon,
+     gradient_ref gradient,
+     const_argument_ref argument,
+     size_type idFunction,
+     argument_ref) const
+    {
+      assert (this->adaptee_.outputSize () - idFunction > 0);
+
+      this->adaptee_ (this->result_, argument);
+      argument_ = argument;
+      step_ = epsilon;
+      idFunction_ = idFunction;
+
+      pool_->run (boost::bind (&Parallel<T>::gradientTask, this, _1));
+
+      assembleGradient (gradient,
+			boost::mpl::bool_<StorageTraits<T>::isDense> ());
+    }
+
+    template <typename T>
+    void
+    Parallel<T>::computeJacobian
+    (value_type epsilon,
+     jacobian_ref jacobian,
+     const_argument_ref argument,
+     argument_ref) const
+    {
+      this->adaptee_ (this->result_, argument);
+      argument_ = argument;
+      step_ = epsilon;
+
+      pool_->run (boost::bind (&Parallel<T>::jacobianTask, this, _1));
+
+      assembleJacobian (jacobian,
+			boost::mpl::bool_<StorageTraits<T>::isDense> ());
+    }
+
+    template <typename T>
+    void
+    Adaptive<T>::resetSteps ()
+    {
+      steps_.setZero ();
+      errors_.setZero ();
+      std::fill (selected_.begin (), selected_.end (), false);
+      std::fill (central_.begin (), central_.end (), false);
+    }
+
+    template <typename T>
+    void
+    Adaptive<T>::fivePointsRule
+    (const_argument_ref argument,
+     size_type j,
+     value_type h,
+     value_type& round,
+     value_type& trunc,
+     argument_ref xEps) const
+    {
+      // Same rule and error estimates as FivePointsRule::compute_deriv,
+      // but for all the outputs at once.
+      xEps = argument;
+
+      xEps[j] = argument[j] - h;
+      this->adaptee_ (fm1_, xEps);
+
+      xEps[j] = argument[j] + h;
+      this->adaptee_ (fp1_, xEps);
+
+      xEps[j] = argument[j] - (h / value_type (2));
+      this->adaptee_ (fmh_, xEps);
+
+      xEps[j] = argument[j] + (h / value_type (2));
+      this->adaptee_ (fph_, xEps);
+
+      round = value_type (0);
+      trunc = value_type (0);
+      for (size_type i = 0; i < this->adaptee_.outputSize (); ++i)
+	{
+	  value_type round_i = value_type (0);
+	  value_type trunc_i = value_type (0);
+	  ::roboptim::detail::FivePointsStencil<value_type>::estimate
+	    (fm1_[i], fp1_[i], fmh_[i], fph_[i], argument[j], h,
+	     derivative_[i], round_i, trunc_i);
+	  trunc = std::max (trunc, trunc_i);
+	  round = std::max (round, round_i);
+	}
+    }
+
+    template <typename T>
+    void
+    Adaptive<T>::selectStep
+    (value_type,
+     const_argument_ref argument,
+     size_type j,
+     argument_ref xEps) const
+    {
+      typedef ::roboptim::detail::FivePointsStencil<value_type> stencil_t;
+
+      const value_type eps = std::numeric_limits<value_type>::epsilon ();
+      const value_type scale = std::max
+	(value_type (1), std::fabs (argument[j]));
+
+      // Five-point rule: start from the usual step for central
+      // differences, and optimize it as in FivePointsRule.
+      value_type h = std::pow (eps, value_type (1) / value_type (3)) * scale;
+      value_type round = value_type (0);
+      value_type trunc = value_type (0);
+      fivePointsRule (argument, j, h, round, trunc, xEps);
+      value_type error = round + trunc;
+
+      // Curvature and magnitude of the function, used to estimate the
+      // error of forward differences.
+      value_type curvature = value_type (0);
+      value_type magnitude = value_type (0);
+      for (size_type i = 0; i < this->adaptee_.outputSize (); ++i)
+	{
+	  curvature = std::max
+	    (curvature, std::fabs (fp1_[i] + fm1_[i] - value_type (2) * result_[i])
+	     / (h * h));
+	  magnitude = std::max (magnitude, std::fabs (result_[i]));
+	}
+
+      if (stencil_t::optimizable (round, trunc))
+	{
+	  value_type h_opt = stencil_t::optimalStep (h, round, trunc);
+	  value_type round_opt = value_type (0);
+	  value_type trunc_opt = value_type (0);
+
+	  previous_ = derivative_;
+	  fivePointsRule (argument, j, h_opt, round_opt, trunc_opt, xEps);
+	  value_type error_opt = round_opt + trunc_opt;
+
+	  if (stencil_t::accept
+	      (error, error_opt,
+	       (derivative_ - previous_).cwiseAbs ().maxCoeff ()))
+	    {
+	      h = h_opt;
+	      error = error_opt;
+	    }
+	}
+
+      // Forward differences: the total error c h / 2 + 2 eps |f| / h is
+      // minimal for h = 2 sqrt (eps |f| / c). If the function is linear,
+      // there is no truncation error and the initial step is kept.
+      value_type hForward =
+	std::pow (eps, value_type (1) / value_type (3)) * scale;
+      value_type errorForward = value_type (2) * eps * magnitude / hForward;
+      if (curvature > value_type (0))
+	{
+	  hForward = value_type (2)
+	    * std::sqrt (eps * std::max (magnitude, eps) / curvature);
+	  errorForward = value_type (2)
+	    * std::sqrt (eps * std::max (magnitude, eps) * curvature);
+	}
+
+      const size_t j_ = static_cast<size_t> (j);
+      selected_[j_] = true;
+      if (errorForward <= tolerance_)
+	{
+	  central_[j_] = false;
+	  steps_[j] = hForward;
+	  errors_[j] = errorForward;
+	}
+      else
+	{
+	  central_[j_] = true;
+	  steps_[j] = h;
+	  errors_[j] = error;
+	}
+    }
+
+    template <typename T>
+    void
+    Adaptive<T>::computeDerivative
+    (value_type epsilon,
+     const_argument_ref argument,
+     size_type j,
+     argument_ref xEps) const
+    {
+      assert (this->adaptee_.inputSize () - j > 0);
+
+      const size_t j_ = static_cast<size_t> (j);
+      if (!selected_[j_])
+	selectStep (epsilon, argument, j, xEps);
+
+      if (central_[j_])
+	{
+	  value_type round = 0.;
+	  value_type trunc = 0.;
+	  fivePointsRule (argument, j, steps_[j], round, trunc, xEps);
+	  errors_[j] = round + trunc;
+	}
+      else
+	{
+	  xEps = argument;
+	  xEps[j] += steps_[j];
+	  this->adaptee_ (fp1_, xEps);
+	  derivative_ = (fp1_ - result_) / steps_[j];
+	}
+    }
+
+    template <typename T>
+    void
+    Adaptive<T>::computeColumn
+    (value_type epsilon,
+     gradient_ref column,
+     const_argument_ref argument,
+     size_type colIdx,
+     argument_ref xEps) const
+    {
+      // Note: result_ = f(x) should have been called already
+      computeDerivative (epsilon, argument, colIdx, xEps);
+      this->copyColumn (column, derivative_,
+			boost::mpl::bool_<StorageTraits<T>::isDense> ());
+    }
+
+    template <typename T>
+    void
+    Adaptive<T>::computeGradient
+    (value_type epsilon,
+     gradient_ref gradient,
+     const_argument_ref argument,
+     size_type idFunction,
+     argument_ref xEps) const
+    {
+      assert (this->adaptee_.outputSize () - idFunction > 0);
+
+      this->adaptee_ (result_, argument);
+      for (size_type j = 0; j < this->adaptee_.inputSize (); ++j)
+	{
+	  computeDerivative (epsilon, argument, j, xEps);
+	  this->setCoefficient
+	    (gradient, j, derivative_[idFunction],
+	     boost::mpl::bool_<StorageTraits<T>::isDense> ());
+	}
+    }
+
+    template <typename T>
+    void
+    Adaptive<T>::computeJacobian
+    (value_type epsilon,
+     jacobian_ref jacobian,
+     const_argument_ref argument,
+     argument_ref xEps) const
+    {
+      // Data used by each computeColumn
+      this->adaptee_ (result_, argument);
+
+      // Call parent Jacobian
+      policy_t::computeJacobian (epsilon, jacobian, argument, xEps);
+    }
+
+    template <typename T>
+    ComplexStep<T>::ComplexStep (const GenericFunction<T>& adaptee)
+      : Policy<T> (adaptee),
+	complex_ (dynamic_cast<const ComplexEvaluation<T>*> (&adaptee)),
+	step_ (1e-20),
+	complexArgument_ (adaptee.inputSize ()),
+	complexResult_ (adaptee.outputSize ()),
+	derivative_ (adaptee.outputSize ())
+    {
+      if (!complex_)
+	throw std::runtime_error
+	  ("the complex-step policy requires a function implementing"
+	   " ComplexEvaluation");
+    }
+
+    template <typename T>
+    void
+    ComplexStep<T>::computeDerivative
+    (const_argument_ref argument,
+     size_type j) const
+    {
+      complexArgument_ = argument.template cast<complex_t> ();
+      complexArgument_[j] += complex_t (0., step_);
+      complex_->complexCompute (complexResult_, complexArgument_);
+      derivative_ = complexResult_.imag () / step_;
+    }
+
+    template <typename T>
+    void
+    ComplexStep<T>::computeColumn
+    (value_type,
+     gradient_ref column,
+     const_argument_ref argument,
+     size_type colIdx,
+     argument_ref) const
+    {
+      computeDerivative (argument, colIdx);
+      this->copyColumn (column, derivative_,
+			boost::mpl::bool_<StorageTraits<T>::isDense> ());
+    }
+
+    template <typename T>
+    void
+    ComplexStep<T>::computeGradient
+    (value_type,
+     gradient_ref gradient,
+     const_argument_ref argument,
+     size_type idFunction,
+     argument_ref) const
+    {
+      assert (this->adaptee_.outputSize () - idFunction > 0);
+
+      for (size_type j = 0; j < this->adaptee_.inputSize (); ++j)
+	{
+	  computeDerivative (argument, j);
+	  this->setCoefficient
+	    (gradient, j, derivative_[idFunction],
+	     boost::mpl::bool_<StorageTraits<T>::isDense> ());
+	}
     }
   } // end of namespace finiteDifferenceGradientPolicies.
 
@@ -0,0 +1,189 @@
+// Copyright (C) 2026 by the RobOptim contributors.
+//
+// This file is part of the roboptim.
+//
+// roboptim is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// roboptim is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with roboptim.  If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef ROBOPTIM_CORE_DECORATOR_FORWARD_MODE_DIFFERENTIATION_HH
+# define ROBOPTIM_CORE_DECORATOR_FORWARD_MODE_DIFFERENTIATION_HH
+# include <roboptim/core/sys.hh>
+# include <roboptim/core/debug.hh>
+
+# include <ostream>
+# include <string>
+# include <vector>
+
+# include <boost/shared_ptr.hpp>
+# include <boost/make_shared.hpp>
+# include <boost/mpl/bool.hpp>
+# include <boost/static_assert.hpp>
+
+# include <unsupported/Eigen/AutoDiff>
+
+# include <roboptim/core/differentiable-function.hh>
+
+namespace roboptim
+{
+  /// \addtogroup roboptim_decorator
+  /// @{
+
+  /// \brief Differentiate a function with forward-mode automatic
+  /// differentiation.
+  ///
+  /// The function is given as a functor written generically over the
+  /// scalar type:
+  /// \code
+  /// struct F
+  /// {
+  ///   template <typename R, typename A>
+  ///   void operator () (R& result, const A& x) const
+  ///   {
+  ///     using std::sin;
+  ///     result[0] = x[0] * sin (x[1]);
+  ///   }
+  /// };
+  /// \endcode
+  /// \c R and \c A are Eigen column vectors, and <tt>typename
+  /// A::Scalar</tt> is the scalar type to use for temporaries.
+  ///
+  /// Values are computed with the function's scalar type. Derivatives
+  /// are computed by evaluating the functor with dual numbers
+  /// (Eigen::AutoDiffScalar) carrying N directional derivatives at once.
+  /// A Jacobian thus costs \f$\lceil n / N \rceil\f$ sweeps, each one
+  /// being a small multiple of a function evaluation, and it is exact up
+  /// to rounding errors: there is no step size to tune, contrary to
+  /// GenericFiniteDifferenceGradient.
+  ///
+  /// \tparam T function traits.
+  /// \tparam F functor type.
+  /// \tparam N number of directions propagated per sweep.
+  template <typename T, typename F, int N = 4>
+  class GenericForwardModeDifferentiation
+    : public GenericDifferentiableFunction<T>
+  {
+  public:
+    ROBOPTIM_DIFFERENTIABLE_FUNCTION_FWD_TYPEDEFS_
+    (GenericDifferentiableFunction<T>);
+
+    BOOST_STATIC_ASSERT (N > 0);
+
+    /// \brief Functor type.
+    typedef F functor_t;
+
+    /// \brief Directional derivatives carried by a dual number.
+    typedef Eigen::Matrix<value_type, N, 1> derivatives_t;
+
+    /// \brief Dual number type.
+    typedef Eigen::AutoDiffScalar<derivatives_t> dual_t;
+
+    /// \brief Vector of dual numbers.
+    typedef Eigen::Matrix<dual_t, Eigen::Dynamic, 1> dualVector_t;
+
+    /// \brief Number of directions propagated per sweep.
+    static const int directions = N;
+
+    /// \brief Wrap a functor.
+    /// \param functor generic implementation of the function.
+    /// \param inputSize input size (argument size)
+    /// \param outputSize output size (result size)
+    /// \param name function's name
+    GenericForwardModeDifferentiation (const F& functor,
+				       size_type inputSize,
+				       size_type outputSize = 1,
+				       std::string name = std::string ());
+    ~GenericForwardModeDifferentiation ();
+
+    const F& functor () const
+    {
+      return functor_;
+    }
+
+    /// \brief Display the function on the specified output stream.
+    ///
+    /// \param o output stream used for display
+    /// \return output stream
+    virtual std::ostream& print (std::ostream& o) const;
+
+  protected:
+    void impl_compute (result_ref result, const_argument_ref argument) const;
+
+    void impl_gradient (gradient_ref gradient,
+			const_argument_ref argument,
+			size_type functionId = 0) const;
+
+    void impl_jacobian (jacobian_ref jacobian,
+			const_argument_ref argument) const;
+
+    void impl_value_and_jacobian (result_ref result,
+				  jacobian_ref jacobian,
+				  const_argument_ref argument) const;
+
+  private:
+    /// \brief Propagate the directions of the inputs [start, start + N).
+    ///
+    /// \param argument point where the derivatives are computed
+    /// \param start first input seeded by the sweep
+    /// \return number of seeded inputs
+    size_type sweep (const_argument_ref argument, size_type start) const;
+
+    /// \brief Dense Jacobian assembly.
+    template <typename J>
+    void assembleJacobian (J& jacobian, const_argument_ref argument,
+			   boost::mpl::true_) const;
+
+    /// \brief Sparse Jacobian assembly, only storing nonzero derivatives.
+    template <typename J>
+    void assembleJacobian (J& jacobian, const_argument_ref argument,
+			   boost::mpl::false_) const;
+
+  private:
+    /// \brief Generic implementation of the function.
+    F functor_;
+
+    /// \brief Dual argument buffer.
+    mutable dualVector_t x_;
+
+    /// \brief Dual result buffer.
+    mutable dualVector_t y_;
+
+    /// \brief Triplet buffer used by the sparse Jacobian assembly.
+    mutable std::vector<Eigen::Triplet<value_type, size_type> > triplets_;
+  };
+
+  /// \brief Differentiate a generic functor with forward-mode automatic
+  /// differentiation.
+  ///
+  /// \tparam T function traits.
+  /// \param functor generic implementation of the function.
+  /// \param inputSize input size (argument size)
+  /// \param outputSize output size (result size)
+  /// \param name function's name
+  template <typename T, typename F>
+  boost::shared_ptr<GenericForwardModeDifferentiation<T, F> >
+  forwardModeDifferentiation
+  (const F& functor,
+   typename GenericFunction<T>::size_type inputSize,
+   typename GenericFunction<T>::size_type outputSize = 1,
+   std::string name = std::string ())
+  {
+    return boost::make_shared<GenericForwardModeDifferentiation<T, F> >
+      (functor, inputSize, outputSize, name);
+  }
+
+  /// @}
+
+} // end of namespace roboptim
+
+# include <roboptim/core/decorator/forward-mode-differentiation.hxx>
+#endif //! ROBOPTIM_CORE_DECORATOR_FORWARD_MODE_DIFFERENTIATION_HH
@@ -0,0 +1,176 @@
+// Copyright (C) 2026 by the RobOptim contributors.
+//
+// This file is part of the roboptim.
+//
+// roboptim is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// roboptim is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with roboptim.  If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef ROBOPTIM_CORE_DECORATOR_FORWARD_MODE_DIFFERENTIATION_HXX
+# define ROBOPTIM_CORE_DECORATOR_FORWARD_MODE_DIFFERENTIATION_HXX
+
+# include <algorithm>
+
+# include <roboptim/core/indent.hh>
+
+namespace roboptim
+{
+  template <typename T, typename F, int N>
+  GenericForwardModeDifferentiation<T, F, N>::GenericForwardModeDifferentiation
+  (const F& functor, size_type inputSize, size_type outputSize,
+   std::string name)
+    : GenericDifferentiableFunction<T> (inputSize, outputSize, name),
+      functor_ (functor),
+      x_ (inputSize),
+      y_ (outputSize),
+      triplets_ ()
+  {
+  }
+
+  template <typename T, typename F, int N>
+  GenericForwardModeDifferentiation<T, F, N>::
+  ~GenericForwardModeDifferentiation ()
+  {
+  }
+
+  template <typename T, typename F, int N>
+  typename GenericForwardModeDifferentiation<T, F, N>::size_type
+  GenericForwardModeDifferentiation<T, F, N>::sweep
+  (const_argument_ref argument, size_type start) const
+  {
+    const size_type seeded = std::min<size_type>
+      (N, this->inputSize () - start);
+
+    for (size_type j = 0; j < this->inputSize (); ++j)
+      {
+	x_[j].value () = argument[j];
+	x_[j].derivatives ().setZero ();
+      }
+    for (size_type k = 0; k < seeded; ++k)
+      x_[start + k].derivatives ()[k] = 1.;
+
+    functor_ (y_, x_);
+    return seeded;
+  }
+
+  template <typename T, typename F, int N>
+  void
+  GenericForwardModeDifferentiation<T, F, N>::impl_compute
+  (result_ref result, const_argument_ref argument) const
+  {
+    functor_ (result, argument);
+  }
+
+  template <typename T, typename F, int N>
+  void
+  GenericForwardModeDifferentiation<T, F, N>::impl_gradient
+  (gradient_ref gradient, const_argument_ref argument, size_type functionId)
+    const
+  {
+    gradient.setZero ();
+
+    for (size_type start = 0; start < this->inputSize (); start += N)
+      {
+	const size_type seeded = sweep (argument, start);
+	for (size_type k = 0; k < seeded; ++k)
+	  {
+	    const value_type d = y_[functionId].derivatives ()[k];
+	    if (d != 0.)
+	      gradient.coeffRef (start + k) = d;
+	  }
+      }
+  }
+
+  template <typename T, typename F, int N>
+  template <typename J>
+  void
+  GenericForwardModeDifferentiation<T, F, N>::assembleJacobian
+  (J& jacobian, const_argument_ref argument, boost::mpl::true_) const
+  {
+    for (size_type start = 0; start < this->inputSize (); start += N)
+      {
+	const size_type seeded = sweep (argument, start);
+	for (size_type i = 0; i < this->outputSize (); ++i)
+	  for (size_type k = 0; k < seeded; ++k)
+	    jacobian (i, start + k) = y_[i].derivatives ()[k];
+      }
+  }
+
+  template <typename T, typename F, int N>
+  template <typename J>
+  void
+  GenericForwardModeDifferentiation<T, F, N>::assembleJacobian
+  (J& jacobian, const_argument_ref argument, boost::mpl::false_) const
+  {
+    typedef Eigen::Triplet<value_type, size_type> triplet_t;
+
+    triplets_.clear ();
+    for (size_type start = 0; start < this->inputSize (); start += N)
+      {
+	const size_type seeded = sweep (argument, start);
+	for (size_type i = 0; i < this->outputSize (); ++i)
+	  for (size_type k = 0; k < seeded; ++k)
+	    {
+	      const value_type d = y_[i].derivatives ()[k];
+	      if (d != 0.)
+		triplets_.push_back (triplet_t (i, start + k, d));
+	    }
+      }
+
+#ifndef ROBOPTIM_DO_NOT_CHECK_ALLOCATION
+    bool cur_malloc_allowed = is_malloc_allowed ();
+    set_is_malloc_allowed (true);
+#endif //! ROBOPTIM_DO_NOT_CHECK_ALLOCATION
+
+    jacobian.setFromTriplets (triplets_.begin (), triplets_.end ());
+
+#ifndef ROBOPTIM_DO_NOT_CHECK_ALLOCATION
+    set_is_malloc_allowed (cur_malloc_allowed);
+#endif //! ROBOPTIM_DO_NOT_CHECK_ALLOCATION
+  }
+
+  template <typename T, typename F, int N>
+  void
+  GenericForwardModeDifferentiation<T, F, N>::impl_jacobian
+  (jacobian_ref jacobian, const_argument_ref argument) const
+  {
+    assembleJacobian (jacobian, argument,
+		      boost::mpl::bool_<StorageTraits<T>::isDense> ());
+  }
+
+  template <typename T, typename F, int N>
+  void
+  GenericForwardModeDifferentiation<T, F, N>::impl_value_and_jacobian
+  (result_ref result, jacobian_ref jacobian, const_argument_ref argument)
+    const
+  {
+    assembleJacobian (jacobian, argument,
+		      boost::mpl::bool_<StorageTraits<T>::isDense> ());
+
+    // The values are carried by the dual numbers of the last sweep.
+    for (size_type i = 0; i < this->outputSize (); ++i)
+      result[i] = y_[i].value ();
+  }
+
+  template <typename T, typename F, int N>
+  std::ostream&
+  GenericForwardModeDifferentiation<T, F, N>::print (std::ostream& o) const
+  {
+    o << "Forward-mode differentiation (" << N << " directions per sweep)";
+    if (!this->getName ().empty ())
+      o << ":" << incindent << iendl << this->getName () << decindent;
+    return o;
+  }
+
+} // end of namespace roboptim
+
+#endif //! ROBOPTIM_CORE_DECORATOR_FORWARD_MODE_DIFFERENTIATION_HXX
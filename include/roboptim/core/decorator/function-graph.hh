@@ -0,0 +1,426 @@
+// Copyright (C) 2026 by the RobOptim contributors.
+//
+// This file is part of the roboptim.
+//
+// roboptim is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// roboptim is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with roboptim.  If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef ROBOPTIM_CORE_DECORATOR_FUNCTION_GRAPH_HH
+# define ROBOPTIM_CORE_DECORATOR_FUNCTION_GRAPH_HH
+# include <roboptim/core/sys.hh>
+# include <roboptim/core/debug.hh>
+
+# include <map>
+# include <ostream>
+# include <string>
+# include <vector>
+
+# include <boost/mpl/bool.hpp>
+# include <boost/noncopyable.hpp>
+# include <boost/shared_ptr.hpp>
+# include <boost/make_shared.hpp>
+# include <boost/thread/lock_guard.hpp>
+# include <boost/thread/mutex.hpp>
+# include <boost/thread/thread.hpp>
+
+# include <roboptim/core/differentiable-function.hh>
+# include <roboptim/core/detail/graph-traversal.hh>
+
+namespace roboptim
+{
+  namespace detail
+  {
+    /// \brief Evaluation state shared by the nodes of a function graph.
+    struct GraphState : boost::noncopyable
+    {
+      GraphState ()
+	: mutex (),
+	  owner (),
+	  epoch (0)
+      {}
+
+      /// \brief Mutex held during an evaluation of the graph.
+      boost::mutex mutex;
+
+      /// \brief Thread evaluating the graph, if any.
+      boost::thread::id owner;
+
+      /// \brief Index of the current evaluation.
+      unsigned long epoch;
+    };
+
+    /// \brief Mark the evaluation of a function graph, for the lifetime
+    /// of the object.
+    ///
+    /// Memos are only used during an evaluation, and only keep the data
+    /// computed during the current one. Concurrent evaluations of the
+    /// same graph are serialized.
+    class GraphEvaluation : boost::noncopyable
+    {
+    public:
+      explicit GraphEvaluation (GraphState& state)
+	: lock_ (state.mutex),
+	  state_ (state)
+      {
+	++state_.epoch;
+	state_.owner = boost::this_thread::get_id ();
+      }
+
+      ~GraphEvaluation ()
+      {
+	state_.owner = boost::thread::id ();
+      }
+
+    private:
+      boost::lock_guard<boost::mutex> lock_;
+      GraphState& state_;
+    };
+
+    /// \brief Node of a function graph standing for a shared function.
+    ///
+    /// The node forwards to the function, and memoizes its value and
+    /// jacobian: the data is tagged with the argument and the evaluation
+    /// it was computed for, and reused only within the same evaluation,
+    /// at the same argument. The buffers are allocated once, when the
+    /// node is built. Only the thread running the evaluation uses the
+    /// memo: functions evaluated by worker threads (e.g. by Map) are
+    /// computed as usual.
+    ///
+    /// \tparam T function traits.
+    template <typename T>
+    class GraphNode : public GenericDifferentiableFunction<T>,
+		      public GenericExpressionNode<T>
+    {
+    public:
+      ROBOPTIM_DIFFERENTIABLE_FUNCTION_FWD_TYPEDEFS_
+      (GenericDifferentiableFunction<T>);
+
+      /// \brief Type of the shared function.
+      typedef GenericDifferentiableFunction<T> origin_t;
+
+      /// \brief Expression node interface.
+      typedef GenericExpressionNode<T> expressionNode_t;
+
+      /// \brief Build a node.
+      /// \param state evaluation state of the graph.
+      /// \param origin shared function.
+      GraphNode (boost::shared_ptr<const GraphState> state,
+		 const origin_t& origin);
+
+      /// \brief Set the shared function, once the node replaces it in an
+      /// operator.
+      void setOrigin (boost::shared_ptr<const origin_t> origin)
+      {
+	origin_ = origin;
+      }
+
+      /// \brief Shared function.
+      const boost::shared_ptr<const origin_t>& origin () const
+      {
+	return origin_;
+      }
+
+      /// \brief Number of evaluations avoided.
+      size_type hits () const
+      {
+	return hits_;
+      }
+
+      virtual std::ostream& print (std::ostream& o) const
+      {
+	return origin_->print (o);
+      }
+
+    protected:
+      void impl_children
+      (typename expressionNode_t::children_t& children) const
+      {
+	children.push_back (origin_.get ());
+      }
+
+      /// \brief The shared function is never replaced.
+      void impl_replace_child (const GenericFunction<T>*,
+			       const typename expressionNode_t::childShPtr_t&,
+			       typename expressionNode_t::constChildShPtr_t&)
+      {
+      }
+
+      /// \brief Nodes are not copied: their memo belongs to one graph.
+      typename expressionNode_t::childShPtr_t impl_clone () const
+      {
+	return typename expressionNode_t::childShPtr_t ();
+      }
+
+      int impl_compile (typename expressionNode_t::compiler_t& compiler,
+			int argument) const
+      {
+	return compiler.operand (origin_, argument);
+      }
+
+      void impl_compute (result_ref result, const_argument_ref argument) const;
+
+      void impl_gradient (gradient_ref gradient,
+			  const_argument_ref argument,
+			  size_type functionId = 0) const;
+
+      void impl_jacobian (jacobian_ref jacobian,
+			  const_argument_ref argument) const;
+
+      void impl_value_and_jacobian (result_ref result,
+				    jacobian_ref jacobian,
+				    const_argument_ref argument) const;
+
+      void impl_jacobian_structure (sparsityPattern_t& pattern) const;
+
+      void impl_vector_jacobian_product (gradient_ref result,
+					 const_argument_ref argument,
+					 const_vector_ref weights) const;
+
+    private:
+      /// \brief Whether the memo can be used by the current thread.
+      bool enabled () const
+      {
+	return state_->owner == boost::this_thread::get_id ();
+      }
+
+      /// \brief Whether data computed at an argument during an
+      /// evaluation can be reused.
+      bool valid (unsigned long epoch, const argument_t& memoArgument,
+		  const_argument_ref argument) const;
+
+      /// \brief Memoize the jacobian, if the memo is enabled.
+      void setJacobian (const_jacobian_ref jacobian,
+			const_argument_ref argument) const;
+
+      /// \brief Copy a dense jacobian.
+      template <typename D, typename S>
+      static void copy (D& dst, const S& src, boost::mpl::true_);
+
+      /// \brief Copy a sparse jacobian, or a row of it.
+      template <typename D, typename S>
+      static void copy (D& dst, const S& src, boost::mpl::false_);
+
+    private:
+      /// \brief Evaluation state of the graph.
+      boost::shared_ptr<const GraphState> state_;
+
+      /// \brief Shared function.
+      boost::shared_ptr<const origin_t> origin_;
+
+      /// \brief Evaluation of the memoized value.
+      mutable unsigned long valueEpoch_;
+
+      /// \brief Argument of the memoized value.
+      mutable argument_t valueArgument_;
+
+      /// \brief Memoized value.
+      mutable result_t result_;
+
+      /// \brief Evaluation of the memoized jacobian.
+      mutable unsigned long jacobianEpoch_;
+
+      /// \brief Argument of the memoized jacobian.
+      mutable argument_t jacobianArgument_;
+
+      /// \brief Memoized jacobian.
+      mutable jacobian_t jacobian_;
+
+      /// \brief Number of evaluations avoided.
+      mutable size_type hits_;
+    };
+  } // end of namespace detail
+
+  /// \addtogroup roboptim_decorator
+  /// @{
+
+  /// \brief Evaluate an expression of operators, computing the
+  /// subexpressions it shares only once.
+  ///
+  /// Operators (see roboptim_operator) keep their operands as shared
+  /// pointers: the same function object may appear several times in an
+  /// expression, e.g. c = chain (f, g) in plus (c, product (c, h)). Each
+  /// occurrence is evaluated independently, including its jacobian.
+  ///
+  /// The graph walks the expression once, when it is built, and lists
+  /// its nodes in topological order (operands first). It then builds its
+  /// own evaluation graph in that order: every differentiable node
+  /// reached more than once is wrapped in a memoizing node
+  /// (detail::GraphNode), and the operators leading to it are copied
+  /// (see GenericFunction::clone) with their operands replaced by the
+  /// wrapped ones. The other nodes are shared with the expression, which
+  /// is left untouched. During an evaluation of the graph, the first
+  /// computation of the value or of the jacobian of a shared node at an
+  /// argument is stored in its memo, and the next occurrences at the same
+  /// argument simply copy it. Memo buffers are allocated once, when the
+  /// graph is built.
+  ///
+  /// Only operands declared as GenericDifferentiableFunction<T> (or as
+  /// one of its bases), in operators which can be copied, can be
+  /// substituted: the other occurrences of a shared node, and shared
+  /// nodes which are not differentiable, are evaluated as usual.
+  ///
+  /// Gradients are read from a memoized jacobian, but are not memoized
+  /// themselves: operators computing the derivatives of their operands
+  /// row by row (e.g. SelectionById) do not benefit from the graph.
+  /// Hessians are not memoized either.
+  ///
+  /// Concurrent evaluations of the graph are serialized.
+  ///
+  /// \warning the copied operators are taken when the graph is built:
+  /// later changes to the operators of the expression (e.g. to their
+  /// options) are not seen by the graph.
+  ///
+  /// \tparam T function traits.
+  template <typename T>
+  class GenericFunctionGraph : public GenericDifferentiableFunction<T>
+  {
+  public:
+    ROBOPTIM_DIFFERENTIABLE_FUNCTION_FWD_TYPEDEFS_
+    (GenericDifferentiableFunction<T>);
+
+    /// \brief Type of the root of the expression.
+    typedef GenericDifferentiableFunction<T> root_t;
+
+    /// \brief Type of a list of nodes.
+    typedef typename detail::GenericExpressionNode<T>::children_t nodes_t;
+
+    /// \brief Build the graph of an expression.
+    ///
+    /// \param root root of the expression.
+    explicit GenericFunctionGraph (boost::shared_ptr<root_t> root);
+    ~GenericFunctionGraph ();
+
+    /// \brief Root of the expression.
+    const boost::shared_ptr<root_t>& root () const
+    {
+      return root_;
+    }
+
+    /// \brief Number of distinct nodes in the expression, including its
+    /// root.
+    size_type nodes () const
+    {
+      return static_cast<size_type> (order_.size ());
+    }
+
+    /// \brief Nodes of the expression, in topological order (operands
+    /// first).
+    const nodes_t& order () const
+    {
+      return order_;
+    }
+
+    /// \brief Nodes reached more than once, in topological order.
+    const nodes_t& sharedNodes () const
+    {
+      return sharedNodes_;
+    }
+
+    /// \brief Number of computations of shared nodes avoided so far.
+    size_type memoHits () const;
+
+    /// \brief Display the function on the specified output stream.
+    ///
+    /// \param o output stream used for display
+    /// \return output stream
+    virtual std::ostream& print (std::ostream& o) const;
+
+  protected:
+    void impl_compute (result_ref result, const_argument_ref argument) const;
+
+    void impl_gradient (gradient_ref gradient,
+			const_argument_ref argument,
+			size_type functionId = 0) const;
+
+    void impl_jacobian (jacobian_ref jacobian,
+			const_argument_ref argument) const;
+
+    void impl_value_and_jacobian (result_ref result,
+				  jacobian_ref jacobian,
+				  const_argument_ref argument) const;
+
+    void impl_jacobian_structure (sparsityPattern_t& pattern) const;
+
+    void impl_vector_jacobian_product (gradient_ref result,
+				       const_argument_ref argument,
+				       const_vector_ref weights) const;
+
+  private:
+    typedef typename detail::GenericExpressionNode<T>::childShPtr_t
+    nodeShPtr_t;
+    typedef std::map<const GenericFunction<T>*, size_type> parents_t;
+    typedef std::map<const GenericFunction<T>*, nodeShPtr_t> images_t;
+    typedef detail::GraphNode<T> node_t;
+
+    /// \brief Count the parents of a node and of its descendants.
+    /// \param node node to visit.
+    /// \param parents number of parents of the nodes visited so far,
+    /// once per edge.
+    /// \param order nodes visited so far, in postorder.
+    static void visit (const GenericFunction<T>* node,
+		       parents_t& parents, nodes_t& order);
+
+    /// \brief Build the node of the evaluation graph standing for a node
+    /// of the expression, once its operands are built.
+    /// \param node node of the expression.
+    /// \param shared whether the node is reached more than once.
+    /// \param images nodes of the evaluation graph built so far, for the
+    /// nodes of the expression which differ from them.
+    void build (const GenericFunction<T>* node, bool shared,
+		images_t& images);
+
+  private:
+    /// \brief Root of the expression.
+    boost::shared_ptr<root_t> root_;
+
+    /// \brief Root of the evaluation graph.
+    boost::shared_ptr<root_t> evaluated_;
+
+    /// \brief Evaluation state shared by the memoizing nodes.
+    boost::shared_ptr<detail::GraphState> state_;
+
+    /// \brief Nodes of the expression, in topological order.
+    nodes_t order_;
+
+    /// \brief Shared nodes, in topological order.
+    nodes_t sharedNodes_;
+
+    /// \brief Memoizing nodes used by the evaluation graph.
+    std::vector<boost::shared_ptr<node_t> > memos_;
+  };
+
+  /// \brief Graph of a dense expression.
+  /// \see GenericFunctionGraph
+  typedef GenericFunctionGraph<EigenMatrixDense> FunctionGraph;
+
+  /// \brief Graph of a sparse expression.
+  /// \see GenericFunctionGraph
+  typedef GenericFunctionGraph<EigenMatrixSparse> FunctionGraphSparse;
+
+  /// \brief Build the graph of an expression.
+  ///
+  /// \tparam T function traits.
+  /// \param root root of the expression.
+  template <typename T>
+  boost::shared_ptr<GenericFunctionGraph<T> >
+  functionGraph (boost::shared_ptr<GenericDifferentiableFunction<T> > root)
+  {
+    return boost::make_shared<GenericFunctionGraph<T> > (root);
+  }
+
+  /// @}
+
+} // end of namespace roboptim
+
+# include <roboptim/core/decorator/function-graph.hxx>
+#endif //! ROBOPTIM_CORE_DECORATOR_FUNCTION_GRAPH_HH
@@ -0,0 +1,390 @@
+// Copyright (C) 2026 by the RobOptim contributors.
+//
+// This file is part of the roboptim.
+//
+// roboptim is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// roboptim is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with roboptim.  If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef ROBOPTIM_CORE_DECORATOR_FUNCTION_GRAPH_HXX
+# define ROBOPTIM_CORE_DECORATOR_FUNCTION_GRAPH_HXX
+# include <algorithm>
+# include <stdexcept>
+
+namespace roboptim
+{
+  namespace detail
+  {
+    template <typename T>
+    GraphNode<T>::GraphNode (boost::shared_ptr<const GraphState> state,
+			     const origin_t& origin)
+      : GenericDifferentiableFunction<T>
+	(origin.inputSize (), origin.outputSize (), origin.getName ()),
+	state_ (state),
+	origin_ (),
+	valueEpoch_ (0),
+	valueArgument_ (origin.inputSize ()),
+	result_ (origin.outputSize ()),
+	jacobianEpoch_ (0),
+	jacobianArgument_ (origin.inputSize ()),
+	jacobian_ (origin.outputSize (), origin.inputSize ()),
+	hits_ (0)
+    {
+      valueArgument_.setZero ();
+      result_.setZero ();
+      jacobianArgument_.setZero ();
+      jacobian_.setZero ();
+    }
+
+    template <typename T>
+    bool
+    GraphNode<T>::valid (unsigned long epoch,
+			 const argument_t& memoArgument,
+			 const_argument_ref argument) const
+    {
+      return enabled () && epoch == state_->epoch
+	&& memoArgument.size () == argument.size ()
+	&& memoArgument == argument;
+    }
+
+    template <typename T>
+    void
+    GraphNode<T>::impl_compute (result_ref result,
+				const_argument_ref argument) const
+    {
+      if (valid (valueEpoch_, valueArgument_, argument))
+	{
+	  result = result_;
+	  ++hits_;
+	  return;
+	}
+
+      (*origin_) (result, argument);
+
+      if (!enabled ())
+	return;
+
+      valueArgument_ = argument;
+      result_ = result;
+      valueEpoch_ = state_->epoch;
+    }
+
+    template <typename T>
+    void
+    GraphNode<T>::impl_gradient (gradient_ref gradient,
+				 const_argument_ref argument,
+				 size_type functionId) const
+    {
+      if (valid (jacobianEpoch_, jacobianArgument_, argument))
+	{
+	  copy (gradient, jacobian_.row (functionId),
+		boost::mpl::bool_<StorageTraits<T>::isDense> ());
+	  ++hits_;
+	  return;
+	}
+
+      origin_->gradient (gradient, argument, functionId);
+    }
+
+    template <typename T>
+    void
+    GraphNode<T>::impl_jacobian (jacobian_ref jacobian,
+				 const_argument_ref argument) const
+    {
+      if (valid (jacobianEpoch_, jacobianArgument_, argument))
+	{
+	  copy (jacobian, jacobian_,
+		boost::mpl::bool_<StorageTraits<T>::isDense> ());
+	  ++hits_;
+	  return;
+	}
+
+      origin_->jacobian (jacobian, argument);
+      setJacobian (jacobian, argument);
+    }
+
+    template <typename T>
+    void
+    GraphNode<T>::impl_value_and_jacobian (result_ref result,
+					   jacobian_ref jacobian,
+					   const_argument_ref argument) const
+    {
+      if (!valid (valueEpoch_, valueArgument_, argument)
+	  || !valid (jacobianEpoch_, jacobianArgument_, argument))
+	{
+	  origin_->valueAndJacobian (result, jacobian, argument);
+
+	  if (!enabled ())
+	    return;
+
+	  valueArgument_ = argument;
+	  result_ = result;
+	  valueEpoch_ = state_->epoch;
+	  setJacobian (jacobian, argument);
+	  return;
+	}
+
+      result = result_;
+      copy (jacobian, jacobian_,
+	    boost::mpl::bool_<StorageTraits<T>::isDense> ());
+      ++hits_;
+    }
+
+    template <typename T>
+    void
+    GraphNode<T>::impl_jacobian_structure (sparsityPattern_t& pattern) const
+    {
+      origin_->jacobianStructure (pattern);
+    }
+
+    template <typename T>
+    void
+    GraphNode<T>::impl_vector_jacobian_product
+    (gradient_ref result, const_argument_ref argument,
+     const_vector_ref weights) const
+    {
+      origin_->vectorJacobianProduct (result, argument, weights);
+    }
+
+    template <typename T>
+    void
+    GraphNode<T>::setJacobian (const_jacobian_ref jacobian,
+			       const_argument_ref argument) const
+    {
+      if (!enabled ())
+	return;
+
+      jacobianArgument_ = argument;
+      copy (jacobian_, jacobian,
+	    boost::mpl::bool_<StorageTraits<T>::isDense> ());
+      jacobianEpoch_ = state_->epoch;
+    }
+
+    template <typename T>
+    template <typename D, typename S>
+    void
+    GraphNode<T>::copy (D& dst, const S& src, boost::mpl::true_)
+    {
+      dst = src;
+    }
+
+    template <typename T>
+    template <typename D, typename S>
+    void
+    GraphNode<T>::copy (D& dst, const S& src, boost::mpl::false_)
+    {
+      // The structure of sparse matrices may change from one evaluation
+      // to the next.
+#ifndef ROBOPTIM_DO_NOT_CHECK_ALLOCATION
+      bool cur_malloc_allowed = is_malloc_allowed ();
+      set_is_malloc_allowed (true);
+#endif //! ROBOPTIM_DO_NOT_CHECK_ALLOCATION
+
+      dst = src;
+
+#ifndef ROBOPTIM_DO_NOT_CHECK_ALLOCATION
+      set_is_malloc_allowed (cur_malloc_allowed);
+#endif //! ROBOPTIM_DO_NOT_CHECK_ALLOCATION
+    }
+  } // end of namespace detail
+
+  template <typename T>
+  GenericFunctionGraph<T>::GenericFunctionGraph
+  (boost::shared_ptr<root_t> root)
+    : GenericDifferentiableFunction<T>
+      (root->inputSize (), root->outputSize (), root->getName ()),
+      root_ (root),
+      evaluated_ (root),
+      state_ (boost::make_shared<detail::GraphState> ()),
+      order_ (),
+      sharedNodes_ (),
+      memos_ ()
+  {
+    parents_t parents;
+    visit (root_.get (), parents, order_);
+
+    // Operands come first: the evaluation graph is built bottom-up.
+    images_t images;
+    for (typename nodes_t::const_iterator it = order_.begin ();
+	 it != order_.end (); ++it)
+      {
+	bool shared = parents[*it] > 1;
+	if (shared)
+	  sharedNodes_.push_back (*it);
+	build (*it, shared, images);
+      }
+
+    typename images_t::const_iterator image = images.find (root_.get ());
+    if (image != images.end ())
+      evaluated_ = boost::dynamic_pointer_cast<root_t> (image->second);
+  }
+
+  template <typename T>
+  GenericFunctionGraph<T>::~GenericFunctionGraph ()
+  {
+  }
+
+  template <typename T>
+  void
+  GenericFunctionGraph<T>::visit (const GenericFunction<T>* node,
+				  parents_t& parents, nodes_t& order)
+  {
+    // Each edge counts, e.g. the operand of plus (f, f) is shared.
+    if (parents[node]++ > 0)
+      return;
+
+    nodes_t children;
+    detail::GraphTraversal::children (*node, children);
+    for (typename nodes_t::const_iterator it = children.begin ();
+	 it != children.end (); ++it)
+      visit (*it, parents, order);
+
+    order.push_back (node);
+  }
+
+  template <typename T>
+  void
+  GenericFunctionGraph<T>::build (const GenericFunction<T>* node,
+				  bool shared, images_t& images)
+  {
+    nodes_t children;
+    detail::GraphTraversal::children (*node, children);
+
+    // Copy the operator if one of its operands is substituted. The
+    // expression itself is not modified.
+    nodeShPtr_t image;
+    for (typename nodes_t::const_iterator it = children.begin ();
+	 it != children.end (); ++it)
+      {
+	typename images_t::const_iterator operand = images.find (*it);
+	if (operand == images.end ())
+	  continue;
+
+	if (!image)
+	  image = detail::GraphTraversal::clone (*node);
+	if (!image)
+	  break;
+
+	typename detail::GenericExpressionNode<T>::constChildShPtr_t
+	  replaced = detail::GraphTraversal::replaceChild
+	  (*image, *it, operand->second);
+	if (!replaced)
+	  continue;
+
+	boost::shared_ptr<node_t> memo =
+	  boost::dynamic_pointer_cast<node_t> (operand->second);
+	if (!memo)
+	  continue;
+
+	if (!memo->origin ())
+	  memo->setOrigin
+	    (boost::dynamic_pointer_cast<const root_t> (replaced));
+	if (std::find (memos_.begin (), memos_.end (), memo) == memos_.end ())
+	  memos_.push_back (memo);
+      }
+
+    const root_t* origin = node->template castInto<root_t> ();
+    if (!shared || !origin)
+      {
+	if (image)
+	  images[node] = image;
+	return;
+      }
+
+    // The memo wraps the copy of the node if there is one, or the node
+    // itself, obtained from the first operator it is substituted in.
+    boost::shared_ptr<node_t> memo =
+      boost::make_shared<node_t> (state_, *origin);
+    if (image)
+      memo->setOrigin (boost::dynamic_pointer_cast<const root_t> (image));
+    images[node] = memo;
+  }
+
+  template <typename T>
+  typename GenericFunctionGraph<T>::size_type
+  GenericFunctionGraph<T>::memoHits () const
+  {
+    size_type hits = 0;
+    for (std::size_t i = 0; i < memos_.size (); ++i)
+      hits += memos_[i]->hits ();
+    return hits;
+  }
+
+  template <typename T>
+  void
+  GenericFunctionGraph<T>::impl_compute (result_ref result,
+					 const_argument_ref argument) const
+  {
+    detail::GraphEvaluation evaluation (*state_);
+    (*evaluated_) (result, argument);
+  }
+
+  template <typename T>
+  void
+  GenericFunctionGraph<T>::impl_gradient (gradient_ref gradient,
+					  const_argument_ref argument,
+					  size_type functionId) const
+  {
+    detail::GraphEvaluation evaluation (*state_);
+    evaluated_->gradient (gradient, argument, functionId);
+  }
+
+  template <typename T>
+  void
+  GenericFunctionGraph<T>::impl_jacobian (jacobian_ref jacobian,
+					  const_argument_ref argument) const
+  {
+    detail::GraphEvaluation evaluation (*state_);
+    evaluated_->jacobian (jacobian, argument);
+  }
+
+  template <typename T>
+  void
+  GenericFunctionGraph<T>::impl_value_and_jacobian
+  (result_ref result, jacobian_ref jacobian,
+   const_argument_ref argument) const
+  {
+    detail::GraphEvaluation evaluation (*state_);
+    evaluated_->valueAndJacobian (result, jacobian, argument);
+  }
+
+  template <typename T>
+  void
+  GenericFunctionGraph<T>::impl_jacobian_structure
+  (sparsityPattern_t& pattern) const
+  {
+    evaluated_->jacobianStructure (pattern);
+  }
+
+  template <typename T>
+  void
+  GenericFunctionGraph<T>::impl_vector_jacobian_product
+  (gradient_ref result, const_argument_ref argument,
+   const_vector_ref weights) const
+  {
+    detail::GraphEvaluation evaluation (*state_);
+    evaluated_->vectorJacobianProduct (result, argument, weights);
+  }
+
+  template <typename T>
+  std::ostream&
+  GenericFunctionGraph<T>::print (std::ostream& o) const
+  {
+    o << "Function graph (" << nodes () << " nodes, "
+      << sharedNodes_.size () << " shared):"
+      << incindent << iendl << *root_ << decindent;
+    return o;
+  }
+
+} // end of namespace roboptim
+
+#endif //! ROBOPTIM_CORE_DECORATOR_FUNCTION_GRAPH_HXX
@@ -0,0 +1,138 @@
+// Copyright (C) 2026 by the RobOptim contributors.
+//
+// This file is part of the roboptim.
+//
+// roboptim is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// roboptim is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with roboptim.  If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef ROBOPTIM_CORE_DECORATOR_IN_PLACE_JACOBIAN_HH
+# define ROBOPTIM_CORE_DECORATOR_IN_PLACE_JACOBIAN_HH
+# include <roboptim/core/sys.hh>
+# include <roboptim/core/debug.hh>
+
+# include <ostream>
+
+# include <boost/shared_ptr.hpp>
+# include <boost/make_shared.hpp>
+# include <boost/static_assert.hpp>
+
+# include <roboptim/core/differentiable-function.hh>
+
+namespace roboptim
+{
+  /// \addtogroup roboptim_decorator
+  /// @{
+
+  /// \brief Assemble the sparse jacobian of a function in place.
+  ///
+  /// The default sparse jacobian computation builds a triplet vector from
+  /// the gradients and assembles the jacobian again on every call. This
+  /// decorator keeps the compressed structure of the jacobian it is given
+  /// (e.g. the result of a previous call, or the output of
+  /// jacobianStructure) and only overwrites its values with the
+  /// gradients of the wrapped function. Entries of the structure missing
+  /// from the gradients are set to zero.
+  ///
+  /// If a gradient has a nonzero entry outside the structure, the change
+  /// is counted by #structureChanges and logged, and the jacobian is
+  /// computed again by the wrapped function.
+  ///
+  /// The gradient buffer belongs to the decorator: concurrent evaluations
+  /// need one decorator per thread.
+  ///
+  /// \tparam T sparse function traits.
+  template <typename T>
+  class InPlaceJacobian : public GenericDifferentiableFunction<T>
+  {
+  public:
+    ROBOPTIM_DIFFERENTIABLE_FUNCTION_FWD_TYPEDEFS_
+    (GenericDifferentiableFunction<T>);
+
+    BOOST_STATIC_ASSERT (!StorageTraits<T>::isDense);
+
+    /// \brief Wrapped function type.
+    typedef GenericDifferentiableFunction<T> origin_t;
+
+    /// \brief Wrap a function.
+    /// \param fct function to wrap.
+    explicit InPlaceJacobian (boost::shared_ptr<const origin_t> fct);
+    ~InPlaceJacobian ();
+
+    const boost::shared_ptr<const origin_t>& origin () const
+    {
+      return origin_;
+    }
+
+    /// \brief Number of structural changes detected.
+    size_type structureChanges () const
+    {
+      return structureChanges_;
+    }
+
+    /// \brief Display the function on the specified output stream.
+    ///
+    /// \param o output stream used for display
+    /// \return output stream
+    virtual std::ostream& print (std::ostream& o) const;
+
+  protected:
+    void impl_compute (result_ref result, const_argument_ref argument) const;
+
+    void impl_gradient (gradient_ref gradient,
+			const_argument_ref argument,
+			size_type functionId = 0) const;
+
+    void impl_jacobian (jacobian_ref jacobian,
+			const_argument_ref argument) const;
+
+    void impl_jacobian_structure (sparsityPattern_t& pattern) const;
+
+    void impl_vector_jacobian_product (gradient_ref result,
+				       const_argument_ref argument,
+				       const_vector_ref weights) const;
+
+  private:
+    /// \brief Overwrite the values of the jacobian with the gradients.
+    ///
+    /// \param jacobian jacobian with a compressed structure
+    /// \param argument point where the jacobian will be computed
+    /// \return false if a gradient does not fit in the structure of the
+    /// jacobian, true otherwise
+    bool updateInPlace (jacobian_ref jacobian,
+			const_argument_ref argument) const;
+
+    /// \brief Wrapped function.
+    boost::shared_ptr<const origin_t> origin_;
+
+    /// \brief Gradient buffer.
+    mutable gradient_t gradient_;
+
+    /// \brief Number of structural changes detected.
+    mutable size_type structureChanges_;
+  };
+
+  /// \brief Assemble the sparse jacobian of a function in place.
+  /// \param fct function to wrap.
+  template <typename U>
+  boost::shared_ptr<InPlaceJacobian<typename U::traits_t> >
+  inPlaceJacobian (boost::shared_ptr<U> fct)
+  {
+    return boost::make_shared<InPlaceJacobian<typename U::traits_t> > (fct);
+  }
+
+  /// @}
+
+} // end of namespace roboptim
+
+# include <roboptim/core/decorator/in-place-jacobian.hxx>
+#endif //! ROBOPTIM_CORE_DECORATOR_IN_PLACE_JACOBIAN_HH
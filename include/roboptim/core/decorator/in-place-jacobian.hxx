@@ -0,0 +1,153 @@
+// Copyright (C) 2026 by the RobOptim contributors.
+//
+// This file is part of the roboptim.
+//
+// roboptim is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// roboptim is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with roboptim.  If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef ROBOPTIM_CORE_DECORATOR_IN_PLACE_JACOBIAN_HXX
+# define ROBOPTIM_CORE_DECORATOR_IN_PLACE_JACOBIAN_HXX
+# include <algorithm>
+
+# include <roboptim/core/indent.hh>
+
+namespace roboptim
+{
+  template <typename T>
+  InPlaceJacobian<T>::InPlaceJacobian (boost::shared_ptr<const origin_t> fct)
+    : GenericDifferentiableFunction<T>
+      (fct->inputSize (), fct->outputSize (), fct->getName ()),
+      origin_ (fct),
+      gradient_ (fct->inputSize ()),
+      structureChanges_ (0)
+  {
+    // Gradients are then filled without reallocation.
+    gradient_.reserve (fct->inputSize ());
+  }
+
+  template <typename T>
+  InPlaceJacobian<T>::~InPlaceJacobian ()
+  {
+  }
+
+  template <typename T>
+  void
+  InPlaceJacobian<T>::impl_compute (result_ref result,
+				    const_argument_ref argument) const
+  {
+    (*origin_) (result, argument);
+  }
+
+  template <typename T>
+  void
+  InPlaceJacobian<T>::impl_gradient (gradient_ref gradient,
+				     const_argument_ref argument,
+				     size_type functionId) const
+  {
+    origin_->gradient (gradient, argument, functionId);
+  }
+
+  template <typename T>
+  bool
+  InPlaceJacobian<T>::updateInPlace (jacobian_ref jacobian,
+				     const_argument_ref argument) const
+  {
+    const int* outerIndex = jacobian.outerIndexPtr ();
+    const int* innerIndex = jacobian.innerIndexPtr ();
+    value_type* values = jacobian.valuePtr ();
+
+    // Entries of the structure missing from the gradients are zero.
+    std::fill (values, values + jacobian.nonZeros (), value_type (0));
+
+    for (size_type i = 0; i < this->outputSize (); ++i)
+      {
+	gradient_.setZero ();
+	origin_->gradient (gradient_, argument, i);
+
+	for (typename gradient_t::InnerIterator it (gradient_); it; ++it)
+	  {
+	    const int j = static_cast<int> (it.index ());
+	    const int outer = jacobian_t::IsRowMajor? static_cast<int> (i) : j;
+	    const int inner = jacobian_t::IsRowMajor? j : static_cast<int> (i);
+
+	    // Binary search of the entry in the outer vector.
+	    const int* end = innerIndex + outerIndex[outer + 1];
+	    const int* entry =
+	      std::lower_bound (innerIndex + outerIndex[outer], end, inner);
+
+	    if (entry == end || *entry != inner)
+	      {
+		// Explicit zeros outside the structure are harmless.
+		if (it.value () != value_type (0))
+		  return false;
+		continue;
+	      }
+
+	    values[entry - innerIndex] = it.value ();
+	  }
+      }
+    return true;
+  }
+
+  template <typename T>
+  void
+  InPlaceJacobian<T>::impl_jacobian (jacobian_ref jacobian,
+				     const_argument_ref argument) const
+  {
+    if (jacobian.isCompressed () && jacobian.nonZeros () > 0)
+      {
+	if (updateInPlace (jacobian, argument))
+	  return;
+
+	// The structure changed: compute the jacobian again.
+	++structureChanges_;
+	LOG4CXX_INFO (this->logger,
+		      "Sparse jacobian structure changed, assembling it"
+		      " again (" << structureChanges_
+		      << " change(s) so far)");
+      }
+
+    origin_->jacobian (jacobian, argument);
+  }
+
+  template <typename T>
+  void
+  InPlaceJacobian<T>::impl_jacobian_structure
+  (sparsityPattern_t& pattern) const
+  {
+    origin_->jacobianStructure (pattern);
+  }
+
+  template <typename T>
+  void
+  InPlaceJacobian<T>::impl_vector_jacobian_product
+  (gradient_ref result, const_argument_ref argument,
+   const_vector_ref weights) const
+  {
+    origin_->vectorJacobianProduct (result, argument, weights);
+  }
+
+  template <typename T>
+  std::ostream&
+  InPlaceJacobian<T>::print (std::ostream& o) const
+  {
+    o << "In-place jacobian:" << incindent
+      << iendl << "Sub-function: " << *origin_
+      << decindent;
+
+    return o;
+  }
+
+} // end of namespace roboptim
+
+#endif //! ROBOPTIM_CORE_DECORATOR_IN_PLACE_JACOBIAN_HXX
@@ -0,0 +1,165 @@
+// Copyright (C) 2026 by the RobOptim contributors.
+//
+// This file is part of the roboptim.
+//
+// roboptim is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// roboptim is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with roboptim.  If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef ROBOPTIM_CORE_DECORATOR_PRECISION_ADAPTER_HH
+# define ROBOPTIM_CORE_DECORATOR_PRECISION_ADAPTER_HH
+# include <roboptim/core/sys.hh>
+# include <roboptim/core/debug.hh>
+
+# include <ostream>
+
+# include <boost/shared_ptr.hpp>
+# include <boost/make_shared.hpp>
+# include <boost/static_assert.hpp>
+
+# include <roboptim/core/differentiable-function.hh>
+
+namespace roboptim
+{
+  /// \addtogroup roboptim_decorator
+  /// @{
+
+  /// \brief Change the floating-point precision of a function.
+  ///
+  /// The adapter exposes a differentiable function with the traits T,
+  /// while the computations are done by the wrapped function, whatever
+  /// its precision. Arguments and results are converted on the fly, using
+  /// buffers allocated once and for all by the constructor. This can be
+  /// used to hand a single-precision function to a double-precision
+  /// solver, and the reverse. This also turns a fixed-size function into
+  /// a function with dynamic sizes (e.g. to add it to a Problem).
+  ///
+  /// Both functions must use the same storage (dense or sparse).
+  ///
+  /// \tparam T traits of the adapter.
+  /// \tparam U type of the wrapped differentiable function.
+  template <typename T, typename U>
+  class PrecisionAdapter : public GenericDifferentiableFunction<T>
+  {
+  public:
+    ROBOPTIM_DIFFERENTIABLE_FUNCTION_FWD_TYPEDEFS_
+    (GenericDifferentiableFunction<T>);
+
+    /// \brief Traits of the wrapped function.
+    typedef typename U::traits_t adapteeTraits_t;
+
+    BOOST_STATIC_ASSERT (StorageTraits<T>::isDense
+			 == StorageTraits<adapteeTraits_t>::isDense);
+
+    /// \brief Wrap a function.
+    /// \param fct function to wrap.
+    explicit PrecisionAdapter (boost::shared_ptr<U> fct);
+    ~PrecisionAdapter ();
+
+    const boost::shared_ptr<U>& origin () const
+    {
+      return origin_;
+    }
+
+    boost::shared_ptr<U>& origin ()
+    {
+      return origin_;
+    }
+
+    /// \brief Display the function on the specified output stream.
+    ///
+    /// \param o output stream used for display
+    /// \return output stream
+    virtual std::ostream& print (std::ostream& o) const;
+
+  protected:
+    void impl_compute (result_ref result, const_argument_ref argument) const;
+
+    void impl_gradient (gradient_ref gradient,
+			const_argument_ref argument,
+			size_type functionId = 0) const;
+
+    void impl_jacobian (jacobian_ref jacobian,
+			const_argument_ref argument) const;
+
+    void impl_value_and_jacobian (result_ref result,
+				  jacobian_ref jacobian,
+				  const_argument_ref argument) const;
+
+    void impl_jacobian_structure (sparsityPattern_t& pattern) const;
+
+  private:
+    /// \brief Convert the argument to the precision of the wrapped
+    /// function.
+    void convertArgument (const_argument_ref argument) const;
+
+    /// \brief Wrapped function.
+    boost::shared_ptr<U> origin_;
+
+    /// \brief Argument buffer.
+    mutable typename U::argument_t argument_;
+
+    /// \brief Result buffer.
+    mutable typename U::result_t result_;
+
+    /// \brief Gradient buffer.
+    mutable typename U::gradient_t gradient_;
+
+    /// \brief Jacobian buffer.
+    mutable typename U::jacobian_t jacobian_;
+  };
+
+  /// \brief Wrap a function as a double-precision function.
+  /// \param fct function to wrap.
+  template <typename U>
+  boost::shared_ptr<PrecisionAdapter
+		    <typename StorageTraits<typename U::traits_t>
+		     ::doublePrecision_t, U> >
+  toDoublePrecision (boost::shared_ptr<U> fct)
+  {
+    return boost::make_shared<PrecisionAdapter
+			      <typename StorageTraits<typename U::traits_t>
+			       ::doublePrecision_t, U> > (fct);
+  }
+
+  /// \brief Wrap a function as a single-precision function.
+  /// \param fct function to wrap.
+  template <typename U>
+  boost::shared_ptr<PrecisionAdapter
+		    <typename StorageTraits<typename U::traits_t>
+		     ::singlePrecision_t, U> >
+  toSinglePrecision (boost::shared_ptr<U> fct)
+  {
+    return boost::make_shared<PrecisionAdapter
+			      <typename StorageTraits<typename U::traits_t>
+			       ::singlePrecision_t, U> > (fct);
+  }
+
+  /// \brief Wrap a fixed-size function as a function with dynamic sizes.
+  /// \param fct function to wrap.
+  template <typename U>
+  boost::shared_ptr<PrecisionAdapter
+		    <typename StorageTraits<typename U::traits_t>
+		     ::dynamicSize_t, U> >
+  toDynamicSize (boost::shared_ptr<U> fct)
+  {
+    return boost::make_shared<PrecisionAdapter
+			      <typename StorageTraits<typename U::traits_t>
+			       ::dynamicSize_t, U> > (fct);
+  }
+
+  /// @}
+
+} // end of namespace roboptim
+
+# include <roboptim/core/decorator/precision-adapter.hxx>
+#endif //! ROBOPTIM_CORE_DECORATOR_PRECISION_ADAPTER_HH
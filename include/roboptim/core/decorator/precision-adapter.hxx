@@ -0,0 +1,151 @@
+// Copyright (C) 2026 by the RobOptim contributors.
+//
+// This file is part of the roboptim.
+//
+// roboptim is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// roboptim is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with roboptim.  If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef ROBOPTIM_CORE_DECORATOR_PRECISION_ADAPTER_HXX
+# define ROBOPTIM_CORE_DECORATOR_PRECISION_ADAPTER_HXX
+
+# include <roboptim/core/indent.hh>
+
+namespace roboptim
+{
+  template <typename T, typename U>
+  PrecisionAdapter<T, U>::PrecisionAdapter (boost::shared_ptr<U> fct)
+    : GenericDifferentiableFunction<T>
+      (fct->inputSize (), fct->outputSize (), fct->getName ()),
+      origin_ (fct),
+      argument_ (fct->inputSize ()),
+      result_ (fct->outputSize ()),
+      gradient_ (fct->inputSize ()),
+      jacobian_ (fct->outputSize (), fct->inputSize ())
+  {
+    argument_.setZero ();
+    result_.setZero ();
+    gradient_.setZero ();
+    jacobian_.setZero ();
+  }
+
+  template <typename T, typename U>
+  PrecisionAdapter<T, U>::~PrecisionAdapter ()
+  {
+  }
+
+  template <typename T, typename U>
+  void
+  PrecisionAdapter<T, U>::convertArgument (const_argument_ref argument) const
+  {
+    argument_ = argument.template cast<typename U::value_type> ();
+  }
+
+  template <typename T, typename U>
+  void
+  PrecisionAdapter<T, U>::impl_compute (result_ref result,
+					const_argument_ref argument) const
+  {
+    convertArgument (argument);
+    (*origin_) (result_, argument_);
+    result = result_.template cast<value_type> ();
+  }
+
+  template <typename T, typename U>
+  void
+  PrecisionAdapter<T, U>::impl_gradient (gradient_ref gradient,
+					 const_argument_ref argument,
+					 size_type functionId) const
+  {
+    convertArgument (argument);
+    gradient_.setZero ();
+    origin_->gradient (gradient_, argument_, functionId);
+
+#ifndef ROBOPTIM_DO_NOT_CHECK_ALLOCATION
+    bool cur_malloc_allowed = is_malloc_allowed ();
+    set_is_malloc_allowed (true);
+#endif //! ROBOPTIM_DO_NOT_CHECK_ALLOCATION
+
+    // Sparse gradients may need to allocate their nonzeros.
+    gradient = gradient_.template cast<value_type> ();
+
+#ifndef ROBOPTIM_DO_NOT_CHECK_ALLOCATION
+    set_is_malloc_allowed (cur_malloc_allowed);
+#endif //! ROBOPTIM_DO_NOT_CHECK_ALLOCATION
+  }
+
+  template <typename T, typename U>
+  void
+  PrecisionAdapter<T, U>::impl_jacobian (jacobian_ref jacobian,
+					 const_argument_ref argument) const
+  {
+    convertArgument (argument);
+    origin_->jacobian (jacobian_, argument_);
+
+#ifndef ROBOPTIM_DO_NOT_CHECK_ALLOCATION
+    bool cur_malloc_allowed = is_malloc_allowed ();
+    set_is_malloc_allowed (true);
+#endif //! ROBOPTIM_DO_NOT_CHECK_ALLOCATION
+
+    // Sparse jacobians may need to allocate their nonzeros.
+    jacobian = jacobian_.template cast<value_type> ();
+
+#ifndef ROBOPTIM_DO_NOT_CHECK_ALLOCATION
+    set_is_malloc_allowed (cur_malloc_allowed);
+#endif //! ROBOPTIM_DO_NOT_CHECK_ALLOCATION
+  }
+
+  template <typename T, typename U>
+  void
+  PrecisionAdapter<T, U>::impl_value_and_jacobian
+  (result_ref result, jacobian_ref jacobian, const_argument_ref argument)
+    const
+  {
+    convertArgument (argument);
+    origin_->valueAndJacobian (result_, jacobian_, argument_);
+    result = result_.template cast<value_type> ();
+
+#ifndef ROBOPTIM_DO_NOT_CHECK_ALLOCATION
+    bool cur_malloc_allowed = is_malloc_allowed ();
+    set_is_malloc_allowed (true);
+#endif //! ROBOPTIM_DO_NOT_CHECK_ALLOCATION
+
+    jacobian = jacobian_.template cast<value_type> ();
+
+#ifndef ROBOPTIM_DO_NOT_CHECK_ALLOCATION
+    set_is_malloc_allowed (cur_malloc_allowed);
+#endif //! ROBOPTIM_DO_NOT_CHECK_ALLOCATION
+  }
+
+  template <typename T, typename U>
+  void
+  PrecisionAdapter<T, U>::impl_jacobian_structure
+  (sparsityPattern_t& pattern) const
+  {
+    // Patterns do not depend on the precision.
+    origin_->jacobianStructure (pattern);
+  }
+
+  template <typename T, typename U>
+  std::ostream&
+  PrecisionAdapter<T, U>::print (std::ostream& o) const
+  {
+    o << "Precision adapter:" << incindent
+      << iendl << "Sub-function: " << *origin_
+      << decindent;
+
+    return o;
+  }
+
+} // end of namespace roboptim
+
+#endif //! ROBOPTIM_CORE_DECORATOR_PRECISION_ADAPTER_HXX
@@ -0,0 +1,199 @@
+// Copyright (C) 2026 by the RobOptim contributors.
+//
+// This file is part of the roboptim.
+//
+// roboptim is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// roboptim is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with roboptim.  If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef ROBOPTIM_CORE_DECORATOR_REVERSE_MODE_DIFFERENTIATION_HH
+# define ROBOPTIM_CORE_DECORATOR_REVERSE_MODE_DIFFERENTIATION_HH
+# include <roboptim/core/sys.hh>
+# include <roboptim/core/debug.hh>
+
+# include <ostream>
+# include <string>
+# include <vector>
+
+# include <boost/shared_ptr.hpp>
+# include <boost/make_shared.hpp>
+# include <boost/mpl/bool.hpp>
+
+# include <roboptim/core/differentiable-function.hh>
+# include <roboptim/core/detail/tape.hh>
+
+namespace roboptim
+{
+  /// \addtogroup roboptim_decorator
+  /// @{
+
+  /// \brief Differentiate a function with reverse-mode automatic
+  /// differentiation.
+  ///
+  /// The functor follows the same contract as for
+  /// GenericForwardModeDifferentiation, i.e. it is written generically
+  /// over the scalar type.
+  ///
+  /// The first time derivatives are requested, the functor is evaluated
+  /// once with scalars recording their operations on a tape
+  /// (detail::Tape). The full gradient of an output is then obtained by a
+  /// single reverse sweep over the tape, whose cost is a small multiple of
+  /// a function evaluation whatever the input size: this is the method of
+  /// choice for scalar objectives with many inputs. A Jacobian costs one
+  /// reverse sweep per output, a vector-jacobian product a single one.
+  ///
+  /// The tape is kept from one call to the next and simply replayed at the
+  /// new point, without calling the functor. Comparisons are recorded with
+  /// their outcome: if one of them changes, i.e. if the control flow of
+  /// the functor changed, the tape is recorded again.
+  ///
+  /// \warning branches on values converted back to plain scalars cannot
+  /// be detected, and would silently reuse a stale tape.
+  ///
+  /// \tparam T function traits.
+  /// \tparam F functor type.
+  template <typename T, typename F>
+  class GenericReverseModeDifferentiation
+    : public GenericDifferentiableFunction<T>
+  {
+  public:
+    ROBOPTIM_DIFFERENTIABLE_FUNCTION_FWD_TYPEDEFS_
+    (GenericDifferentiableFunction<T>);
+
+    /// \brief Functor type.
+    typedef F functor_t;
+
+    /// \brief Tape type.
+    typedef detail::Tape<value_type> tape_t;
+
+    /// \brief Scalar type recording its operations on the tape.
+    typedef typename tape_t::scalar_t tapeScalar_t;
+
+    /// \brief Vector of recording scalars.
+    typedef Eigen::Matrix<tapeScalar_t, Eigen::Dynamic, 1> tapeVector_t;
+
+    /// \brief Wrap a functor.
+    /// \param functor generic implementation of the function.
+    /// \param inputSize input size (argument size)
+    /// \param outputSize output size (result size)
+    /// \param name function's name
+    GenericReverseModeDifferentiation (const F& functor,
+				       size_type inputSize,
+				       size_type outputSize = 1,
+				       std::string name = std::string ());
+    ~GenericReverseModeDifferentiation ();
+
+    const F& functor () const
+    {
+      return functor_;
+    }
+
+    /// \brief Recorded tape.
+    const tape_t& tape () const
+    {
+      return tape_;
+    }
+
+    /// \brief Number of times the tape has been recorded.
+    size_type recordings () const
+    {
+      return recordings_;
+    }
+
+    /// \brief Display the function on the specified output stream.
+    ///
+    /// \param o output stream used for display
+    /// \return output stream
+    virtual std::ostream& print (std::ostream& o) const;
+
+  protected:
+    void impl_compute (result_ref result, const_argument_ref argument) const;
+
+    void impl_gradient (gradient_ref gradient,
+			const_argument_ref argument,
+			size_type functionId = 0) const;
+
+    void impl_jacobian (jacobian_ref jacobian,
+			const_argument_ref argument) const;
+
+    void impl_value_and_jacobian (result_ref result,
+				  jacobian_ref jacobian,
+				  const_argument_ref argument) const;
+
+    /// \brief Product of a vector with the jacobian, computed with a
+    /// single reverse sweep whatever the output size.
+    void impl_vector_jacobian_product (gradient_ref result,
+				       const_argument_ref argument,
+				       const_vector_ref weights) const;
+
+  private:
+    /// \brief Replay the tape at a new point, recording it again if it
+    /// was never recorded or if the control flow changed.
+    void prepareTape (const_argument_ref argument) const;
+
+    /// \brief Dense Jacobian assembly.
+    template <typename J>
+    void assembleJacobian (J& jacobian, boost::mpl::true_) const;
+
+    /// \brief Sparse Jacobian assembly, only storing nonzero derivatives.
+    template <typename J>
+    void assembleJacobian (J& jacobian, boost::mpl::false_) const;
+
+  private:
+    /// \brief Generic implementation of the function.
+    F functor_;
+
+    /// \brief Tape of the functor's operations.
+    mutable tape_t tape_;
+
+    /// \brief Whether the tape has been recorded.
+    mutable bool recorded_;
+
+    /// \brief Number of recordings.
+    mutable size_type recordings_;
+
+    /// \brief Recording argument buffer.
+    mutable tapeVector_t x_;
+
+    /// \brief Recording result buffer.
+    mutable tapeVector_t y_;
+
+    /// \brief Triplet buffer used by the sparse Jacobian assembly.
+    mutable std::vector<Eigen::Triplet<value_type, size_type> > triplets_;
+  };
+
+  /// \brief Differentiate a generic functor with reverse-mode automatic
+  /// differentiation.
+  ///
+  /// \tparam T function traits.
+  /// \param functor generic implementation of the function.
+  /// \param inputSize input size (argument size)
+  /// \param outputSize output size (result size)
+  /// \param name function's name
+  template <typename T, typename F>
+  boost::shared_ptr<GenericReverseModeDifferentiation<T, F> >
+  reverseModeDifferentiation
+  (const F& functor,
+   typename GenericFunction<T>::size_type inputSize,
+   typename GenericFunction<T>::size_type outputSize = 1,
+   std::string name = std::string ())
+  {
+    return boost::make_shared<GenericReverseModeDifferentiation<T, F> >
+      (functor, inputSize, outputSize, name);
+  }
+
+  /// @}
+
+} // end of namespace roboptim
+
+# include <roboptim/core/decorator/reverse-mode-differentiation.hxx>
+#endif //! ROBOPTIM_CORE_DECORATOR_REVERSE_MODE_DIFFERENTIATION_HH
@@ -0,0 +1,209 @@
+// Copyright (C) 2026 by the RobOptim contributors.
+//
+// This file is part of the roboptim.
+//
+// roboptim is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// roboptim is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with roboptim.  If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef ROBOPTIM_CORE_DECORATOR_REVERSE_MODE_DIFFERENTIATION_HXX
+# define ROBOPTIM_CORE_DECORATOR_REVERSE_MODE_DIFFERENTIATION_HXX
+
+# include <roboptim/core/indent.hh>
+
+namespace roboptim
+{
+  template <typename T, typename F>
+  GenericReverseModeDifferentiation<T, F>::GenericReverseModeDifferentiation
+  (const F& functor, size_type inputSize, size_type outputSize,
+   std::string name)
+    : GenericDifferentiableFunction<T> (inputSize, outputSize, name),
+      functor_ (functor),
+      tape_ (),
+      recorded_ (false),
+      recordings_ (0),
+      x_ (inputSize),
+      y_ (outputSize),
+      triplets_ ()
+  {
+  }
+
+  template <typename T, typename F>
+  GenericReverseModeDifferentiation<T, F>::
+  ~GenericReverseModeDifferentiation ()
+  {
+  }
+
+  template <typename T, typename F>
+  void
+  GenericReverseModeDifferentiation<T, F>::prepareTape
+  (const_argument_ref argument) const
+  {
+    if (recorded_ && tape_.forward (argument))
+      return;
+
+#ifndef ROBOPTIM_DO_NOT_CHECK_ALLOCATION
+    bool cur_malloc_allowed = is_malloc_allowed ();
+    set_is_malloc_allowed (true);
+#endif //! ROBOPTIM_DO_NOT_CHECK_ALLOCATION
+
+    tape_.clear ();
+    for (size_type j = 0; j < this->inputSize (); ++j)
+      x_[j] = tape_.input (argument[j]);
+
+    functor_ (y_, x_);
+
+    for (size_type i = 0; i < this->outputSize (); ++i)
+      tape_.output (y_[i]);
+
+#ifndef ROBOPTIM_DO_NOT_CHECK_ALLOCATION
+    set_is_malloc_allowed (cur_malloc_allowed);
+#endif //! ROBOPTIM_DO_NOT_CHECK_ALLOCATION
+
+    recorded_ = true;
+    ++recordings_;
+  }
+
+  template <typename T, typename F>
+  void
+  GenericReverseModeDifferentiation<T, F>::impl_compute
+  (result_ref result, const_argument_ref argument) const
+  {
+    functor_ (result, argument);
+  }
+
+  template <typename T, typename F>
+  void
+  GenericReverseModeDifferentiation<T, F>::impl_gradient
+  (gradient_ref gradient, const_argument_ref argument, size_type functionId)
+    const
+  {
+    prepareTape (argument);
+    tape_.reverse (static_cast<typename tape_t::index_t> (functionId));
+
+    gradient.setZero ();
+    for (size_type j = 0; j < this->inputSize (); ++j)
+      {
+	const value_type d =
+	  tape_.adjoint (static_cast<typename tape_t::index_t> (j));
+	if (d != 0.)
+	  gradient.coeffRef (j) = d;
+      }
+  }
+
+  template <typename T, typename F>
+  template <typename J>
+  void
+  GenericReverseModeDifferentiation<T, F>::assembleJacobian
+  (J& jacobian, boost::mpl::true_) const
+  {
+    for (size_type i = 0; i < this->outputSize (); ++i)
+      {
+	tape_.reverse (static_cast<typename tape_t::index_t> (i));
+	for (size_type j = 0; j < this->inputSize (); ++j)
+	  jacobian (i, j) =
+	    tape_.adjoint (static_cast<typename tape_t::index_t> (j));
+      }
+  }
+
+  template <typename T, typename F>
+  template <typename J>
+  void
+  GenericReverseModeDifferentiation<T, F>::assembleJacobian
+  (J& jacobian, boost::mpl::false_) const
+  {
+    typedef Eigen::Triplet<value_type, size_type> triplet_t;
+
+    triplets_.clear ();
+    for (size_type i = 0; i < this->outputSize (); ++i)
+      {
+	tape_.reverse (static_cast<typename tape_t::index_t> (i));
+	for (size_type j = 0; j < this->inputSize (); ++j)
+	  {
+	    const value_type d =
+	      tape_.adjoint (static_cast<typename tape_t::index_t> (j));
+	    if (d != 0.)
+	      triplets_.push_back (triplet_t (i, j, d));
+	  }
+      }
+
+#ifndef ROBOPTIM_DO_NOT_CHECK_ALLOCATION
+    bool cur_malloc_allowed = is_malloc_allowed ();
+    set_is_malloc_allowed (true);
+#endif //! ROBOPTIM_DO_NOT_CHECK_ALLOCATION
+
+    jacobian.setFromTriplets (triplets_.begin (), triplets_.end ());
+
+#ifndef ROBOPTIM_DO_NOT_CHECK_ALLOCATION
+    set_is_malloc_allowed (cur_malloc_allowed);
+#endif //! ROBOPTIM_DO_NOT_CHECK_ALLOCATION
+  }
+
+  template <typename T, typename F>
+  void
+  GenericReverseModeDifferentiation<T, F>::impl_jacobian
+  (jacobian_ref jacobian, const_argument_ref argument) const
+  {
+    prepareTape (argument);
+    assembleJacobian (jacobian,
+		      boost::mpl::bool_<StorageTraits<T>::isDense> ());
+  }
+
+  template <typename T, typename F>
+  void
+  GenericReverseModeDifferentiation<T, F>::impl_value_and_jacobian
+  (result_ref result, jacobian_ref jacobian, const_argument_ref argument)
+    const
+  {
+    prepareTape (argument);
+    assembleJacobian (jacobian,
+		      boost::mpl::bool_<StorageTraits<T>::isDense> ());
+
+    // The values are those of the last replay of the tape.
+    for (size_type i = 0; i < this->outputSize (); ++i)
+      result[i] = tape_.value (static_cast<typename tape_t::index_t> (i));
+  }
+
+  template <typename T, typename F>
+  void
+  GenericReverseModeDifferentiation<T, F>::impl_vector_jacobian_product
+  (gradient_ref result, const_argument_ref argument,
+   const_vector_ref weights) const
+  {
+    prepareTape (argument);
+    tape_.reverse (weights);
+
+    result.setZero ();
+    for (size_type j = 0; j < this->inputSize (); ++j)
+      {
+	const value_type d =
+	  tape_.adjoint (static_cast<typename tape_t::index_t> (j));
+	if (d != 0.)
+	  result.coeffRef (j) = d;
+      }
+  }
+
+  template <typename T, typename F>
+  std::ostream&
+  GenericReverseModeDifferentiation<T, F>::print (std::ostream& o) const
+  {
+    o << "Reverse-mode differentiation";
+    if (recorded_)
+      o << " (" << tape_.size () << " recorded operations)";
+    if (!this->getName ().empty ())
+      o << ":" << incindent << iendl << this->getName () << decindent;
+    return o;
+  }
+
+} // end of namespace roboptim
+
+#endif //! ROBOPTIM_CORE_DECORATOR_REVERSE_MODE_DIFFERENTIATION_HXX
@@ -46,26 +46,46 @@ namespace roboptim
 
     ROBOPTIM_CORE_DECLARE_PRECISION (GenericFunction<EigenMatrixDense>, 1);
     ROBOPTIM_CORE_DECLARE_PRECISION (GenericFunction<EigenMatrixSparse>, 1);
+    ROBOPTIM_CORE_DECLARE_PRECISION
+    (GenericFunction<EigenMatrixDenseFloat>, 1);
+    ROBOPTIM_CORE_DECLARE_PRECISION
+    (GenericFunction<EigenMatrixSparseFloat>, 1);
 
     ROBOPTIM_CORE_DECLARE_PRECISION
     (GenericDifferentiableFunction<EigenMatrixDense>, 2);
     ROBOPTIM_CORE_DECLARE_PRECISION
     (GenericDifferentiableFunction<EigenMatrixSparse>, 2);
+    ROBOPTIM_CORE_DECLARE_PRECISION
+    (GenericDifferentiableFunction<EigenMatrixDenseFloat>, 2);
+    ROBOPTIM_CORE_DECLARE_PRECISION
+    (GenericDifferentiableFunction<EigenMatrixSparseFloat>, 2);
 
     ROBOPTIM_CORE_DECLARE_PRECISION
     (GenericTwiceDifferentiableFunction<EigenMatrixDense>, 3);
     ROBOPTIM_CORE_DECLARE_PRECISION
     (GenericTwiceDifferentiableFunction<EigenMatrixSparse>, 3);
+    ROBOPTIM_CORE_DECLARE_PRECISION
+    (GenericTwiceDifferentiableFunction<EigenMatrixDenseFloat>, 3);
+    ROBOPTIM_CORE_DECLARE_PRECISION
+    (GenericTwiceDifferentiableFunction<EigenMatrixSparseFloat>, 3);
 
     ROBOPTIM_CORE_DECLARE_PRECISION
     (GenericQuadraticFunction<EigenMatrixDense>, 3);
     ROBOPTIM_CORE_DECLARE_PRECISION
     (GenericQuadraticFunction<EigenMatrixSparse>, 3);
+    ROBOPTIM_CORE_DECLARE_PRECISION
+    (GenericQuadraticFunction<EigenMatrixDenseFloat>, 3);
+    ROBOPTIM_CORE_DECLARE_PRECISION
+    (GenericQuadraticFunction<EigenMatrixSparseFloat>, 3);
 
     ROBOPTIM_CORE_DECLARE_PRECISION
     (GenericLinearFunction<EigenMatrixDense>, 4);
     ROBOPTIM_CORE_DECLARE_PRECISION
     (GenericLinearFunction<EigenMatrixSparse>, 4);
+    ROBOPTIM_CORE_DECLARE_PRECISION
+    (GenericLinearFunction<EigenMatrixDenseFloat>, 4);
+    ROBOPTIM_CORE_DECLARE_PRECISION
+    (GenericLinearFunction<EigenMatrixSparseFloat>, 4);
 
 
 
@@ -112,6 +132,12 @@ namespace roboptim
     ROBOPTIM_CORE_DECLARE_AUTOPROMOTE
     (GenericNumericQuadraticFunction<EigenMatrixSparse>,
      GenericQuadraticFunction<EigenMatrixSparse>);
+    ROBOPTIM_CORE_DECLARE_AUTOPROMOTE
+    (GenericNumericQuadraticFunction<EigenMatrixDenseFloat>,
+     GenericQuadraticFunction<EigenMatrixDenseFloat>);
+    ROBOPTIM_CORE_DECLARE_AUTOPROMOTE
+    (GenericNumericQuadraticFunction<EigenMatrixSparseFloat>,
+     GenericQuadraticFunction<EigenMatrixSparseFloat>);
 
     ROBOPTIM_CORE_DECLARE_AUTOPROMOTE
     (GenericNumericLinearFunction<EigenMatrixDense>,
@@ -119,6 +145,12 @@ namespace roboptim
     ROBOPTIM_CORE_DECLARE_AUTOPROMOTE
     (GenericNumericLinearFunction<EigenMatrixSparse>,
      GenericLinearFunction<EigenMatrixSparse>);
+    ROBOPTIM_CORE_DECLARE_AUTOPROMOTE
+    (GenericNumericLinearFunction<EigenMatrixDenseFloat>,
+     GenericLinearFunction<EigenMatrixDenseFloat>);
+    ROBOPTIM_CORE_DECLARE_AUTOPROMOTE
+    (GenericNumericLinearFunction<EigenMatrixSparseFloat>,
+     GenericLinearFunction<EigenMatrixSparseFloat>);
 
 
     ROBOPTIM_CORE_DECLARE_AUTOPROMOTE
@@ -127,6 +159,12 @@ namespace roboptim
     ROBOPTIM_CORE_DECLARE_AUTOPROMOTE
     (GenericConstantFunction<EigenMatrixSparse>,
      GenericLinearFunction<EigenMatrixSparse>);
+    ROBOPTIM_CORE_DECLARE_AUTOPROMOTE
+    (GenericConstantFunction<EigenMatrixDenseFloat>,
+     GenericLinearFunction<EigenMatrixDenseFloat>);
+    ROBOPTIM_CORE_DECLARE_AUTOPROMOTE
+    (GenericConstantFunction<EigenMatrixSparseFloat>,
+     GenericLinearFunction<EigenMatrixSparseFloat>);
 
     ROBOPTIM_CORE_DECLARE_AUTOPROMOTE
     (GenericIdentityFunction<EigenMatrixDense>,
@@ -134,6 +172,12 @@ namespace roboptim
     ROBOPTIM_CORE_DECLARE_AUTOPROMOTE
     (GenericIdentityFunction<EigenMatrixSparse>,
      GenericLinearFunction<EigenMatrixSparse>);
+    ROBOPTIM_CORE_DECLARE_AUTOPROMOTE
+    (GenericIdentityFunction<EigenMatrixDenseFloat>,
+     GenericLinearFunction<EigenMatrixDenseFloat>);
+    ROBOPTIM_CORE_DECLARE_AUTOPROMOTE
+    (GenericIdentityFunction<EigenMatrixSparseFloat>,
+     GenericLinearFunction<EigenMatrixSparseFloat>);
 
     ROBOPTIM_CORE_DECLARE_AUTOPROMOTE
     (Cos<EigenMatrixDense>,
@@ -141,6 +185,12 @@ namespace roboptim
     ROBOPTIM_CORE_DECLARE_AUTOPROMOTE
     (Cos<EigenMatrixSparse>,
      GenericDifferentiableFunction<EigenMatrixSparse>);
+    ROBOPTIM_CORE_DECLARE_AUTOPROMOTE
+    (Cos<EigenMatrixDenseFloat>,
+     GenericDifferentiableFunction<EigenMatrixDenseFloat>);
+    ROBOPTIM_CORE_DECLARE_AUTOPROMOTE
+    (Cos<EigenMatrixSparseFloat>,
+     GenericDifferentiableFunction<EigenMatrixSparseFloat>);
 
     ROBOPTIM_CORE_DECLARE_AUTOPROMOTE
     (Sin<EigenMatrixDense>,
@@ -148,6 +198,12 @@ namespace roboptim
     ROBOPTIM_CORE_DECLARE_AUTOPROMOTE
     (Sin<EigenMatrixSparse>,
      GenericDifferentiableFunction<EigenMatrixSparse>);
+    ROBOPTIM_CORE_DECLARE_AUTOPROMOTE
+    (Sin<EigenMatrixDenseFloat>,
+     GenericDifferentiableFunction<EigenMatrixDenseFloat>);
+    ROBOPTIM_CORE_DECLARE_AUTOPROMOTE
+    (Sin<EigenMatrixSparseFloat>,
+     GenericDifferentiableFunction<EigenMatrixSparseFloat>);
 
 
 
@@ -0,0 +1,187 @@
+// Copyright (C) 2026 by the RobOptim contributors.
+//
+// This file is part of the roboptim.
+//
+// roboptim is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// roboptim is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with roboptim.  If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef ROBOPTIM_CORE_DETAIL_EXPRESSION_NODE_HH
+# define ROBOPTIM_CORE_DETAIL_EXPRESSION_NODE_HH
+
+# include <vector>
+
+# include <boost/mpl/bool.hpp>
+# include <boost/shared_ptr.hpp>
+# include <boost/type_traits/is_base_of.hpp>
+
+# include <roboptim/core/fwd.hh>
+# include <roboptim/core/function.hh>
+
+namespace roboptim
+{
+  namespace detail
+  {
+    /// \brief Node of an expression of operators.
+    ///
+    /// Operators (see roboptim_operator) implement this interface next to
+    /// the function one: it lists, rewires, copies and compiles their
+    /// operands. Functions that do not implement it are the leaves of
+    /// the expression. It is only used through GraphTraversal, by the
+    /// function graph (see GenericFunctionGraph) and the compiled function
+    /// (see GenericCompiledFunction).
+    ///
+    /// \tparam T function traits.
+    template <typename T>
+    class GenericExpressionNode
+    {
+    public:
+      /// \brief Function type.
+      typedef GenericFunction<T> function_t;
+
+      /// \brief Type of the list of functions a node is built on.
+      typedef std::vector<const function_t*> children_t;
+
+      /// \brief Type of a function replacing an operand.
+      typedef boost::shared_ptr<function_t> childShPtr_t;
+
+      /// \brief Type of a replaced operand.
+      typedef boost::shared_ptr<const function_t> constChildShPtr_t;
+
+      /// \brief Type of the compiler of an expression.
+      typedef FunctionCompiler<T> compiler_t;
+
+      virtual ~GenericExpressionNode ()
+      {}
+
+    protected:
+      /// \brief Children listing.
+      ///
+      /// Append the operands with the same traits (see
+      /// detail::appendChild).
+      /// \param children children will be appended to this vector
+      virtual void impl_children (children_t& children) const = 0;
+
+      /// \brief Operand replacement.
+      ///
+      /// Replace the operands equal to child (see detail::replaceChild).
+      /// \param child operand to replace
+      /// \param replacement new operand
+      /// \param replaced set to the replaced operand, if any
+      virtual void impl_replace_child (const function_t* child,
+				       const childShPtr_t& replacement,
+				       constChildShPtr_t& replaced) = 0;
+
+      /// \brief Copy.
+      ///
+      /// \return copy of the node, sharing its operands
+      virtual childShPtr_t impl_clone () const = 0;
+
+      /// \brief Instructions emission.
+      ///
+      /// Emit the instructions computing the result of the node from the
+      /// ones of its operands. The default implementation returns -1,
+      /// i.e. the node is evaluated as a whole.
+      /// \param compiler compiler of the expression.
+      /// \param argument slot of the argument of the node.
+      /// \return slot of the result of the node, -1 if it is not
+      /// compiled.
+      virtual int impl_compile (compiler_t&, int) const
+      {
+	return -1;
+      }
+
+    private:
+      friend struct GraphTraversal;
+    };
+
+    /// \brief Append an operand with the same traits to a list of
+    /// children.
+    template <typename T, typename C>
+    void appendChild (std::vector<const GenericFunction<T>*>& children,
+		      const C* child, boost::mpl::true_)
+    {
+      if (child)
+	children.push_back (child);
+    }
+
+    /// \brief Operands with other traits are not listed.
+    template <typename T, typename C>
+    void appendChild (std::vector<const GenericFunction<T>*>&,
+		      const C*, boost::mpl::false_)
+    {
+    }
+
+    /// \brief Append an operand to the children of an operator, if it
+    /// has the same traits.
+    /// \param children list of children.
+    /// \param child operand of the operator.
+    template <typename T, typename C>
+    void appendChild (std::vector<const GenericFunction<T>*>& children,
+		      const boost::shared_ptr<C>& child)
+    {
+      appendChild (children, child.get (),
+		   boost::mpl::bool_<boost::is_base_of
+		   <GenericFunction<T>, C>::value> ());
+    }
+
+    /// \brief Replace an operand with the same traits.
+    template <typename T, typename C>
+    void replaceChild (boost::shared_ptr<C>& operand,
+		       const GenericFunction<T>* child,
+		       const boost::shared_ptr<GenericFunction<T> >&
+		       replacement,
+		       boost::shared_ptr<const GenericFunction<T> >& replaced,
+		       boost::mpl::true_)
+    {
+      if (operand.get () != child)
+	return;
+
+      boost::shared_ptr<C> r = boost::dynamic_pointer_cast<C> (replacement);
+      if (!r)
+	return;
+
+      replaced = operand;
+      operand = r;
+    }
+
+    /// \brief Operands with other traits are not replaced.
+    template <typename T, typename C>
+    void replaceChild (boost::shared_ptr<C>&,
+		       const GenericFunction<T>*,
+		       const boost::shared_ptr<GenericFunction<T> >&,
+		       boost::shared_ptr<const GenericFunction<T> >&,
+		       boost::mpl::false_)
+    {
+    }
+
+    /// \brief Replace an operand of an operator, if it is the given
+    /// child and the replacement has its type.
+    /// \param operand operand of the operator.
+    /// \param child operand to replace.
+    /// \param replacement new operand.
+    /// \param replaced set to the replaced operand, if it is replaced.
+    template <typename T, typename C>
+    void replaceChild (boost::shared_ptr<C>& operand,
+		       const GenericFunction<T>* child,
+		       const boost::shared_ptr<GenericFunction<T> >&
+		       replacement,
+		       boost::shared_ptr<const GenericFunction<T> >& replaced)
+    {
+      replaceChild (operand, child, replacement, replaced,
+		    boost::mpl::bool_<boost::is_base_of
+		    <GenericFunction<T>, C>::value> ());
+    }
+  } // end of namespace detail
+} // end of namespace roboptim
+
+#endif //! ROBOPTIM_CORE_DETAIL_EXPRESSION_NODE_HH
@@ -0,0 +1,265 @@
+// Copyright (C) 2026 by the RobOptim contributors.
+//
+// This file is part of the roboptim.
+//
+// roboptim is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// roboptim is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with roboptim.  If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef ROBOPTIM_CORE_DETAIL_FUNCTION_COMPILER_HH
+# define ROBOPTIM_CORE_DETAIL_FUNCTION_COMPILER_HH
+
+# include <map>
+# include <utility>
+# include <vector>
+
+# include <boost/mpl/bool.hpp>
+# include <boost/shared_ptr.hpp>
+# include <boost/type_traits/is_base_of.hpp>
+
+# include <roboptim/core/function.hh>
+# include <roboptim/core/detail/graph-traversal.hh>
+
+namespace roboptim
+{
+  namespace detail
+  {
+    /// \brief Instructions of a compiled function.
+    struct CompiledOperation
+    {
+      enum type
+	{
+	  /// \brief Evaluation of a function that is not compiled.
+	  LEAF,
+
+	  // Element-wise operations.
+	  ADD,
+	  SUB,
+	  MUL,
+
+	  /// \brief Product with a constant.
+	  SCALE,
+
+	  /// \brief Stack of two results.
+	  CONCATENATE,
+
+	  /// \brief Rows picked from a result, or constants.
+	  GATHER
+	};
+    };
+
+    /// \brief Compile an expression of operators to a flat list of
+    /// instructions.
+    ///
+    /// Every intermediate result is a slot holding a value and its
+    /// jacobian with respect to the argument of the whole expression (slot
+    /// 0). Operators (see roboptim_operator) emit their instructions
+    /// through GenericExpressionNode::impl_compile; other functions, and
+    /// operators with operands of other traits, are evaluated as a whole
+    /// by a LEAF instruction, the chain rule being applied if their
+    /// argument is not the one of the expression. A node reached several
+    /// times with the same argument is only compiled once.
+    ///
+    /// The compiler only lays out the instructions and the memory they
+    /// need: they are interpreted by GenericCompiledFunction.
+    ///
+    /// \tparam T function traits.
+    template <typename T>
+    class FunctionCompiler
+    {
+    public:
+      typedef GenericFunction<T> function_t;
+      typedef typename function_t::value_type value_type;
+      typedef typename function_t::size_type size_type;
+
+      /// \brief Index of a slot.
+      typedef int slot_t;
+
+      /// \brief Intermediate result.
+      struct Slot
+      {
+	/// \brief Size of the value.
+	size_type size;
+
+	/// \brief Offset of the value in the arena.
+	size_type value;
+
+	/// \brief Offset of the jacobian in the arena, -1 for the
+	/// argument of the expression (identity).
+	size_type jacobian;
+      };
+
+      /// \brief Compiled instruction.
+      struct Instruction
+      {
+	/// \brief Leaf function, null for other instructions.
+	const function_t* function;
+
+	/// \brief Constant of SCALE instructions.
+	value_type constant;
+
+	/// \brief Offset of the indices and constants of GATHER
+	/// instructions.
+	size_type data;
+
+	/// \brief Slot of the result.
+	slot_t result;
+
+	/// \brief Slot of the first operand (argument of LEAF).
+	slot_t lhs;
+
+	/// \brief Slot of the second operand, -1 if none.
+	slot_t rhs;
+
+	/// \brief Operation (CompiledOperation::type).
+	unsigned char op;
+      };
+
+      typedef std::vector<Slot> slots_t;
+      typedef std::vector<Instruction> instructions_t;
+
+      /// \brief Start a compilation.
+      /// \param inputSize input size of the expression.
+      explicit FunctionCompiler (size_type inputSize);
+
+      /// \brief Compile a node of the expression.
+      ///
+      /// \throw std::runtime_error if the node has to be evaluated as a
+      /// whole but is not differentiable.
+      /// \param node node to compile.
+      /// \param argument slot of its argument.
+      /// \return slot of its result.
+      slot_t compile (const function_t* node, slot_t argument);
+
+      /// \brief Whether an operand can be compiled, i.e. has the same
+      /// traits.
+      template <typename C>
+      static bool compatible (const boost::shared_ptr<C>&)
+      {
+	return boost::is_base_of<function_t, C>::value;
+      }
+
+      /// \brief Compile an operand of an operator.
+      ///
+      /// \return slot of its result, -1 if it is not compatible.
+      template <typename C>
+      slot_t operand (const boost::shared_ptr<C>& f, slot_t argument)
+      {
+	return operand (f.get (), argument,
+			boost::mpl::bool_<boost::is_base_of
+			<function_t, C>::value> ());
+      }
+
+      /// \brief Emit an element-wise operation (ADD, SUB or MUL).
+      slot_t binary (CompiledOperation::type op, slot_t lhs, slot_t rhs);
+
+      /// \brief Emit the product of a result with a constant.
+      slot_t scale (slot_t origin, value_type constant);
+
+      /// \brief Emit the stack of two results.
+      slot_t concatenate (slot_t lhs, slot_t rhs);
+
+      /// \brief Emit a result built from rows of another one.
+      ///
+      /// \param origin slot rows are picked from.
+      /// \param indices row of origin for each row of the result, -1 for
+      /// constant rows.
+      /// \param constants values of the constant rows (zero if empty).
+      slot_t gather (slot_t origin, const std::vector<int>& indices,
+		     const std::vector<value_type>& constants
+		     = std::vector<value_type> ());
+
+      const slots_t& slots () const
+      {
+	return slots_;
+      }
+
+      const instructions_t& instructions () const
+      {
+	return instructions_;
+      }
+
+      /// \brief Row indices of GATHER instructions.
+      const std::vector<int>& indices () const
+      {
+	return indices_;
+      }
+
+      /// \brief Constants of GATHER instructions.
+      const std::vector<value_type>& constants () const
+      {
+	return constants_;
+      }
+
+      /// \brief Size of the memory holding the slots.
+      size_type arenaSize () const
+      {
+	return arenaSize_;
+      }
+
+      /// \brief Size of the memory needed by LEAF instructions applying
+      /// the chain rule.
+      size_type scratchSize () const
+      {
+	return scratchSize_;
+      }
+
+    private:
+      template <typename C>
+      slot_t operand (const C* f, slot_t argument, boost::mpl::true_)
+      {
+	return compile (f, argument);
+      }
+
+      template <typename C>
+      slot_t operand (const C*, slot_t, boost::mpl::false_)
+      {
+	return -1;
+      }
+
+      typedef std::map<std::pair<const function_t*, slot_t>, slot_t>
+      compiled_t;
+
+      /// \brief Add a slot.
+      slot_t push (size_type size);
+
+      /// \brief Add an instruction.
+      slot_t emit (CompiledOperation::type op, slot_t result,
+		   slot_t lhs, slot_t rhs);
+
+    private:
+      /// \brief Intermediate results.
+      slots_t slots_;
+
+      /// \brief Instructions, in evaluation order.
+      instructions_t instructions_;
+
+      /// \brief Row indices of GATHER instructions.
+      std::vector<int> indices_;
+
+      /// \brief Constants of GATHER instructions.
+      std::vector<value_type> constants_;
+
+      /// \brief Nodes already compiled, by argument.
+      compiled_t compiled_;
+
+      /// \brief Size of the memory holding the slots.
+      size_type arenaSize_;
+
+      /// \brief Size of the chain rule memory.
+      size_type scratchSize_;
+    };
+  } // end of namespace detail
+} // end of namespace roboptim
+
+# include <roboptim/core/detail/function-compiler.hxx>
+#endif //! ROBOPTIM_CORE_DETAIL_FUNCTION_COMPILER_HH
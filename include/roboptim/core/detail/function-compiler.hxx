@@ -0,0 +1,181 @@
+// Copyright (C) 2026 by the RobOptim contributors.
+//
+// This file is part of the roboptim.
+//
+// roboptim is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// roboptim is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with roboptim.  If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef ROBOPTIM_CORE_DETAIL_FUNCTION_COMPILER_HXX
+# define ROBOPTIM_CORE_DETAIL_FUNCTION_COMPILER_HXX
+# include <algorithm>
+# include <stdexcept>
+
+# include <boost/format.hpp>
+
+namespace roboptim
+{
+  namespace detail
+  {
+    template <typename T>
+    FunctionCompiler<T>::FunctionCompiler (size_type inputSize)
+      : slots_ (),
+	instructions_ (),
+	indices_ (),
+	constants_ (),
+	compiled_ (),
+	arenaSize_ (inputSize),
+	scratchSize_ (0)
+    {
+      // The argument of the expression is stored first, its jacobian is
+      // the identity.
+      Slot argument;
+      argument.size = inputSize;
+      argument.value = 0;
+      argument.jacobian = -1;
+      slots_.push_back (argument);
+    }
+
+    template <typename T>
+    typename FunctionCompiler<T>::slot_t
+    FunctionCompiler<T>::compile (const function_t* node, slot_t argument)
+    {
+      const std::pair<const function_t*, slot_t> key (node, argument);
+      typename compiled_t::const_iterator it = compiled_.find (key);
+      if (it != compiled_.end ())
+	return it->second;
+
+      const size_type argumentSize =
+	slots_[static_cast<std::size_t> (argument)].size;
+      if (node->inputSize () != argumentSize)
+	throw std::runtime_error
+	  ((boost::format ("function \"%s\" input size (%d) and argument"
+			   " size (%d) do not match")
+	    % node->getName () % node->inputSize () % argumentSize).str ());
+
+      slot_t result = GraphTraversal::compile (*node, *this, argument);
+      if (result < 0)
+	{
+	  // Evaluate the node as a whole.
+	  if (!node->template asType<GenericDifferentiableFunction<T> > ())
+	    throw std::runtime_error
+	      ((boost::format ("function \"%s\" is not differentiable")
+		% node->getName ()).str ());
+
+	  result = emit (CompiledOperation::LEAF,
+			 push (node->outputSize ()), argument, -1);
+	  instructions_.back ().function = node;
+
+	  if (argument != 0)
+	    scratchSize_ = std::max (scratchSize_,
+				     node->outputSize () * argumentSize);
+	}
+
+      compiled_[key] = result;
+      return result;
+    }
+
+    template <typename T>
+    typename FunctionCompiler<T>::slot_t
+    FunctionCompiler<T>::binary (CompiledOperation::type op,
+				 slot_t lhs, slot_t rhs)
+    {
+      assert (op == CompiledOperation::ADD
+	      || op == CompiledOperation::SUB
+	      || op == CompiledOperation::MUL);
+      assert (slots_[static_cast<std::size_t> (lhs)].size
+	      == slots_[static_cast<std::size_t> (rhs)].size);
+
+      return emit (op, push (slots_[static_cast<std::size_t> (lhs)].size),
+		   lhs, rhs);
+    }
+
+    template <typename T>
+    typename FunctionCompiler<T>::slot_t
+    FunctionCompiler<T>::scale (slot_t origin, value_type constant)
+    {
+      slot_t result =
+	emit (CompiledOperation::SCALE,
+	      push (slots_[static_cast<std::size_t> (origin)].size),
+	      origin, -1);
+      instructions_.back ().constant = constant;
+      return result;
+    }
+
+    template <typename T>
+    typename FunctionCompiler<T>::slot_t
+    FunctionCompiler<T>::concatenate (slot_t lhs, slot_t rhs)
+    {
+      return emit (CompiledOperation::CONCATENATE,
+		   push (slots_[static_cast<std::size_t> (lhs)].size
+			 + slots_[static_cast<std::size_t> (rhs)].size),
+		   lhs, rhs);
+    }
+
+    template <typename T>
+    typename FunctionCompiler<T>::slot_t
+    FunctionCompiler<T>::gather (slot_t origin,
+				 const std::vector<int>& indices,
+				 const std::vector<value_type>& constants)
+    {
+      assert (constants.empty () || constants.size () == indices.size ());
+
+      slot_t result =
+	emit (CompiledOperation::GATHER,
+	      push (static_cast<size_type> (indices.size ())), origin, -1);
+      instructions_.back ().data = static_cast<size_type> (indices_.size ());
+
+      indices_.insert (indices_.end (), indices.begin (), indices.end ());
+      if (constants.empty ())
+	constants_.resize (indices_.size (), value_type (0));
+      else
+	constants_.insert (constants_.end (),
+			   constants.begin (), constants.end ());
+      return result;
+    }
+
+    template <typename T>
+    typename FunctionCompiler<T>::slot_t
+    FunctionCompiler<T>::push (size_type size)
+    {
+      // Values and jacobians are laid out in evaluation order.
+      Slot slot;
+      slot.size = size;
+      slot.value = arenaSize_;
+      slot.jacobian = arenaSize_ + size;
+      arenaSize_ += size * (1 + slots_[0].size);
+
+      slots_.push_back (slot);
+      return static_cast<slot_t> (slots_.size () - 1);
+    }
+
+    template <typename T>
+    typename FunctionCompiler<T>::slot_t
+    FunctionCompiler<T>::emit (CompiledOperation::type op, slot_t result,
+			       slot_t lhs, slot_t rhs)
+    {
+      Instruction instruction;
+      instruction.function = 0;
+      instruction.constant = value_type (0);
+      instruction.data = 0;
+      instruction.result = result;
+      instruction.lhs = lhs;
+      instruction.rhs = rhs;
+      instruction.op = static_cast<unsigned char> (op);
+
+      instructions_.push_back (instruction);
+      return result;
+    }
+  } // end of namespace detail
+} // end of namespace roboptim
+
+#endif //! ROBOPTIM_CORE_DETAIL_FUNCTION_COMPILER_HXX
@@ -0,0 +1,129 @@
+// Copyright (C) 2026 by the RobOptim contributors.
+//
+// This file is part of the roboptim.
+//
+// roboptim is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// roboptim is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with roboptim.  If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef ROBOPTIM_CORE_DETAIL_GRAPH_TRAVERSAL_HH
+# define ROBOPTIM_CORE_DETAIL_GRAPH_TRAVERSAL_HH
+
+# include <roboptim/core/function.hh>
+# include <roboptim/core/detail/expression-node.hh>
+
+namespace roboptim
+{
+  namespace detail
+  {
+    /// \brief Traversal of the operators of an expression.
+    ///
+    /// Listing, copying, rewiring and compiling the operands of an
+    /// operator is only needed to build a function graph (see
+    /// GenericFunctionGraph) or a compiled function (see
+    /// GenericCompiledFunction). Operators provide it by implementing
+    /// GenericExpressionNode, and this class dispatches to them. Other
+    /// functions are leaves: they have no children and are neither copied
+    /// nor compiled.
+    struct GraphTraversal
+    {
+      /// \brief Get the node interface of a function.
+      /// \return node interface, null if the function is a leaf
+      template <typename T>
+      static const GenericExpressionNode<T>*
+      node (const GenericFunction<T>& function)
+      {
+	return dynamic_cast<const GenericExpressionNode<T>*> (&function);
+      }
+
+      /// \brief Get the node interface of a function.
+      /// \return node interface, null if the function is a leaf
+      template <typename T>
+      static GenericExpressionNode<T>*
+      node (GenericFunction<T>& function)
+      {
+	return dynamic_cast<GenericExpressionNode<T>*> (&function);
+      }
+
+      /// \brief Get the functions a node is built on.
+      ///
+      /// Operators (e.g. Plus, Chain) list their operands, other
+      /// functions have no children.
+      /// \param function node of the expression
+      /// \param children children will be appended to this vector
+      template <typename T>
+      static void
+      children (const GenericFunction<T>& function,
+		typename GenericExpressionNode<T>::children_t& children)
+      {
+	if (const GenericExpressionNode<T>* n = node (function))
+	  n->impl_children (children);
+      }
+
+      /// \brief Replace an operand of a node.
+      ///
+      /// Operators replace their operands equal to child, if replacement
+      /// has their type.
+      /// \param function node of the expression
+      /// \param child operand to replace
+      /// \param replacement new operand
+      /// \return replaced operand, null if child was not replaced
+      template <typename T>
+      static typename GenericExpressionNode<T>::constChildShPtr_t
+      replaceChild (GenericFunction<T>& function,
+		    const GenericFunction<T>* child,
+		    const typename GenericExpressionNode<T>::childShPtr_t&
+		    replacement)
+      {
+	typename GenericExpressionNode<T>::constChildShPtr_t replaced;
+	if (GenericExpressionNode<T>* n = node (function))
+	  n->impl_replace_child (child, replacement, replaced);
+	return replaced;
+      }
+
+      /// \brief Copy a node.
+      ///
+      /// Operators return a copy sharing their operands, whose operands
+      /// can then be replaced without modifying the node.
+      /// \param function node of the expression
+      /// \return copy, null if the node cannot be copied
+      template <typename T>
+      static typename GenericExpressionNode<T>::childShPtr_t
+      clone (const GenericFunction<T>& function)
+      {
+	if (const GenericExpressionNode<T>* n = node (function))
+	  return n->impl_clone ();
+	return typename GenericExpressionNode<T>::childShPtr_t ();
+      }
+
+      /// \brief Emit the instructions of a node.
+      ///
+      /// \param function node of the expression
+      /// \param compiler compiler of the expression
+      /// \param argument slot of the argument of the node
+      /// \return slot of the result of the node, -1 if it is evaluated
+      /// as a whole
+      template <typename T>
+      static int
+      compile (const GenericFunction<T>& function,
+	       typename GenericExpressionNode<T>::compiler_t& compiler,
+	       int argument)
+      {
+	if (const GenericExpressionNode<T>* n = node (function))
+	  return n->impl_compile (compiler, argument);
+	return -1;
+      }
+    };
+  } // end of namespace detail
+} // end of namespace roboptim
+
+#endif //! ROBOPTIM_CORE_DETAIL_GRAPH_TRAVERSAL_HH
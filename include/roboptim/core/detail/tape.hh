@@ -0,0 +1,467 @@
+// Copyright (C) 2026 by the RobOptim contributors.
+//
+// This file is part of the roboptim.
+//
+// roboptim is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// roboptim is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with roboptim.  If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef ROBOPTIM_CORE_DETAIL_TAPE_HH
+# define ROBOPTIM_CORE_DETAIL_TAPE_HH
+
+# include <cmath>
+# include <vector>
+
+# include <Eigen/Core>
+
+namespace roboptim
+{
+  namespace detail
+  {
+    /// \brief Operations recorded on a tape.
+    struct TapeOperation
+    {
+      enum type
+	{
+	  /// \brief Independent variable.
+	  INPUT,
+
+	  // Binary operations.
+	  ADD,
+	  SUB,
+	  MUL,
+	  DIV,
+	  POW,
+
+	  // Operations with a constant c, x being the variable.
+	  /// \brief x + c
+	  ADD_SCALAR,
+	  /// \brief c * x
+	  MUL_SCALAR,
+	  /// \brief x / c
+	  DIV_SCALAR,
+	  /// \brief c - x
+	  SCALAR_SUB,
+	  /// \brief c / x
+	  SCALAR_DIV,
+	  /// \brief x ^ c
+	  POW_SCALAR,
+
+	  // Unary operations.
+	  NEG,
+	  ABS,
+	  SQRT,
+	  EXP,
+	  LOG,
+	  SIN,
+	  COS,
+	  TAN,
+	  ASIN,
+	  ACOS,
+	  ATAN,
+	  TANH,
+
+	  // Comparisons: they do not contribute to the derivatives, but
+	  // their outcome tells whether the control flow changed.
+	  LESS,
+	  LESS_EQUAL,
+	  GREATER,
+	  GREATER_EQUAL,
+	  EQUAL,
+	  NOT_EQUAL
+	};
+    };
+
+    template <typename S>
+    class Tape;
+
+    /// \brief Scalar type recording its operations on a tape.
+    ///
+    /// Scalars built from a value (e.g. literals) are constants: they are
+    /// not recorded, and operations involving only constants are not
+    /// recorded either.
+    ///
+    /// \tparam S underlying scalar type.
+    template <typename S>
+    class TapeScalar
+    {
+    public:
+      typedef S value_type;
+      typedef int index_t;
+
+      TapeScalar ()
+	: value_ (0),
+	  tape_ (0),
+	  index_ (-1)
+      {}
+
+      /// \brief Constant.
+      TapeScalar (const S& value)
+	: value_ (value),
+	  tape_ (0),
+	  index_ (-1)
+      {}
+
+      /// \brief Variable recorded on a tape.
+      TapeScalar (const S& value, Tape<S>* tape, index_t index)
+	: value_ (value),
+	  tape_ (tape),
+	  index_ (index)
+      {}
+
+      const S& value () const
+      {
+	return value_;
+      }
+
+      Tape<S>* tape () const
+      {
+	return tape_;
+      }
+
+      index_t index () const
+      {
+	return index_;
+      }
+
+      bool isConstant () const
+      {
+	return !tape_;
+      }
+
+      TapeScalar& operator+= (const TapeScalar& x)
+      {
+	return *this = *this + x;
+      }
+
+      TapeScalar& operator-= (const TapeScalar& x)
+      {
+	return *this = *this - x;
+      }
+
+      TapeScalar& operator*= (const TapeScalar& x)
+      {
+	return *this = *this * x;
+      }
+
+      TapeScalar& operator/= (const TapeScalar& x)
+      {
+	return *this = *this / x;
+      }
+
+      friend TapeScalar operator+ (const TapeScalar& x)
+      {
+	return x;
+      }
+
+      friend TapeScalar operator- (const TapeScalar& x)
+      {
+	return x.unary (TapeOperation::NEG, -x.value_);
+      }
+
+      friend TapeScalar operator+ (const TapeScalar& a, const TapeScalar& b)
+      {
+	const S value = a.value_ + b.value_;
+	if (b.isConstant ())
+	  return a.scalar (TapeOperation::ADD_SCALAR, b.value_, value);
+	if (a.isConstant ())
+	  return b.scalar (TapeOperation::ADD_SCALAR, a.value_, value);
+	return a.binary (TapeOperation::ADD, b, value);
+      }
+
+      friend TapeScalar operator- (const TapeScalar& a, const TapeScalar& b)
+      {
+	const S value = a.value_ - b.value_;
+	if (b.isConstant ())
+	  return a.scalar (TapeOperation::ADD_SCALAR, -b.value_, value);
+	if (a.isConstant ())
+	  return b.scalar (TapeOperation::SCALAR_SUB, a.value_, value);
+	return a.binary (TapeOperation::SUB, b, value);
+      }
+
+      friend TapeScalar operator* (const TapeScalar& a, const TapeScalar& b)
+      {
+	const S value = a.value_ * b.value_;
+	if (b.isConstant ())
+	  return a.scalar (TapeOperation::MUL_SCALAR, b.value_, value);
+	if (a.isConstant ())
+	  return b.scalar (TapeOperation::MUL_SCALAR, a.value_, value);
+	return a.binary (TapeOperation::MUL, b, value);
+      }
+
+      friend TapeScalar operator/ (const TapeScalar& a, const TapeScalar& b)
+      {
+	const S value = a.value_ / b.value_;
+	if (b.isConstant ())
+	  return a.scalar (TapeOperation::DIV_SCALAR, b.value_, value);
+	if (a.isConstant ())
+	  return b.scalar (TapeOperation::SCALAR_DIV, a.value_, value);
+	return a.binary (TapeOperation::DIV, b, value);
+      }
+
+      friend TapeScalar pow (const TapeScalar& a, const TapeScalar& b)
+      {
+	using std::pow;
+	const S value = pow (a.value_, b.value_);
+	if (b.isConstant ())
+	  return a.scalar (TapeOperation::POW_SCALAR, b.value_, value);
+	if (a.isConstant ())
+	  // c ^ x = exp (x log (c))
+	  return exp (b * std::log (a.value_));
+	return a.binary (TapeOperation::POW, b, value);
+      }
+
+# define ROBOPTIM_CORE_TAPE_UNARY(NAME, OP)			\
+      friend TapeScalar NAME (const TapeScalar& x)		\
+      {								\
+	using std::NAME;					\
+	return x.unary (TapeOperation::OP, NAME (x.value_));	\
+      }
+
+      ROBOPTIM_CORE_TAPE_UNARY (abs, ABS)
+      ROBOPTIM_CORE_TAPE_UNARY (sqrt, SQRT)
+      ROBOPTIM_CORE_TAPE_UNARY (exp, EXP)
+      ROBOPTIM_CORE_TAPE_UNARY (log, LOG)
+      ROBOPTIM_CORE_TAPE_UNARY (sin, SIN)
+      ROBOPTIM_CORE_TAPE_UNARY (cos, COS)
+      ROBOPTIM_CORE_TAPE_UNARY (tan, TAN)
+      ROBOPTIM_CORE_TAPE_UNARY (asin, ASIN)
+      ROBOPTIM_CORE_TAPE_UNARY (acos, ACOS)
+      ROBOPTIM_CORE_TAPE_UNARY (atan, ATAN)
+      ROBOPTIM_CORE_TAPE_UNARY (tanh, TANH)
+
+# undef ROBOPTIM_CORE_TAPE_UNARY
+
+# define ROBOPTIM_CORE_TAPE_COMPARISON(OPERATOR, OP, MIRROR)		\
+      friend bool operator OPERATOR (const TapeScalar& a,		\
+				     const TapeScalar& b)		\
+      {									\
+	const bool outcome = a.value_ OPERATOR b.value_;		\
+	if (!a.isConstant ())						\
+	  a.tape_->branch (TapeOperation::OP, a.index_, b.index_,	\
+			   b.value_, outcome);				\
+	else if (!b.isConstant ())					\
+	  b.tape_->branch (TapeOperation::MIRROR, b.index_, -1,		\
+			   a.value_, outcome);				\
+	return outcome;							\
+      }
+
+      ROBOPTIM_CORE_TAPE_COMPARISON (<, LESS, GREATER)
+      ROBOPTIM_CORE_TAPE_COMPARISON (<=, LESS_EQUAL, GREATER_EQUAL)
+      ROBOPTIM_CORE_TAPE_COMPARISON (>, GREATER, LESS)
+      ROBOPTIM_CORE_TAPE_COMPARISON (>=, GREATER_EQUAL, LESS_EQUAL)
+      ROBOPTIM_CORE_TAPE_COMPARISON (==, EQUAL, EQUAL)
+      ROBOPTIM_CORE_TAPE_COMPARISON (!=, NOT_EQUAL, NOT_EQUAL)
+
+# undef ROBOPTIM_CORE_TAPE_COMPARISON
+
+    private:
+      TapeScalar unary (TapeOperation::type op, const S& value) const
+      {
+	if (isConstant ())
+	  return TapeScalar (value);
+	return tape_->push (op, index_, -1, S (0), value);
+      }
+
+      TapeScalar scalar (TapeOperation::type op, const S& constant,
+			 const S& value) const
+      {
+	if (isConstant ())
+	  return TapeScalar (value);
+	return tape_->push (op, index_, -1, constant, value);
+      }
+
+      TapeScalar binary (TapeOperation::type op, const TapeScalar& b,
+			 const S& value) const
+      {
+	return tape_->push (op, index_, b.index_, S (0), value);
+      }
+
+    private:
+      /// \brief Current value.
+      S value_;
+
+      /// \brief Tape recording the operations, null for constants.
+      Tape<S>* tape_;
+
+      /// \brief Index of the variable on the tape.
+      index_t index_;
+    };
+
+    /// \brief Tape of the operations of a function, for reverse-mode
+    /// automatic differentiation.
+    ///
+    /// The operations are stored in a single contiguous array of compact
+    /// nodes, which is kept (with its capacity) from one recording to the
+    /// next. Once recorded, the tape can be replayed at other points
+    /// without calling the function again: forward() recomputes the
+    /// values, and reverse() propagates the adjoints of an output back to
+    /// the inputs. Comparisons are recorded with their outcome, so that a
+    /// replay can detect that the control flow of the function changed.
+    ///
+    /// \warning control flow depending on values converted back to S
+    /// (e.g. with TapeScalar::value) cannot be detected.
+    ///
+    /// \tparam S underlying scalar type.
+    template <typename S>
+    class Tape
+    {
+    public:
+      typedef S value_type;
+      typedef TapeScalar<S> scalar_t;
+      typedef typename scalar_t::index_t index_t;
+
+      /// \brief Recorded operation.
+      struct Node
+      {
+	/// \brief Constant operand, if any.
+	S constant;
+
+	/// \brief Index of the first operand.
+	index_t lhs;
+
+	/// \brief Index of the second operand, -1 if none.
+	index_t rhs;
+
+	/// \brief Operation (TapeOperation::type).
+	unsigned char op;
+
+	/// \brief Recorded outcome of a comparison.
+	unsigned char outcome;
+      };
+
+      Tape ();
+
+      /// \brief Forget the recorded operations, keeping the memory.
+      void clear ();
+
+      /// \brief Record an independent variable.
+      ///
+      /// Inputs have to be recorded before any other operation.
+      scalar_t input (const S& value);
+
+      /// \brief Mark a variable as the next output of the function.
+      void output (const scalar_t& y);
+
+      /// \brief Record an operation.
+      scalar_t push (TapeOperation::type op, index_t lhs, index_t rhs,
+		     const S& constant, const S& value);
+
+      /// \brief Record the outcome of a comparison.
+      ///
+      /// If rhs is -1, the comparison is done with the constant.
+      void branch (TapeOperation::type op, index_t lhs, index_t rhs,
+		   const S& constant, bool outcome);
+
+      /// \brief Number of recorded operations.
+      index_t size () const
+      {
+	return static_cast<index_t> (nodes_.size ());
+      }
+
+      /// \brief Number of inputs.
+      index_t inputs () const
+      {
+	return inputs_;
+      }
+
+      /// \brief Number of outputs.
+      index_t outputs () const
+      {
+	return static_cast<index_t> (outputs_.size ());
+      }
+
+      /// \brief Replay the tape at a new point.
+      ///
+      /// \param x new values of the inputs
+      /// \return false if the outcome of a comparison changed, i.e. if the
+      /// tape has to be recorded again.
+      template <typename V>
+      bool forward (const V& x);
+
+      /// \brief Value of an output at the last recorded or replayed point.
+      S value (index_t output) const;
+
+      /// \brief Propagate the adjoint of an output back to the inputs.
+      ///
+      /// The derivatives of the output with respect to the inputs are then
+      /// given by adjoint().
+      void reverse (index_t output) const;
+
+      /// \brief Propagate a weighted sum of the outputs back to the
+      /// inputs.
+      ///
+      /// A single sweep gives the product of the weights with the
+      /// jacobian, through adjoint().
+      /// \param weights weight of each output
+      template <typename V>
+      void reverse (const V& weights) const;
+
+      /// \brief Adjoint of an input, after a call to reverse().
+      const S& adjoint (index_t input) const
+      {
+	return adjoints_[static_cast<std::size_t> (input)];
+      }
+
+    private:
+      /// \brief Propagate the adjoints of the nodes up to last back to
+      /// the inputs.
+      void sweep (index_t last) const;
+
+    private:
+      /// \brief Recorded operations.
+      std::vector<Node> nodes_;
+
+      /// \brief Value of each node.
+      std::vector<S> values_;
+
+      /// \brief Adjoint of each node.
+      mutable std::vector<S> adjoints_;
+
+      /// \brief Number of inputs.
+      index_t inputs_;
+
+      /// \brief Node of each output, -1 for constant outputs.
+      std::vector<index_t> outputs_;
+
+      /// \brief Value of the constant outputs.
+      std::vector<S> constants_;
+    };
+  } // end of namespace detail
+} // end of namespace roboptim
+
+namespace Eigen
+{
+  /// \brief Allow the use of tape scalars in Eigen matrices.
+  template <typename S>
+  struct NumTraits<roboptim::detail::TapeScalar<S> > : NumTraits<S>
+  {
+    typedef roboptim::detail::TapeScalar<S> Real;
+    typedef roboptim::detail::TapeScalar<S> NonInteger;
+    typedef roboptim::detail::TapeScalar<S> Nested;
+    typedef S Literal;
+
+    enum
+      {
+	IsComplex = 0,
+	IsInteger = 0,
+	IsSigned = 1,
+	RequireInitialization = 1,
+	ReadCost = 1,
+	AddCost = 2,
+	MulCost = 2
+      };
+  };
+} // end of namespace Eigen
+
+# include <roboptim/core/detail/tape.hxx>
+#endif //! ROBOPTIM_CORE_DETAIL_TAPE_HH
@@ -0,0 +1,378 @@
+// Copyright (C) 2026 by the RobOptim contributors.
+//
+// This file is part of the roboptim.
+//
+// roboptim is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// roboptim is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with roboptim.  If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef ROBOPTIM_CORE_DETAIL_TAPE_HXX
+# define ROBOPTIM_CORE_DETAIL_TAPE_HXX
+
+# include <algorithm>
+# include <cassert>
+
+namespace roboptim
+{
+  namespace detail
+  {
+    template <typename S>
+    Tape<S>::Tape ()
+      : nodes_ (),
+	values_ (),
+	adjoints_ (),
+	inputs_ (0),
+	outputs_ (),
+	constants_ ()
+    {
+    }
+
+    template <typename S>
+    void Tape<S>::clear ()
+    {
+      nodes_.clear ();
+      values_.clear ();
+      outputs_.clear ();
+      constants_.clear ();
+      inputs_ = 0;
+    }
+
+    template <typename S>
+    typename Tape<S>::scalar_t Tape<S>::input (const S& value)
+    {
+      // Inputs are the first nodes of the tape.
+      assert (size () == inputs_);
+      ++inputs_;
+      return push (TapeOperation::INPUT, -1, -1, S (0), value);
+    }
+
+    template <typename S>
+    void Tape<S>::output (const scalar_t& y)
+    {
+      assert (y.isConstant () || y.tape () == this);
+      outputs_.push_back (y.isConstant ()? -1 : y.index ());
+      constants_.push_back (y.isConstant ()? y.value () : S (0));
+    }
+
+    template <typename S>
+    typename Tape<S>::scalar_t
+    Tape<S>::push (TapeOperation::type op, index_t lhs, index_t rhs,
+		   const S& constant, const S& value)
+    {
+      const Node node = {constant, lhs, rhs,
+			 static_cast<unsigned char> (op), 0};
+      const index_t index = size ();
+      nodes_.push_back (node);
+      values_.push_back (value);
+      return scalar_t (value, this, index);
+    }
+
+    template <typename S>
+    void
+    Tape<S>::branch (TapeOperation::type op, index_t lhs, index_t rhs,
+		     const S& constant, bool outcome)
+    {
+      const Node node = {constant, lhs, rhs,
+			 static_cast<unsigned char> (op),
+			 static_cast<unsigned char> (outcome)};
+      nodes_.push_back (node);
+      values_.push_back (S (0));
+    }
+
+    template <typename S>
+    template <typename V>
+    bool Tape<S>::forward (const V& x)
+    {
+      using std::abs;
+      using std::sqrt;
+      using std::exp;
+      using std::log;
+      using std::sin;
+      using std::cos;
+      using std::tan;
+      using std::asin;
+      using std::acos;
+      using std::atan;
+      using std::tanh;
+      using std::pow;
+
+      assert (x.size () == inputs_);
+
+      for (index_t j = 0; j < inputs_; ++j)
+	values_[static_cast<std::size_t> (j)] = x[j];
+
+      for (std::size_t i = static_cast<std::size_t> (inputs_);
+	   i < nodes_.size (); ++i)
+	{
+	  const Node& node = nodes_[i];
+	  const S& l = values_[static_cast<std::size_t> (node.lhs)];
+	  // For operations with a constant, the constant is the right operand.
+	  const S& r = node.rhs < 0 ?
+	    node.constant : values_[static_cast<std::size_t> (node.rhs)];
+	  S& y = values_[i];
+
+	  switch (node.op)
+	    {
+	    case TapeOperation::ADD:
+	    case TapeOperation::ADD_SCALAR:
+	      y = l + r;
+	      break;
+	    case TapeOperation::SUB:
+	      y = l - r;
+	      break;
+	    case TapeOperation::MUL:
+	    case TapeOperation::MUL_SCALAR:
+	      y = l * r;
+	      break;
+	    case TapeOperation::DIV:
+	    case TapeOperation::DIV_SCALAR:
+	      y = l / r;
+	      break;
+	    case TapeOperation::POW:
+	    case TapeOperation::POW_SCALAR:
+	      y = pow (l, r);
+	      break;
+	    case TapeOperation::SCALAR_SUB:
+	      y = r - l;
+	      break;
+	    case TapeOperation::SCALAR_DIV:
+	      y = r / l;
+	      break;
+	    case TapeOperation::NEG:
+	      y = -l;
+	      break;
+	    case TapeOperation::ABS:
+	      y = abs (l);
+	      break;
+	    case TapeOperation::SQRT:
+	      y = sqrt (l);
+	      break;
+	    case TapeOperation::EXP:
+	      y = exp (l);
+	      break;
+	    case TapeOperation::LOG:
+	      y = log (l);
+	      break;
+	    case TapeOperation::SIN:
+	      y = sin (l);
+	      break;
+	    case TapeOperation::COS:
+	      y = cos (l);
+	      break;
+	    case TapeOperation::TAN:
+	      y = tan (l);
+	      break;
+	    case TapeOperation::ASIN:
+	      y = asin (l);
+	      break;
+	    case TapeOperation::ACOS:
+	      y = acos (l);
+	      break;
+	    case TapeOperation::ATAN:
+	      y = atan (l);
+	      break;
+	    case TapeOperation::TANH:
+	      y = tanh (l);
+	      break;
+
+	    // Branches: the tape is only valid if the outcomes did not change.
+	    case TapeOperation::LESS:
+	      if ((l < r) != static_cast<bool> (node.outcome))
+		return false;
+	      break;
+	    case TapeOperation::LESS_EQUAL:
+	      if ((l <= r) != static_cast<bool> (node.outcome))
+		return false;
+	      break;
+	    case TapeOperation::GREATER:
+	      if ((l > r) != static_cast<bool> (node.outcome))
+		return false;
+	      break;
+	    case TapeOperation::GREATER_EQUAL:
+	      if ((l >= r) != static_cast<bool> (node.outcome))
+		return false;
+	      break;
+	    case TapeOperation::EQUAL:
+	      if ((l == r) != static_cast<bool> (node.outcome))
+		return false;
+	      break;
+	    case TapeOperation::NOT_EQUAL:
+	      if ((l != r) != static_cast<bool> (node.outcome))
+		return false;
+	      break;
+
+	    default:
+	      assert (0 && "unexpected operation on the tape");
+	    }
+	}
+      return true;
+    }
+
+    template <typename S>
+    S Tape<S>::value (index_t output) const
+    {
+      const std::size_t o = static_cast<std::size_t> (output);
+      return outputs_[o] < 0 ?
+	constants_[o] : values_[static_cast<std::size_t> (outputs_[o])];
+    }
+
+    template <typename S>
+    void Tape<S>::reverse (index_t output) const
+    {
+      adjoints_.assign (nodes_.size (), S (0));
+
+      const index_t last = outputs_[static_cast<std::size_t> (output)];
+      if (last < 0)
+	return;
+      adjoints_[static_cast<std::size_t> (last)] = S (1);
+
+      sweep (last);
+    }
+
+    template <typename S>
+    template <typename V>
+    void Tape<S>::reverse (const V& weights) const
+    {
+      assert (weights.size () == outputs ());
+
+      adjoints_.assign (nodes_.size (), S (0));
+
+      // Several outputs may share the same node.
+      index_t last = -1;
+      for (std::size_t o = 0; o < outputs_.size (); ++o)
+	{
+	  if (outputs_[o] < 0)
+	    continue;
+	  adjoints_[static_cast<std::size_t> (outputs_[o])] +=
+	    weights[static_cast<index_t> (o)];
+	  last = std::max (last, outputs_[o]);
+	}
+
+      if (last >= 0)
+	sweep (last);
+    }
+
+    template <typename S>
+    void Tape<S>::sweep (index_t last) const
+    {
+      using std::sqrt;
+      using std::log;
+      using std::sin;
+      using std::cos;
+      using std::pow;
+
+      for (index_t i = last; i >= inputs_; --i)
+	{
+	  const S a = adjoints_[static_cast<std::size_t> (i)];
+	  if (a == S (0))
+	    continue;
+
+	  const Node& node = nodes_[static_cast<std::size_t> (i)];
+	  const S& y = values_[static_cast<std::size_t> (i)];
+	  const S& l = values_[static_cast<std::size_t> (node.lhs)];
+	  const S& c = node.constant;
+	  S& al = adjoints_[static_cast<std::size_t> (node.lhs)];
+
+	  switch (node.op)
+	    {
+	    case TapeOperation::ADD:
+	      al += a;
+	      adjoints_[static_cast<std::size_t> (node.rhs)] += a;
+	      break;
+	    case TapeOperation::SUB:
+	      al += a;
+	      adjoints_[static_cast<std::size_t> (node.rhs)] -= a;
+	      break;
+	    case TapeOperation::MUL:
+	      {
+		const std::size_t rhs = static_cast<std::size_t> (node.rhs);
+		al += a * values_[rhs];
+		adjoints_[rhs] += a * l;
+	      }
+	      break;
+	    case TapeOperation::DIV:
+	      {
+		const std::size_t rhs = static_cast<std::size_t> (node.rhs);
+		al += a / values_[rhs];
+		adjoints_[rhs] -= a * y / values_[rhs];
+	      }
+	      break;
+	    case TapeOperation::POW:
+	      {
+		const std::size_t rhs = static_cast<std::size_t> (node.rhs);
+		al += a * values_[rhs] * pow (l, values_[rhs] - S (1));
+		adjoints_[rhs] += a * y * log (l);
+	      }
+	      break;
+	    case TapeOperation::ADD_SCALAR:
+	      al += a;
+	      break;
+	    case TapeOperation::MUL_SCALAR:
+	      al += a * c;
+	      break;
+	    case TapeOperation::DIV_SCALAR:
+	      al += a / c;
+	      break;
+	    case TapeOperation::SCALAR_SUB:
+	    case TapeOperation::NEG:
+	      al -= a;
+	      break;
+	    case TapeOperation::SCALAR_DIV:
+	      al -= a * y / l;
+	      break;
+	    case TapeOperation::POW_SCALAR:
+	      al += a * c * pow (l, c - S (1));
+	      break;
+	    case TapeOperation::ABS:
+	      al += l < S (0) ? -a : a;
+	      break;
+	    case TapeOperation::SQRT:
+	      al += a / (S (2) * y);
+	      break;
+	    case TapeOperation::EXP:
+	      al += a * y;
+	      break;
+	    case TapeOperation::LOG:
+	      al += a / l;
+	      break;
+	    case TapeOperation::SIN:
+	      al += a * cos (l);
+	      break;
+	    case TapeOperation::COS:
+	      al -= a * sin (l);
+	      break;
+	    case TapeOperation::TAN:
+	      al += a * (S (1) + y * y);
+	      break;
+	    case TapeOperation::ASIN:
+	      al += a / sqrt (S (1) - l * l);
+	      break;
+	    case TapeOperation::ACOS:
+	      al -= a / sqrt (S (1) - l * l);
+	      break;
+	    case TapeOperation::ATAN:
+	      al += a / (S (1) + l * l);
+	      break;
+	    case TapeOperation::TANH:
+	      al += a * (S (1) - y * y);
+	      break;
+
+	    default:
+	      // Branches do not contribute to the derivatives.
+	      break;
+	    }
+	}
+    }
+  } // end of namespace detail
+} // end of namespace roboptim
+
+#endif //! ROBOPTIM_CORE_DETAIL_TAPE_HXX
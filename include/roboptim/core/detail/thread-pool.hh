@@ -0,0 +1,234 @@
+// Copyright (C) 2026 by the RobOptim contributors.
+//
+// This file is part of the roboptim.
+//
+// roboptim is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// roboptim is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with roboptim.  If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef ROBOPTIM_CORE_DETAIL_THREAD_POOL_HH
+# define ROBOPTIM_CORE_DETAIL_THREAD_POOL_HH
+
+# include <cstddef>
+# include <stdexcept>
+# include <string>
+
+# include <boost/bind.hpp>
+# include <boost/function.hpp>
+# include <boost/noncopyable.hpp>
+# include <boost/thread/condition_variable.hpp>
+# include <boost/thread/locks.hpp>
+# include <boost/thread/mutex.hpp>
+# include <boost/thread/thread.hpp>
+
+# include <roboptim/core/alloc.hh>
+
+namespace roboptim
+{
+  namespace detail
+  {
+    /// \brief Fixed-size pool of threads running the same task.
+    ///
+    /// The pool keeps its worker threads alive between calls to run, so
+    /// that the cost of thread creation is only paid once. The calling
+    /// thread takes part in the computation as the worker 0.
+    ///
+    /// The other workers run the task with the allocation flag of the
+    /// calling thread (see set_is_malloc_allowed), and forget it once
+    /// the task is done.
+    class ThreadPool : private boost::noncopyable
+    {
+    public:
+      /// \brief Task run by each worker, given the worker index.
+      typedef boost::function<void (size_t)> task_t;
+
+      /// \brief Constructor.
+      ///
+      /// \param size number of workers, including the calling thread.
+      explicit ThreadPool (size_t size)
+	: size_ (size > 0 ? size : 1),
+	  task_ (0),
+	  generation_ (0),
+	  pending_ (0),
+	  mallocAllowed_ (true),
+	  stop_ (false),
+	  failed_ (false)
+      {
+	for (size_t i = 1; i < size_; ++i)
+	  threads_.create_thread (boost::bind (&ThreadPool::work, this, i));
+      }
+
+      ~ThreadPool ()
+      {
+	{
+	  boost::lock_guard<boost::mutex> lock (mutex_);
+	  stop_ = true;
+	}
+	start_.notify_all ();
+	threads_.join_all ();
+      }
+
+      /// \brief Number of workers, including the calling thread.
+      size_t size () const
+      {
+	return size_;
+      }
+
+      /// \brief Run task (i) for every worker i, and wait for completion.
+      ///
+      /// Exceptions thrown by the task are rethrown once all the workers
+      /// are done. Exceptions thrown in the other threads are reported as
+      /// std::runtime_error.
+      ///
+      /// \param task task to run.
+      void run (const task_t& task)
+      {
+	// Only one task can be run at a time.
+	boost::lock_guard<boost::mutex> runLock (runMutex_);
+
+	if (size_ == 1)
+	  {
+	    task (0);
+	    return;
+	  }
+
+	{
+	  boost::lock_guard<boost::mutex> lock (mutex_);
+	  task_ = &task;
+	  pending_ = size_ - 1;
+	  mallocAllowed_ = is_malloc_allowed ();
+	  failed_ = false;
+	  ++generation_;
+	}
+	start_.notify_all ();
+
+	try
+	  {
+	    task (0);
+	  }
+	catch (...)
+	  {
+	    wait ();
+	    throw;
+	  }
+	wait ();
+
+	if (failed_)
+	  throw std::runtime_error (error_);
+      }
+
+    private:
+      /// \brief Wait for the other workers to complete their task.
+      void wait ()
+      {
+	boost::unique_lock<boost::mutex> lock (mutex_);
+	while (pending_ > 0)
+	  done_.wait (lock);
+	task_ = 0;
+      }
+
+      /// \brief Main loop of the worker threads.
+      void work (size_t id)
+      {
+	size_t generation = 0;
+
+	for (;;)
+	  {
+	    const task_t* task = 0;
+	    bool mallocAllowed = true;
+	    {
+	      boost::unique_lock<boost::mutex> lock (mutex_);
+	      while (!stop_ && generation_ == generation)
+		start_.wait (lock);
+	      if (stop_)
+		return;
+	      generation = generation_;
+	      task = task_;
+	      mallocAllowed = mallocAllowed_;
+	    }
+
+	    set_is_malloc_allowed (mallocAllowed);
+
+	    std::string error;
+	    bool failed = false;
+	    try
+	      {
+		(*task) (id);
+	      }
+	    catch (const std::exception& e)
+	      {
+		failed = true;
+		error = e.what ();
+	      }
+	    catch (...)
+	      {
+		failed = true;
+		error = "unknown exception in worker thread";
+	      }
+
+	    detail::reset_thread_malloc_allowed ();
+
+	    boost::lock_guard<boost::mutex> lock (mutex_);
+	    if (failed && !failed_)
+	      {
+		failed_ = true;
+		error_ = error;
+	      }
+	    if (--pending_ == 0)
+	      done_.notify_one ();
+	  }
+      }
+
+    private:
+      /// \brief Number of workers, including the calling thread.
+      const size_t size_;
+
+      /// \brief Worker threads.
+      boost::thread_group threads_;
+
+      /// \brief Mutex serializing the calls to run.
+      boost::mutex runMutex_;
+
+      /// \brief Mutex protecting the state below.
+      boost::mutex mutex_;
+
+      /// \brief Notified when a new task is available.
+      boost::condition_variable start_;
+
+      /// \brief Notified when all the workers are done.
+      boost::condition_variable done_;
+
+      /// \brief Current task.
+      const task_t* task_;
+
+      /// \brief Index of the current task.
+      size_t generation_;
+
+      /// \brief Number of threads still working on the current task.
+      size_t pending_;
+
+      /// \brief Allocation flag of the thread running the current task.
+      bool mallocAllowed_;
+
+      /// \brief Whether the workers should stop.
+      bool stop_;
+
+      /// \brief Whether a worker thread failed.
+      bool failed_;
+
+      /// \brief Error message of the first failure.
+      std::string error_;
+    };
+  } // end of namespace detail
+} // end of namespace roboptim
+
+#endif //! ROBOPTIM_CORE_DETAIL_THREAD_POOL_HH
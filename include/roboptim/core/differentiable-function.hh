@@ -24,6 +24,8 @@
 
 # include <log4cxx/logger.h>
 
+# include <boost/mpl/bool.hpp>
+
 # include <roboptim/core/fwd.hh>
 
 # include <roboptim/core/function.hh>
@@ -31,12 +33,14 @@
 # define ROBOPTIM_DIFFERENTIABLE_FUNCTION_FWD_TYPEDEFS(PARENT)	\
   ROBOPTIM_FUNCTION_FWD_TYPEDEFS (PARENT);			\
   ROBOPTIM_GENERATE_FWD_REFS (gradient);			\
-  ROBOPTIM_GENERATE_FWD_REFS (jacobian)
+  ROBOPTIM_GENERATE_FWD_REFS (jacobian);			\
+  typedef parent_t::sparsityPattern_t sparsityPattern_t
 
 # define ROBOPTIM_DIFFERENTIABLE_FUNCTION_FWD_TYPEDEFS_(PARENT)	\
   ROBOPTIM_FUNCTION_FWD_TYPEDEFS_ (PARENT);			\
   ROBOPTIM_GENERATE_FWD_REFS_ (gradient);			\
-  ROBOPTIM_GENERATE_FWD_REFS_ (jacobian)
+  ROBOPTIM_GENERATE_FWD_REFS_ (jacobian);			\
+  typedef typename parent_t::sparsityPattern_t sparsityPattern_t
 
 namespace roboptim
 {
@@ -89,6 +93,13 @@ namespace roboptim
     /// \brief Jacobian size type (pair of values).
     typedef std::pair<size_type, size_type> jacobianSize_t;
 
+    /// \brief Sparsity pattern type.
+    ///
+    /// The stored entries of a sparsity pattern are the entries of the
+    /// jacobian that may be nonzero. Their values are meaningless.
+    typedef GenericFunctionTraits<EigenMatrixSparse>::matrix_t
+    sparsityPattern_t;
+
 
     /// \brief Return the gradient size.
     ///
@@ -164,6 +175,69 @@ namespace roboptim
       assert (isValidJacobian (jacobian));
     }
 
+    /// \brief Computes the sparsity pattern of the jacobian.
+    ///
+    /// The pattern holds for any argument, and is computed without
+    /// evaluating the jacobian: sparse solvers can use it to allocate
+    /// their structures once.
+    /// \return sparsity pattern
+    sparsityPattern_t jacobianStructure () const
+    {
+      sparsityPattern_t pattern;
+      jacobianStructure (pattern);
+      return pattern;
+    }
+
+    /// \brief Computes the sparsity pattern of the jacobian.
+    ///
+    /// Unlike the other evaluation methods, this method may allocate
+    /// memory.
+    /// \param pattern pattern will be stored in this matrix (resized if
+    /// needed)
+    void jacobianStructure (sparsityPattern_t& pattern) const
+    {
+      LOG4CXX_TRACE (this->logger, "Computing jacobian structure");
+
+      pattern.resize (jacobianSize ().first, jacobianSize ().second);
+      this->impl_jacobian_structure (pattern);
+
+      assert (pattern.rows () == jacobianSize ().first
+	      && pattern.cols () == jacobianSize ().second);
+    }
+
+    /// \brief Computes the value and the jacobian at the same point.
+    ///
+    /// This is equivalent to calling #operator() then #jacobian, but
+    /// lets functions share the work needed by both computations.
+    /// Program will abort if the result or jacobian size is wrong before
+    /// or after the computation.
+    /// \param result result will be stored in this vector
+    /// \param jacobian jacobian will be stored in this argument
+    /// \param argument point at which the function will be evaluated
+    void valueAndJacobian (result_ref result, jacobian_ref jacobian,
+			   const_argument_ref argument) const
+    {
+      LOG4CXX_TRACE (this->logger,
+		     "Evaluating value and jacobian at point: " << argument);
+      assert (argument.size () == this->inputSize ());
+      assert (this->isValidResult (result));
+      assert (isValidJacobian (jacobian));
+
+#ifndef ROBOPTIM_DO_NOT_CHECK_ALLOCATION
+      bool cur_malloc_allowed = is_malloc_allowed ();
+      set_is_malloc_allowed (false);
+#endif //! ROBOPTIM_DO_NOT_CHECK_ALLOCATION
+
+      this->impl_value_and_jacobian (result, jacobian, argument);
+
+#ifndef ROBOPTIM_DO_NOT_CHECK_ALLOCATION
+      set_is_malloc_allowed (cur_malloc_allowed);
+#endif //! ROBOPTIM_DO_NOT_CHECK_ALLOCATION
+
+      assert (this->isValidResult (result));
+      assert (isValidJacobian (jacobian));
+    }
+
     /// \brief Computes the gradient.
     ///
     /// \param argument point at which the gradient will be computed
@@ -213,6 +287,59 @@ namespace roboptim
       assert (isValidGradient (gradient));
     }
 
+    /// \brief Computes the product of a vector with the jacobian.
+    ///
+    /// \f[ w^T J(x) = \nabla (w^T f)(x) \f]
+    ///
+    /// The default implementation accumulates the gradients of the
+    /// outputs with a non-zero weight, concrete classes should override
+    /// #impl_vector_jacobian_product when the product is cheaper (e.g.
+    /// reverse-mode differentiation, or operators composing products).
+    ///
+    /// \param argument point at which the jacobian will be computed
+    /// \param weights weight of each output (size: output size)
+    /// \return computed product (size: input size)
+    gradient_t vectorJacobianProduct (const_argument_ref argument,
+				      const_vector_ref weights) const
+    {
+      gradient_t result (gradientSize ());
+      result.setZero ();
+      this->vectorJacobianProduct (result, argument, weights);
+      return result;
+    }
+
+    /// \brief Computes the product of a vector with the jacobian.
+    ///
+    /// Program will abort if the result size is wrong before or after
+    /// the computation.
+    /// \param result product will be stored in this argument
+    /// \param argument point at which the jacobian will be computed
+    /// \param weights weight of each output (size: output size)
+    void vectorJacobianProduct (gradient_ref result,
+				const_argument_ref argument,
+				const_vector_ref weights) const
+    {
+      LOG4CXX_TRACE (this->logger,
+		     "Evaluating vector-jacobian product at point: "
+		     << argument);
+      assert (argument.size () == this->inputSize ());
+      assert (weights.size () == this->outputSize ());
+      assert (isValidGradient (result));
+
+#ifndef ROBOPTIM_DO_NOT_CHECK_ALLOCATION
+      bool cur_malloc_allowed = is_malloc_allowed ();
+      set_is_malloc_allowed (false);
+#endif //! ROBOPTIM_DO_NOT_CHECK_ALLOCATION
+
+      this->impl_vector_jacobian_product (result, argument, weights);
+
+#ifndef ROBOPTIM_DO_NOT_CHECK_ALLOCATION
+      set_is_malloc_allowed (cur_malloc_allowed);
+#endif //! ROBOPTIM_DO_NOT_CHECK_ALLOCATION
+
+      assert (isValidGradient (result));
+    }
+
     /// \brief Display the function on the specified output stream.
     ///
     /// \param o output stream used for display
@@ -239,6 +366,32 @@ namespace roboptim
     virtual void impl_jacobian (jacobian_ref jacobian, const_argument_ref arg)
       const;
 
+    /// \brief Jacobian sparsity pattern computation.
+    ///
+    /// Computes the sparsity pattern of the jacobian, can be overridden
+    /// by concrete classes whose jacobian has structural zeros. The
+    /// default behavior is to return a full pattern.
+    /// \warning Do not call this function directly, call
+    /// #jacobianStructure instead.
+    /// \param pattern empty matrix of the jacobian size, where the
+    /// pattern will be stored
+    virtual void impl_jacobian_structure (sparsityPattern_t& pattern) const;
+
+    /// \brief Value and jacobian evaluation.
+    ///
+    /// Computes the value and the jacobian at the same point, can be
+    /// overridden by concrete classes sharing intermediate results
+    /// between both computations. The default behavior is to call
+    /// #impl_compute then #impl_jacobian.
+    /// \warning Do not call this function directly, call
+    /// #valueAndJacobian instead.
+    /// \param result result will be stored in this vector
+    /// \param jacobian jacobian will be stored in this argument
+    /// \param argument point where the function will be evaluated
+    virtual void impl_value_and_jacobian (result_ref result,
+					  jacobian_ref jacobian,
+					  const_argument_ref argument) const;
+
     /// \brief Gradient evaluation.
     ///
     /// Compute the gradient, has to be implemented in concrete classes.
@@ -252,6 +405,42 @@ namespace roboptim
 				const_argument_ref argument,
 				size_type functionId = 0)
       const = 0;
+
+    /// \brief Vector-jacobian product evaluation.
+    ///
+    /// The default implementation accumulates the gradients of the
+    /// outputs with a non-zero weight. The result has to be overwritten.
+    /// \warning Do not call this function directly, call
+    /// #vectorJacobianProduct instead.
+    /// \param result product will be stored in this argument
+    /// \param argument point where the jacobian will be computed
+    /// \param weights weight of each output
+    virtual void impl_vector_jacobian_product (gradient_ref result,
+					       const_argument_ref argument,
+					       const_vector_ref weights)
+      const;
+
+  private:
+    /// \brief Assemble a sparse jacobian from the gradients.
+    ///
+    /// Shared by the sparse storages, whatever their precision.
+    ///
+    /// \param jacobian sparse jacobian
+    /// \param argument point where the jacobian will be computed
+    template <typename J>
+    void sparseJacobian (J& jacobian, const_argument_ref argument) const;
+
+    /// \brief Accumulate the weighted gradients in a dense product.
+    template <typename G>
+    void accumulateGradients (G& result, const_argument_ref argument,
+			      const_vector_ref weights,
+			      boost::mpl::true_) const;
+
+    /// \brief Accumulate the weighted gradients in a sparse product.
+    template <typename G>
+    void accumulateGradients (G& result, const_argument_ref argument,
+			      const_vector_ref weights,
+			      boost::mpl::false_) const;
   };
 
   /// @}
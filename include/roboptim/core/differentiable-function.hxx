@@ -32,22 +32,23 @@ namespace roboptim
   {
   }
 
-  template <>
-  inline void
-  GenericDifferentiableFunction<EigenMatrixSparse>::impl_jacobian
-  (jacobian_ref jacobian, const_argument_ref argument)
+  template <typename T>
+  template <typename J>
+  void
+  GenericDifferentiableFunction<T>::sparseJacobian
+  (J& jacobian, const_argument_ref argument)
     const
   {
     typedef Eigen::Triplet<value_type> triplet_t;
     std::vector<triplet_t> coefficients;
 
-    for (jacobian_t::Index i = 0; i < this->outputSize (); ++i)
+    for (typename J::Index i = 0; i < this->outputSize (); ++i)
       {
         gradient_t grad = gradient (argument, i);
-        for (gradient_t::InnerIterator it (grad); it; ++it)
+        for (typename gradient_t::InnerIterator it (grad); it; ++it)
           {
-            const jacobian_t::Index
-              idx = static_cast<const jacobian_t::Index> (it.index ());
+            const typename J::Index
+              idx = static_cast<const typename J::Index> (it.index ());
             coefficients.push_back
               (triplet_t (i, idx, it.value ()));
           }
@@ -65,6 +66,23 @@ namespace roboptim
 #endif //! ROBOPTIM_DO_NOT_CHECK_ALLOCATION
   }
 
+  template <>
+  inline void
+  GenericDifferentiableFunction<EigenMatrixSparse>::impl_jacobian
+  (jacobian_ref jacobian, const_argument_ref argument)
+    const
+  {
+    sparseJacobian (jacobian, argument);
+  }
+
+  template <>
+  inline void
+  GenericDifferentiableFunction<EigenMatrixSparseFloat>::impl_jacobian
+  (jacobian_ref jacobian, const_argument_ref argument)
+    const
+  {
+    sparseJacobian (jacobian, argument);
+  }
 
   template <typename T>
   void
@@ -76,6 +94,122 @@ namespace roboptim
        gradient (jacobian.row (i), argument, i);
   }
 
+  template <typename T>
+  void
+  GenericDifferentiableFunction<T>::impl_jacobian_structure
+  (sparsityPattern_t& pattern) const
+  {
+    typedef typename sparsityPattern_t::Index index_t;
+
+    // Without further knowledge, any entry may be nonzero. The pattern is
+    // filled directly, without any dense temporary.
+    const index_t outer = pattern.outerSize ();
+    const index_t inner = pattern.innerSize ();
+    pattern.setZero ();
+    pattern.reserve (Eigen::VectorXi::Constant (outer,
+						static_cast<int> (inner)));
+    for (index_t k = 0; k < outer; ++k)
+      for (index_t l = 0; l < inner; ++l)
+	pattern.insertByOuterInner (k, l) = 1.;
+    pattern.makeCompressed ();
+  }
+
+  template <typename T>
+  void
+  GenericDifferentiableFunction<T>::impl_value_and_jacobian
+  (result_ref result, jacobian_ref jacobian, const_argument_ref argument)
+    const
+  {
+    this->impl_compute (result, argument);
+    this->impl_jacobian (jacobian, argument);
+  }
+
+  template <typename T>
+  template <typename G>
+  void
+  GenericDifferentiableFunction<T>::accumulateGradients
+  (G& result, const_argument_ref argument, const_vector_ref weights,
+   boost::mpl::true_) const
+  {
+#ifndef ROBOPTIM_DO_NOT_CHECK_ALLOCATION
+    bool cur_malloc_allowed = is_malloc_allowed ();
+    set_is_malloc_allowed (true);
+#endif //! ROBOPTIM_DO_NOT_CHECK_ALLOCATION
+
+    gradient_t row (this->inputSize ());
+
+#ifndef ROBOPTIM_DO_NOT_CHECK_ALLOCATION
+    set_is_malloc_allowed (cur_malloc_allowed);
+#endif //! ROBOPTIM_DO_NOT_CHECK_ALLOCATION
+
+    result.setZero ();
+    for (size_type i = 0; i < this->outputSize (); ++i)
+      {
+	// Outputs with a zero weight do not contribute.
+	if (weights[i] == 0.)
+	  continue;
+
+	row.setZero ();
+	gradient (row, argument, i);
+	result += weights[i] * row;
+      }
+  }
+
+  template <typename T>
+  template <typename G>
+  void
+  GenericDifferentiableFunction<T>::accumulateGradients
+  (G& result, const_argument_ref argument, const_vector_ref weights,
+   boost::mpl::false_) const
+  {
+#ifndef ROBOPTIM_DO_NOT_CHECK_ALLOCATION
+    bool cur_malloc_allowed = is_malloc_allowed ();
+    set_is_malloc_allowed (true);
+#endif //! ROBOPTIM_DO_NOT_CHECK_ALLOCATION
+
+    // Sparse gradients are accumulated in a dense buffer, the sum of
+    // sparse vectors reallocating its storage.
+    rowVector_t product (this->inputSize ());
+    gradient_t row (this->inputSize ());
+    row.reserve (this->inputSize ());
+
+#ifndef ROBOPTIM_DO_NOT_CHECK_ALLOCATION
+    set_is_malloc_allowed (cur_malloc_allowed);
+#endif //! ROBOPTIM_DO_NOT_CHECK_ALLOCATION
+
+    product.setZero ();
+    for (size_type i = 0; i < this->outputSize (); ++i)
+      {
+	if (weights[i] == 0.)
+	  continue;
+
+	row.setZero ();
+	gradient (row, argument, i);
+	for (typename gradient_t::InnerIterator it (row); it; ++it)
+	  product[it.index ()] += weights[i] * it.value ();
+      }
+
+#ifndef ROBOPTIM_DO_NOT_CHECK_ALLOCATION
+    set_is_malloc_allowed (true);
+#endif //! ROBOPTIM_DO_NOT_CHECK_ALLOCATION
+
+    result = product.sparseView ();
+
+#ifndef ROBOPTIM_DO_NOT_CHECK_ALLOCATION
+    set_is_malloc_allowed (cur_malloc_allowed);
+#endif //! ROBOPTIM_DO_NOT_CHECK_ALLOCATION
+  }
+
+  template <typename T>
+  void
+  GenericDifferentiableFunction<T>::impl_vector_jacobian_product
+  (gradient_ref result, const_argument_ref argument,
+   const_vector_ref weights) const
+  {
+    accumulateGradients (result, argument, weights,
+			 boost::mpl::bool_<StorageTraits<T>::isDense> ());
+  }
+
   template <typename T>
   std::ostream&
   GenericDifferentiableFunction<T>::print (std::ostream& o) const
@@ -100,6 +234,8 @@ namespace roboptim
   ROBOPTIM_ALLOW_ATTRIBUTES_ON
   extern template class ROBOPTIM_CORE_DLLAPI GenericDifferentiableFunction<EigenMatrixDense>;
   extern template class ROBOPTIM_CORE_DLLAPI GenericDifferentiableFunction<EigenMatrixSparse>;
+  extern template class ROBOPTIM_CORE_DLLAPI GenericDifferentiableFunction<EigenMatrixDenseFloat>;
+  extern template class ROBOPTIM_CORE_DLLAPI GenericDifferentiableFunction<EigenMatrixSparseFloat>;
   ROBOPTIM_ALLOW_ATTRIBUTES_OFF
 # endif
 
@@ -17,7 +17,6 @@
 
 # include <boost/variant/apply_visitor.hpp>
 # include <boost/utility/enable_if.hpp>
-# include <boost/type_traits/is_same.hpp>
 
 # include <roboptim/core/util.hh>
 
@@ -111,9 +110,8 @@ namespace roboptim
       template <typename U>
       void operator ()
       (const boost::shared_ptr<U>& f,
-       typename boost::enable_if<boost::is_same<typename U::traits_t,
-                                                EigenMatrixDense>
-                                >::type* = 0)
+       typename boost::enable_if_c<StorageTraits<typename U::traits_t>
+                                   ::isDense>::type* = 0)
       {
         assert (f->inputSize () == m_);
 
@@ -124,9 +122,8 @@ namespace roboptim
       template <typename U>
       void operator ()
       (const boost::shared_ptr<U>& f,
-       typename boost::disable_if<boost::is_same<typename U::traits_t,
-                                                 EigenMatrixDense>
-                                 >::type* = 0)
+       typename boost::disable_if_c<StorageTraits<typename U::traits_t>
+                                    ::isDense>::type* = 0)
       {
         assert (f->inputSize () == m_);
 
@@ -88,7 +88,8 @@
   ROBOPTIM_GENERATE_FWD_REFS(result);		\
   ROBOPTIM_GENERATE_FWD_REFS(vector);		\
   ROBOPTIM_GENERATE_FWD_REFS(rowVector);		\
-  ROBOPTIM_GENERATE_FWD_REFS(matrix)
+  ROBOPTIM_GENERATE_FWD_REFS(matrix);		\
+  ROBOPTIM_GENERATE_FWD_REFS(batch)
 
 # define ROBOPTIM_FUNCTION_FWD_TYPEDEFS_(PARENT)	\
   typedef PARENT parent_t;				\
@@ -99,7 +100,8 @@
   ROBOPTIM_GENERATE_FWD_REFS_(result);			\
   ROBOPTIM_GENERATE_FWD_REFS_(vector);			\
   ROBOPTIM_GENERATE_FWD_REFS_(rowVector);			\
-  ROBOPTIM_GENERATE_FWD_REFS_(matrix)
+  ROBOPTIM_GENERATE_FWD_REFS_(matrix);			\
+  ROBOPTIM_GENERATE_FWD_REFS_(batch)
 
 # define ROBOPTIM_DEFINE_FLAG_TYPE()		\
   typedef unsigned int flag_t
@@ -233,6 +235,12 @@ namespace roboptim
     /// \brief Type of a function evaluation argument.
     ROBOPTIM_GENERATE_TRAITS_REFS_(argument);
 
+    /// \brief Type of a batch of arguments or results.
+    ///
+    /// Dense column-major matrix storing one argument (or result) per
+    /// column, used for batched evaluations.
+    ROBOPTIM_GENERATE_TRAITS_REFS_(batch);
+
     /// \brief Type of a function argument name.
     typedef std::string name_t;
 
@@ -418,6 +426,18 @@ namespace roboptim
     void operator () (result_ref result, const_argument_ref argument)
       const;
 
+    /// \brief Evaluate the function at several points.
+    ///
+    /// The program will abort if the arguments or the results do not
+    /// have the expected sizes. Contrary to operator(), the batch size
+    /// is not known in advance, so implementations may allocate
+    /// temporaries.
+    /// \param results results will be stored in this matrix, one per
+    /// column
+    /// \param arguments points at which the function will be evaluated,
+    /// one per column
+    void evaluateBatch (batch_ref results, const_batch_ref arguments) const;
+
     /// \brief Get function name.
     ///
     /// \return Function name.
@@ -457,6 +477,18 @@ namespace roboptim
     virtual void impl_compute (result_ref result, const_argument_ref argument)
       const = 0;
 
+    /// \brief Batched function evaluation.
+    ///
+    /// Evaluate the function at each column of arguments. The default
+    /// implementation calls impl_compute for each column. Functions that
+    /// can process all the points at once (e.g. with a single matrix
+    /// product) should override it.  \warning Do not call this function
+    /// directly, call #evaluateBatch instead.
+    /// \param results results will be stored in this matrix
+    /// \param arguments points at which the function will be evaluated
+    virtual void impl_compute_batch (batch_ref results,
+				     const_batch_ref arguments) const;
+
   private:
     /// \brief Problem dimension.
     size_type inputSize_;
@@ -476,13 +508,173 @@ namespace roboptim
   log4cxx::LoggerPtr GenericFunction<T>::logger
   (log4cxx::Logger::getLogger ("roboptim"));
 
+  namespace detail
+  {
+    /// \brief Function traits of Eigen dense matrices.
+    ///
+    /// \tparam S scalar type.
+    template <typename S>
+    struct DenseFunctionTraits
+    {
+      /// \brief Matrix storage order.
+      static const int StorageOrder = roboptim::StorageOrder;
+
+      /// \brief Value type.
+      typedef S value_type;
+
+      // For each type, we have:
+      //  - type_t:         the type itself
+      //  - type_ref:       reference to type object
+      //  - const_type_ref: const reference to type object
+
+      // Matrix types
+      ROBOPTIM_GENERATE_TYPEDEFS_EIGEN_REF
+      (matrix,
+       Eigen::Matrix<value_type BOOST_PP_COMMA()
+       Eigen::Dynamic BOOST_PP_COMMA()
+       Eigen::Dynamic BOOST_PP_COMMA()
+       StorageOrder>);
+
+      // Vector types
+      ROBOPTIM_GENERATE_TYPEDEFS_EIGEN_REF
+      (vector,
+       Eigen::Matrix<value_type BOOST_PP_COMMA()
+       Eigen::Dynamic BOOST_PP_COMMA()
+       1>);
+
+      // Row vector types
+      ROBOPTIM_GENERATE_TYPEDEFS_EIGEN_REF
+      (rowVector,
+       Eigen::Matrix<value_type BOOST_PP_COMMA()
+       1 BOOST_PP_COMMA()
+       Eigen::Dynamic>);
+
+      typedef typename matrix_t::Index size_type;
+
+      ROBOPTIM_GENERATE_TYPEDEFS_EIGEN_REF(result,vector_t);
+      ROBOPTIM_GENERATE_TYPEDEFS_EIGEN_REF(argument,vector_t);
+      ROBOPTIM_GENERATE_TYPEDEFS_EIGEN_REF
+      (batch,
+       Eigen::Matrix<value_type BOOST_PP_COMMA()
+       Eigen::Dynamic BOOST_PP_COMMA()
+       Eigen::Dynamic BOOST_PP_COMMA()
+       Eigen::ColMajor>);
+      typedef rowVector_t gradient_t;
+      typedef Eigen::Ref<gradient_t, 0,
+			 typename row_vector_stride<StorageOrder>::type>
+      gradient_ref;
+      typedef const Eigen::Ref<const gradient_t, 0,
+			       typename row_vector_stride
+			       <StorageOrder>::type>&
+      const_gradient_ref;
+      ROBOPTIM_GENERATE_TYPEDEFS_EIGEN_REF(jacobian,matrix_t);
+      ROBOPTIM_GENERATE_TYPEDEFS_EIGEN_REF(hessian,matrix_t);
+      ROBOPTIM_GENERATE_TYPEDEFS_EIGEN_REF(derivative,vector_t);
+    };
+
+    /// \brief Function traits of Eigen sparse matrices.
+    ///
+    /// \tparam S scalar type.
+    template <typename S>
+    struct SparseFunctionTraits
+    {
+      /// \brief Matrix storage order.
+      static const int StorageOrder = roboptim::StorageOrder;
+
+      /// \brief Value type.
+      typedef S value_type;
+
+      // For each type, we have:
+      //  - type_t:         the type itself
+      //  - type_ref:       reference to type object
+      //  - const_type_ref: const reference to type object
+
+      // Matrix types
+      ROBOPTIM_GENERATE_TYPEDEFS_REF
+      (matrix,
+       Eigen::SparseMatrix<value_type BOOST_PP_COMMA() StorageOrder>);
+
+      // Vector types
+      ROBOPTIM_GENERATE_TYPEDEFS_EIGEN_REF
+      (vector,
+       Eigen::Matrix<value_type BOOST_PP_COMMA()
+       Eigen::Dynamic BOOST_PP_COMMA()
+       1>);
+
+      // Row vector types
+      ROBOPTIM_GENERATE_TYPEDEFS_EIGEN_REF
+      (rowVector,
+       Eigen::Matrix<value_type BOOST_PP_COMMA()
+       1 BOOST_PP_COMMA()
+       Eigen::Dynamic>);
+
+      typedef typename matrix_t::Index size_type;
+
+      ROBOPTIM_GENERATE_TYPEDEFS_EIGEN_REF(result,vector_t);
+      ROBOPTIM_GENERATE_TYPEDEFS_EIGEN_REF(argument,vector_t);
+      ROBOPTIM_GENERATE_TYPEDEFS_EIGEN_REF
+      (batch,
+       Eigen::Matrix<value_type BOOST_PP_COMMA()
+       Eigen::Dynamic BOOST_PP_COMMA()
+       Eigen::Dynamic BOOST_PP_COMMA()
+       Eigen::ColMajor>);
+      ROBOPTIM_GENERATE_TYPEDEFS_REF(gradient,Eigen::SparseVector<value_type \
+                                     BOOST_PP_COMMA() Eigen::RowMajor>);
+      ROBOPTIM_GENERATE_TYPEDEFS_REF(jacobian,matrix_t);
+      ROBOPTIM_GENERATE_TYPEDEFS_REF(hessian,matrix_t);
+      ROBOPTIM_GENERATE_TYPEDEFS_EIGEN_REF(derivative,vector_t);
+    };
+  } // end of namespace detail
+
   /// \brief Trait specializing GenericFunction for Eigen dense matrices.
   template <>
   struct ROBOPTIM_CORE_DLLAPI GenericFunctionTraits<EigenMatrixDense>
+    : public detail::DenseFunctionTraits<double>
+  {};
+
+  /// \brief Trait specializing GenericFunction for Eigen sparse matrices.
+  template <>
+  struct ROBOPTIM_CORE_DLLAPI GenericFunctionTraits<EigenMatrixSparse>
+    : public detail::SparseFunctionTraits<double>
+  {};
+
+  /// \brief Trait specializing GenericFunction for single-precision Eigen
+  /// dense matrices.
+  template <>
+  struct ROBOPTIM_CORE_DLLAPI GenericFunctionTraits<EigenMatrixDenseFloat>
+    : public detail::DenseFunctionTraits<float>
+  {};
+
+  /// \brief Trait specializing GenericFunction for single-precision Eigen
+  /// sparse matrices.
+  template <>
+  struct ROBOPTIM_CORE_DLLAPI GenericFunctionTraits<EigenMatrixSparseFloat>
+    : public detail::SparseFunctionTraits<float>
+  {};
+
+  /// \brief Trait specializing GenericFunction for fixed-size Eigen dense
+  /// matrices.
+  ///
+  /// Arguments, results and derivatives have compile-time dimensions, so
+  /// that they are stored on the stack and their loops are unrolled.
+  /// Generic matrices and vectors, as well as batches, stay dynamic.
+  /// Functions built with other sizes throw std::runtime_error.
+  ///
+  /// \tparam N input size.
+  /// \tparam M output size.
+  template <int N, int M>
+  struct GenericFunctionTraits<EigenMatrixFixed<N, M> >
   {
     /// \brief Matrix storage order.
     static const int StorageOrder = roboptim::StorageOrder;
 
+    /// \brief Storage order of the jacobian (Eigen requires row-major
+    /// storage for row vectors and column-major storage for column
+    /// vectors).
+    static const int JacobianStorageOrder =
+      (M == 1 && N != 1)? Eigen::RowMajor
+      : (N == 1 && M != 1)? Eigen::ColMajor : StorageOrder;
+
     /// \brief Value type.
     typedef double value_type;
 
@@ -513,59 +705,124 @@ namespace roboptim
      1 BOOST_PP_COMMA()
      Eigen::Dynamic>);
 
-    typedef matrix_t::Index size_type;
-
-    ROBOPTIM_GENERATE_TYPEDEFS_EIGEN_REF(result,vector_t);
-    ROBOPTIM_GENERATE_TYPEDEFS_EIGEN_REF(argument,vector_t);
-    ROBOPTIM_GENERATE_TYPEDEFS_EIGEN_REF_VEC(gradient,rowVector_t);
-    ROBOPTIM_GENERATE_TYPEDEFS_EIGEN_REF(jacobian,matrix_t);
-    ROBOPTIM_GENERATE_TYPEDEFS_EIGEN_REF(hessian,matrix_t);
-    ROBOPTIM_GENERATE_TYPEDEFS_EIGEN_REF(derivative,vector_t);
-  };
-
-  /// \brief Trait specializing GenericFunction for Eigen sparse matrices.
-  template <>
-  struct ROBOPTIM_CORE_DLLAPI GenericFunctionTraits<EigenMatrixSparse>
-  {
-    /// \brief Matrix storage order.
-    static const int StorageOrder = roboptim::StorageOrder;
-
-    /// \brief Value type.
-    typedef double value_type;
+    typedef typename matrix_t::Index size_type;
 
-    // For each type, we have:
-    //  - type_t:         the type itself
-    //  - type_ref:       reference to type object
-    //  - const_type_ref: const reference to type object
-
-    // Matrix types
-    ROBOPTIM_GENERATE_TYPEDEFS_REF
-    (matrix,
-     Eigen::SparseMatrix<value_type BOOST_PP_COMMA() StorageOrder>);
-
-    // Vector types
     ROBOPTIM_GENERATE_TYPEDEFS_EIGEN_REF
-    (vector,
+    (result,
+     Eigen::Matrix<value_type BOOST_PP_COMMA() M BOOST_PP_COMMA() 1>);
+    ROBOPTIM_GENERATE_TYPEDEFS_EIGEN_REF
+    (argument,
+     Eigen::Matrix<value_type BOOST_PP_COMMA() N BOOST_PP_COMMA() 1>);
+    ROBOPTIM_GENERATE_TYPEDEFS_EIGEN_REF
+    (batch,
      Eigen::Matrix<value_type BOOST_PP_COMMA()
      Eigen::Dynamic BOOST_PP_COMMA()
-     1>);
+     Eigen::Dynamic BOOST_PP_COMMA()
+     Eigen::ColMajor>);
+
+    typedef Eigen::Matrix<value_type, 1, N> gradient_t;
+    typedef Eigen::Ref<gradient_t, 0,
+		       typename detail::row_vector_stride<StorageOrder>::type>
+    gradient_ref;
+    typedef const Eigen::Ref<const gradient_t, 0,
+			     typename detail::row_vector_stride
+			     <StorageOrder>::type>&
+    const_gradient_ref;
 
-    // Row vector types
     ROBOPTIM_GENERATE_TYPEDEFS_EIGEN_REF
-    (rowVector,
+    (jacobian,
      Eigen::Matrix<value_type BOOST_PP_COMMA()
-     1 BOOST_PP_COMMA()
-     Eigen::Dynamic>);
+     M BOOST_PP_COMMA()
+     N BOOST_PP_COMMA()
+     JacobianStorageOrder>);
+    ROBOPTIM_GENERATE_TYPEDEFS_EIGEN_REF
+    (hessian,
+     Eigen::Matrix<value_type BOOST_PP_COMMA()
+     N BOOST_PP_COMMA()
+     N BOOST_PP_COMMA()
+     StorageOrder>);
+    ROBOPTIM_GENERATE_TYPEDEFS_EIGEN_REF(derivative,result_t);
+  };
 
-    typedef matrix_t::Index size_type;
+  /// \brief Matrix storage and scalar precision of a traits tag.
+  ///
+  /// \tparam T traits tag (e.g. EigenMatrixDense).
+  template <typename T>
+  struct StorageTraits;
 
-    ROBOPTIM_GENERATE_TYPEDEFS_EIGEN_REF(result,vector_t);
-    ROBOPTIM_GENERATE_TYPEDEFS_EIGEN_REF(argument,vector_t);
-    ROBOPTIM_GENERATE_TYPEDEFS_REF(gradient,Eigen::SparseVector<value_type \
-                                   BOOST_PP_COMMA() Eigen::RowMajor>);
-    ROBOPTIM_GENERATE_TYPEDEFS_REF(jacobian,matrix_t);
-    ROBOPTIM_GENERATE_TYPEDEFS_REF(hessian,matrix_t);
-    ROBOPTIM_GENERATE_TYPEDEFS_EIGEN_REF(derivative,vector_t);
+  /// \brief Storage traits of double-precision dense matrices.
+  template <>
+  struct StorageTraits<EigenMatrixDense>
+  {
+    /// \brief Whether matrices are dense.
+    static const bool isDense = true;
+    /// \brief Tag with the same storage in double precision.
+    typedef EigenMatrixDense doublePrecision_t;
+    /// \brief Tag with the same storage in single precision.
+    typedef EigenMatrixDenseFloat singlePrecision_t;
+    /// \brief Tag with the same storage and precision, and dynamic
+    /// sizes.
+    typedef EigenMatrixDense dynamicSize_t;
+  };
+
+  /// \brief Storage traits of double-precision sparse matrices.
+  template <>
+  struct StorageTraits<EigenMatrixSparse>
+  {
+    /// \brief Whether matrices are dense.
+    static const bool isDense = false;
+    /// \brief Tag with the same storage in double precision.
+    typedef EigenMatrixSparse doublePrecision_t;
+    /// \brief Tag with the same storage in single precision.
+    typedef EigenMatrixSparseFloat singlePrecision_t;
+    /// \brief Tag with the same storage and precision, and dynamic
+    /// sizes.
+    typedef EigenMatrixSparse dynamicSize_t;
+  };
+
+  /// \brief Storage traits of single-precision dense matrices.
+  template <>
+  struct StorageTraits<EigenMatrixDenseFloat>
+  {
+    /// \brief Whether matrices are dense.
+    static const bool isDense = true;
+    /// \brief Tag with the same storage in double precision.
+    typedef EigenMatrixDense doublePrecision_t;
+    /// \brief Tag with the same storage in single precision.
+    typedef EigenMatrixDenseFloat singlePrecision_t;
+    /// \brief Tag with the same storage and precision, and dynamic
+    /// sizes.
+    typedef EigenMatrixDenseFloat dynamicSize_t;
+  };
+
+  /// \brief Storage traits of single-precision sparse matrices.
+  template <>
+  struct StorageTraits<EigenMatrixSparseFloat>
+  {
+    /// \brief Whether matrices are dense.
+    static const bool isDense = false;
+    /// \brief Tag with the same storage in double precision.
+    typedef EigenMatrixSparse doublePrecision_t;
+    /// \brief Tag with the same storage in single precision.
+    typedef EigenMatrixSparseFloat singlePrecision_t;
+    /// \brief Tag with the same storage and precision, and dynamic
+    /// sizes.
+    typedef EigenMatrixSparseFloat dynamicSize_t;
+  };
+
+  /// \brief Storage traits of fixed-size dense matrices.
+  template <int N, int M>
+  struct StorageTraits<EigenMatrixFixed<N, M> >
+  {
+    /// \brief Whether matrices are dense.
+    static const bool isDense = true;
+    /// \brief Tag with the same storage in double precision.
+    typedef EigenMatrixFixed<N, M> doublePrecision_t;
+    /// \brief Tag with dense storage in single precision.
+    typedef EigenMatrixDenseFloat singlePrecision_t;
+    /// \brief Tag with the same storage and precision, and dynamic
+    /// sizes.
+    typedef EigenMatrixDense dynamicSize_t;
   };
 
   /// @}
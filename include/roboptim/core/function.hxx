@@ -142,6 +142,18 @@ namespace roboptim
   {
     // Positive size is required.
     assert (inputSize > 0 && outputSize > 0);
+
+    // Sizes known at compile time (see EigenMatrixFixed) must match.
+    const int n = argument_t::RowsAtCompileTime;
+    const int m = result_t::RowsAtCompileTime;
+    if ((n != Eigen::Dynamic && inputSize != n)
+        || (m != Eigen::Dynamic && outputSize != m))
+      {
+        boost::format fmt ("function sizes (%d, %d) do not match the"
+                           " compile-time sizes (%d, %d)");
+        fmt % inputSize % outputSize % n % m;
+        throw std::runtime_error (fmt.str ());
+      }
   }
 
   template <typename T>
@@ -190,6 +202,27 @@ namespace roboptim
     assert (isValidResult (result));
   }
 
+  template <typename T>
+  void GenericFunction<T>::evaluateBatch (batch_ref results,
+                                          const_batch_ref arguments) const
+  {
+    LOG4CXX_TRACE
+      (logger, "Evaluating function at " << arguments.cols () << " points");
+    assert (arguments.rows () == inputSize ());
+    assert (results.rows () == outputSize ());
+    assert (results.cols () == arguments.cols ());
+
+    this->impl_compute_batch (results, arguments);
+  }
+
+  template <typename T>
+  void GenericFunction<T>::impl_compute_batch (batch_ref results,
+                                               const_batch_ref arguments) const
+  {
+    for (typename batch_t::Index i = 0; i < arguments.cols (); ++i)
+      this->impl_compute (results.col (i), arguments.col (i));
+  }
+
   template <typename T>
   typename GenericFunction<T>::result_t
   GenericFunction<T>::operator () (const_argument_ref argument) const
@@ -348,6 +381,8 @@ namespace roboptim
   ROBOPTIM_ALLOW_ATTRIBUTES_ON
   extern template class ROBOPTIM_CORE_DLLAPI GenericFunction<EigenMatrixDense>;
   extern template class ROBOPTIM_CORE_DLLAPI GenericFunction<EigenMatrixSparse>;
+  extern template class ROBOPTIM_CORE_DLLAPI GenericFunction<EigenMatrixDenseFloat>;
+  extern template class ROBOPTIM_CORE_DLLAPI GenericFunction<EigenMatrixSparseFloat>;
   ROBOPTIM_ALLOW_ATTRIBUTES_OFF
 # endif //! ROBOPTIM_PRECOMPILED_DENSE_SPARSE
 
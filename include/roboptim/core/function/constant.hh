@@ -93,6 +93,11 @@ namespace roboptim
       jacobian.setZero ();
     }
 
+    void impl_jacobian_structure (sparsityPattern_t&) const
+    {
+      // The jacobian is zero: the pattern is empty.
+    }
+
   private:
     const vector_t offset_;
   };
@@ -107,6 +112,8 @@ namespace roboptim
   ROBOPTIM_ALLOW_ATTRIBUTES_ON
   extern template class ROBOPTIM_CORE_DLLAPI GenericConstantFunction<EigenMatrixDense>;
   extern template class ROBOPTIM_CORE_DLLAPI GenericConstantFunction<EigenMatrixSparse>;
+  extern template class ROBOPTIM_CORE_DLLAPI GenericConstantFunction<EigenMatrixDenseFloat>;
+  extern template class ROBOPTIM_CORE_DLLAPI GenericConstantFunction<EigenMatrixSparseFloat>;
   ROBOPTIM_ALLOW_ATTRIBUTES_OFF
 # endif
 
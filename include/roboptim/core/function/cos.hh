@@ -60,6 +60,11 @@ namespace roboptim
       result[0] = std::cos (x[0]);
     }
 
+    void impl_compute_batch (batch_ref results, const_batch_ref x) const
+    {
+      results.array () = x.array ().cos ();
+    }
+
     void impl_gradient (gradient_ref gradient, const_argument_ref x, size_type)
     const;
 
@@ -75,7 +80,15 @@ namespace roboptim
   Cos<EigenMatrixSparse>::impl_gradient (gradient_ref gradient, const_argument_ref x, size_type)
     const
   {
-    gradient.insert (0) = -std::sin (x[0]);
+    gradient.coeffRef (0) = -std::sin (x[0]);
+  }
+
+  template <>
+  inline void
+  Cos<EigenMatrixSparseFloat>::impl_gradient (gradient_ref gradient, const_argument_ref x, size_type)
+    const
+  {
+    gradient.coeffRef (0) = -std::sin (x[0]);
   }
 
   template <typename T>
@@ -93,6 +106,15 @@ namespace roboptim
   {
     jacobian.coeffRef (0, 0) = -std::sin (x[0]);
   }
+
+  template <>
+  inline void
+  Cos<EigenMatrixSparseFloat>::impl_jacobian
+  (jacobian_ref jacobian, const_argument_ref x) const
+  {
+    jacobian.coeffRef (0, 0) = -std::sin (x[0]);
+  }
+
   template <typename T>
   void
   Cos<T>::impl_jacobian
@@ -119,6 +141,15 @@ namespace roboptim
     hessian.coeffRef (0, 0) = -std::cos (x[0]);
   }
 
+  template <>
+  inline void
+  Cos<EigenMatrixSparseFloat>::impl_hessian (hessian_ref hessian,
+					     const_argument_ref x,
+					     size_type) const
+  {
+    hessian.coeffRef (0, 0) = -std::cos (x[0]);
+  }
+
 
   /// Example shows cosinus function use.
   /// \example function_cos.cc
@@ -130,6 +161,8 @@ namespace roboptim
   ROBOPTIM_ALLOW_ATTRIBUTES_ON
   extern template class ROBOPTIM_CORE_DLLAPI Cos<EigenMatrixDense>;
   extern template class ROBOPTIM_CORE_DLLAPI Cos<EigenMatrixSparse>;
+  extern template class ROBOPTIM_CORE_DLLAPI Cos<EigenMatrixDenseFloat>;
+  extern template class ROBOPTIM_CORE_DLLAPI Cos<EigenMatrixSparseFloat>;
   ROBOPTIM_ALLOW_ATTRIBUTES_OFF
 # endif
 
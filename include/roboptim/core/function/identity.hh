@@ -76,6 +76,11 @@ namespace roboptim
       jacobian.setIdentity ();
     }
 
+    void impl_jacobian_structure (sparsityPattern_t& pattern) const
+    {
+      pattern.setIdentity ();
+    }
+
     void
     impl_gradient (gradient_ref gradient,
 		   const_argument_ref ,
@@ -94,6 +99,15 @@ namespace roboptim
     gradient.insert (idFunction) = 1.;
   }
 
+  template <>
+  inline void
+  GenericIdentityFunction<EigenMatrixSparseFloat>::impl_gradient
+  (gradient_ref gradient, const_argument_ref, size_type idFunction) const
+  {
+    gradient.setZero ();
+    gradient.insert (idFunction) = 1.;
+  }
+
   template <typename T>
   void
   GenericIdentityFunction<T>::impl_gradient
@@ -113,6 +127,8 @@ namespace roboptim
   ROBOPTIM_ALLOW_ATTRIBUTES_ON
   extern template class ROBOPTIM_CORE_DLLAPI GenericIdentityFunction<EigenMatrixDense>;
   extern template class ROBOPTIM_CORE_DLLAPI GenericIdentityFunction<EigenMatrixSparse>;
+  extern template class ROBOPTIM_CORE_DLLAPI GenericIdentityFunction<EigenMatrixDenseFloat>;
+  extern template class ROBOPTIM_CORE_DLLAPI GenericIdentityFunction<EigenMatrixSparseFloat>;
   ROBOPTIM_ALLOW_ATTRIBUTES_OFF
 # endif
 
@@ -60,6 +60,8 @@ namespace roboptim
   protected:
     void impl_compute (result_ref result, const_argument_ref x) const;
 
+    void impl_compute_batch (batch_ref results, const_batch_ref x) const;
+
     void impl_gradient (gradient_ref gradient, const_argument_ref x, size_type)
       const;
 
@@ -69,6 +71,14 @@ namespace roboptim
     void impl_hessian
     (hessian_ref hessian, const_argument_ref x, size_type) const;
 
+    void impl_hessian_vector_product
+    (vector_ref result, const_argument_ref x, const_vector_ref direction,
+     size_type) const;
+
+    void impl_lagrangian_hessian
+    (hessian_ref hessian, const_argument_ref x, const_vector_ref weights)
+      const;
+
     /// \brief Implement Horner's method.
     value_type applyPolynomial
     (const_vector_ref coeffs, const_argument_ref x) const;
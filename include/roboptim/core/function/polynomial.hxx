@@ -124,6 +124,17 @@ namespace roboptim
     result[0] = applyPolynomial (coeffs_, x);
   }
 
+  template <typename T>
+  void Polynomial<T>::impl_compute_batch (batch_ref results,
+					  const_batch_ref x) const
+  {
+    // Horner's method, applied to all the points at once.
+    results.setZero ();
+    for (typename vector_t::Index degree = coeffs_.size () - 1; degree >= 0;
+	 --degree)
+      results.array () = results.array () * x.array () + coeffs_[degree];
+  }
+
   template <typename T>
   typename Polynomial<T>::value_type Polynomial<T>::applyPolynomial
   (const_vector_ref coeffs, const_argument_ref x) const
@@ -163,11 +174,32 @@ namespace roboptim
     hessian.coeffRef (0, 0) = applyPolynomial (dDCoeffs_, x);
   }
 
+  template <typename T>
+  void
+  Polynomial<T>::impl_hessian_vector_product (vector_ref result,
+					      const_argument_ref x,
+					      const_vector_ref direction,
+					      size_type) const
+  {
+    result[0] = applyPolynomial (dDCoeffs_, x) * direction[0];
+  }
+
+  template <typename T>
+  void
+  Polynomial<T>::impl_lagrangian_hessian (hessian_ref hessian,
+					  const_argument_ref x,
+					  const_vector_ref weights) const
+  {
+    hessian.coeffRef (0, 0) = weights[0] * applyPolynomial (dDCoeffs_, x);
+  }
+
 // Explicit template instantiations for dense and sparse matrices.
 # ifdef ROBOPTIM_PRECOMPILED_DENSE_SPARSE
   ROBOPTIM_ALLOW_ATTRIBUTES_ON
   extern template class ROBOPTIM_CORE_DLLAPI Polynomial<EigenMatrixDense>;
   extern template class ROBOPTIM_CORE_DLLAPI Polynomial<EigenMatrixSparse>;
+  extern template class ROBOPTIM_CORE_DLLAPI Polynomial<EigenMatrixDenseFloat>;
+  extern template class ROBOPTIM_CORE_DLLAPI Polynomial<EigenMatrixSparseFloat>;
   ROBOPTIM_ALLOW_ATTRIBUTES_OFF
 # endif
 
@@ -60,6 +60,11 @@ namespace roboptim
       result[0] = std::sin (x[0]);
     }
 
+    void impl_compute_batch (batch_ref results, const_batch_ref x) const
+    {
+      results.array () = x.array ().sin ();
+    }
+
     void impl_gradient (gradient_ref gradient, const_argument_ref x, size_type)
     const;
 
@@ -74,7 +79,15 @@ namespace roboptim
   Sin<EigenMatrixSparse>::impl_gradient (gradient_ref gradient, const_argument_ref x, size_type)
     const
   {
-    gradient.insert (0) = std::cos (x[0]);
+    gradient.coeffRef (0) = std::cos (x[0]);
+  }
+
+  template <>
+  inline void
+  Sin<EigenMatrixSparseFloat>::impl_gradient (gradient_ref gradient, const_argument_ref x, size_type)
+    const
+  {
+    gradient.coeffRef (0) = std::cos (x[0]);
   }
 
   template <typename T>
@@ -92,6 +105,15 @@ namespace roboptim
   {
     jacobian.coeffRef (0, 0) = std::cos (x[0]);
   }
+
+  template <>
+  inline void
+  Sin<EigenMatrixSparseFloat>::impl_jacobian
+  (jacobian_ref jacobian, const_argument_ref x) const
+  {
+    jacobian.coeffRef (0, 0) = std::cos (x[0]);
+  }
+
   template <typename T>
   void
   Sin<T>::impl_jacobian
@@ -118,6 +140,15 @@ namespace roboptim
     hessian.coeffRef (0, 0) = -std::sin (x[0]);
   }
 
+  template <>
+  inline void
+  Sin<EigenMatrixSparseFloat>::impl_hessian (hessian_ref hessian,
+					     const_argument_ref x,
+					     size_type) const
+  {
+    hessian.coeffRef (0, 0) = -std::sin (x[0]);
+  }
+
 
   /// Example shows constant function use.
   /// \example sin.cc
@@ -129,6 +160,8 @@ namespace roboptim
   ROBOPTIM_ALLOW_ATTRIBUTES_ON
   extern template class ROBOPTIM_CORE_DLLAPI Sin<EigenMatrixDense>;
   extern template class ROBOPTIM_CORE_DLLAPI Sin<EigenMatrixSparse>;
+  extern template class ROBOPTIM_CORE_DLLAPI Sin<EigenMatrixDenseFloat>;
+  extern template class ROBOPTIM_CORE_DLLAPI Sin<EigenMatrixSparseFloat>;
   ROBOPTIM_ALLOW_ATTRIBUTES_OFF
 # endif
 
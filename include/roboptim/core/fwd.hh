@@ -41,6 +41,14 @@ namespace roboptim
     class Simple;
     template <typename T>
     class FivePointsRule;
+    template <typename T>
+    class ColumnColoring;
+    template <typename T>
+    class Parallel;
+    template <typename T>
+    class Adaptive;
+    template <typename T>
+    class ComplexStep;
   } // end of finiteDifferenceGradientPolicies
 
   template <typename T,
@@ -55,10 +63,39 @@ namespace roboptim
   struct ROBOPTIM_CORE_DLLAPI EigenMatrixDense {};
   /// \brief Tag type for functions using Eigen sparse matrices.
   struct ROBOPTIM_CORE_DLLAPI EigenMatrixSparse {};
+  /// \brief Tag type for functions using single-precision Eigen dense
+  /// matrices.
+  ///
+  /// The library precompiles the function hierarchy and Problem for the
+  /// single-precision tags. Solvers and their callbacks are double-only.
+  struct ROBOPTIM_CORE_DLLAPI EigenMatrixDenseFloat {};
+  /// \brief Tag type for functions using single-precision Eigen sparse
+  /// matrices.
+  struct ROBOPTIM_CORE_DLLAPI EigenMatrixSparseFloat {};
+  /// \brief Tag type for functions using fixed-size Eigen dense matrices.
+  ///
+  /// \tparam N input size.
+  /// \tparam M output size.
+  template <int N, int M = 1>
+  struct EigenMatrixFixed {};
 
   template <typename T>
   class GenericFunction;
 
+  namespace detail
+  {
+    template <typename T>
+    class FunctionCompiler;
+
+    struct GraphTraversal;
+  } // end of namespace detail
+
+  template <typename T>
+  class GenericFunctionGraph;
+
+  template <typename T>
+  class GenericCompiledFunction;
+
   /// \brief Dense function.
   typedef GenericFunction<EigenMatrixDense>
   Function;
@@ -67,6 +104,14 @@ namespace roboptim
   typedef GenericFunction<EigenMatrixSparse>
   SparseFunction;
 
+  /// \brief Single-precision dense function.
+  typedef GenericFunction<EigenMatrixDenseFloat>
+  FloatFunction;
+
+  /// \brief Single-precision sparse function.
+  typedef GenericFunction<EigenMatrixSparseFloat>
+  FloatSparseFunction;
+
   template <typename T>
   class GenericDifferentiableFunction;
 
@@ -78,6 +123,14 @@ namespace roboptim
   typedef GenericDifferentiableFunction<EigenMatrixSparse>
   DifferentiableSparseFunction;
 
+  /// \brief Single-precision dense differentiable function.
+  typedef GenericDifferentiableFunction<EigenMatrixDenseFloat>
+  DifferentiableFloatFunction;
+
+  /// \brief Single-precision sparse differentiable function.
+  typedef GenericDifferentiableFunction<EigenMatrixSparseFloat>
+  DifferentiableFloatSparseFunction;
+
   template <typename T>
   class GenericConstantFunction;
 
@@ -154,6 +207,7 @@ namespace roboptim
   struct derivativeSize;
 
   template <typename K, typename V, typename H> class LRUCache;
+  template <typename K, typename V, typename H> class ShardedLRUCache;
 
   template <typename T>
   class OptimizationLogger;
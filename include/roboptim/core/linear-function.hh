@@ -56,6 +56,15 @@ namespace roboptim
     void impl_hessian (hessian_ref hessian,
 		       const_argument_ref argument,
 		       size_type functionId = 0) const;
+
+    void impl_hessian_vector_product (vector_ref result,
+				      const_argument_ref argument,
+				      const_vector_ref direction,
+				      size_type functionId = 0) const;
+
+    void impl_lagrangian_hessian (hessian_ref hessian,
+				  const_argument_ref argument,
+				  const_vector_ref weights) const;
   };
 
   /// @}
@@ -38,6 +38,22 @@ namespace roboptim
     this->setZero (hessian);
   }
 
+  template <typename T>
+  void
+  GenericLinearFunction<T>::impl_hessian_vector_product
+  (vector_ref result, const_argument_ref, const_vector_ref, size_type) const
+  {
+    result.setZero ();
+  }
+
+  template <typename T>
+  void
+  GenericLinearFunction<T>::impl_lagrangian_hessian
+  (hessian_ref hessian, const_argument_ref, const_vector_ref) const
+  {
+    this->setZero (hessian);
+  }
+
   template <typename T>
   std::ostream&
   GenericLinearFunction<T>::print (std::ostream& o) const
@@ -53,6 +69,8 @@ namespace roboptim
   ROBOPTIM_ALLOW_ATTRIBUTES_ON
   extern template class ROBOPTIM_CORE_DLLAPI GenericLinearFunction<EigenMatrixDense>;
   extern template class ROBOPTIM_CORE_DLLAPI GenericLinearFunction<EigenMatrixSparse>;
+  extern template class ROBOPTIM_CORE_DLLAPI GenericLinearFunction<EigenMatrixDenseFloat>;
+  extern template class ROBOPTIM_CORE_DLLAPI GenericLinearFunction<EigenMatrixSparseFloat>;
   ROBOPTIM_ALLOW_ATTRIBUTES_OFF
 # endif
 
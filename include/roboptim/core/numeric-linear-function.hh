@@ -18,6 +18,9 @@
 #ifndef ROBOPTIM_CORE_NUMERIC_LINEAR_FUNCTION_HH
 # define ROBOPTIM_CORE_NUMERIC_LINEAR_FUNCTION_HH
 
+# include <boost/mpl/bool.hpp>
+# include <boost/utility/enable_if.hpp>
+
 # include <roboptim/core/sys.hh>
 # include <roboptim/core/debug.hh>
 # include <roboptim/core/portability.hh>
@@ -85,11 +88,34 @@ namespace roboptim
 
 
     void impl_compute (result_ref , const_argument_ref) const;
+    void impl_compute_batch (batch_ref, const_batch_ref) const;
     void impl_gradient (gradient_ref, const_argument_ref, size_type = 0)
       const;
     void impl_jacobian (jacobian_ref, const_argument_ref) const;
+    void impl_jacobian_structure (sparsityPattern_t& pattern) const;
 
   private:
+    /// \brief Copy the nonzeros of A (dense).
+    template <typename S>
+    void copyStructure (sparsityPattern_t& pattern,
+      typename boost::enable_if
+      <boost::mpl::bool_<StorageTraits<S>::isDense> >::type* = 0) const;
+    /// \brief Copy the nonzeros of A (sparse).
+    template <typename S>
+    void copyStructure (sparsityPattern_t& pattern,
+      typename boost::disable_if
+      <boost::mpl::bool_<StorageTraits<S>::isDense> >::type* = 0) const;
+    /// \brief Copy a row of A (dense).
+    template <typename S>
+    void copyRow (gradient_ref gradient, size_type idFunction,
+      typename boost::enable_if
+      <boost::mpl::bool_<StorageTraits<S>::isDense> >::type* = 0) const;
+    /// \brief Copy a row of A (sparse).
+    template <typename S>
+    void copyRow (gradient_ref gradient, size_type idFunction,
+      typename boost::disable_if
+      <boost::mpl::bool_<StorageTraits<S>::isDense> >::type* = 0) const;
+
     /// \brief A matrix.
     matrix_t a_;
     /// \brief B vector.
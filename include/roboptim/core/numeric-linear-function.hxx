@@ -71,6 +71,16 @@ namespace roboptim
     result += b_;
   }
 
+  template <typename T>
+  void
+  GenericNumericLinearFunction<T>::impl_compute_batch
+  (batch_ref results, const_batch_ref arguments) const
+  {
+    // Single matrix-matrix product for all the points.
+    results.noalias () = a_ * arguments;
+    results.colwise () += b_;
+  }
+
   // A
   template <typename T>
   void
@@ -80,28 +90,74 @@ namespace roboptim
     jacobian = this->a_;
   }
 
-  // A(i) - sparse specialization
-  template <>
-  inline void
-  GenericNumericLinearFunction<EigenMatrixSparse>::impl_gradient
-  (gradient_ref gradient, const_argument_ref, size_type idFunction)
-    const
+  template <typename T>
+  void
+  GenericNumericLinearFunction<T>::impl_jacobian_structure
+  (sparsityPattern_t& pattern) const
   {
-    for (size_type j = 0; j < this->inputSize (); ++j)
-      gradient.coeffRef (j) = a_.coeff (idFunction, j);
+    copyStructure<T> (pattern);
+  }
+
+  // Nonzeros of A
+  template <typename T>
+  template <typename S>
+  void
+  GenericNumericLinearFunction<T>::copyStructure
+  (sparsityPattern_t& pattern,
+   typename boost::enable_if
+   <boost::mpl::bool_<StorageTraits<S>::isDense> >::type*) const
+  {
+    pattern = this->a_.template cast<typename sparsityPattern_t::Scalar> ()
+      .sparseView ();
+  }
+
+  // Nonzeros of A - sparse version
+  template <typename T>
+  template <typename S>
+  void
+  GenericNumericLinearFunction<T>::copyStructure
+  (sparsityPattern_t& pattern,
+   typename boost::disable_if
+   <boost::mpl::bool_<StorageTraits<S>::isDense> >::type*) const
+  {
+    pattern = this->a_.template cast<typename sparsityPattern_t::Scalar> ();
   }
 
-  // A(i)
   template <typename T>
   void
   GenericNumericLinearFunction<T>::impl_gradient (gradient_ref gradient,
 						  const_argument_ref,
 						  size_type idFunction) const
+  {
+    copyRow<T> (gradient, idFunction);
+  }
+
+  // A(i)
+  template <typename T>
+  template <typename S>
+  void
+  GenericNumericLinearFunction<T>::copyRow
+  (gradient_ref gradient, size_type idFunction,
+   typename boost::enable_if
+   <boost::mpl::bool_<StorageTraits<S>::isDense> >::type*) const
   {
     for (size_type j = 0; j < this->inputSize (); ++j)
       gradient[j] = a_ (idFunction, j);
   }
 
+  // A(i) - sparse version
+  template <typename T>
+  template <typename S>
+  void
+  GenericNumericLinearFunction<T>::copyRow
+  (gradient_ref gradient, size_type idFunction,
+   typename boost::disable_if
+   <boost::mpl::bool_<StorageTraits<S>::isDense> >::type*) const
+  {
+    for (size_type j = 0; j < this->inputSize (); ++j)
+      gradient.coeffRef (j) = a_.coeff (idFunction, j);
+  }
+
   template <typename T>
   std::ostream&
   GenericNumericLinearFunction<T>::print (std::ostream& o) const
@@ -126,6 +182,10 @@ namespace roboptim
     GenericNumericLinearFunction<EigenMatrixDense>;
   extern template class ROBOPTIM_CORE_DLLAPI
     GenericNumericLinearFunction<EigenMatrixSparse>;
+  extern template class ROBOPTIM_CORE_DLLAPI
+    GenericNumericLinearFunction<EigenMatrixDenseFloat>;
+  extern template class ROBOPTIM_CORE_DLLAPI
+    GenericNumericLinearFunction<EigenMatrixSparseFloat>;
   ROBOPTIM_ALLOW_ATTRIBUTES_OFF
 # endif //! ROBOPTIM_PRECOMPILED_DENSE_SPARSE
 
@@ -18,6 +18,9 @@
 #ifndef ROBOPTIM_CORE_NUMERIC_QUADRATIC_FUNCTION_HH
 # define ROBOPTIM_CORE_NUMERIC_QUADRATIC_FUNCTION_HH
 
+# include <boost/mpl/bool.hpp>
+# include <boost/utility/enable_if.hpp>
+
 # include <roboptim/core/sys.hh>
 # include <roboptim/core/debug.hh>
 # include <roboptim/core/portability.hh>
@@ -114,13 +117,42 @@ namespace roboptim
 
   protected:
     void impl_compute (result_ref, const_argument_ref) const;
+    void impl_compute_batch (batch_ref, const_batch_ref) const;
     void impl_gradient (gradient_ref, const_argument_ref, size_type = 0)
       const;
     void impl_jacobian (jacobian_ref, const_argument_ref) const;
     void impl_hessian (hessian_ref hessian,
 		       const_argument_ref argument,
 		       size_type functionId = 0) const;
+    void impl_hessian_vector_product (vector_ref result,
+				      const_argument_ref argument,
+				      const_vector_ref direction,
+				      size_type functionId = 0) const;
+    void impl_lagrangian_hessian (hessian_ref hessian,
+				  const_argument_ref argument,
+				  const_vector_ref weights) const;
   private:
+    /// \brief Compute the jacobian (dense).
+    template <typename S>
+    void computeJacobian (jacobian_ref jacobian, const_argument_ref x,
+      typename boost::enable_if
+      <boost::mpl::bool_<StorageTraits<S>::isDense> >::type* = 0) const;
+    /// \brief Compute the jacobian (sparse).
+    template <typename S>
+    void computeJacobian (jacobian_ref jacobian, const_argument_ref x,
+      typename boost::disable_if
+      <boost::mpl::bool_<StorageTraits<S>::isDense> >::type* = 0) const;
+    /// \brief Copy the gradient computed in the buffer (dense).
+    template <typename S>
+    void copyGradient (gradient_ref gradient,
+      typename boost::enable_if
+      <boost::mpl::bool_<StorageTraits<S>::isDense> >::type* = 0) const;
+    /// \brief Copy the gradient computed in the buffer (sparse).
+    template <typename S>
+    void copyGradient (gradient_ref gradient,
+      typename boost::disable_if
+      <boost::mpl::bool_<StorageTraits<S>::isDense> >::type* = 0) const;
+
     /// \brief A matrix.
     symmetric_t a_;
     /// \brief B vector.
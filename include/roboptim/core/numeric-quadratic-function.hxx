@@ -75,18 +75,58 @@ namespace roboptim
     result += c_;
   }
 
-  // 2 * x * A + b
-  template <>
-  inline void
-  GenericNumericQuadraticFunction<EigenMatrixSparse>::impl_jacobian
+  template <typename T>
+  void
+  GenericNumericQuadraticFunction<T>::impl_compute_batch
+  (batch_ref results, const_batch_ref arguments) const
+  {
+    // x_i^T A x_i for all the points, from a single matrix-matrix product.
+    results.noalias () = b_.adjoint () * arguments;
+    results += arguments.cwiseProduct (a_ * arguments).colwise ().sum ();
+    results.array () += c_[0];
+  }
+
+  template <typename T>
+  void
+  GenericNumericQuadraticFunction<T>::impl_jacobian
   (jacobian_ref jacobian, const_argument_ref x) const
   {
+    computeJacobian<T> (jacobian, x);
+  }
+
+  // 2 * x * A + b
+  template <typename T>
+  template <typename S>
+  void
+  GenericNumericQuadraticFunction<T>::computeJacobian
+  (jacobian_ref jacobian, const_argument_ref x,
+   typename boost::enable_if
+   <boost::mpl::bool_<StorageTraits<S>::isDense> >::type*) const
+  {
+    // Warning: noalias() led to a possible Eigen bug here
+    // See: http://eigen.tuxfamily.org/bz/show_bug.cgi?id=1166
+    jacobian = value_type (2) * x.transpose () * a_;
+    jacobian += b_.transpose ();
+  }
+
+  // 2 * x * A + b - sparse version
+  template <typename T>
+  template <typename S>
+  void
+  GenericNumericQuadraticFunction<T>::computeJacobian
+  (jacobian_ref jacobian, const_argument_ref x,
+   typename boost::disable_if
+   <boost::mpl::bool_<StorageTraits<S>::isDense> >::type*) const
+  {
+    typedef Eigen::Matrix<value_type, Eigen::Dynamic, Eigen::Dynamic>
+      denseMatrix_t;
+
 #ifndef ROBOPTIM_DO_NOT_CHECK_ALLOCATION
     bool cur_malloc_allowed = is_malloc_allowed ();
     set_is_malloc_allowed (true);
 #endif //! ROBOPTIM_DO_NOT_CHECK_ALLOCATION
 
-    Eigen::MatrixXd j = 2 * x.transpose () * a_;
+    denseMatrix_t j = value_type (2) * x.transpose () * a_;
 
 #ifndef ROBOPTIM_DO_NOT_CHECK_ALLOCATION
     set_is_malloc_allowed (cur_malloc_allowed);
@@ -99,49 +139,67 @@ namespace roboptim
       jacobian.coeffRef (0, i) = j.coeffRef (0, i);
   }
 
-
   template <typename T>
   void
-  GenericNumericQuadraticFunction<T>::impl_jacobian
-  (jacobian_ref jacobian, const_argument_ref x) const
-  {
-    // Warning: noalias() led to a possible Eigen bug here
-    // See: http://eigen.tuxfamily.org/bz/show_bug.cgi?id=1166
-    jacobian = 2 * x.transpose () * a_;
-    jacobian += b_.transpose ();
-  }
-
-  // A(i) - sparse specialization
-  template <>
-  inline void
-  GenericNumericQuadraticFunction<EigenMatrixSparse>::impl_gradient
-  (gradient_ref gradient, const_argument_ref x, size_type)
-    const
+  GenericNumericQuadraticFunction<T>::impl_gradient
+  (gradient_ref gradient, const_argument_ref x, size_type) const
   {
-    buffer_.noalias () = 2 * a_ * x;
+    buffer_.noalias () = value_type (2) * a_ * x;
     buffer_ += b_;
-    for (size_type j = 0; j < this->inputSize (); ++j)
-      gradient.coeffRef (j) = buffer_.coeffRef (j);
+    copyGradient<T> (gradient);
   }
 
   // A(i)
   template <typename T>
+  template <typename S>
   void
-  GenericNumericQuadraticFunction<T>::impl_gradient
-  (gradient_ref gradient, const_argument_ref x, size_type) const
+  GenericNumericQuadraticFunction<T>::copyGradient
+  (gradient_ref gradient,
+   typename boost::enable_if
+   <boost::mpl::bool_<StorageTraits<S>::isDense> >::type*) const
   {
-    buffer_.noalias () = 2 * a_ * x;
-    buffer_ += b_;
     gradient = buffer_;
   }
 
+  // A(i) - sparse version
+  template <typename T>
+  template <typename S>
+  void
+  GenericNumericQuadraticFunction<T>::copyGradient
+  (gradient_ref gradient,
+   typename boost::disable_if
+   <boost::mpl::bool_<StorageTraits<S>::isDense> >::type*) const
+  {
+    for (size_type j = 0; j < this->inputSize (); ++j)
+      gradient.coeffRef (j) = buffer_.coeffRef (j);
+  }
+
   // A
   template <typename T>
   void
   GenericNumericQuadraticFunction<T>::impl_hessian
   (hessian_ref hessian, const_argument_ref, size_type) const
   {
-    hessian = 2 * a_;
+    hessian = value_type (2) * a_;
+  }
+
+  // 2 A v
+  template <typename T>
+  void
+  GenericNumericQuadraticFunction<T>::impl_hessian_vector_product
+  (vector_ref result, const_argument_ref, const_vector_ref direction,
+   size_type) const
+  {
+    result.noalias () = value_type (2) * a_ * direction;
+  }
+
+  // 2 lambda A
+  template <typename T>
+  void
+  GenericNumericQuadraticFunction<T>::impl_lagrangian_hessian
+  (hessian_ref hessian, const_argument_ref, const_vector_ref weights) const
+  {
+    hessian = (value_type (2) * weights[0]) * a_;
   }
 
   template <typename T>
@@ -169,6 +227,10 @@ namespace roboptim
     GenericNumericQuadraticFunction<EigenMatrixDense>;
   extern template class ROBOPTIM_CORE_DLLAPI
     GenericNumericQuadraticFunction<EigenMatrixSparse>;
+  extern template class ROBOPTIM_CORE_DLLAPI
+    GenericNumericQuadraticFunction<EigenMatrixDenseFloat>;
+  extern template class ROBOPTIM_CORE_DLLAPI
+    GenericNumericQuadraticFunction<EigenMatrixSparseFloat>;
   ROBOPTIM_ALLOW_ATTRIBUTES_OFF
 # endif //! ROBOPTIM_PRECOMPILED_DENSE_SPARSE
 
@@ -24,6 +24,7 @@
 # include <boost/shared_ptr.hpp>
 
 # include <roboptim/core/detail/autopromote.hh>
+# include <roboptim/core/detail/expression-node.hh>
 # include <roboptim/core/differentiable-function.hh>
 
 
@@ -39,10 +40,14 @@ namespace roboptim
   ///
   /// \tparam U input function type.
   template <typename U>
-  class Bind : public detail::AutopromoteTrait<U>::T_type
+  class Bind : public detail::AutopromoteTrait<U>::T_type,
+	       public detail::GenericExpressionNode
+	       <typename detail::AutopromoteTrait<U>::T_type::traits_t>
   {
   public:
     typedef typename detail::AutopromoteTrait<U>::T_type parentType_t;
+    typedef detail::GenericExpressionNode<typename parentType_t::traits_t>
+    expressionNode_t;
     ROBOPTIM_DIFFERENTIABLE_FUNCTION_FWD_TYPEDEFS_ (parentType_t);
 
     typedef boost::shared_ptr<Bind> BindShPtr_t;
@@ -62,6 +67,19 @@ namespace roboptim
       return origin_;
     }
 
+    void impl_children
+    (typename expressionNode_t::children_t& children) const;
+
+    void impl_replace_child
+    (typename expressionNode_t::children_t::value_type child,
+     const typename expressionNode_t::childShPtr_t& replacement,
+     typename expressionNode_t::constChildShPtr_t& replaced);
+
+    typename expressionNode_t::childShPtr_t impl_clone () const;
+
+    int impl_compile (typename expressionNode_t::compiler_t& compiler,
+		      int argument) const;
+
     void impl_compute (result_ref result, const_argument_ref x)
       const;
 
@@ -72,6 +90,12 @@ namespace roboptim
     void impl_jacobian (jacobian_ref jacobian,
 			const_argument_ref arg)
       const;
+    void impl_value_and_jacobian (result_ref result,
+				  jacobian_ref jacobian,
+				  const_argument_ref arg)
+      const;
+    void impl_jacobian_structure (sparsityPattern_t& pattern)
+      const;
 
     /// \brief Display the function on the specified output stream.
     ///
@@ -22,6 +22,8 @@
 # include <boost/format.hpp>
 
 # include <roboptim/core/indent.hh>
+# include <roboptim/core/util.hh>
+# include <roboptim/core/detail/function-compiler.hh>
 
 namespace roboptim
 {
@@ -63,6 +65,56 @@ namespace roboptim
   Bind<U>::~Bind ()
   {}
 
+  template <typename U>
+  void
+  Bind<U>::impl_children
+  (typename expressionNode_t::children_t& children) const
+  {
+    detail::appendChild (children, origin_);
+  }
+
+  template <typename U>
+  void
+  Bind<U>::impl_replace_child
+  (typename expressionNode_t::children_t::value_type child,
+   const typename expressionNode_t::childShPtr_t& replacement,
+   typename expressionNode_t::constChildShPtr_t& replaced)
+  {
+    detail::replaceChild (origin_, child, replacement, replaced);
+  }
+
+  template <typename U>
+  typename Bind<U>::expressionNode_t::childShPtr_t
+  Bind<U>::impl_clone () const
+  {
+    return boost::make_shared<Bind<U> > (*this);
+  }
+
+  template <typename U>
+  int
+  Bind<U>::impl_compile
+  (typename expressionNode_t::compiler_t& compiler, int argument) const
+  {
+    if (!compiler.compatible (origin_))
+      return -1;
+
+    // The argument of the origin function mixes the bound values and the
+    // argument of the function.
+    std::vector<int> indices (boundValues_.size ());
+    std::vector<value_type> constants (boundValues_.size (), value_type (0));
+    int id = 0;
+    for (std::size_t idx = 0; idx < boundValues_.size (); ++idx)
+      if (boundValues_[idx])
+	{
+	  indices[idx] = -1;
+	  constants[idx] = *(boundValues_[idx]);
+	}
+      else
+	indices[idx] = id++;
+    return compiler.operand
+      (origin_, compiler.gather (argument, indices, constants));
+  }
+
   template <typename U>
   void
   Bind<U>::impl_compute
@@ -127,6 +179,53 @@ namespace roboptim
 	}
   }
 
+  template <typename U>
+  void
+  Bind<U>::impl_value_and_jacobian (result_ref result,
+				    jacobian_ref jacobian,
+				    const_argument_ref argument)
+    const
+  {
+    size_type id = 0;
+    for (std::size_t idx = 0; idx < boundValues_.size (); ++idx)
+      if (boundValues_[idx])
+	x_[static_cast<size_type> (idx)] = *(boundValues_[idx]);
+      else
+	x_[static_cast<size_type> (idx)] = argument[id++];
+
+    origin_->valueAndJacobian (result, jacobian_, x_);
+    assert (jacobian_.rows () == jacobian.rows ());
+
+    id = 0;
+    for (size_type col = 0; col < jacobian_.cols (); ++col)
+      if (!boundValues_[static_cast<std::size_t> (col)])
+	{
+	  for (size_type row = 0; row < jacobian_.rows (); ++row)
+	    jacobian.coeffRef (row, id) = jacobian_.coeffRef (row, col);
+	  ++id;
+	}
+  }
+
+  template <typename U>
+  void
+  Bind<U>::impl_jacobian_structure (sparsityPattern_t& pattern) const
+  {
+    typedef typename sparsityPattern_t::Index index_t;
+
+    // Drop the columns of the bound variables.
+    std::vector<index_t> rows
+      (static_cast<std::size_t> (origin_->outputSize ()));
+    std::vector<index_t> cols (boundValues_.size (), -1);
+    for (size_type i = 0; i < origin_->outputSize (); ++i)
+      rows[static_cast<std::size_t> (i)] = i;
+    index_t col = 0;
+    for (std::size_t j = 0; j < boundValues_.size (); ++j)
+      if (!boundValues_[j])
+	cols[j] = col++;
+
+    remapSparseMatrix (pattern, origin_->jacobianStructure (), rows, cols);
+  }
+
 
   template <typename U>
   std::ostream&
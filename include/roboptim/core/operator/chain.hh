@@ -23,6 +23,7 @@
 # include <boost/shared_ptr.hpp>
 
 # include <roboptim/core/detail/autopromote.hh>
+# include <roboptim/core/detail/expression-node.hh>
 # include <roboptim/core/differentiable-function.hh>
 
 
@@ -42,13 +43,29 @@ namespace roboptim
   ///
   /// (left (right (x)))' = left'(right(x)) * right'(x)
   ///
+  /// When enabled with #cacheRightJacobian, the value and the jacobian of
+  /// the right function are kept from one gradient computation to the
+  /// next, as long as the argument does not change: computing the m
+  /// gradients of the chain at a point then only costs one jacobian of
+  /// the right function, instead of m. This must not be enabled if the
+  /// right function may change without its argument changing (e.g. a
+  /// numeric linear function whose matrix is updated).
+  ///
+  /// Vector-jacobian products are composed: the product of the left
+  /// function gives the weights of the product of the right function,
+  /// and no jacobian is computed unless the functions need one.
+  ///
   /// \tparam U left input function type.
   /// \tparam V right input function type.
   template <typename U, typename V>
-  class Chain : public detail::PromoteTrait<U, V>::T_promote
+  class Chain : public detail::PromoteTrait<U, V>::T_promote,
+	        public detail::GenericExpressionNode
+	        <typename detail::PromoteTrait<U, V>::T_promote::traits_t>
   {
   public:
     typedef typename detail::PromoteTrait<U, V>::T_promote parentType_t;
+    typedef detail::GenericExpressionNode<typename parentType_t::traits_t>
+    expressionNode_t;
     ROBOPTIM_DIFFERENTIABLE_FUNCTION_FWD_TYPEDEFS_ (parentType_t);
 
     typedef boost::shared_ptr<Chain> ChainShPtr_t;
@@ -80,6 +97,35 @@ namespace roboptim
       return right_;
     }
 
+    /// \brief Get a reference to the flag enabling the reuse of the
+    /// right function jacobian across gradient computations.
+    ///
+    /// Disabled by default.
+    bool& cacheRightJacobian ()
+    {
+      return cacheRightJacobian_;
+    }
+
+    /// \brief Whether the right function jacobian is reused across
+    /// gradient computations.
+    bool cacheRightJacobian () const
+    {
+      return cacheRightJacobian_;
+    }
+
+    void impl_children
+    (typename expressionNode_t::children_t& children) const;
+
+    void impl_replace_child
+    (typename expressionNode_t::children_t::value_type child,
+     const typename expressionNode_t::childShPtr_t& replacement,
+     typename expressionNode_t::constChildShPtr_t& replaced);
+
+    typename expressionNode_t::childShPtr_t impl_clone () const;
+
+    int impl_compile (typename expressionNode_t::compiler_t& compiler,
+		      int argument) const;
+
     void impl_compute (result_ref result, const_argument_ref x)
       const;
 
@@ -90,7 +136,24 @@ namespace roboptim
     void impl_jacobian (jacobian_ref jacobian,
 			const_argument_ref arg)
       const;
+    void impl_value_and_jacobian (result_ref result,
+				  jacobian_ref jacobian,
+				  const_argument_ref arg)
+      const;
+    void impl_jacobian_structure (sparsityPattern_t& pattern)
+      const;
+    void impl_vector_jacobian_product (gradient_ref result,
+				       const_argument_ref argument,
+				       const_vector_ref weights)
+      const;
   private:
+    /// \brief Compute the value and the jacobian of the right function,
+    /// unless they are still valid for this argument.
+    void updateRight (const_argument_ref x) const;
+
+    /// \brief Remember the argument of the right jacobian.
+    void rightUpdated (const_argument_ref x) const;
+
     /// \brief Shared pointer to the left function.
     boost::shared_ptr<U> left_;
     /// \brief Shared pointer to the right function.
@@ -114,6 +177,27 @@ namespace roboptim
     /// \brief Temporary buffer to store right function jacobian.
     mutable jacobian_t jacobianRight_;
 
+    /// \brief Temporary buffer to store left vector-jacobian product.
+    mutable gradient_t productLeft_;
+
+    /// \brief Weights of the right vector-jacobian product.
+    mutable vector_t weightsRight_;
+
+    /// \}
+
+    /// \name Right jacobian cache
+    /// \{
+
+    /// \brief Whether the right jacobian is reused.
+    bool cacheRightJacobian_;
+
+    /// \brief Whether rightResult_ and jacobianRight_ hold the value and
+    /// the jacobian of the right function at rightArgument_.
+    mutable bool rightValid_;
+
+    /// \brief Argument of the cached right jacobian.
+    mutable argument_t rightArgument_;
+
     /// \}
   };
 
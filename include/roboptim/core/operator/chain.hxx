@@ -19,6 +19,8 @@
 # define ROBOPTIM_CORE_OPERATOR_CHAIN_HXX
 # include <boost/format.hpp>
 
+# include <roboptim/core/detail/function-compiler.hh>
+
 namespace roboptim
 {
   template <typename U, typename V>
@@ -38,7 +40,12 @@ namespace roboptim
       jacobianLeft_ (left->outputSize (),
 		     left->inputSize ()),
       jacobianRight_ (right->outputSize (),
-		      right->inputSize ())
+		      right->inputSize ()),
+      productLeft_ (left->inputSize ()),
+      weightsRight_ (left->inputSize ()),
+      cacheRightJacobian_ (false),
+      rightValid_ (false),
+      rightArgument_ (right->inputSize ())
   {
     if (left->inputSize () != right->outputSize ())
       throw std::runtime_error
@@ -49,12 +56,55 @@ namespace roboptim
     gradientRight_.setZero ();
     jacobianLeft_.setZero ();
     jacobianRight_.setZero ();
+    productLeft_.setZero ();
+    weightsRight_.setZero ();
+    rightArgument_.setZero ();
   }
 
   template <typename U, typename V>
   Chain<U, V>::~Chain ()
   {}
 
+  template <typename U, typename V>
+  void
+  Chain<U, V>::impl_children
+  (typename expressionNode_t::children_t& children) const
+  {
+    detail::appendChild (children, left_);
+    detail::appendChild (children, right_);
+  }
+
+  template <typename U, typename V>
+  void
+  Chain<U, V>::impl_replace_child
+  (typename expressionNode_t::children_t::value_type child,
+   const typename expressionNode_t::childShPtr_t& replacement,
+   typename expressionNode_t::constChildShPtr_t& replaced)
+  {
+    detail::replaceChild (left_, child, replacement, replaced);
+    detail::replaceChild (right_, child, replacement, replaced);
+  }
+
+  template <typename U, typename V>
+  typename Chain<U, V>::expressionNode_t::childShPtr_t
+  Chain<U, V>::impl_clone () const
+  {
+    return boost::make_shared<Chain<U, V> > (*this);
+  }
+
+  template <typename U, typename V>
+  int
+  Chain<U, V>::impl_compile
+  (typename expressionNode_t::compiler_t& compiler, int argument) const
+  {
+    if (!compiler.compatible (left_) || !compiler.compatible (right_))
+      return -1;
+
+    // The left function takes the result of the right one as argument.
+    int right = compiler.operand (right_, argument);
+    return compiler.operand (left_, right);
+  }
+
   template <typename U, typename V>
   void
   Chain<U, V>::impl_compute
@@ -62,9 +112,29 @@ namespace roboptim
     const
   {
     (*right_) (rightResult_, x);
+    rightValid_ = false;
     (*left_) (result, rightResult_);
   }
 
+  template <typename U, typename V>
+  void
+  Chain<U, V>::rightUpdated (const_argument_ref x) const
+  {
+    rightArgument_ = x;
+    rightValid_ = true;
+  }
+
+  template <typename U, typename V>
+  void
+  Chain<U, V>::updateRight (const_argument_ref x) const
+  {
+    if (cacheRightJacobian_ && rightValid_ && rightArgument_ == x)
+      return;
+
+    right_->valueAndJacobian (rightResult_, jacobianRight_, x);
+    rightUpdated (x);
+  }
+
   template <typename U, typename V>
   void
   Chain<U, V>::impl_gradient (gradient_ref gradient,
@@ -72,10 +142,10 @@ namespace roboptim
 			 size_type functionId)
     const
   {
-    (*right_) (rightResult_, x);
+    // The right jacobian is shared by the gradients of all the outputs.
+    updateRight (x);
     left_->gradient (gradientLeft_, rightResult_, functionId);
-    right_->jacobian (jacobianRight_, x);
-    gradient.noalias () = gradientLeft_.adjoint () * jacobianRight_;
+    gradient.noalias () = gradientLeft_ * jacobianRight_;
   }
 
   template <typename U, typename V>
@@ -84,13 +154,67 @@ namespace roboptim
 			      const_argument_ref x)
     const
   {
-    (*right_) (rightResult_, x);
+    updateRight (x);
     left_->jacobian (jacobianLeft_, rightResult_);
-    right_->jacobian (jacobianRight_, x);
 
     jacobian.noalias () = jacobianLeft_ * jacobianRight_;
   }
 
+  template <typename U, typename V>
+  void
+  Chain<U, V>::impl_value_and_jacobian (result_ref result,
+					jacobian_ref jacobian,
+					const_argument_ref x)
+    const
+  {
+    // The right function is evaluated once for both the value and the
+    // jacobian.
+    right_->valueAndJacobian (rightResult_, jacobianRight_, x);
+    rightUpdated (x);
+    left_->valueAndJacobian (result, jacobianLeft_, rightResult_);
+
+    jacobian.noalias () = jacobianLeft_ * jacobianRight_;
+  }
+
+  template <typename U, typename V>
+  void
+  Chain<U, V>::impl_jacobian_structure (sparsityPattern_t& pattern) const
+  {
+    // Entry (i, j) of the product may be nonzero if there is a k such
+    // that (i, k) and (k, j) may be nonzero in the left and right
+    // jacobians.
+    sparsityPattern_t left = left_->jacobianStructure ();
+    sparsityPattern_t right = right_->jacobianStructure ();
+    pattern = left * right;
+  }
+
+  template <typename U, typename V>
+  void
+  Chain<U, V>::impl_vector_jacobian_product (gradient_ref result,
+					     const_argument_ref x,
+					     const_vector_ref weights)
+    const
+  {
+    const bool cached =
+      cacheRightJacobian_ && rightValid_ && rightArgument_ == x;
+    if (!cached)
+      {
+	(*right_) (rightResult_, x);
+	rightValid_ = false;
+      }
+
+    // w^T J_left (right (x)) J_right (x), from left to right.
+    left_->vectorJacobianProduct (productLeft_, rightResult_, weights);
+
+    if (cached)
+      result.noalias () = productLeft_ * jacobianRight_;
+    else
+      {
+	weightsRight_ = productLeft_.transpose ();
+	right_->vectorJacobianProduct (result, x, weightsRight_);
+      }
+  }
+
 } // end of namespace roboptim.
 
 #endif //! ROBOPTIM_CORE_OPERATOR_CHAIN_HXX
@@ -22,9 +22,10 @@
 
 # include <boost/shared_ptr.hpp>
 # include <boost/utility/enable_if.hpp>
-# include <boost/type_traits/is_same.hpp>
+# include <boost/mpl/bool.hpp>
 
 # include <roboptim/core/detail/autopromote.hh>
+# include <roboptim/core/detail/expression-node.hh>
 # include <roboptim/core/differentiable-function.hh>
 
 
@@ -42,10 +43,14 @@ namespace roboptim
   /// \brief Concatenate the output of two functions.
   /// \tparam U input functions type.
   template <typename U>
-  class Concatenate : public detail::AutopromoteTrait<U>::T_type
+  class Concatenate : public detail::AutopromoteTrait<U>::T_type,
+	              public detail::GenericExpressionNode
+	              <typename detail::AutopromoteTrait<U>::T_type::traits_t>
   {
   public:
     typedef typename detail::AutopromoteTrait<U>::T_type parentType_t;
+    typedef detail::GenericExpressionNode<typename parentType_t::traits_t>
+    expressionNode_t;
     ROBOPTIM_DIFFERENTIABLE_FUNCTION_FWD_TYPEDEFS_ (parentType_t);
 
     /// \brief Traits type.
@@ -78,6 +83,19 @@ namespace roboptim
     }
 
 
+    void impl_children
+    (typename expressionNode_t::children_t& children) const;
+
+    void impl_replace_child
+    (typename expressionNode_t::children_t::value_type child,
+     const typename expressionNode_t::childShPtr_t& replacement,
+     typename expressionNode_t::constChildShPtr_t& replaced);
+
+    typename expressionNode_t::childShPtr_t impl_clone () const;
+
+    int impl_compile (typename expressionNode_t::compiler_t& compiler,
+		      int argument) const;
+
     void impl_compute (result_ref result, const_argument_ref x)
       const;
 
@@ -88,6 +106,12 @@ namespace roboptim
     void impl_jacobian (jacobian_ref jacobian,
 			const_argument_ref arg)
       const;
+    void impl_value_and_jacobian (result_ref result,
+				  jacobian_ref jacobian,
+				  const_argument_ref arg)
+      const;
+    void impl_jacobian_structure (sparsityPattern_t& pattern)
+      const;
 
   private:
 
@@ -100,12 +124,9 @@ namespace roboptim
 
     template <typename T>
     void concatenateJacobian(jacobian_ref jacobian,
-      const_argument_ref x,
       typename detail::ConcatenateTypes<T>::isDense_t::type* = 0)
       const
     {
-      left_->jacobian(jacobianLeft_, x);
-      right_->jacobian(jacobianRight_, x);
       jacobian.middleRows(0, left_->outputSize()) =
         jacobianLeft_;
       jacobian.middleRows(left_->outputSize(), right_->outputSize()) =
@@ -114,13 +135,9 @@ namespace roboptim
 
     template <typename T>
     void concatenateJacobian(jacobian_ref jacobian,
-      const_argument_ref x,
       typename detail::ConcatenateTypes<T>::isNotDense_t::type* = 0)
       const
     {
-      left_->jacobian(jacobianLeft_, x);
-      right_->jacobian(jacobianRight_, x);
-
       copySparseBlock(jacobian, jacobianLeft_, 0, 0);
       copySparseBlock(jacobian, jacobianRight_, left_->outputSize(), 0);
     }
@@ -22,6 +22,7 @@
 # include <boost/utility/enable_if.hpp>
 
 # include <roboptim/core/util.hh>
+# include <roboptim/core/detail/function-compiler.hh>
 
 namespace roboptim
 {
@@ -33,11 +34,11 @@ namespace roboptim
       typedef typename T::traits_t traits_t;
 
       typedef typename boost::enable_if<
-        boost::is_same<traits_t, EigenMatrixDense> >
+        boost::mpl::bool_<StorageTraits<traits_t>::isDense> >
       isDense_t;
 
       typedef typename boost::disable_if<
-        boost::is_same<traits_t, EigenMatrixDense> >
+        boost::mpl::bool_<StorageTraits<traits_t>::isDense> >
       isNotDense_t;
     };
   } // end of namespace detail
@@ -75,6 +76,46 @@ namespace roboptim
   Concatenate<U>::~Concatenate ()
   {}
 
+  template <typename U>
+  void
+  Concatenate<U>::impl_children
+  (typename expressionNode_t::children_t& children) const
+  {
+    detail::appendChild (children, left_);
+    detail::appendChild (children, right_);
+  }
+
+  template <typename U>
+  void
+  Concatenate<U>::impl_replace_child
+  (typename expressionNode_t::children_t::value_type child,
+   const typename expressionNode_t::childShPtr_t& replacement,
+   typename expressionNode_t::constChildShPtr_t& replaced)
+  {
+    detail::replaceChild (left_, child, replacement, replaced);
+    detail::replaceChild (right_, child, replacement, replaced);
+  }
+
+  template <typename U>
+  typename Concatenate<U>::expressionNode_t::childShPtr_t
+  Concatenate<U>::impl_clone () const
+  {
+    return boost::make_shared<Concatenate<U> > (*this);
+  }
+
+  template <typename U>
+  int
+  Concatenate<U>::impl_compile
+  (typename expressionNode_t::compiler_t& compiler, int argument) const
+  {
+    if (!compiler.compatible (left_) || !compiler.compatible (right_))
+      return -1;
+
+    int left = compiler.operand (left_, argument);
+    int right = compiler.operand (right_, argument);
+    return compiler.concatenate (left, right);
+  }
+
   template <typename U>
   void
   Concatenate<U>::impl_compute
@@ -84,7 +125,7 @@ namespace roboptim
     left_->operator () (resultLeft_, x);
     right_->operator () (resultRight_, x);
     result.segment (0, left_->outputSize ()) = resultLeft_;
-    result.segment (left_->inputSize (), right_->outputSize ()) = resultRight_;
+    result.segment (left_->outputSize (), right_->outputSize ()) = resultRight_;
   }
 
   template <typename U>
@@ -106,7 +147,33 @@ namespace roboptim
 				 const_argument_ref x)
     const
   {
-    concatenateJacobian<U> (jacobian, x);
+    left_->jacobian (jacobianLeft_, x);
+    right_->jacobian (jacobianRight_, x);
+    concatenateJacobian<U> (jacobian);
+  }
+
+  template <typename U>
+  void
+  Concatenate<U>::impl_value_and_jacobian (result_ref result,
+					   jacobian_ref jacobian,
+					   const_argument_ref x)
+    const
+  {
+    left_->valueAndJacobian (resultLeft_, jacobianLeft_, x);
+    right_->valueAndJacobian (resultRight_, jacobianRight_, x);
+    result.segment (0, left_->outputSize ()) = resultLeft_;
+    result.segment (left_->outputSize (), right_->outputSize ()) =
+      resultRight_;
+    concatenateJacobian<U> (jacobian);
+  }
+
+  template <typename U>
+  void
+  Concatenate<U>::impl_jacobian_structure (sparsityPattern_t& pattern) const
+  {
+    copySparseBlock (pattern, left_->jacobianStructure (), 0, 0);
+    copySparseBlock (pattern, right_->jacobianStructure (),
+		     left_->outputSize (), 0, true);
   }
 } // end of namespace roboptim.
 
@@ -25,6 +25,7 @@
 # include <boost/type_traits/is_base_of.hpp>
 
 # include <roboptim/core/detail/autopromote.hh>
+# include <roboptim/core/detail/expression-node.hh>
 # include <roboptim/core/differentiable-function.hh>
 
 
@@ -54,10 +55,14 @@ namespace roboptim
   /// Known issue: for now it returns a non-differentiable function.
   /// \tparam U input function type.
   template <typename U>
-  class Derivative : public DerivativeParent<U>::result_t
+  class Derivative : public DerivativeParent<U>::result_t,
+	             public detail::GenericExpressionNode
+	             <typename U::traits_t>
   {
   public:
     typedef typename DerivativeParent<U>::result_t parentType_t;
+    typedef detail::GenericExpressionNode<typename parentType_t::traits_t>
+    expressionNode_t;
 
     // Note: we need gradient/jacobian typedefs, but since parentType_t may not
     // be differentiable, we rely on DifferentiableFunction directly.
@@ -102,6 +107,25 @@ namespace roboptim
     }
 
   protected:
+    void impl_children
+    (typename expressionNode_t::children_t& children) const
+    {
+      detail::appendChild (children, origin_);
+    }
+
+    void impl_replace_child
+    (typename expressionNode_t::children_t::value_type child,
+     const typename expressionNode_t::childShPtr_t& replacement,
+     typename expressionNode_t::constChildShPtr_t& replaced)
+    {
+      detail::replaceChild (origin_, child, replacement, replaced);
+    }
+
+    typename expressionNode_t::childShPtr_t impl_clone () const
+    {
+      return boost::make_shared<Derivative<U> > (*this);
+    }
+
     // FIXME: this is inefficient.
     void impl_compute (result_ref result, const_argument_ref x)
       const
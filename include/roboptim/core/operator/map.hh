@@ -18,9 +18,13 @@
 #ifndef ROBOPTIM_CORE_OPERATOR_MAP_HH
 # define ROBOPTIM_CORE_OPERATOR_MAP_HH
 # include <vector>
+# include <boost/make_shared.hpp>
+# include <boost/mpl/bool.hpp>
 # include <boost/shared_ptr.hpp>
 
 # include <roboptim/core/detail/autopromote.hh>
+# include <roboptim/core/detail/expression-node.hh>
+# include <roboptim/core/detail/thread-pool.hh>
 # include <roboptim/core/differentiable-function.hh>
 
 
@@ -37,13 +41,30 @@ namespace roboptim
   /// Output:
   /// [f(x_0^0 x_1^0 ... x_N^0) ... f(x_0^M x_1^M ... x_N^M)]
   ///
+  /// The Jacobian is block-diagonal, and each block is written directly
+  /// into the Jacobian. For sparse functions with #reuseJacobianStructure
+  /// enabled, a Jacobian that already has a compressed structure (e.g. the
+  /// output of jacobianStructure, or the result of a previous call) is
+  /// updated in place, without rebuilding the matrix.
+  ///
+  /// The repeats are evaluated sequentially by default. setThreads spreads
+  /// them over a thread pool, each worker evaluating a contiguous range of
+  /// repeats with its own buffers. The input function has to support
+  /// concurrent evaluations in that case. Sparse Jacobians are only
+  /// computed in parallel when they are updated in place.
+  ///
   /// \tparam U input function type.
   template <typename U>
-  class Map : public detail::AutopromoteTrait<U>::T_type
+  class Map : public detail::AutopromoteTrait<U>::T_type,
+	      public detail::GenericExpressionNode
+	      <typename detail::AutopromoteTrait<U>::T_type::traits_t>
   {
   public:
     typedef typename detail::AutopromoteTrait<U>::T_type parentType_t;
+    typedef detail::GenericExpressionNode<typename parentType_t::traits_t>
+    expressionNode_t;
     ROBOPTIM_DIFFERENTIABLE_FUNCTION_FWD_TYPEDEFS_ (parentType_t);
+    typedef typename parentType_t::traits_t traits_t;
 
     typedef boost::shared_ptr<Map> MapShPtr_t;
 
@@ -63,6 +84,16 @@ namespace roboptim
       return origin_;
     }
 
+    void impl_children
+    (typename expressionNode_t::children_t& children) const;
+
+    void impl_replace_child
+    (typename expressionNode_t::children_t::value_type child,
+     const typename expressionNode_t::childShPtr_t& replacement,
+     typename expressionNode_t::constChildShPtr_t& replaced);
+
+    typename expressionNode_t::childShPtr_t impl_clone () const;
+
     void impl_compute (result_ref result, const_argument_ref x)
       const ;
 
@@ -73,14 +104,115 @@ namespace roboptim
     void impl_jacobian (jacobian_ref jacobian,
 			const_argument_ref arg)
       const ;
+    void impl_value_and_jacobian (result_ref result,
+				  jacobian_ref jacobian,
+				  const_argument_ref arg)
+      const ;
+    void impl_jacobian_structure (sparsityPattern_t& pattern)
+      const ;
+
+    /// \brief Set the number of threads used to evaluate the repeats.
+    ///
+    /// \param n number of threads, including the calling thread. If 0,
+    /// the number of hardware threads is used. If 1, the repeats are
+    /// evaluated sequentially.
+    void setThreads (size_t n);
+
+    /// \brief Number of threads used to evaluate the repeats.
+    size_t threads () const
+    {
+      return x_.size ();
+    }
+
+    /// \brief Get a reference to the flag enabling the in-place update of
+    /// sparse Jacobians.
+    ///
+    /// When enabled, a Jacobian that already has a compressed, non-empty
+    /// structure only has its values overwritten. If a block has a
+    /// nonzero entry outside this structure, the change is counted by
+    /// #jacobianStructureChanges and the Jacobian is assembled again.
+    bool& reuseJacobianStructure ()
+    {
+      return reuseJacobianStructure_;
+    }
+
+    /// \brief Whether sparse Jacobians are updated in place.
+    bool reuseJacobianStructure () const
+    {
+      return reuseJacobianStructure_;
+    }
+
+    /// \brief Number of structural changes detected while updating
+    /// sparse Jacobians in place.
+    size_type jacobianStructureChanges () const
+    {
+      return jacobianStructureChanges_;
+    }
+
+  private:
+    /// \brief Evaluate the repeats assigned to a worker.
+    void computeTask (size_t worker, const_argument_ref x,
+		      result_ref result) const;
+
+    /// \brief Evaluate the Jacobian blocks (and the values, if result is
+    /// not null) of the repeats assigned to a worker.
+    template <typename J>
+    void jacobianTask (size_t worker, const_argument_ref x,
+		       result_ref* result, J* jacobian) const;
+
+    /// \brief Run jacobianTask for every worker.
+    template <typename J>
+    void runJacobianTask (const_argument_ref x, result_ref* result,
+			  J& jacobian) const;
+
+    /// \brief Dense Jacobian evaluation.
+    template <typename J>
+    void computeJacobian (result_ref* result, J& jacobian,
+			  const_argument_ref x, boost::mpl::true_) const;
+
+    /// \brief Sparse Jacobian evaluation.
+    template <typename J>
+    void computeJacobian (result_ref* result, J& jacobian,
+			  const_argument_ref x, boost::mpl::false_) const;
+
+    /// \brief Write a dense block of the Jacobian.
+    template <typename J>
+    bool writeBlock (J& jacobian, const jacobian_t& block, size_type i,
+		     boost::mpl::true_) const;
+
+    /// \brief Write a sparse block in the structure of the Jacobian.
+    ///
+    /// \return false if the block does not fit in the structure.
+    template <typename J>
+    bool writeBlock (J& jacobian, const jacobian_t& block, size_type i,
+		     boost::mpl::false_) const;
+
   private:
     boost::shared_ptr<U> origin_;
     size_type repeat_;
 
-    mutable argument_t x_;
-    mutable result_t result_;
+    /// \brief Thread pool, null if the repeats are evaluated sequentially.
+    boost::shared_ptr<detail::ThreadPool> pool_;
+
+    /// \brief Per-worker buffers.
+    mutable std::vector<argument_t> x_;
+    mutable std::vector<result_t> result_;
+    mutable std::vector<jacobian_t> jacobian_;
+
+    /// \brief Per-worker flags raised when a block does not fit in the
+    /// structure of a sparse Jacobian.
+    mutable std::vector<char> mismatch_;
+
     mutable gradient_t gradient_;
-    mutable jacobian_t jacobian_;
+
+    /// \brief Triplet buffer used to assemble sparse Jacobians.
+    mutable std::vector<Eigen::Triplet<value_type, size_type> > triplets_;
+
+    /// \brief Whether sparse Jacobians are updated in place.
+    bool reuseJacobianStructure_;
+
+    /// \brief Number of structural changes detected.
+    mutable size_type jacobianStructureChanges_;
   };
 
   template <typename U>
@@ -17,8 +17,13 @@
 
 #ifndef ROBOPTIM_CORE_OPERATOR_MAP_HXX
 # define ROBOPTIM_CORE_OPERATOR_MAP_HXX
+# include <algorithm>
+
+# include <boost/bind.hpp>
 # include <boost/format.hpp>
 
+# include <roboptim/core/util.hh>
+
 namespace roboptim
 {
   template <typename U>
@@ -33,35 +38,112 @@ namespace roboptim
 	% repeat).str ()),
       origin_ (origin),
       repeat_ (repeat),
-      x_ (origin->inputSize ()),
-      result_ (origin->outputSize ()),
+      pool_ (),
+      x_ (),
+      result_ (),
+      jacobian_ (),
+      mismatch_ (),
       gradient_ (origin->inputSize ()),
-      jacobian_ (origin->outputSize (),
-		 origin->inputSize ())
+      triplets_ (),
+      reuseJacobianStructure_ (false),
+      jacobianStructureChanges_ (0)
   {
-    x_.setZero ();
-    result_.setZero ();
     gradient_.setZero ();
-    jacobian_.setZero ();
+    setThreads (1);
   }
 
   template <typename U>
   Map<U>::~Map ()
   {}
 
+  template <typename U>
+  void
+  Map<U>::setThreads (size_t n)
+  {
+    if (n == 0)
+      n = std::max (boost::thread::hardware_concurrency (), 1u);
+
+    if (n > 1)
+      pool_ = boost::make_shared<detail::ThreadPool> (n);
+    else
+      pool_.reset ();
+
+    argument_t x (origin_->inputSize ());
+    x.setZero ();
+    result_t result (origin_->outputSize ());
+    result.setZero ();
+    jacobian_t jacobian (origin_->outputSize (), origin_->inputSize ());
+    jacobian.setZero ();
+
+    x_.assign (n, x);
+    result_.assign (n, result);
+    jacobian_.assign (n, jacobian);
+    mismatch_.assign (n, 0);
+  }
+
+  template <typename U>
+  void
+  Map<U>::computeTask (size_t worker, const_argument_ref x,
+		       result_ref result) const
+  {
+    const size_type n = origin_->inputSize ();
+    const size_type m = origin_->outputSize ();
+    const size_type workers = static_cast<size_type> (threads ());
+    const size_type w = static_cast<size_type> (worker);
+
+    argument_t& xw = x_[worker];
+    result_t& rw = result_[worker];
+
+    for (size_type i = repeat_ * w / workers;
+	 i < repeat_ * (w + 1) / workers; ++i)
+      {
+	xw = x.segment (i * n, n);
+	origin_->operator () (rw, xw);
+	result.segment (i * m, m) = rw;
+      }
+  }
+
+  template <typename U>
+  void
+  Map<U>::impl_children
+  (typename expressionNode_t::children_t& children) const
+  {
+    detail::appendChild (children, origin_);
+  }
+
+  template <typename U>
+  void
+  Map<U>::impl_replace_child
+  (typename expressionNode_t::children_t::value_type child,
+   const typename expressionNode_t::childShPtr_t& replacement,
+   typename expressionNode_t::constChildShPtr_t& replaced)
+  {
+    detail::replaceChild (origin_, child, replacement, replaced);
+  }
+
+  template <typename U>
+  typename Map<U>::expressionNode_t::childShPtr_t
+  Map<U>::impl_clone () const
+  {
+    boost::shared_ptr<Map<U> > copy = boost::make_shared<Map<U> > (*this);
+    // The thread pool is not shared between copies.
+    if (pool_)
+      copy->setThreads (threads ());
+    return copy;
+  }
+
   template <typename U>
   void
   Map<U>::impl_compute
   (result_ref result, const_argument_ref x)
     const
   {
-    for (size_type i = 0; i < repeat_; ++i)
-      {
-	x_ = x.segment (i * origin_->inputSize (), origin_->inputSize ());
-	origin_->operator () (result_, x_);
-	result.segment (i * origin_->outputSize (), origin_->outputSize ()) =
-	  result_;
-      }
+    // The task is only bound for the thread pool, binding allocates.
+    if (pool_)
+      pool_->run (boost::bind (&Map<U>::computeTask, this, _1,
+			       boost::cref (x), result));
+    else
+      computeTask (0, x, result);
   }
 
   template <typename U>
@@ -71,16 +153,193 @@ namespace roboptim
 			 size_type functionId)
     const
   {
+    // Only one repeat depends on the requested output.
+    const size_type n = origin_->inputSize ();
+    const size_type i = functionId / origin_->outputSize ();
+
+    x_[0] = x.segment (i * n, n);
+    gradient_.setZero ();
+    origin_->gradient (gradient_, x_[0],
+		       functionId % origin_->outputSize ());
+
+    // The other repeats do not depend on x: clear what the buffer held.
+    gradient.setZero ();
+    //FIXME: should be a segment but Eigen support is still preliminary.
+    for (size_type idx = 0; idx < n; ++idx)
+      gradient.coeffRef (i * n + idx) = gradient_.coeffRef (idx);
+  }
+
+  template <typename U>
+  template <typename J>
+  void
+  Map<U>::jacobianTask (size_t worker, const_argument_ref x,
+			result_ref* result, J* jacobian) const
+  {
+    const size_type n = origin_->inputSize ();
+    const size_type m = origin_->outputSize ();
+    const size_type workers = static_cast<size_type> (threads ());
+    const size_type w = static_cast<size_type> (worker);
+
+    argument_t& xw = x_[worker];
+    result_t& rw = result_[worker];
+    jacobian_t& jw = jacobian_[worker];
+
+    for (size_type i = repeat_ * w / workers;
+	 i < repeat_ * (w + 1) / workers; ++i)
+      {
+	xw = x.segment (i * n, n);
+	if (result)
+	  {
+	    origin_->valueAndJacobian (rw, jw, xw);
+	    result->segment (i * m, m) = rw;
+	  }
+	else
+	  origin_->jacobian (jw, xw);
+
+	if (!writeBlock (*jacobian, jw, i,
+			 boost::mpl::bool_<StorageTraits<traits_t>::isDense> ()))
+	  mismatch_[worker] = 1;
+      }
+  }
+
+  template <typename U>
+  template <typename J>
+  void
+  Map<U>::runJacobianTask (const_argument_ref x, result_ref* result,
+			   J& jacobian) const
+  {
+    // The task is only bound for the thread pool, binding allocates.
+    if (pool_)
+      pool_->run (boost::bind (&Map<U>::jacobianTask<J>, this, _1,
+			       boost::cref (x), result, &jacobian));
+    else
+      jacobianTask (0, x, result, &jacobian);
+  }
+
+  template <typename U>
+  template <typename J>
+  bool
+  Map<U>::writeBlock (J& jacobian, const jacobian_t& block, size_type i,
+		      boost::mpl::true_) const
+  {
+    jacobian.block (i * origin_->outputSize (), i * origin_->inputSize (),
+		    origin_->outputSize (), origin_->inputSize ()) = block;
+    return true;
+  }
+
+  template <typename U>
+  template <typename J>
+  bool
+  Map<U>::writeBlock (J& jacobian, const jacobian_t& block, size_type i,
+		      boost::mpl::false_) const
+  {
+    const bool rowMajor = jacobian_t::IsRowMajor;
+    const size_type outerOffset =
+      i * (rowMajor? origin_->outputSize () : origin_->inputSize ());
+    const size_type innerOffset =
+      i * (rowMajor? origin_->inputSize () : origin_->outputSize ());
+
+    value_type* values = jacobian.valuePtr ();
+    const int* inner = jacobian.innerIndexPtr ();
+
+    for (size_type k = 0; k < block.outerSize (); ++k)
+      {
+	size_type first = jacobian.outerIndexPtr ()[outerOffset + k];
+	const size_type end = jacobian.outerIndexPtr ()[outerOffset + k + 1];
+
+	// Both matrices are sorted: look for the entries in a single pass.
+	for (typename jacobian_t::InnerIterator it (block, k); it; ++it)
+	  {
+	    const size_type idx = innerOffset + it.index ();
+	    while (first < end && inner[first] < idx)
+	      ++first;
+
+	    if (first == end || inner[first] != idx)
+	      {
+		// Explicit zeros outside the structure are harmless.
+		if (it.value () != 0.)
+		  return false;
+		continue;
+	      }
+
+	    values[first] = it.value ();
+	  }
+      }
+    return true;
+  }
+
+  template <typename U>
+  template <typename J>
+  void
+  Map<U>::computeJacobian (result_ref* result, J& jacobian,
+			   const_argument_ref x, boost::mpl::true_) const
+  {
+    runJacobianTask (x, result, jacobian);
+  }
+
+  template <typename U>
+  template <typename J>
+  void
+  Map<U>::computeJacobian (result_ref* result, J& jacobian,
+			   const_argument_ref x, boost::mpl::false_) const
+  {
+    if (reuseJacobianStructure_
+	&& jacobian.isCompressed () && jacobian.nonZeros () > 0)
+      {
+	// Entries of the structure missing from the blocks are zero.
+	std::fill (jacobian.valuePtr (),
+		   jacobian.valuePtr () + jacobian.nonZeros (), 0.);
+	std::fill (mismatch_.begin (), mismatch_.end (), 0);
+
+	runJacobianTask (x, result, jacobian);
+
+	if (std::find (mismatch_.begin (), mismatch_.end (), 1)
+	    == mismatch_.end ())
+	  return;
+
+	// The structure changed: assemble the jacobian again.
+	++jacobianStructureChanges_;
+	LOG4CXX_INFO (this->logger,
+		      "Sparse jacobian structure changed, assembling it"
+		      " again (" << jacobianStructureChanges_
+		      << " change(s) so far)");
+      }
+
+    typedef Eigen::Triplet<value_type, size_type> triplet_t;
+
+    const size_type n = origin_->inputSize ();
+    const size_type m = origin_->outputSize ();
+
+    triplets_.clear ();
     for (size_type i = 0; i < repeat_; ++i)
       {
-	x_ = x.segment (i * origin_->inputSize (), origin_->inputSize ());
-	origin_->gradient (gradient_, x_, functionId);
+	x_[0] = x.segment (i * n, n);
+	if (result)
+	  {
+	    origin_->valueAndJacobian (result_[0], jacobian_[0], x_[0]);
+	    result->segment (i * m, m) = result_[0];
+	  }
+	else
+	  origin_->jacobian (jacobian_[0], x_[0]);
 
-	//FIXME: should be a segment but Eigen support is still preliminary.
-	for (size_type idx = 0; idx < origin_->inputSize (); ++idx)
-	  gradient.coeffRef (i * origin_->inputSize () + idx) =
-	    gradient_.coeffRef (idx);
+	for (size_type k = 0; k < jacobian_[0].outerSize (); ++k)
+	  for (typename jacobian_t::InnerIterator it (jacobian_[0], k);
+	       it; ++it)
+	    triplets_.push_back (triplet_t (i * m + it.row (),
+					    i * n + it.col (),
+					    it.value ()));
       }
+
+#ifndef ROBOPTIM_DO_NOT_CHECK_ALLOCATION
+    bool cur_malloc_allowed = is_malloc_allowed ();
+    set_is_malloc_allowed (true);
+#endif //! ROBOPTIM_DO_NOT_CHECK_ALLOCATION
+
+    jacobian.setFromTriplets (triplets_.begin (), triplets_.end ());
+
+#ifndef ROBOPTIM_DO_NOT_CHECK_ALLOCATION
+    set_is_malloc_allowed (cur_malloc_allowed);
+#endif //! ROBOPTIM_DO_NOT_CHECK_ALLOCATION
   }
 
   template <typename U>
@@ -89,19 +348,32 @@ namespace roboptim
 			 const_argument_ref x)
     const
   {
+    computeJacobian (static_cast<result_ref*> (0), jacobian, x,
+		     boost::mpl::bool_<StorageTraits<traits_t>::isDense> ());
+  }
+
+  template <typename U>
+  void
+  Map<U>::impl_value_and_jacobian (result_ref result,
+				   jacobian_ref jacobian,
+				   const_argument_ref x)
+    const
+  {
+    computeJacobian (&result, jacobian, x,
+		     boost::mpl::bool_<StorageTraits<traits_t>::isDense> ());
+  }
+
+  template <typename U>
+  void
+  Map<U>::impl_jacobian_structure (sparsityPattern_t& pattern) const
+  {
+    // Block-diagonal pattern.
+    sparsityPattern_t origin = origin_->jacobianStructure ();
     for (size_type i = 0; i < repeat_; ++i)
-      {
-	x_ = x.segment (i * origin_->inputSize (), origin_->inputSize ());
-	origin_->jacobian (jacobian_, x_);
-
-	//FIXME: should be a block but Eigen support is still preliminary.
-	for (size_type idx_i = 0; idx_i < origin_->outputSize (); ++idx_i)
-	  for (size_type idx_j = 0; idx_j < origin_->inputSize (); ++idx_j)
-	    jacobian.coeffRef
-	      (i * origin_->outputSize () + idx_i,
-	       i * origin_->inputSize () + idx_j) =
-	      jacobian_.coeffRef (idx_i, idx_j);
-      }
+      copySparseBlock (pattern, origin,
+		       i * origin_->outputSize (),
+		       i * origin_->inputSize ());
+    pattern.makeCompressed ();
   }
 
 } // end of namespace roboptim.
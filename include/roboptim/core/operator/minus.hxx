@@ -19,6 +19,8 @@
 # define ROBOPTIM_CORE_OPERATOR_MINUS_HXX
 # include <boost/format.hpp>
 
+# include <roboptim/core/detail/function-compiler.hh>
+
 namespace roboptim
 {
   template <typename U, typename V>
@@ -35,7 +37,9 @@ namespace roboptim
       result_ (left->outputSize ()),
       gradient_ (left->inputSize ()),
       jacobian_ (left->outputSize (),
-		 left->inputSize ())
+		 left->inputSize ()),
+      hessianVectorProduct_ (left->inputSize ()),
+      hessian_ ()
   {
     if (left->inputSize () != right->inputSize ()
 	|| left->outputSize () != right->outputSize ())
@@ -43,12 +47,53 @@ namespace roboptim
     result_.setZero ();
     gradient_.setZero ();
     jacobian_.setZero ();
+    hessianVectorProduct_.setZero ();
   }
 
   template <typename U, typename V>
   Minus<U, V>::~Minus ()
   {}
 
+  template <typename U, typename V>
+  void
+  Minus<U, V>::impl_children
+  (typename expressionNode_t::children_t& children) const
+  {
+    detail::appendChild (children, left_);
+    detail::appendChild (children, right_);
+  }
+
+  template <typename U, typename V>
+  void
+  Minus<U, V>::impl_replace_child
+  (typename expressionNode_t::children_t::value_type child,
+   const typename expressionNode_t::childShPtr_t& replacement,
+   typename expressionNode_t::constChildShPtr_t& replaced)
+  {
+    detail::replaceChild (left_, child, replacement, replaced);
+    detail::replaceChild (right_, child, replacement, replaced);
+  }
+
+  template <typename U, typename V>
+  typename Minus<U, V>::expressionNode_t::childShPtr_t
+  Minus<U, V>::impl_clone () const
+  {
+    return boost::make_shared<Minus<U, V> > (*this);
+  }
+
+  template <typename U, typename V>
+  int
+  Minus<U, V>::impl_compile
+  (typename expressionNode_t::compiler_t& compiler, int argument) const
+  {
+    if (!compiler.compatible (left_) || !compiler.compatible (right_))
+      return -1;
+
+    int left = compiler.operand (left_, argument);
+    int right = compiler.operand (right_, argument);
+    return compiler.binary (detail::CompiledOperation::SUB, left, right);
+  }
+
   template <typename U, typename V>
   void
   Minus<U, V>::impl_compute
@@ -83,6 +128,112 @@ namespace roboptim
     right_->jacobian (jacobian_, argument);
     jacobian -= jacobian_;
   }
+
+  template <typename U, typename V>
+  void
+  Minus<U, V>::impl_value_and_jacobian (result_ref result,
+					jacobian_ref jacobian,
+					const_argument_ref argument)
+    const
+  {
+    left_->valueAndJacobian (result, jacobian, argument);
+    right_->valueAndJacobian (result_, jacobian_, argument);
+    result -= result_;
+    jacobian -= jacobian_;
+  }
+
+  template <typename U, typename V>
+  void
+  Minus<U, V>::impl_jacobian_structure (sparsityPattern_t& pattern) const
+  {
+    // Union of both patterns.
+    sparsityPattern_t left = left_->jacobianStructure ();
+    sparsityPattern_t right = right_->jacobianStructure ();
+    pattern = left + right;
+  }
+
+  template <typename U, typename V>
+  void
+  Minus<U, V>::resizeHessianBuffer () const
+  {
+    if (hessian_.rows () == this->inputSize ())
+      return;
+
+#ifndef ROBOPTIM_DO_NOT_CHECK_ALLOCATION
+    bool cur_malloc_allowed = is_malloc_allowed ();
+    set_is_malloc_allowed (true);
+#endif //! ROBOPTIM_DO_NOT_CHECK_ALLOCATION
+
+    hessian_.resize (this->inputSize (), this->inputSize ());
+
+#ifndef ROBOPTIM_DO_NOT_CHECK_ALLOCATION
+    set_is_malloc_allowed (cur_malloc_allowed);
+#endif //! ROBOPTIM_DO_NOT_CHECK_ALLOCATION
+  }
+
+  template <typename U, typename V>
+  void
+  Minus<U, V>::impl_hessian (hessian_ref hessian,
+			     const_argument_ref argument,
+			     size_type functionId)
+    const
+  {
+    resizeHessianBuffer ();
+    left_->hessian (hessian, argument, functionId);
+    hessian_.setZero ();
+    right_->hessian (hessian_, argument, functionId);
+
+#ifndef ROBOPTIM_DO_NOT_CHECK_ALLOCATION
+    // Sparse sums are evaluated in a temporary matrix.
+    bool cur_malloc_allowed = is_malloc_allowed ();
+    set_is_malloc_allowed (true);
+#endif //! ROBOPTIM_DO_NOT_CHECK_ALLOCATION
+
+    hessian -= hessian_;
+
+#ifndef ROBOPTIM_DO_NOT_CHECK_ALLOCATION
+    set_is_malloc_allowed (cur_malloc_allowed);
+#endif //! ROBOPTIM_DO_NOT_CHECK_ALLOCATION
+  }
+
+  template <typename U, typename V>
+  void
+  Minus<U, V>::impl_hessian_vector_product (vector_ref result,
+					    const_argument_ref argument,
+					    const_vector_ref direction,
+					    size_type functionId)
+    const
+  {
+    left_->hessianVectorProduct (result, argument, direction, functionId);
+    right_->hessianVectorProduct (hessianVectorProduct_, argument, direction,
+				  functionId);
+    result -= hessianVectorProduct_;
+  }
+
+  template <typename U, typename V>
+  void
+  Minus<U, V>::impl_lagrangian_hessian (hessian_ref hessian,
+					const_argument_ref argument,
+					const_vector_ref weights)
+    const
+  {
+    resizeHessianBuffer ();
+    left_->lagrangianHessian (hessian, argument, weights);
+    hessian_.setZero ();
+    right_->lagrangianHessian (hessian_, argument, weights);
+
+#ifndef ROBOPTIM_DO_NOT_CHECK_ALLOCATION
+    // Sparse sums are evaluated in a temporary matrix.
+    bool cur_malloc_allowed = is_malloc_allowed ();
+    set_is_malloc_allowed (true);
+#endif //! ROBOPTIM_DO_NOT_CHECK_ALLOCATION
+
+    hessian -= hessian_;
+
+#ifndef ROBOPTIM_DO_NOT_CHECK_ALLOCATION
+    set_is_malloc_allowed (cur_malloc_allowed);
+#endif //! ROBOPTIM_DO_NOT_CHECK_ALLOCATION
+  }
 } // end of namespace roboptim.
 
 #endif //! ROBOPTIM_CORE_OPERATOR_MINUS_HXX
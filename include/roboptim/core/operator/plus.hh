@@ -22,6 +22,7 @@
 # include <boost/shared_ptr.hpp>
 
 # include <roboptim/core/detail/autopromote.hh>
+# include <roboptim/core/detail/expression-node.hh>
 # include <roboptim/core/differentiable-function.hh>
 
 namespace roboptim
@@ -33,12 +34,22 @@ namespace roboptim
   /// \tparam U first input function type.
   /// \tparam V second input function type.
   template <typename U, typename V>
-  class Plus : public detail::PromoteTrait<U, V>::T_promote
+  class Plus : public detail::PromoteTrait<U, V>::T_promote,
+	       public detail::GenericExpressionNode
+	       <typename detail::PromoteTrait<U, V>::T_promote::traits_t>
   {
   public:
     typedef typename detail::PromoteTrait<U, V>::T_promote parentType_t;
+    typedef detail::GenericExpressionNode<typename parentType_t::traits_t>
+    expressionNode_t;
     ROBOPTIM_DIFFERENTIABLE_FUNCTION_FWD_TYPEDEFS_ (parentType_t);
 
+    /// \brief Hessian types, only relevant for twice differentiable
+    /// functions.
+    typedef typename parentType_t::traits_t traits_t;
+    typedef typename GenericFunctionTraits<traits_t>::hessian_t hessian_t;
+    typedef typename GenericFunctionTraits<traits_t>::hessian_ref hessian_ref;
+
     typedef boost::shared_ptr<Plus> PlusShPtr_t;
 
     explicit Plus (boost::shared_ptr<U> left, boost::shared_ptr<V> right);
@@ -64,6 +75,19 @@ namespace roboptim
       return right_;
     }
 
+    void impl_children
+    (typename expressionNode_t::children_t& children) const;
+
+    void impl_replace_child
+    (typename expressionNode_t::children_t::value_type child,
+     const typename expressionNode_t::childShPtr_t& replacement,
+     typename expressionNode_t::constChildShPtr_t& replaced);
+
+    typename expressionNode_t::childShPtr_t impl_clone () const;
+
+    int impl_compile (typename expressionNode_t::compiler_t& compiler,
+		      int argument) const;
+
     void impl_compute (result_ref result, const_argument_ref x)
       const;
 
@@ -74,13 +98,40 @@ namespace roboptim
     void impl_jacobian (jacobian_ref jacobian,
 			const_argument_ref arg)
       const;
+    void impl_value_and_jacobian (result_ref result,
+				  jacobian_ref jacobian,
+				  const_argument_ref arg)
+      const;
+    void impl_jacobian_structure (sparsityPattern_t& pattern)
+      const;
+
+    // The following methods are only instantiated when both functions
+    // are twice differentiable.
+    void impl_hessian (hessian_ref hessian,
+		       const_argument_ref argument,
+		       size_type functionId = 0)
+      const;
+    void impl_hessian_vector_product (vector_ref result,
+				      const_argument_ref argument,
+				      const_vector_ref direction,
+				      size_type functionId = 0)
+      const;
+    void impl_lagrangian_hessian (hessian_ref hessian,
+				  const_argument_ref argument,
+				  const_vector_ref weights)
+      const;
   private:
+    /// \brief Allocate the hessian buffer on first use.
+    void resizeHessianBuffer () const;
+
     boost::shared_ptr<U> left_;
     boost::shared_ptr<V> right_;
 
     mutable result_t result_;
     mutable gradient_t gradient_;
     mutable jacobian_t jacobian_;
+    mutable vector_t hessianVectorProduct_;
+    mutable hessian_t hessian_;
   };
 
   template <typename U, typename V>
@@ -22,6 +22,7 @@
 # include <boost/shared_ptr.hpp>
 
 # include <roboptim/core/detail/autopromote.hh>
+# include <roboptim/core/detail/expression-node.hh>
 # include <roboptim/core/differentiable-function.hh>
 
 namespace roboptim
@@ -33,10 +34,14 @@ namespace roboptim
   /// \tparam U first input function type.
   /// \tparam V second input function type.
   template <typename U, typename V>
-  class Product : public detail::PromoteTrait<U, V>::T_promote
+  class Product : public detail::PromoteTrait<U, V>::T_promote,
+	          public detail::GenericExpressionNode
+	          <typename detail::PromoteTrait<U, V>::T_promote::traits_t>
   {
   public:
     typedef typename detail::PromoteTrait<U, V>::T_promote parentType_t;
+    typedef detail::GenericExpressionNode<typename parentType_t::traits_t>
+    expressionNode_t;
     ROBOPTIM_DIFFERENTIABLE_FUNCTION_FWD_TYPEDEFS_ (parentType_t);
 
     typedef boost::shared_ptr<Product> ProductShPtr_t;
@@ -64,6 +69,19 @@ namespace roboptim
       return right_;
     }
 
+    void impl_children
+    (typename expressionNode_t::children_t& children) const;
+
+    void impl_replace_child
+    (typename expressionNode_t::children_t::value_type child,
+     const typename expressionNode_t::childShPtr_t& replacement,
+     typename expressionNode_t::constChildShPtr_t& replaced);
+
+    typename expressionNode_t::childShPtr_t impl_clone () const;
+
+    int impl_compile (typename expressionNode_t::compiler_t& compiler,
+		      int argument) const;
+
     void impl_compute (result_ref result, const_argument_ref x)
       const;
 
@@ -74,6 +92,12 @@ namespace roboptim
     void impl_jacobian (jacobian_ref jacobian,
 			const_argument_ref arg)
       const;
+    void impl_value_and_jacobian (result_ref result,
+				  jacobian_ref jacobian,
+				  const_argument_ref arg)
+      const;
+    void impl_jacobian_structure (sparsityPattern_t& pattern)
+      const;
   private:
     boost::shared_ptr<U> left_;
     boost::shared_ptr<V> right_;
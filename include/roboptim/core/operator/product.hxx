@@ -19,9 +19,11 @@
 # define ROBOPTIM_CORE_OPERATOR_PRODUCT_HXX
 # include <boost/format.hpp>
 # include <boost/utility/enable_if.hpp>
-# include <boost/type_traits/is_same.hpp>
+# include <boost/mpl/bool.hpp>
 # include <boost/mpl/and.hpp>
 
+# include <roboptim/core/detail/function-compiler.hh>
+
 namespace roboptim
 {
   namespace detail
@@ -36,8 +38,8 @@ namespace roboptim
       struct Types
       {
         typedef typename boost::mpl::and_<
-          boost::is_same<typename U::traits_t, EigenMatrixDense>,
-          boost::is_same<typename V::traits_t, EigenMatrixDense> >
+          boost::mpl::bool_<StorageTraits<typename U::traits_t>::isDense>,
+          boost::mpl::bool_<StorageTraits<typename V::traits_t>::isDense> >
             fullDense_t;
 
         typedef typename Product<U,V>::size_type  size_type;
@@ -70,17 +72,19 @@ namespace roboptim
 
 
       /// \brief Full dense version of gradient computation.
+      ///
+      /// u and v are the values of the outputs the gradients belong to.
       template <typename U, typename V>
       static void gradient
       (typename Types<U,V>::gradient_ref grad_uv,
-       const typename Types<U,V>::rowVectorU_ref u,
-       const typename Types<U,V>::rowVectorV_ref v,
+       typename Types<U,V>::value_type u,
+       typename Types<U,V>::value_type v,
        const typename Types<U,V>::gradientU_ref grad_u,
        const typename Types<U,V>::gradientV_ref grad_v,
        typename boost::enable_if<typename Types<U,V>::fullDense_t>::type* = 0)
       {
-        grad_uv.noalias () = u.cwiseProduct (grad_v);
-        grad_uv.noalias () += v.cwiseProduct (grad_u);
+        grad_uv.noalias () = u * grad_v;
+        grad_uv.noalias () += v * grad_u;
       }
 
       /// \brief Dense/sparse version of gradient computation.
@@ -89,16 +93,14 @@ namespace roboptim
       template <typename U, typename V>
       static void gradient
       (typename Types<U,V>::gradient_ref grad_uv,
-       const typename Types<U,V>::rowVectorU_ref u,
-       const typename Types<U,V>::rowVectorV_ref v,
+       typename Types<U,V>::value_type u,
+       typename Types<U,V>::value_type v,
        const typename Types<U,V>::gradientU_ref grad_u,
        const typename Types<U,V>::gradientV_ref grad_v,
        typename boost::disable_if<typename Types<U,V>::fullDense_t>::type* = 0)
       {
-        // Here, u and v are dense vectors, while grad_u and grad_v are sparse
-        // vectors. Since cwiseProduct is not available for dense-sparse
-        // computation, we compute it manually. All we need to do is loop over
-        // the nonzeros of grad_u or grad_v and multiply by v or u.
+        // Here, grad_u and grad_v may be sparse vectors, we loop over their
+        // nonzeros and multiply them by v or u.
         grad_uv.setZero ();
 
         // grad_uv = u * grad_v;
@@ -106,7 +108,7 @@ namespace roboptim
              it; ++it)
 	  {
 	    typename Types<U,V>::gradientV_t::Index id = it.index ();
-	    grad_uv.coeffRef (id) = u (id) * it.value ();
+	    grad_uv.coeffRef (id) = u * it.value ();
 	  }
 
         // grad_uv += v * grad_u;
@@ -114,7 +116,7 @@ namespace roboptim
              it; ++it)
 	  {
 	    typename Types<U,V>::gradientU_t::Index id = it.index ();
-	    grad_uv.coeffRef (id) += v (id) * it.value ();
+	    grad_uv.coeffRef (id) += v * it.value ();
 	  }
       }
 
@@ -233,6 +235,46 @@ namespace roboptim
   Product<U, V>::~Product ()
   {}
 
+  template <typename U, typename V>
+  void
+  Product<U, V>::impl_children
+  (typename expressionNode_t::children_t& children) const
+  {
+    detail::appendChild (children, left_);
+    detail::appendChild (children, right_);
+  }
+
+  template <typename U, typename V>
+  void
+  Product<U, V>::impl_replace_child
+  (typename expressionNode_t::children_t::value_type child,
+   const typename expressionNode_t::childShPtr_t& replacement,
+   typename expressionNode_t::constChildShPtr_t& replaced)
+  {
+    detail::replaceChild (left_, child, replacement, replaced);
+    detail::replaceChild (right_, child, replacement, replaced);
+  }
+
+  template <typename U, typename V>
+  typename Product<U, V>::expressionNode_t::childShPtr_t
+  Product<U, V>::impl_clone () const
+  {
+    return boost::make_shared<Product<U, V> > (*this);
+  }
+
+  template <typename U, typename V>
+  int
+  Product<U, V>::impl_compile
+  (typename expressionNode_t::compiler_t& compiler, int argument) const
+  {
+    if (!compiler.compatible (left_) || !compiler.compatible (right_))
+      return -1;
+
+    int left = compiler.operand (left_, argument);
+    int right = compiler.operand (right_, argument);
+    return compiler.binary (detail::CompiledOperation::MUL, left, right);
+  }
+
   template <typename U, typename V>
   void
   Product<U, V>::impl_compute
@@ -262,7 +304,7 @@ namespace roboptim
 
     // Compute gradient = ∂U V + ∂V U
     detail::ProductDifferentiation::gradient<U,V>
-      (gradient, resultLeft_, resultRight_,
+      (gradient, resultLeft_[functionId], resultRight_[functionId],
        gradientLeft_, gradientRight_);
   }
 
@@ -286,6 +328,35 @@ namespace roboptim
       (jacobian, resultLeft_, resultRight_,
        jacobianLeft_, jacobianRight_);
   }
+
+  template <typename U, typename V>
+  void
+  Product<U, V>::impl_value_and_jacobian (result_ref result,
+					  jacobian_ref jacobian,
+					  const_argument_ref x)
+    const
+  {
+    // Compute U, V, Jac(U) and Jac(V)
+    left_->valueAndJacobian (resultLeft_, jacobianLeft_, x);
+    right_->valueAndJacobian (resultRight_, jacobianRight_, x);
+
+    result.noalias () = resultLeft_.cwiseProduct (resultRight_);
+
+    // Compute the Jacobian
+    detail::ProductDifferentiation::jacobian<U,V>
+      (jacobian, resultLeft_, resultRight_,
+       jacobianLeft_, jacobianRight_);
+  }
+
+  template <typename U, typename V>
+  void
+  Product<U, V>::impl_jacobian_structure (sparsityPattern_t& pattern) const
+  {
+    // Union of both patterns.
+    sparsityPattern_t left = left_->jacobianStructure ();
+    sparsityPattern_t right = right_->jacobianStructure ();
+    pattern = left + right;
+  }
 } // end of namespace roboptim.
 
 #endif //! ROBOPTIM_CORE_OPERATOR_PRODUCT_HXX
@@ -21,6 +21,7 @@
 # include <boost/shared_ptr.hpp>
 
 # include <roboptim/core/detail/autopromote.hh>
+# include <roboptim/core/detail/expression-node.hh>
 # include <roboptim/core/twice-differentiable-function.hh>
 
 
@@ -32,10 +33,14 @@ namespace roboptim
   /// \brief Multiply by a constant scalar value.
   /// \tparam U input function type.
   template <typename U>
-  class Scalar : public detail::AutopromoteTrait<U>::T_type
+  class Scalar : public detail::AutopromoteTrait<U>::T_type,
+	         public detail::GenericExpressionNode
+	         <typename detail::AutopromoteTrait<U>::T_type::traits_t>
   {
   public:
     typedef typename detail::AutopromoteTrait<U>::T_type parentType_t;
+    typedef detail::GenericExpressionNode<typename parentType_t::traits_t>
+    expressionNode_t;
     typedef typename parentType_t::traits_t traits_t;
     ROBOPTIM_TWICE_DIFFERENTIABLE_FUNCTION_FWD_TYPEDEFS_
       (GenericTwiceDifferentiableFunction<traits_t>);
@@ -59,6 +64,19 @@ namespace roboptim
       return origin_;
     }
 
+    void impl_children
+    (typename expressionNode_t::children_t& children) const;
+
+    void impl_replace_child
+    (typename expressionNode_t::children_t::value_type child,
+     const typename expressionNode_t::childShPtr_t& replacement,
+     typename expressionNode_t::constChildShPtr_t& replaced);
+
+    typename expressionNode_t::childShPtr_t impl_clone () const;
+
+    int impl_compile (typename expressionNode_t::compiler_t& compiler,
+		      int argument) const;
+
     void impl_compute (result_ref result, const_argument_ref x)
       const;
 
@@ -69,11 +87,26 @@ namespace roboptim
     void impl_jacobian (jacobian_ref jacobian,
 			const_argument_ref arg)
       const;
+    void impl_value_and_jacobian (result_ref result,
+				  jacobian_ref jacobian,
+				  const_argument_ref arg)
+      const;
+    void impl_jacobian_structure (sparsityPattern_t& pattern)
+      const;
 
     void impl_hessian (hessian_ref hessian,
                        const_argument_ref x,
                        size_type functionId = 0) const;
 
+    void impl_hessian_vector_product (vector_ref result,
+                                      const_argument_ref x,
+                                      const_vector_ref direction,
+                                      size_type functionId = 0) const;
+
+    void impl_lagrangian_hessian (hessian_ref hessian,
+                                  const_argument_ref x,
+                                  const_vector_ref weights) const;
+
     /// \brief Display the function on the specified output stream.
     ///
     /// \param o output stream used for display
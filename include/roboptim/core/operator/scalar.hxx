@@ -19,6 +19,8 @@
 # define ROBOPTIM_CORE_OPERATOR_SCALAR_HXX
 # include <boost/format.hpp>
 
+# include <roboptim/core/detail/function-compiler.hh>
+
 namespace roboptim
 {
   template <typename U>
@@ -39,6 +41,42 @@ namespace roboptim
   Scalar<U>::~Scalar ()
   {}
 
+  template <typename U>
+  void
+  Scalar<U>::impl_children
+  (typename expressionNode_t::children_t& children) const
+  {
+    detail::appendChild (children, origin_);
+  }
+
+  template <typename U>
+  void
+  Scalar<U>::impl_replace_child
+  (typename expressionNode_t::children_t::value_type child,
+   const typename expressionNode_t::childShPtr_t& replacement,
+   typename expressionNode_t::constChildShPtr_t& replaced)
+  {
+    detail::replaceChild (origin_, child, replacement, replaced);
+  }
+
+  template <typename U>
+  typename Scalar<U>::expressionNode_t::childShPtr_t
+  Scalar<U>::impl_clone () const
+  {
+    return boost::make_shared<Scalar<U> > (*this);
+  }
+
+  template <typename U>
+  int
+  Scalar<U>::impl_compile
+  (typename expressionNode_t::compiler_t& compiler, int argument) const
+  {
+    if (!compiler.compatible (origin_))
+      return -1;
+
+    return compiler.scale (compiler.operand (origin_, argument), scalar_);
+  }
+
   template <typename U>
   void
   Scalar<U>::impl_compute
@@ -70,6 +108,25 @@ namespace roboptim
     jacobian *= scalar_;
   }
 
+  template <typename U>
+  void
+  Scalar<U>::impl_value_and_jacobian (result_ref result,
+				      jacobian_ref jacobian,
+				      const_argument_ref argument)
+    const
+  {
+    origin_->valueAndJacobian (result, jacobian, argument);
+    result *= scalar_;
+    jacobian *= scalar_;
+  }
+
+  template <typename U>
+  void
+  Scalar<U>::impl_jacobian_structure (sparsityPattern_t& pattern) const
+  {
+    origin_->jacobianStructure (pattern);
+  }
+
   template <typename U>
   void
   Scalar<U>::impl_hessian (hessian_ref hessian,
@@ -81,6 +138,29 @@ namespace roboptim
     hessian *= scalar_;
   }
 
+  template <typename U>
+  void
+  Scalar<U>::impl_hessian_vector_product (vector_ref result,
+					  const_argument_ref argument,
+					  const_vector_ref direction,
+					  size_type functionId)
+    const
+  {
+    origin_->hessianVectorProduct (result, argument, direction, functionId);
+    result *= scalar_;
+  }
+
+  template <typename U>
+  void
+  Scalar<U>::impl_lagrangian_hessian (hessian_ref hessian,
+				      const_argument_ref argument,
+				      const_vector_ref weights)
+    const
+  {
+    origin_->lagrangianHessian (hessian, argument, weights);
+    hessian *= scalar_;
+  }
+
   template <typename U>
   std::ostream& Scalar<U>::print (std::ostream& o) const
   {
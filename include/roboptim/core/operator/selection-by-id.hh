@@ -22,6 +22,7 @@
 # include <boost/shared_ptr.hpp>
 
 # include <roboptim/core/detail/autopromote.hh>
+# include <roboptim/core/detail/expression-node.hh>
 # include <roboptim/core/differentiable-function.hh>
 
 
@@ -33,10 +34,14 @@ namespace roboptim
   /// \brief Select part of a function.
   /// \tparam U input function type.
   template <typename U>
-  class SelectionById : public detail::AutopromoteTrait<U>::T_type
+  class SelectionById : public detail::AutopromoteTrait<U>::T_type,
+	                public detail::GenericExpressionNode
+	                <typename detail::AutopromoteTrait<U>::T_type::traits_t>
   {
   public:
     typedef typename detail::AutopromoteTrait<U>::T_type parentType_t;
+    typedef detail::GenericExpressionNode<typename parentType_t::traits_t>
+    expressionNode_t;
     ROBOPTIM_DIFFERENTIABLE_FUNCTION_FWD_TYPEDEFS_ (parentType_t);
 
     typedef boost::shared_ptr<SelectionById> SelectionByIdShPtr_t;
@@ -55,6 +60,19 @@ namespace roboptim
       return origin_;
     }
 
+    void impl_children
+    (typename expressionNode_t::children_t& children) const;
+
+    void impl_replace_child
+    (typename expressionNode_t::children_t::value_type child,
+     const typename expressionNode_t::childShPtr_t& replacement,
+     typename expressionNode_t::constChildShPtr_t& replaced);
+
+    typename expressionNode_t::childShPtr_t impl_clone () const;
+
+    int impl_compile (typename expressionNode_t::compiler_t& compiler,
+		      int argument) const;
+
     void impl_compute (result_ref result, const_argument_ref x)
       const;
 
@@ -65,6 +83,8 @@ namespace roboptim
     void impl_jacobian (jacobian_ref jacobian,
 			const_argument_ref arg)
       const;
+    void impl_jacobian_structure (sparsityPattern_t& pattern)
+      const;
   private:
     boost::shared_ptr<U> origin_;
     std::vector<bool> selector_;
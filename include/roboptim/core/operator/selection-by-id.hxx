@@ -19,6 +19,9 @@
 # define ROBOPTIM_CORE_OPERATOR_SELECTION_BY_ID_HXX
 # include <boost/format.hpp>
 
+# include <roboptim/core/util.hh>
+# include <roboptim/core/detail/function-compiler.hh>
+
 namespace roboptim
 {
   template <typename U>
@@ -56,6 +59,46 @@ namespace roboptim
   SelectionById<U>::~SelectionById ()
   {}
 
+  template <typename U>
+  void
+  SelectionById<U>::impl_children
+  (typename expressionNode_t::children_t& children) const
+  {
+    detail::appendChild (children, origin_);
+  }
+
+  template <typename U>
+  void
+  SelectionById<U>::impl_replace_child
+  (typename expressionNode_t::children_t::value_type child,
+   const typename expressionNode_t::childShPtr_t& replacement,
+   typename expressionNode_t::constChildShPtr_t& replaced)
+  {
+    detail::replaceChild (origin_, child, replacement, replaced);
+  }
+
+  template <typename U>
+  typename SelectionById<U>::expressionNode_t::childShPtr_t
+  SelectionById<U>::impl_clone () const
+  {
+    return boost::make_shared<SelectionById<U> > (*this);
+  }
+
+  template <typename U>
+  int
+  SelectionById<U>::impl_compile
+  (typename expressionNode_t::compiler_t& compiler, int argument) const
+  {
+    if (!compiler.compatible (origin_))
+      return -1;
+
+    std::vector<int> indices;
+    for (std::size_t row = 0; row < selector_.size (); ++row)
+      if (selector_[row])
+	indices.push_back (static_cast<int> (row));
+    return compiler.gather (compiler.operand (origin_, argument), indices);
+  }
+
   template <typename U>
   void
   SelectionById<U>::impl_compute
@@ -110,6 +153,27 @@ namespace roboptim
       }
   }
 
+  template <typename U>
+  void
+  SelectionById<U>::impl_jacobian_structure (sparsityPattern_t& pattern)
+    const
+  {
+    typedef typename sparsityPattern_t::Index index_t;
+
+    // Keep the selected rows.
+    std::vector<index_t> rows (selector_.size (), -1);
+    std::vector<index_t> cols
+      (static_cast<std::size_t> (origin_->inputSize ()));
+    index_t row = 0;
+    for (std::size_t i = 0; i < selector_.size (); ++i)
+      if (selector_[i])
+	rows[i] = row++;
+    for (size_type j = 0; j < origin_->inputSize (); ++j)
+      cols[static_cast<std::size_t> (j)] = j;
+
+    remapSparseMatrix (pattern, origin_->jacobianStructure (), rows, cols);
+  }
+
 } // end of namespace roboptim.
 
 #endif //! ROBOPTIM_CORE_OPERATOR_SELECTION_BY_ID_HXX
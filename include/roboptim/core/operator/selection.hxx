@@ -19,6 +19,9 @@
 # define ROBOPTIM_CORE_OPERATOR_SELECTION_HXX
 # include <boost/format.hpp>
 
+# include <roboptim/core/util.hh>
+# include <roboptim/core/detail/function-compiler.hh>
+
 namespace roboptim
 {
   template <typename U>
@@ -50,6 +53,45 @@ namespace roboptim
   Selection<U>::~Selection ()
   {}
 
+  template <typename U>
+  void
+  Selection<U>::impl_children
+  (typename expressionNode_t::children_t& children) const
+  {
+    detail::appendChild (children, origin_);
+  }
+
+  template <typename U>
+  void
+  Selection<U>::impl_replace_child
+  (typename expressionNode_t::children_t::value_type child,
+   const typename expressionNode_t::childShPtr_t& replacement,
+   typename expressionNode_t::constChildShPtr_t& replaced)
+  {
+    detail::replaceChild (origin_, child, replacement, replaced);
+  }
+
+  template <typename U>
+  typename Selection<U>::expressionNode_t::childShPtr_t
+  Selection<U>::impl_clone () const
+  {
+    return boost::make_shared<Selection<U> > (*this);
+  }
+
+  template <typename U>
+  int
+  Selection<U>::impl_compile
+  (typename expressionNode_t::compiler_t& compiler, int argument) const
+  {
+    if (!compiler.compatible (origin_))
+      return -1;
+
+    std::vector<int> indices (static_cast<std::size_t> (size_));
+    for (size_type i = 0; i < size_; ++i)
+      indices[static_cast<std::size_t> (i)] = static_cast<int> (start_ + i);
+    return compiler.gather (compiler.operand (origin_, argument), indices);
+  }
+
   template <typename U>
   void
   Selection<U>::impl_compute
@@ -80,6 +122,37 @@ namespace roboptim
     jacobian = jacobian_.block (start_, 0, size_, jacobian_.cols ());
   }
 
+  template <typename U>
+  void
+  Selection<U>::impl_value_and_jacobian (result_ref result,
+					 jacobian_ref jacobian,
+					 const_argument_ref argument)
+    const
+  {
+    origin_->valueAndJacobian (result_, jacobian_, argument);
+    result = result_.segment (start_, size_);
+    jacobian = jacobian_.block (start_, 0, size_, jacobian_.cols ());
+  }
+
+  template <typename U>
+  void
+  Selection<U>::impl_jacobian_structure (sparsityPattern_t& pattern) const
+  {
+    typedef typename sparsityPattern_t::Index index_t;
+
+    // Keep the selected rows.
+    std::vector<index_t> rows
+      (static_cast<std::size_t> (origin_->outputSize ()), -1);
+    std::vector<index_t> cols
+      (static_cast<std::size_t> (origin_->inputSize ()));
+    for (size_type i = 0; i < size_; ++i)
+      rows[static_cast<std::size_t> (start_ + i)] = i;
+    for (size_type j = 0; j < origin_->inputSize (); ++j)
+      cols[static_cast<std::size_t> (j)] = j;
+
+    remapSparseMatrix (pattern, origin_->jacobianStructure (), rows, cols);
+  }
+
 } // end of namespace roboptim.
 
 #endif //! ROBOPTIM_CORE_OPERATOR_SELECTION_HXX
@@ -18,24 +18,160 @@
 #ifndef ROBOPTIM_CORE_OPERATOR_SPLIT_HH
 # define ROBOPTIM_CORE_OPERATOR_SPLIT_HH
 # include <stdexcept>
+# include <vector>
+
+# include <boost/mpl/bool.hpp>
 # include <boost/shared_ptr.hpp>
+# include <boost/thread/mutex.hpp>
 
 # include <roboptim/core/n-times-derivable-function.hh>
+# include <roboptim/core/detail/expression-node.hh>
 
 namespace roboptim
 {
   /// \addtogroup roboptim_operator
   /// @{
 
+  /// \brief Shared evaluation of a function split into its outputs.
+  ///
+  /// Splitting an m-output function into m scalar functions would
+  /// otherwise evaluate it m times per argument, once per Split. All the
+  /// Split built on the same group share a single evaluation of the
+  /// function per argument, for the values and the jacobian alike: the
+  /// gradient of an output is a row of the shared jacobian.
+  ///
+  /// The last value and the last jacobian are kept with their argument,
+  /// and computed again as soon as the argument changes. If the function
+  /// may change without its argument changing, #invalidate has to be
+  /// called. The group is thread-safe: concurrent siblings wait for the
+  /// first evaluation, then use its result.
+  ///
+  /// \tparam T input function type.
+  template <typename T>
+  class SplitGroup
+  {
+  public:
+    /// \brief Import traits type.
+    typedef typename T::traits_t traits_t;
+
+    typedef typename T::value_type value_type;
+    typedef typename T::size_type size_type;
+    typedef typename T::argument_t argument_t;
+    typedef typename T::const_argument_ref const_argument_ref;
+    typedef typename T::result_t result_t;
+    typedef typename GenericFunctionTraits<traits_t>::gradient_ref
+    gradient_ref;
+    typedef typename GenericFunctionTraits<traits_t>::jacobian_t jacobian_t;
+    typedef detail::GenericExpressionNode<traits_t> expressionNode_t;
+
+    /// \brief Build a group for a function.
+    /// \param fct split function.
+    explicit SplitGroup (boost::shared_ptr<const T> fct);
+
+    /// \brief Split function.
+    const boost::shared_ptr<const T>& function () const
+    {
+      return function_;
+    }
+
+    /// \brief Value of an output, the function being evaluated only if
+    /// the argument changed.
+    /// \param argument point at which the function will be evaluated
+    /// \param functionId index of the output
+    value_type value (const_argument_ref argument,
+		      size_type functionId) const;
+
+    /// \brief Gradient of an output, the jacobian being computed only if
+    /// the argument changed.
+    /// \param gradient gradient will be stored in this argument
+    /// \param argument point at which the jacobian will be computed
+    /// \param functionId index of the output
+    void gradient (gradient_ref gradient, const_argument_ref argument,
+		   size_type functionId) const;
+
+    /// \brief Replace the split function, for all the splits of the
+    /// group, if it is child.
+    ///
+    /// The last value and jacobian are forgotten.
+    /// \see detail::GraphTraversal::replaceChild
+    void replaceChild
+    (typename expressionNode_t::children_t::value_type child,
+     const typename expressionNode_t::childShPtr_t& replacement,
+     typename expressionNode_t::constChildShPtr_t& replaced);
+
+    /// \brief Forget the last value and jacobian.
+    void invalidate ();
+
+    /// \brief Number of evaluations of the function.
+    size_type evaluations () const
+    {
+      return evaluations_;
+    }
+
+    /// \brief Number of jacobian computations of the function.
+    size_type jacobianEvaluations () const
+    {
+      return jacobianEvaluations_;
+    }
+
+  private:
+    /// \brief Copy a row of the dense jacobian.
+    template <typename G>
+    void copyRow (G& gradient, size_type functionId,
+		  boost::mpl::true_) const;
+
+    /// \brief Copy a row of the sparse jacobian.
+    template <typename G>
+    void copyRow (G& gradient, size_type functionId,
+		  boost::mpl::false_) const;
+
+  private:
+    /// \brief Split function.
+    boost::shared_ptr<const T> function_;
+
+    /// \brief Mutex protecting the shared evaluations.
+    mutable boost::mutex mutex_;
+
+    /// \brief Whether result_ is the value at valueArgument_.
+    mutable bool valueValid_;
+
+    /// \brief Argument of the last evaluation.
+    mutable argument_t valueArgument_;
+
+    /// \brief Last value.
+    mutable result_t result_;
+
+    /// \brief Whether jacobian_ is the jacobian at jacobianArgument_.
+    mutable bool jacobianValid_;
+
+    /// \brief Argument of the last jacobian computation.
+    mutable argument_t jacobianArgument_;
+
+    /// \brief Last jacobian.
+    mutable jacobian_t jacobian_;
+
+    /// \brief Number of evaluations.
+    mutable size_type evaluations_;
+
+    /// \brief Number of jacobian computations.
+    mutable size_type jacobianEvaluations_;
+  };
+
   /// \brief Select an element of a function's output.
+  ///
+  /// Splits built on a SplitGroup share the evaluations of the function,
+  /// see splitGroup.
   /// \tparam T input function type.
   template <typename T>
-  class Split : public T
+  class Split : public T,
+		public detail::GenericExpressionNode<typename T::traits_t>
   {
   public:
     /// \brief Import traits type.
     typedef typename T::traits_t traits_t;
 
+    typedef detail::GenericExpressionNode<traits_t> expressionNode_t;
+
     ROBOPTIM_TWICE_DIFFERENTIABLE_FUNCTION_FWD_TYPEDEFS_
     (GenericTwiceDifferentiableFunction<traits_t>);
 
@@ -47,9 +183,32 @@ namespace roboptim
     /// \param functionId index of the output to select.
     explicit Split (boost::shared_ptr<const T> fct,
 		    size_type functionId);
+
+    /// \brief Split operator constructor, sharing the evaluations of the
+    /// function with the other splits of the group.
+    /// \param group group of the input function.
+    /// \param functionId index of the output to select.
+    explicit Split (boost::shared_ptr<SplitGroup<T> > group,
+		    size_type functionId);
     ~Split ();
 
+    /// \brief Group sharing the evaluations, null if none.
+    const boost::shared_ptr<SplitGroup<T> >& group () const
+    {
+      return group_;
+    }
+
   protected:
+    void impl_children
+    (typename expressionNode_t::children_t& children) const;
+
+    void impl_replace_child
+    (typename expressionNode_t::children_t::value_type child,
+     const typename expressionNode_t::childShPtr_t& replacement,
+     typename expressionNode_t::constChildShPtr_t& replaced);
+
+    typename expressionNode_t::childShPtr_t impl_clone () const;
+
     virtual void impl_compute (result_ref result, const_argument_ref argument)
       const;
 
@@ -59,27 +218,69 @@ namespace roboptim
 				size_type functionId = 0)
       const;
 
+    virtual void impl_jacobian_structure (sparsityPattern_t& pattern)
+      const;
+
     virtual void impl_hessian (hessian_ref hessian,
     			       const_argument_ref argument,
     			       size_type functionId = 0) const;
 
+    virtual void impl_hessian_vector_product (vector_ref result,
+					      const_argument_ref argument,
+					      const_vector_ref direction,
+					      size_type functionId = 0) const;
+
+    virtual void impl_lagrangian_hessian (hessian_ref hessian,
+					  const_argument_ref argument,
+					  const_vector_ref weights) const;
+
     virtual void impl_derivative (gradient_ref derivative,
     				  value_type argument,
     				  size_type order = 1) const;
 
   private:
+    /// \brief Input function, read from the group if any.
+    const boost::shared_ptr<const T>& function () const
+    {
+      return group_ ? group_->function () : function_;
+    }
+
+  private:
+    /// \brief Input function, null if the split belongs to a group.
     boost::shared_ptr<const T> function_;
+    boost::shared_ptr<SplitGroup<T> > group_;
     size_type functionId_;
     mutable result_t res_;
   };
 
+  /// \brief Split a function into scalar functions sharing its
+  /// evaluations.
+  ///
+  /// \param fct input function.
+  /// \return one Split per output of the function, built on a single
+  /// SplitGroup.
+  template <typename T>
+  std::vector<boost::shared_ptr<Split<T> > >
+  splitGroup (boost::shared_ptr<const T> fct);
+
+  /// \brief Add each output of a function as a scalar constraint.
+  ///
+  /// \param problem problem the constraints are added to.
+  /// \param constraint non-scalar constraint.
+  /// \param interval interval of each output.
+  /// \param scale scale of each output (none if empty).
+  /// \param shareEvaluations whether the scalar constraints are built
+  /// with splitGroup, and share the evaluations of the function. This is
+  /// only valid if the function does not change without its argument
+  /// changing.
   template <typename P, typename C>
   void addNonScalarConstraint
   (P& problem,
    boost::shared_ptr<C> constraint,
    std::vector<Function::interval_t> interval,
    std::vector<Function::value_type> scale
-   = std::vector<Function::value_type> ());
+   = std::vector<Function::value_type> (),
+   bool shareEvaluations = false);
 
   /// @}
 
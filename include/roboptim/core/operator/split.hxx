@@ -18,9 +18,11 @@
 #ifndef ROBOPTIM_CORE_OPERATOR_SPLIT_HXX
 # define ROBOPTIM_CORE_OPERATOR_SPLIT_HXX
 # include <boost/format.hpp>
+# include <boost/make_shared.hpp>
 
 # include <roboptim/core/debug.hh>
 # include <roboptim/core/derivative-size.hh>
+# include <roboptim/core/util.hh>
 
 namespace roboptim
 {
@@ -39,29 +41,188 @@ namespace roboptim
     }
   } // end of anonymous namespace.
 
+  template <typename T>
+  SplitGroup<T>::SplitGroup (boost::shared_ptr<const T> fct)
+    : function_ (fct),
+      mutex_ (),
+      valueValid_ (false),
+      valueArgument_ (fct->inputSize ()),
+      result_ (fct->outputSize ()),
+      jacobianValid_ (false),
+      jacobianArgument_ (fct->inputSize ()),
+      jacobian_ (fct->outputSize (), fct->inputSize ()),
+      evaluations_ (0),
+      jacobianEvaluations_ (0)
+  {
+    valueArgument_.setZero ();
+    result_.setZero ();
+    jacobianArgument_.setZero ();
+    jacobian_.setZero ();
+  }
+
+  template <typename T>
+  typename SplitGroup<T>::value_type
+  SplitGroup<T>::value (const_argument_ref argument,
+			size_type functionId) const
+  {
+    boost::mutex::scoped_lock lock (mutex_);
+
+    if (!valueValid_ || valueArgument_ != argument)
+      {
+	(*function_) (result_, argument);
+	valueArgument_ = argument;
+	valueValid_ = true;
+	++evaluations_;
+      }
+    return result_[functionId];
+  }
+
+  template <typename T>
+  void
+  SplitGroup<T>::gradient (gradient_ref gradient,
+			   const_argument_ref argument,
+			   size_type functionId) const
+  {
+    boost::mutex::scoped_lock lock (mutex_);
+
+    if (!jacobianValid_ || jacobianArgument_ != argument)
+      {
+	function_->jacobian (jacobian_, argument);
+	jacobianArgument_ = argument;
+	jacobianValid_ = true;
+	++jacobianEvaluations_;
+      }
+    copyRow (gradient, functionId,
+	     boost::mpl::bool_<StorageTraits<traits_t>::isDense> ());
+  }
+
+  template <typename T>
+  template <typename G>
+  void
+  SplitGroup<T>::copyRow (G& gradient, size_type functionId,
+			  boost::mpl::true_) const
+  {
+    gradient = jacobian_.row (functionId);
+  }
+
+  template <typename T>
+  template <typename G>
+  void
+  SplitGroup<T>::copyRow (G& gradient, size_type functionId,
+			  boost::mpl::false_) const
+  {
+#ifndef ROBOPTIM_DO_NOT_CHECK_ALLOCATION
+    bool cur_malloc_allowed = is_malloc_allowed ();
+    set_is_malloc_allowed (true);
+#endif //! ROBOPTIM_DO_NOT_CHECK_ALLOCATION
+
+    gradient = jacobian_.row (functionId);
+
+#ifndef ROBOPTIM_DO_NOT_CHECK_ALLOCATION
+    set_is_malloc_allowed (cur_malloc_allowed);
+#endif //! ROBOPTIM_DO_NOT_CHECK_ALLOCATION
+  }
+
+  template <typename T>
+  void
+  SplitGroup<T>::replaceChild
+  (typename expressionNode_t::children_t::value_type child,
+   const typename expressionNode_t::childShPtr_t& replacement,
+   typename expressionNode_t::constChildShPtr_t& replaced)
+  {
+    boost::mutex::scoped_lock lock (mutex_);
+    detail::replaceChild (function_, child, replacement, replaced);
+    if (!replaced)
+      return;
+    valueValid_ = false;
+    jacobianValid_ = false;
+  }
+
+  template <typename T>
+  void
+  SplitGroup<T>::invalidate ()
+  {
+    boost::mutex::scoped_lock lock (mutex_);
+    valueValid_ = false;
+    jacobianValid_ = false;
+  }
+
   template <typename T>
   Split<T>::Split (boost::shared_ptr<const T> fct,
 		   size_type functionId)
     : T (fct->inputSize (), 1, splitName (*fct, functionId)),
       function_ (fct),
+      group_ (),
       functionId_ (functionId),
       res_ (function_->outputSize ())
   {
     assert (functionId < fct->outputSize ());
   }
 
+  template <typename T>
+  Split<T>::Split (boost::shared_ptr<SplitGroup<T> > group,
+		   size_type functionId)
+    : T (group->function ()->inputSize (), 1,
+	 splitName (*group->function (), functionId)),
+      function_ (),
+      group_ (group),
+      functionId_ (functionId),
+      res_ (group->function ()->outputSize ())
+  {
+    assert (functionId < group->function ()->outputSize ());
+  }
+
   template <typename T>
   Split<T>::~Split ()
   {
   }
 
+  template <typename T>
+  void
+  Split<T>::impl_children
+  (typename expressionNode_t::children_t& children) const
+  {
+    detail::appendChild (children, function ());
+  }
+
+  template <typename T>
+  void
+  Split<T>::impl_replace_child
+  (typename expressionNode_t::children_t::value_type child,
+   const typename expressionNode_t::childShPtr_t& replacement,
+   typename expressionNode_t::constChildShPtr_t& replaced)
+  {
+    // The function is replaced for the whole group.
+    if (group_)
+      group_->replaceChild (child, replacement, replaced);
+    else
+      detail::replaceChild (function_, child, replacement, replaced);
+  }
+
+  template <typename T>
+  typename Split<T>::expressionNode_t::childShPtr_t
+  Split<T>::impl_clone () const
+  {
+    boost::shared_ptr<Split<T> > copy = boost::make_shared<Split<T> > (*this);
+    // Replacing the operand of the copy must not affect the group.
+    if (group_)
+      copy->group_ = boost::make_shared<SplitGroup<T> > (group_->function ());
+    return copy;
+  }
+
   template <typename T>
   void
   Split<T>::impl_compute (result_ref result,
 			  const_argument_ref argument)
     const
   {
-    (*function_) (this->res_, argument);
+    if (group_)
+      {
+	result[0] = group_->value (argument, functionId_);
+	return;
+      }
+
+    (*function ()) (this->res_, argument);
     result[0] = this->res_[functionId_];
   }
 
@@ -82,12 +243,40 @@ namespace roboptim
     const
   {
     assert (functionId == 0);
-    function_->gradient (gradient, argument, functionId_);
+    if (group_)
+      group_->gradient (gradient, argument, functionId_);
+    else
+      function ()->gradient (gradient, argument, functionId_);
   }
 
 
 
 
+  template <>
+  inline void
+  Split<Function>::impl_jacobian_structure (sparsityPattern_t&) const
+  {
+    assert (0);
+  }
+
+  template <typename T>
+  void
+  Split<T>::impl_jacobian_structure (sparsityPattern_t& pattern) const
+  {
+    typedef typename sparsityPattern_t::Index index_t;
+
+    // Keep the selected row.
+    std::vector<index_t> rows
+      (static_cast<std::size_t> (function ()->outputSize ()), -1);
+    std::vector<index_t> cols
+      (static_cast<std::size_t> (function ()->inputSize ()));
+    rows[static_cast<std::size_t> (functionId_)] = 0;
+    for (size_type j = 0; j < function ()->inputSize (); ++j)
+      cols[static_cast<std::size_t> (j)] = j;
+
+    remapSparseMatrix (pattern, function ()->jacobianStructure (), rows, cols);
+  }
+
   template <>
   inline void
   Split<Function>::impl_hessian
@@ -114,7 +303,65 @@ namespace roboptim
     const
   {
     assert (functionId == 0);
-    function_->hessian (hessian, argument, functionId_);
+    function ()->hessian (hessian, argument, functionId_);
+  }
+
+  template <>
+  inline void
+  Split<Function>::impl_hessian_vector_product
+  (vector_ref, const_argument_ref, const_vector_ref, size_type) const
+  {
+    assert (0);
+  }
+
+  template <>
+  inline void
+  Split<DifferentiableFunction>::impl_hessian_vector_product
+  (vector_ref, const_argument_ref, const_vector_ref, size_type) const
+  {
+    assert (0);
+  }
+
+  template <typename T>
+  void
+  Split<T>::impl_hessian_vector_product (vector_ref result,
+					 const_argument_ref argument,
+					 const_vector_ref direction,
+					 size_type ROBOPTIM_DEBUG_ONLY (functionId))
+    const
+  {
+    assert (functionId == 0);
+    function ()->hessianVectorProduct (result, argument, direction,
+				     functionId_);
+  }
+
+  template <>
+  inline void
+  Split<Function>::impl_lagrangian_hessian
+  (hessian_ref, const_argument_ref, const_vector_ref) const
+  {
+    assert (0);
+  }
+
+  template <>
+  inline void
+  Split<DifferentiableFunction>::impl_lagrangian_hessian
+  (hessian_ref, const_argument_ref, const_vector_ref) const
+  {
+    assert (0);
+  }
+
+  // Only the selected output has a weight: no need for the hessians of
+  // the other outputs.
+  template <typename T>
+  void
+  Split<T>::impl_lagrangian_hessian (hessian_ref hessian,
+				     const_argument_ref argument,
+				     const_vector_ref weights)
+    const
+  {
+    function ()->hessian (hessian, argument, functionId_);
+    hessian *= weights[0];
   }
 
 
@@ -149,7 +396,21 @@ namespace roboptim
 			     size_type order)
     const
   {
-    function_->derivative (derivative, argument, order);
+    function ()->derivative (derivative, argument, order);
+  }
+
+  template <typename T>
+  std::vector<boost::shared_ptr<Split<T> > >
+  splitGroup (boost::shared_ptr<const T> fct)
+  {
+    boost::shared_ptr<SplitGroup<T> > group =
+      boost::make_shared<SplitGroup<T> > (fct);
+
+    std::vector<boost::shared_ptr<Split<T> > > splits;
+    splits.reserve (static_cast<std::size_t> (fct->outputSize ()));
+    for (typename Split<T>::size_type i = 0; i < fct->outputSize (); ++i)
+      splits.push_back (boost::make_shared<Split<T> > (group, i));
+    return splits;
   }
 
   template <typename P, typename C>
@@ -157,7 +418,8 @@ namespace roboptim
   (P& problem,
    boost::shared_ptr<C> constraint,
    std::vector<Function::interval_t> interval,
-   std::vector<Function::value_type> scaling)
+   std::vector<Function::value_type> scaling,
+   bool shareEvaluations)
   {
     assert (constraint);
     assert (interval.size () == constraint->outputSize ());
@@ -171,9 +433,16 @@ namespace roboptim
 	problem.addConstraint (constraint, interval[0], scaling[0]);
       return;
     }
+
+    std::vector<boost::shared_ptr<Split<C> > > splits;
+    if (shareEvaluations)
+      splits = splitGroup<C> (constraint);
+
     for (unsigned i = 0; i < constraint->outputSize (); ++i)
       {
-	boost::shared_ptr<Split<C> > split (new Split<C> (constraint, i));
+	boost::shared_ptr<Split<C> > split =
+	  shareEvaluations? splits[i]
+	  : boost::shared_ptr<Split<C> > (new Split<C> (constraint, i));
 	if (scaling.empty ())
 	  problem.addConstraint (split, interval[i]);
 	else
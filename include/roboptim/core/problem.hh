@@ -22,6 +22,7 @@
 # include <vector>
 
 # include <boost/mpl/assert.hpp>
+# include <boost/mpl/bool.hpp>
 # include <boost/mpl/vector.hpp>
 # include <boost/optional.hpp>
 # include <boost/shared_ptr.hpp>
@@ -395,6 +396,14 @@ namespace roboptim
     /// \brief Initialize attributes and do some checking.
     void initialize ();
 
+    /// \brief Evaluate the dense Jacobian matrix of the problem.
+    template <typename J>
+    J jacobian (const_argument_ref x, boost::mpl::true_) const;
+
+    /// \brief Evaluate the sparse Jacobian matrix of the problem.
+    template <typename J>
+    J jacobian (const_argument_ref x, boost::mpl::false_) const;
+
   private:
     /// \brief Objective function.
     /// Note: do not give access to this shared_ptr, since for now the legacy
@@ -371,15 +371,16 @@ namespace roboptim
   }
 
   template <typename T>
-  typename Problem<T>::jacobian_t
-  Problem<T>::jacobian (const_argument_ref x) const
+  template <typename J>
+  J
+  Problem<T>::jacobian (const_argument_ref x, boost::mpl::true_) const
   {
     typedef GenericDifferentiableFunction<T> differentiableFunction_t;
 
     size_type n = function_->inputSize ();
     size_type m = differentiableConstraintsOutputSize ();
 
-    jacobian_t jac (m, n);
+    J jac (m, n);
     jac.setZero ();
 
     // For each constraint of the problem
@@ -401,71 +402,32 @@ namespace roboptim
   }
 
   template <typename T>
-  typename Problem<T>::jacobian_t
-  Problem<T>::scaledJacobian (const_argument_ref x) const
+  template <typename J>
+  J
+  Problem<T>::jacobian (const_argument_ref x, boost::mpl::false_) const
   {
     typedef GenericDifferentiableFunction<T> differentiableFunction_t;
-
-    // Compute the unscaled Jacobian matrix
-    jacobian_t jac = jacobian (x);
-
-    // Apply constraint scaling parameters
-    size_type global_row = 0;
-    size_t c_idx = 0;
-    for (typename constraints_t::const_iterator
-	   c = constraints_.begin (); c != constraints_.end (); ++c)
-      {
-	// If the constraint is differentiable
-        if ((*c)->template asType<differentiableFunction_t> ())
-	  {
-	    const differentiableFunction_t*
-	      df = (*c)->template castInto<differentiableFunction_t> ();
-            for (size_type i = 0; i < df->outputSize (); ++i)
-	      {
-                jac.row(global_row + i) *=
-		  scalingVect_[c_idx][static_cast<size_t> (i)];
-              }
-	    global_row += df->outputSize ();
-	  }
-        c_idx++;
-      }
-
-    // Apply argument scaling parameters
-    for (size_t i = 0; i < argumentScaling_.size (); ++i)
-      {
-	jac.col (static_cast<size_type> (i)) *= argumentScaling_[i];
-      }
-
-    return jac;
-  }
-
-  template <>
-  inline typename Problem<EigenMatrixSparse>::jacobian_t
-  Problem<EigenMatrixSparse>::jacobian (const_argument_ref x) const
-  {
-    typedef GenericDifferentiableFunction<EigenMatrixSparse>
-      differentiableFunction_t;
-    typedef Eigen::Triplet<double> triplet_t;
+    typedef Eigen::Triplet<value_type> triplet_t;
 
     size_type n = function_->inputSize ();
     size_type m = differentiableConstraintsOutputSize ();
 
-    jacobian_t jac (m, n);
+    J jac (m, n);
     jac.setZero ();
 
-    jacobian_t tmp;
+    J tmp;
     std::vector<triplet_t> coeffs;
 
     // For each constraint of the problem
     size_type global_row = 0;
-    for (constraints_t::const_iterator
+    for (typename constraints_t::const_iterator
 	   c = constraints_.begin (); c != constraints_.end (); ++c)
       {
 	// If the constraint is differentiable
-        if ((*c)->asType<differentiableFunction_t> ())
+        if ((*c)->template asType<differentiableFunction_t> ())
 	  {
 	    const differentiableFunction_t*
-	      df = (*c)->castInto<differentiableFunction_t> ();
+	      df = (*c)->template castInto<differentiableFunction_t> ();
 
             tmp.resize (df->outputSize (), n);
             tmp.setZero ();
@@ -473,7 +435,7 @@ namespace roboptim
             tmp.makeCompressed ();
 
 	    for (int k = 0; k < tmp.outerSize (); ++k)
-	      for (differentiableFunction_t::jacobian_t::InnerIterator
+	      for (typename J::InnerIterator
 		     it (tmp, k); it; ++it)
 		{
 		  const int row = static_cast<int> (global_row + it.row ());
@@ -491,6 +453,53 @@ namespace roboptim
     return jac;
   }
 
+  template <typename T>
+  typename Problem<T>::jacobian_t
+  Problem<T>::jacobian (const_argument_ref x) const
+  {
+    return jacobian<jacobian_t> (x,
+				 boost::mpl::bool_<StorageTraits<T>::isDense> ());
+  }
+
+  template <typename T>
+  typename Problem<T>::jacobian_t
+  Problem<T>::scaledJacobian (const_argument_ref x) const
+  {
+    typedef GenericDifferentiableFunction<T> differentiableFunction_t;
+
+    // Compute the unscaled Jacobian matrix
+    jacobian_t jac = jacobian (x);
+
+    // Apply constraint scaling parameters
+    size_type global_row = 0;
+    size_t c_idx = 0;
+    for (typename constraints_t::const_iterator
+	   c = constraints_.begin (); c != constraints_.end (); ++c)
+      {
+	// If the constraint is differentiable
+        if ((*c)->template asType<differentiableFunction_t> ())
+	  {
+	    const differentiableFunction_t*
+	      df = (*c)->template castInto<differentiableFunction_t> ();
+            for (size_type i = 0; i < df->outputSize (); ++i)
+	      {
+                jac.row(global_row + i) *=
+		  scalingVect_[c_idx][static_cast<size_t> (i)];
+              }
+	    global_row += df->outputSize ();
+	  }
+        c_idx++;
+      }
+
+    // Apply argument scaling parameters
+    for (size_t i = 0; i < argumentScaling_.size (); ++i)
+      {
+	jac.col (static_cast<size_type> (i)) *= argumentScaling_[i];
+      }
+
+    return jac;
+  }
+
   template <typename T>
   typename Problem<T>::result_t
   Problem<T>::constraintsViolationVector (const_argument_ref x) const
@@ -511,9 +520,9 @@ namespace roboptim
 	const interval_t& bounds = argumentBounds_[static_cast<size_t> (j)];
 
 	if (bounds.first != -Function::infinity ())
-	  inf_viol = std::min (x[j] - bounds.first, 0.);
+	  inf_viol = std::min (x[j] - bounds.first, value_type (0));
 	if (bounds.second != Function::infinity ())
-	  sup_viol = std::max (x[j] - bounds.second, 0.);
+	  sup_viol = std::max (x[j] - bounds.second, value_type (0));
 
         if (inf_viol < 0.) violations[i] = inf_viol;
         else violations[i] = sup_viol;
@@ -534,9 +543,9 @@ namespace roboptim
 	    value_type sup_viol = 0.;
 
 	    if (bounds[jj].first != -Function::infinity ())
-	      inf_viol = std::min (res[j] - bounds[jj].first, 0.);
+	      inf_viol = std::min (res[j] - bounds[jj].first, value_type (0));
 	    if (bounds[jj].second != Function::infinity ())
-	      sup_viol = std::max (res[j] - bounds[jj].second, 0.);
+	      sup_viol = std::max (res[j] - bounds[jj].second, value_type (0));
 
 	    if (inf_viol < 0.) violations[i] = inf_viol;
 	    else violations[i] = sup_viol;
@@ -732,6 +741,8 @@ namespace roboptim
   ROBOPTIM_ALLOW_ATTRIBUTES_ON
   extern template class ROBOPTIM_CORE_DLLAPI Problem<EigenMatrixDense>;
   extern template class ROBOPTIM_CORE_DLLAPI Problem<EigenMatrixSparse>;
+  extern template class ROBOPTIM_CORE_DLLAPI Problem<EigenMatrixDenseFloat>;
+  extern template class ROBOPTIM_CORE_DLLAPI Problem<EigenMatrixSparseFloat>;
   ROBOPTIM_ALLOW_ATTRIBUTES_OFF
 # endif //! ROBOPTIM_PRECOMPILED_DENSE_SPARSE
 
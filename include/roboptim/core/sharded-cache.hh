@@ -0,0 +1,190 @@
+// Copyright (C) 2026 by the RobOptim contributors.
+//
+// This file is part of the roboptim.
+//
+// roboptim is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// roboptim is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with roboptim.  If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef ROBOPTIM_CORE_SHARDED_CACHE_HH
+# define ROBOPTIM_CORE_SHARDED_CACHE_HH
+
+# include <vector>
+# include <ostream>
+
+# include <boost/thread/mutex.hpp>
+
+# include <roboptim/core/cache.hh>
+
+namespace roboptim
+{
+  /// \brief Thread-safe LRU (Least Recently Used) cache.
+  ///
+  /// Keys are dispatched among several LRUCache shards depending on their
+  /// hash, and each shard is protected by its own mutex (lock striping).
+  /// Threads accessing different shards do not wait for each other, and
+  /// keys are only hashed once. Since shards evict their elements
+  /// independently, the eviction policy is only approximately LRU.
+  ///
+  /// Cached values cannot be accessed by reference, since they could be
+  /// modified by another thread as soon as the shard is unlocked: they are
+  /// copied instead.
+  ///
+  /// \tparam K type for keys.
+  /// \tparam V type for values.
+  /// \tparam H hasher type.
+  template <typename K, typename V, typename H = boost::hash<K> >
+  class ShardedLRUCache
+  {
+  public:
+    /// \brief Type of a shard.
+    typedef LRUCache<K, V, H> shard_t;
+
+    /// \brief Type of keys.
+    typedef typename shard_t::key_t key_t;
+
+    /// \brief Type of const reference to key.
+    typedef typename shard_t::const_key_ref const_key_ref;
+
+    /// \brief Type of values.
+    typedef typename shard_t::value_t value_t;
+
+    /// \brief Hasher type.
+    typedef typename shard_t::hasher_t hasher_t;
+
+    /// \brief Hash type.
+    typedef typename shard_t::hash_t hash_t;
+
+  public:
+    /// \brief Constructor.
+    /// Note: all the memory is allocated in the constructor.
+    /// \param size maximum size of the cache.
+    /// \param verifyKeys whether keys are stored and checked on hit.
+    /// \param shards number of shards (at most size).
+    ShardedLRUCache (size_t size = 10, bool verifyKeys = false,
+                     size_t shards = 8);
+
+    /// \brief Destructor.
+    virtual ~ShardedLRUCache ();
+
+    /// \brief Size of the cache.
+    size_t size () const;
+
+    /// \brief Number of shards.
+    size_t shards () const;
+
+    /// \brief Whether keys are verified on hit.
+    bool verifyKeys () const;
+
+    /// \brief Copy a cached element.
+    /// \param key key to the element.
+    /// \param value value of the element, if found.
+    /// \return whether the element was found.
+    template <typename R>
+    bool get (const_key_ref key, R& value) const;
+
+    /// \brief Insert a value into the cache.
+    /// \param key key of the element.
+    /// \param value value of the element.
+    template <typename R>
+    void insert (const_key_ref key, const R& value);
+
+    /// \brief Read a cached element, given the precomputed hash of its key.
+    /// The shard is locked while the reader is called.
+    /// \param key key to the element.
+    /// \param hash hash of the key (see detail::CacheHash).
+    /// \param reader functor called with the cached element, if any, and
+    /// returning whether it could be used.
+    /// \return whether the element was found and used by the reader.
+    template <typename F>
+    bool read (const_key_ref key, hash_t hash, const F& reader) const;
+
+    /// \brief Update a cached element, creating it if necessary, given the
+    /// precomputed hash of its key.
+    /// The shard is locked while the writer is called.
+    /// \param key key to the element.
+    /// \param hash hash of the key (see detail::CacheHash).
+    /// \param writer functor called with the element and whether it was
+    /// inserted (see LRUCache::access).
+    template <typename F>
+    void write (const_key_ref key, hash_t hash, const F& writer);
+
+    /// \brief Clear the cache.
+    void clear ();
+
+    /// \brief Number of successful lookups.
+    size_t hits () const;
+
+    /// \brief Number of unsuccessful lookups.
+    size_t misses () const;
+
+    /// \brief Number of elements inserted in the cache.
+    size_t insertions () const;
+
+    /// \brief Number of elements evicted to make room for new ones.
+    size_t evictions () const;
+
+    /// \brief Statistics of the cache (sum over all the shards).
+    CacheStatistics statistics () const;
+
+    /// \brief Reset the lookup, insertion and eviction counters.
+    void resetStatistics ();
+
+    /// \brief Display the cache on the specified output stream.
+    virtual std::ostream& print (std::ostream&) const;
+
+  protected:
+    /// \brief Hash function used in the cache.
+    /// \param key key to hash.
+    /// \return hashed key.
+    hash_t hash_function (const_key_ref key) const;
+
+  private:
+    friend struct detail::CacheHash;
+
+    /// \brief Shard of the cache, with its own mutex.
+    struct Shard
+    {
+      Shard (size_t size, bool verifyKeys);
+      Shard (const Shard& shard);
+      Shard& operator= (const Shard& shard);
+
+      /// \brief Cached elements.
+      shard_t cache;
+
+      /// \brief Mutex protecting the cache.
+      mutable boost::mutex mutex;
+    };
+
+    /// \brief Get the shard for a given hash.
+    const Shard& shard (hash_t hash) const;
+
+    /// \brief Get the shard for a given hash.
+    Shard& shard (hash_t hash);
+
+  private:
+    /// \brief Shards of the cache.
+    std::vector<Shard> shards_;
+
+    /// \brief Hasher for the cache.
+    hasher_t hasher_;
+  };
+
+  template <typename K, typename V, typename H>
+  std::ostream&
+  operator<< (std::ostream& o, const ShardedLRUCache<K,V,H>& cache);
+
+} // end of namespace roboptim
+
+# include <roboptim/core/sharded-cache.hxx>
+
+#endif //! ROBOPTIM_CORE_SHARDED_CACHE_HH
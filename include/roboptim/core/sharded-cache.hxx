@@ -0,0 +1,282 @@
+// Copyright (C) 2026 by the RobOptim contributors.
+//
+// This file is part of the roboptim.
+//
+// roboptim is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// roboptim is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with roboptim.  If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef ROBOPTIM_CORE_SHARDED_CACHE_HXX
+# define ROBOPTIM_CORE_SHARDED_CACHE_HXX
+
+# include <algorithm>
+
+namespace roboptim
+{
+  template <typename K, typename V, typename H>
+  ShardedLRUCache<K,V,H>::Shard::Shard (size_t size, bool verifyKeys)
+    : cache (size, verifyKeys),
+      mutex ()
+  {
+  }
+
+  template <typename K, typename V, typename H>
+  ShardedLRUCache<K,V,H>::Shard::Shard (const Shard& shard)
+    : cache (0),
+      mutex ()
+  {
+    boost::mutex::scoped_lock lock (shard.mutex);
+    cache = shard.cache;
+  }
+
+  template <typename K, typename V, typename H>
+  typename ShardedLRUCache<K,V,H>::Shard&
+  ShardedLRUCache<K,V,H>::Shard::operator= (const Shard& shard)
+  {
+    if (this != &shard)
+      {
+	// Copy first to avoid holding both locks at the same time
+	shard_t tmp (0);
+	{
+	  boost::mutex::scoped_lock lock (shard.mutex);
+	  tmp = shard.cache;
+	}
+
+	boost::mutex::scoped_lock lock (mutex);
+	cache = tmp;
+      }
+    return *this;
+  }
+
+  template <typename K, typename V, typename H>
+  ShardedLRUCache<K,V,H>::ShardedLRUCache (size_t size, bool verifyKeys,
+                                           size_t shards)
+    : shards_ (),
+      hasher_ ()
+  {
+    // Every shard should hold at least one element
+    shards = std::max<size_t> (1, std::min (shards, size));
+
+    // Spread the remainder over the first shards, so that the total size
+    // of the shards is the requested size
+    size_t shardSize = size / shards;
+    size_t remainder = size % shards;
+
+    shards_.reserve (shards);
+    shards_.resize (remainder, Shard (shardSize + 1, verifyKeys));
+    shards_.resize (shards, Shard (shardSize, verifyKeys));
+  }
+
+  template <typename K, typename V, typename H>
+  ShardedLRUCache<K,V,H>::~ShardedLRUCache ()
+  {}
+
+  template <typename K, typename V, typename H>
+  size_t ShardedLRUCache<K,V,H>::size () const
+  {
+    size_t size = 0;
+    for (size_t i = 0; i < shards_.size (); ++i)
+      size += shards_[i].cache.size ();
+    return size;
+  }
+
+  template <typename K, typename V, typename H>
+  size_t ShardedLRUCache<K,V,H>::shards () const
+  {
+    return shards_.size ();
+  }
+
+  template <typename K, typename V, typename H>
+  bool ShardedLRUCache<K,V,H>::verifyKeys () const
+  {
+    return shards_[0].cache.verifyKeys ();
+  }
+
+  template <typename K, typename V, typename H>
+  template <typename R>
+  bool ShardedLRUCache<K,V,H>::get (const_key_ref key, R& value) const
+  {
+    hash_t hash = hash_function (key);
+    const Shard& s = shard (hash);
+
+    boost::mutex::scoped_lock lock (s.mutex);
+    typename shard_t::const_iterator it = s.cache.find (key, hash);
+    if (it == s.cache.cend ())
+      return false;
+
+    value = *(it->second);
+    return true;
+  }
+
+  template <typename K, typename V, typename H>
+  template <typename R>
+  void ShardedLRUCache<K,V,H>::insert (const_key_ref key, const R& value)
+  {
+    hash_t hash = hash_function (key);
+    Shard& s = shard (hash);
+
+    boost::mutex::scoped_lock lock (s.mutex);
+    s.cache.access (key, hash) = value;
+  }
+
+  template <typename K, typename V, typename H>
+  template <typename F>
+  bool ShardedLRUCache<K,V,H>::read (const_key_ref key, hash_t hash,
+                                     const F& reader) const
+  {
+    const Shard& s = shard (hash);
+
+    boost::mutex::scoped_lock lock (s.mutex);
+    typename shard_t::const_iterator it = s.cache.find (key, hash);
+    return it != s.cache.cend () && reader (*(it->second));
+  }
+
+  template <typename K, typename V, typename H>
+  template <typename F>
+  void ShardedLRUCache<K,V,H>::write (const_key_ref key, hash_t hash,
+                                      const F& writer)
+  {
+    Shard& s = shard (hash);
+
+    boost::mutex::scoped_lock lock (s.mutex);
+    bool inserted;
+    V& value = s.cache.access (key, hash, inserted);
+    writer (value, inserted);
+  }
+
+  template <typename K, typename V, typename H>
+  void ShardedLRUCache<K,V,H>::clear ()
+  {
+    for (size_t i = 0; i < shards_.size (); ++i)
+      {
+	boost::mutex::scoped_lock lock (shards_[i].mutex);
+	shards_[i].cache.clear ();
+      }
+  }
+
+  template <typename K, typename V, typename H>
+  size_t ShardedLRUCache<K,V,H>::hits () const
+  {
+    size_t n = 0;
+    for (size_t i = 0; i < shards_.size (); ++i)
+      {
+	boost::mutex::scoped_lock lock (shards_[i].mutex);
+	n += shards_[i].cache.hits ();
+      }
+    return n;
+  }
+
+  template <typename K, typename V, typename H>
+  size_t ShardedLRUCache<K,V,H>::misses () const
+  {
+    size_t n = 0;
+    for (size_t i = 0; i < shards_.size (); ++i)
+      {
+	boost::mutex::scoped_lock lock (shards_[i].mutex);
+	n += shards_[i].cache.misses ();
+      }
+    return n;
+  }
+
+  template <typename K, typename V, typename H>
+  size_t ShardedLRUCache<K,V,H>::insertions () const
+  {
+    size_t n = 0;
+    for (size_t i = 0; i < shards_.size (); ++i)
+      {
+	boost::mutex::scoped_lock lock (shards_[i].mutex);
+	n += shards_[i].cache.insertions ();
+      }
+    return n;
+  }
+
+  template <typename K, typename V, typename H>
+  size_t ShardedLRUCache<K,V,H>::evictions () const
+  {
+    size_t n = 0;
+    for (size_t i = 0; i < shards_.size (); ++i)
+      {
+	boost::mutex::scoped_lock lock (shards_[i].mutex);
+	n += shards_[i].cache.evictions ();
+      }
+    return n;
+  }
+
+  template <typename K, typename V, typename H>
+  CacheStatistics ShardedLRUCache<K,V,H>::statistics () const
+  {
+    CacheStatistics stats;
+    for (size_t i = 0; i < shards_.size (); ++i)
+      {
+	boost::mutex::scoped_lock lock (shards_[i].mutex);
+	stats += shards_[i].cache.statistics ();
+      }
+    return stats;
+  }
+
+  template <typename K, typename V, typename H>
+  void ShardedLRUCache<K,V,H>::resetStatistics ()
+  {
+    for (size_t i = 0; i < shards_.size (); ++i)
+      {
+	boost::mutex::scoped_lock lock (shards_[i].mutex);
+	shards_[i].cache.resetStatistics ();
+      }
+  }
+
+  template <typename K, typename V, typename H>
+  const typename ShardedLRUCache<K,V,H>::Shard&
+  ShardedLRUCache<K,V,H>::shard (hash_t hash) const
+  {
+    return shards_[hash % shards_.size ()];
+  }
+
+  template <typename K, typename V, typename H>
+  typename ShardedLRUCache<K,V,H>::Shard&
+  ShardedLRUCache<K,V,H>::shard (hash_t hash)
+  {
+    return shards_[hash % shards_.size ()];
+  }
+
+  template <typename K, typename V, typename H>
+  typename ShardedLRUCache<K,V,H>::hash_t
+  ShardedLRUCache<K,V,H>::hash_function (const_key_ref key) const
+  {
+    return hasher_ (key);
+  }
+
+  template <typename K, typename V, typename H>
+  std::ostream& ShardedLRUCache<K,V,H>::print (std::ostream& o) const
+  {
+    o << "[";
+    for (size_t i = 0; i < shards_.size (); ++i)
+      {
+	if (i > 0)
+	  o << ", ";
+
+	boost::mutex::scoped_lock lock (shards_[i].mutex);
+	o << shards_[i].cache;
+      }
+    o << "]";
+
+    return o;
+  }
+
+  template <typename K, typename V, typename H>
+  std::ostream&
+  operator<< (std::ostream& o, const ShardedLRUCache<K,V,H>& cache)
+  {
+    return cache.print (o);
+  }
+} // end of namespace roboptim
+
+#endif //! ROBOPTIM_CORE_SHARDED_CACHE_HXX
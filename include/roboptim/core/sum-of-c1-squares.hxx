@@ -100,6 +100,8 @@ namespace roboptim {
 # ifdef ROBOPTIM_PRECOMPILED_DENSE_SPARSE
   extern template class ROBOPTIM_CORE_DLLAPI GenericSumOfC1Squares<EigenMatrixDense>;
   extern template class ROBOPTIM_CORE_DLLAPI GenericSumOfC1Squares<EigenMatrixSparse>;
+  extern template class ROBOPTIM_CORE_DLLAPI GenericSumOfC1Squares<EigenMatrixDenseFloat>;
+  extern template class ROBOPTIM_CORE_DLLAPI GenericSumOfC1Squares<EigenMatrixSparseFloat>;
 # endif //! ROBOPTIM_PRECOMPILED_DENSE_SPARSE
 
 } // namespace roboptim
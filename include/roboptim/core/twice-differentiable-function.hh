@@ -106,7 +106,7 @@ namespace roboptim
     hessian_t hessian (const_argument_ref argument,
 		       size_type functionId = 0) const
     {
-      hessian_t hessian (matrix_t(hessianSize ().first, hessianSize ().second));
+      hessian_t hessian (hessianSize ().first, hessianSize ().second);
       setZero (hessian);
       this->hessian (hessian, argument, functionId);
       return hessian;
@@ -133,6 +133,107 @@ namespace roboptim
 
       this->impl_hessian (hessian, argument, functionId);
 
+#ifndef ROBOPTIM_DO_NOT_CHECK_ALLOCATION
+      set_is_malloc_allowed (cur_malloc_allowed);
+#endif //! ROBOPTIM_DO_NOT_CHECK_ALLOCATION
+
+      assert (isValidHessian (hessian));
+    }
+
+    /// \brief Compute the product of the hessian with a vector.
+    ///
+    /// The default implementation computes the whole hessian, concrete
+    /// classes should override #impl_hessian_vector_product when the
+    /// product is cheaper than the hessian.
+    ///
+    /// \param argument point where the hessian will be computed
+    /// \param direction vector multiplied by the hessian
+    /// \param functionId evaluated function id in the split representation
+    /// \return computed product
+    vector_t hessianVectorProduct (const_argument_ref argument,
+				   const_vector_ref direction,
+				   size_type functionId = 0) const
+    {
+      vector_t result (this->inputSize ());
+      result.setZero ();
+      this->hessianVectorProduct (result, argument, direction, functionId);
+      return result;
+    }
+
+    /// \brief Compute the product of the hessian with a vector.
+    ///
+    /// Program will abort if the argument size is wrong.
+    /// \param result product will be stored here
+    /// \param argument point where the hessian will be computed
+    /// \param direction vector multiplied by the hessian
+    /// \param functionId evaluated function id in the split representation
+    void hessianVectorProduct (vector_ref result,
+			       const_argument_ref argument,
+			       const_vector_ref direction,
+			       size_type functionId = 0) const
+    {
+      LOG4CXX_TRACE (this->logger,
+		     "Evaluating hessian-vector product at point: "
+		     << argument);
+      assert (argument.size () == this->inputSize ());
+      assert (direction.size () == this->inputSize ());
+      assert (result.size () == this->inputSize ());
+
+#ifndef ROBOPTIM_DO_NOT_CHECK_ALLOCATION
+      bool cur_malloc_allowed = is_malloc_allowed ();
+      set_is_malloc_allowed (false);
+#endif //! ROBOPTIM_DO_NOT_CHECK_ALLOCATION
+
+      this->impl_hessian_vector_product (result, argument, direction,
+					 functionId);
+
+#ifndef ROBOPTIM_DO_NOT_CHECK_ALLOCATION
+      set_is_malloc_allowed (cur_malloc_allowed);
+#endif //! ROBOPTIM_DO_NOT_CHECK_ALLOCATION
+    }
+
+    /// \brief Compute the weighted sum of the hessians of all outputs.
+    ///
+    /// \f[ \sum_{i=0}^{m-1} \lambda_i \nabla^2 f_i(x) \f]
+    ///
+    /// This is the contribution of the function to the hessian of a
+    /// Lagrangian, \f$\lambda\f$ being the multipliers.
+    ///
+    /// \param argument point where the hessians will be computed
+    /// \param weights weight of each output (size: output size)
+    /// \return weighted sum of the hessians
+    hessian_t lagrangianHessian (const_argument_ref argument,
+				 const_vector_ref weights) const
+    {
+      hessian_t hessian (hessianSize ().first, hessianSize ().second);
+      setZero (hessian);
+      this->lagrangianHessian (hessian, argument, weights);
+      return hessian;
+    }
+
+    /// \brief Compute the weighted sum of the hessians of all outputs.
+    ///
+    /// Program will abort if the argument size is wrong.
+    /// \param hessian weighted sum will be stored here
+    /// \param argument point where the hessians will be computed
+    /// \param weights weight of each output (size: output size)
+    void lagrangianHessian (hessian_ref hessian,
+			    const_argument_ref argument,
+			    const_vector_ref weights) const
+    {
+      LOG4CXX_TRACE (this->logger,
+		     "Evaluating lagrangian hessian at point: " << argument);
+      assert (argument.size () == this->inputSize ());
+      assert (weights.size () == this->outputSize ());
+      assert (isValidHessian (hessian));
+
+#ifndef ROBOPTIM_DO_NOT_CHECK_ALLOCATION
+      bool cur_malloc_allowed = is_malloc_allowed ();
+      set_is_malloc_allowed (false);
+#endif //! ROBOPTIM_DO_NOT_CHECK_ALLOCATION
+
+      this->impl_lagrangian_hessian (hessian, argument, weights);
+
 #ifndef ROBOPTIM_DO_NOT_CHECK_ALLOCATION
       set_is_malloc_allowed (cur_malloc_allowed);
 #endif //! ROBOPTIM_DO_NOT_CHECK_ALLOCATION
@@ -170,6 +271,35 @@ namespace roboptim
     virtual void impl_hessian (hessian_ref hessian,
 			       const_argument_ref argument,
 			       size_type functionId = 0) const = 0;
+
+    /// \brief Hessian-vector product evaluation.
+    ///
+    /// The default implementation multiplies the hessian computed by
+    /// #impl_hessian with the direction.
+    /// \warning Do not call this function directly, call
+    /// #hessianVectorProduct instead.
+    /// \param result product will be stored here
+    /// \param argument point where the hessian will be computed
+    /// \param direction vector multiplied by the hessian
+    /// \param functionId evaluated function id in the split representation
+    virtual void impl_hessian_vector_product (vector_ref result,
+					      const_argument_ref argument,
+					      const_vector_ref direction,
+					      size_type functionId = 0) const;
+
+    /// \brief Weighted sum of the hessians evaluation.
+    ///
+    /// The default implementation accumulates the hessians of the
+    /// outputs with a non-zero weight. The result has to be overwritten.
+    /// \warning Do not call this function directly, call
+    /// #lagrangianHessian instead.
+    /// \param hessian weighted sum will be stored here
+    /// \param argument point where the hessians will be computed
+    /// \param weights weight of each output
+    virtual void impl_lagrangian_hessian (hessian_ref hessian,
+					  const_argument_ref argument,
+					  const_vector_ref weights) const;
+
     /// \brief Set a symmetric matrix to zero
     ///
     /// \note there might be an eigen function to do that.
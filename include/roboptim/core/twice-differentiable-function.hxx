@@ -34,6 +34,61 @@ namespace roboptim
   {
   }
 
+  template <typename T>
+  void
+  GenericTwiceDifferentiableFunction<T>::impl_hessian_vector_product
+  (vector_ref result, const_argument_ref argument,
+   const_vector_ref direction, size_type functionId) const
+  {
+#ifndef ROBOPTIM_DO_NOT_CHECK_ALLOCATION
+    bool cur_malloc_allowed = is_malloc_allowed ();
+    set_is_malloc_allowed (true);
+#endif //! ROBOPTIM_DO_NOT_CHECK_ALLOCATION
+
+    hessian_t buffer (hessianSize ().first, hessianSize ().second);
+
+#ifndef ROBOPTIM_DO_NOT_CHECK_ALLOCATION
+    set_is_malloc_allowed (cur_malloc_allowed);
+#endif //! ROBOPTIM_DO_NOT_CHECK_ALLOCATION
+
+    setZero (buffer);
+    this->hessian (buffer, argument, functionId);
+    result.noalias () = buffer * direction;
+  }
+
+  template <typename T>
+  void
+  GenericTwiceDifferentiableFunction<T>::impl_lagrangian_hessian
+  (hessian_ref hessian, const_argument_ref argument,
+   const_vector_ref weights) const
+  {
+#ifndef ROBOPTIM_DO_NOT_CHECK_ALLOCATION
+    bool cur_malloc_allowed = is_malloc_allowed ();
+    set_is_malloc_allowed (true);
+#endif //! ROBOPTIM_DO_NOT_CHECK_ALLOCATION
+
+    hessian_t buffer (hessianSize ().first, hessianSize ().second);
+
+    setZero (hessian);
+
+    // Allocations remain checked while the hessians are computed, but
+    // sparse sums are evaluated in a temporary matrix.
+    for (size_type i = 0; i < this->outputSize (); ++i)
+      {
+	// Inactive constraints do not contribute.
+	if (weights[i] == 0.)
+	  continue;
+
+	setZero (buffer);
+	this->hessian (buffer, argument, i);
+	hessian += weights[i] * buffer;
+      }
+
+#ifndef ROBOPTIM_DO_NOT_CHECK_ALLOCATION
+    set_is_malloc_allowed (cur_malloc_allowed);
+#endif //! ROBOPTIM_DO_NOT_CHECK_ALLOCATION
+  }
+
   template <typename T>
   std::ostream&
   GenericTwiceDifferentiableFunction<T>::print (std::ostream& o) const
@@ -58,6 +113,8 @@ namespace roboptim
   ROBOPTIM_ALLOW_ATTRIBUTES_ON
   extern template class ROBOPTIM_CORE_DLLAPI GenericTwiceDifferentiableFunction<EigenMatrixDense>;
   extern template class ROBOPTIM_CORE_DLLAPI GenericTwiceDifferentiableFunction<EigenMatrixSparse>;
+  extern template class ROBOPTIM_CORE_DLLAPI GenericTwiceDifferentiableFunction<EigenMatrixDenseFloat>;
+  extern template class ROBOPTIM_CORE_DLLAPI GenericTwiceDifferentiableFunction<EigenMatrixSparseFloat>;
   ROBOPTIM_ALLOW_ATTRIBUTES_OFF
 # endif
 
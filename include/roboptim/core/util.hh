@@ -144,6 +144,28 @@ namespace roboptim
   GenericFunctionTraits<EigenMatrixDense>::const_matrix_ref toDense
   (GenericFunctionTraits<EigenMatrixDense>::const_matrix_ref m);
 
+  /// \brief Convert a single-precision input gradient to a dense gradient
+  /// (e.g. for printing).
+  /// \param g input gradient.
+  ROBOPTIM_CORE_DLLAPI
+  GenericFunctionTraits<EigenMatrixDenseFloat>::gradient_t toDense
+  (GenericFunctionTraits<EigenMatrixSparseFloat>::const_gradient_ref g);
+
+  /// \brief Convert a single-precision input matrix to a dense matrix
+  /// (e.g. for printing).
+  /// \param m input matrix.
+  ROBOPTIM_CORE_DLLAPI
+  GenericFunctionTraits<EigenMatrixDenseFloat>::matrix_t toDense
+  (GenericFunctionTraits<EigenMatrixSparseFloat>::const_matrix_ref m);
+
+  /// \brief Convert a single-precision input matrix to a dense matrix
+  /// (e.g. for printing).
+  /// \param m input matrix.
+  /// Note: since the input is a dense matrix, we just return it.
+  ROBOPTIM_CORE_DLLAPI
+  GenericFunctionTraits<EigenMatrixDenseFloat>::const_matrix_ref toDense
+  (GenericFunctionTraits<EigenMatrixDenseFloat>::const_matrix_ref m);
+
   /// \brief Compare sparse vectors (matrices) using both relative and absolute
   /// tolerances.
   /// \see http://stackoverflow.com/a/15052131/1043187
@@ -194,6 +216,25 @@ namespace roboptim
   (M& m, const B& b,
    Function::size_type startRow, Function::size_type startCol);
 
+  /// \brief Copy the entries of a sparse matrix into another sparse
+  /// matrix, moving and filtering its rows and columns.
+  ///
+  /// Entry (i, j) of b is copied to (rows[i], cols[j]) in m if both
+  /// indices are nonnegative, and is dropped otherwise. The content of m
+  /// is replaced, but its size is kept. This function involves filling a
+  /// vector of triplets, so this should be avoided in critical sections.
+  /// \param m sparse matrix to fill.
+  /// \param b sparse matrix to copy to m.
+  /// \param rows new index of each row of b (negative to drop the row).
+  /// \param cols new index of each column of b (negative to drop the
+  /// column).
+  /// \tparam M sparse matrix type.
+  template <typename M>
+  void remapSparseMatrix
+  (M& m, const M& b,
+   const std::vector<typename M::Index>& rows,
+   const std::vector<typename M::Index>& cols);
+
   /// \brief Apply normalize to a scalar.
   inline double normalize (double x, double eps = 1e-8);
 
@@ -212,6 +212,36 @@ namespace roboptim
       }
   }
 
+  template <typename M>
+  void remapSparseMatrix
+  (M& m, const M& b,
+   const std::vector<typename M::Index>& rows,
+   const std::vector<typename M::Index>& cols)
+  {
+    typedef typename M::Index index_t;
+    typedef Eigen::Triplet<typename M::Scalar, index_t> triplet_t;
+
+    ROBOPTIM_ASSERT (static_cast<index_t> (rows.size ()) == b.rows ());
+    ROBOPTIM_ASSERT (static_cast<index_t> (cols.size ()) == b.cols ());
+
+    std::vector<triplet_t> triplets;
+    triplets.reserve (static_cast<std::size_t> (b.nonZeros ()));
+
+    for (index_t k = 0; k < b.outerSize (); ++k)
+      for (typename M::InnerIterator it (b, k); it; ++it)
+	{
+	  index_t row = rows[static_cast<std::size_t> (it.row ())];
+	  index_t col = cols[static_cast<std::size_t> (it.col ())];
+	  if (row < 0 || col < 0)
+	    continue;
+
+	  ROBOPTIM_ASSERT (row < m.rows () && col < m.cols ());
+	  triplets.push_back (triplet_t (row, col, it.value ()));
+	}
+
+    m.setFromTriplets (triplets.begin (), triplets.end ());
+  }
+
   inline double normalize (double x, double eps)
   {
       return (std::fabs (x) < eps)? 0:x;
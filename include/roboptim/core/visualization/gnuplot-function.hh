@@ -20,6 +20,8 @@
 # include <roboptim/core/sys.hh>
 # include <roboptim/core/debug.hh>
 
+# include <vector>
+
 # include <boost/format.hpp>
 
 # include <roboptim/core/function.hh>
@@ -84,26 +86,33 @@ namespace roboptim
                   % i).str ();
 	str += "\n";
 
-        // Argument (only 1D supported for now)
-	Function::vector_t x (f.inputSize ());
+        // Arguments (only 1D supported for now)
+        std::vector<value_type> ts;
+        for (value_type t = boost::get<0> (window); t < boost::get<1> (window);
+             t += boost::get<2> (window))
+          ts.push_back (t);
+
+        typename GenericFunction<T>::batch_t
+          x (f.inputSize (), static_cast<Function::size_type> (ts.size ()));
         x.setZero ();
+        for (size_t k = 0; k < ts.size (); ++k)
+          x (0, static_cast<Function::size_type> (k)) = ts[k];
+
+        // Evaluate the function at all the points at once
+        typename GenericFunction<T>::batch_t res (f.outputSize (), x.cols ());
+        f.evaluateBatch (res, x);
 
         // Vector used to store the result for each output
         std::vector<std::string> results ((size_t) f.outputSize ());
 
-        for (value_type t = boost::get<0> (window); t < boost::get<1> (window);
-             t += boost::get<2> (window))
+        for (Function::size_type k = 0; k < res.cols (); ++k)
           {
-            // Evaluate the function
-            x[0] = t;
-            Function::vector_t res = f (x);
-
             // Store the result in the vector of strings (for each output)
             for (Function::size_type i = 0; i < f.outputSize (); ++i)
               {
                 results [(size_t)i] += (boost::format ("%2.8f %2.8f\n")
-                                        % normalize (t)
-                                        % normalize (res [i])).str ();
+                                        % normalize (x (0, k))
+                                        % normalize (res (i, k))).str ();
               }
           }
 
@@ -132,16 +141,25 @@ namespace roboptim
 	std::string str = (boost::format ("plot '-' title '%1%' with line\n")
 			   % f.getName ()).str ();
 
-	Function::vector_t x (f.inputSize ());
-
+	std::vector<value_type> ts;
 	for (value_type t = boost::get<0> (window); t < boost::get<1> (window);
 	     t += boost::get<2> (window))
+	  ts.push_back (t);
+
+	typename GenericFunction<T>::batch_t
+	  x (f.inputSize (), static_cast<Function::size_type> (ts.size ()));
+	for (size_t k = 0; k < ts.size (); ++k)
+	  x (0, static_cast<Function::size_type> (k)) = ts[k];
+
+	// Evaluate the function at all the points at once
+	typename GenericFunction<T>::batch_t res (f.outputSize (), x.cols ());
+	f.evaluateBatch (res, x);
+
+	for (Function::size_type k = 0; k < res.cols (); ++k)
 	  {
-	    x[0] = t;
-	    Function::vector_t res = f (x);
             str += (boost::format ("%2.8f %2.8f\n")
-		    % normalize (res[0])
-		    % normalize (res [1])).str ();
+		    % normalize (res (0, k))
+		    % normalize (res (1, k))).str ();
 	  }
 	str += "e\n";
 
@@ -20,6 +20,8 @@
 # include <roboptim/core/sys.hh>
 # include <roboptim/core/debug.hh>
 
+# include <vector>
+
 # include <boost/format.hpp>
 
 # include <roboptim/core/function.hh>
@@ -64,25 +66,34 @@ namespace roboptim
         // Compute points
         std::string data_name = "data";
 
-        // Argument (only 1D supported for now)
-        typename GenericFunction<T>::vector_t x (f.inputSize ());
+        // Arguments (only 1D supported for now)
+        typedef typename GenericFunction<T>::size_type size_type;
+        std::vector<value_type> ts;
+        for (value_type t = boost::get<0> (window); t < boost::get<1> (window);
+             t += boost::get<2> (window))
+          ts.push_back (t);
+
+        typename GenericFunction<T>::batch_t
+          x (f.inputSize (), static_cast<size_type> (ts.size ()));
         x.setZero ();
+        for (size_t k = 0; k < ts.size (); ++k)
+          x (0, static_cast<size_type> (k)) = ts[k];
+
+        // Evaluate the function at all the points at once
+        typename GenericFunction<T>::batch_t res (f.outputSize (), x.cols ());
+        f.evaluateBatch (res, x);
 
         ss << data_name << " = np.array ([";
 
-        for (value_type t = boost::get<0> (window); t < boost::get<1> (window);
-             t += boost::get<2> (window))
+        for (size_t k = 0; k < ts.size (); ++k)
 	  {
-	    // Evaluate the function
-	    x[0] = t;
-	    typename GenericFunction<T>::vector_t res = f (x);
-
-	    ss << (boost::format ("(%2.8f") % normalize (t)).str ();
+	    ss << (boost::format ("(%2.8f") % normalize (ts[k])).str ();
 
 	    // Store the result in the vector of strings (for each output)
-	    for (typename GenericFunction<T>::size_type i = 0; i < f.outputSize (); ++i)
+	    for (size_type i = 0; i < f.outputSize (); ++i)
 	      {
-		ss << (boost::format (", %2.8f") % normalize (res [i])).str ();
+		ss << (boost::format (", %2.8f")
+		       % normalize (res (i, static_cast<size_type> (k)))).str ();
 	      }
 	    ss << "), ";
 	  }
@@ -17,13 +17,111 @@
 
 #include "roboptim/core/alloc.hh"
 
+#include <cstddef>
+
+#include <boost/thread/locks.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/tss.hpp>
+
 namespace roboptim
 {
+  namespace
+  {
+    /// \brief Allocation flag of a thread.
+    struct ThreadFlag
+    {
+      bool allowed;
+    };
+
+    /// \brief Protects the counters and Eigen's flag.
+    boost::mutex flagMutex;
+
+    /// \brief Number of threads forbidding allocations.
+    std::size_t forbidding = 0;
+
+    /// \brief Number of threads that updated their flag and allow
+    /// allocations.
+    std::size_t allowing = 0;
+
+    /// \brief Last setter of Eigen's flag.
+    detail::eigenMallocSetter_t eigenSetter = 0;
+
+    /// \brief Eigen's flag given the counters.
+    bool eigenFlag ()
+    {
+      return forbidding == 0 || allowing > 0;
+    }
+
+    /// \brief Stop counting the flag of a thread.
+    void releaseFlag (ThreadFlag* flag)
+    {
+      {
+	boost::lock_guard<boost::mutex> lock (flagMutex);
+	if (flag->allowed)
+	  --allowing;
+	else
+	  --forbidding;
+	if (eigenSetter)
+	  eigenSetter (eigenFlag ());
+      }
+      delete flag;
+    }
+
+    boost::thread_specific_ptr<ThreadFlag> threadFlag (&releaseFlag);
+  } // end of anonymous namespace.
+
   bool is_malloc_allowed_update (bool update, bool new_value)
   {
-    static bool value = true;
     if (update)
-      value = new_value;
-    return value;
+      detail::set_thread_malloc_allowed (new_value, 0);
+
+    ThreadFlag* flag = threadFlag.get ();
+    return flag ? flag->allowed : true;
   }
+
+  namespace detail
+  {
+    bool set_thread_malloc_allowed (bool allow, eigenMallocSetter_t setter)
+    {
+      boost::lock_guard<boost::mutex> lock (flagMutex);
+
+      ThreadFlag* flag = threadFlag.get ();
+      if (!flag)
+	{
+	  flag = new ThreadFlag;
+	  flag->allowed = true;
+	  ++allowing;
+	  threadFlag.reset (flag);
+	}
+
+      if (flag->allowed != allow)
+	{
+	  if (allow)
+	    {
+	      --forbidding;
+	      ++allowing;
+	    }
+	  else
+	    {
+	      --allowing;
+	      ++forbidding;
+	    }
+	  flag->allowed = allow;
+	}
+
+      if (setter)
+	{
+	  eigenSetter = setter;
+	  return setter (eigenFlag ());
+	}
+      return eigenFlag ();
+    }
+
+    void reset_thread_malloc_allowed ()
+    {
+      ThreadFlag* flag = threadFlag.release ();
+      if (flag)
+	releaseFlag (flag);
+    }
+  } // end of namespace detail
 } // end of namespace roboptim.
@@ -42,30 +42,52 @@ namespace roboptim
 
   template class GenericFunction<EigenMatrixDense>;
   template class GenericFunction<EigenMatrixSparse>;
+  template class GenericFunction<EigenMatrixDenseFloat>;
+  template class GenericFunction<EigenMatrixSparseFloat>;
 
   template class GenericDifferentiableFunction<EigenMatrixDense>;
   template class GenericDifferentiableFunction<EigenMatrixSparse>;
+  template class GenericDifferentiableFunction<EigenMatrixDenseFloat>;
+  template class GenericDifferentiableFunction<EigenMatrixSparseFloat>;
 
   template class GenericTwiceDifferentiableFunction<EigenMatrixDense>;
   template class GenericTwiceDifferentiableFunction<EigenMatrixSparse>;
+  template class GenericTwiceDifferentiableFunction<EigenMatrixDenseFloat>;
+  template class GenericTwiceDifferentiableFunction<EigenMatrixSparseFloat>;
 
   template class GenericLinearFunction<EigenMatrixDense>;
   template class GenericLinearFunction<EigenMatrixSparse>;
+  template class GenericLinearFunction<EigenMatrixDenseFloat>;
+  template class GenericLinearFunction<EigenMatrixSparseFloat>;
 
   template class GenericQuadraticFunction<EigenMatrixDense>;
   template class GenericQuadraticFunction<EigenMatrixSparse>;
+  template class GenericQuadraticFunction<EigenMatrixDenseFloat>;
+  template class GenericQuadraticFunction<EigenMatrixSparseFloat>;
 
   template class GenericNumericQuadraticFunction<EigenMatrixDense>;
   template class GenericNumericQuadraticFunction<EigenMatrixSparse>;
+  template class GenericNumericQuadraticFunction<EigenMatrixDenseFloat>;
+  template class GenericNumericQuadraticFunction<EigenMatrixSparseFloat>;
 
   template class GenericNumericLinearFunction<EigenMatrixDense>;
   template class GenericNumericLinearFunction<EigenMatrixSparse>;
+  template class GenericNumericLinearFunction<EigenMatrixDenseFloat>;
+  template class GenericNumericLinearFunction<EigenMatrixSparseFloat>;
 
   template class GenericSumOfC1Squares<EigenMatrixDense>;
   template class GenericSumOfC1Squares<EigenMatrixSparse>;
+  template class GenericSumOfC1Squares<EigenMatrixDenseFloat>;
+  template class GenericSumOfC1Squares<EigenMatrixSparseFloat>;
 
+  // The solvers, and the classes that work on them, stay double-only
+  // since the solver plug-ins are. The decorators and the operators are
+  // templates on their operands, and are instantiated where they are used,
+  // whatever the precision.
   template class Problem<EigenMatrixDense>;
   template class Problem<EigenMatrixSparse>;
+  template class Problem<EigenMatrixDenseFloat>;
+  template class Problem<EigenMatrixSparseFloat>;
 
   template class Solver<EigenMatrixDense>;
   template class Solver<EigenMatrixSparse>;
@@ -90,18 +112,28 @@ namespace roboptim
 
   template class GenericConstantFunction<EigenMatrixDense>;
   template class GenericConstantFunction<EigenMatrixSparse>;
+  template class GenericConstantFunction<EigenMatrixDenseFloat>;
+  template class GenericConstantFunction<EigenMatrixSparseFloat>;
 
   template class Cos<EigenMatrixDense>;
   template class Cos<EigenMatrixSparse>;
+  template class Cos<EigenMatrixDenseFloat>;
+  template class Cos<EigenMatrixSparseFloat>;
 
   template class GenericIdentityFunction<EigenMatrixDense>;
   template class GenericIdentityFunction<EigenMatrixSparse>;
+  template class GenericIdentityFunction<EigenMatrixDenseFloat>;
+  template class GenericIdentityFunction<EigenMatrixSparseFloat>;
 
   template class Polynomial<EigenMatrixDense>;
   template class Polynomial<EigenMatrixSparse>;
+  template class Polynomial<EigenMatrixDenseFloat>;
+  template class Polynomial<EigenMatrixSparseFloat>;
 
   template class Sin<EigenMatrixDense>;
   template class Sin<EigenMatrixSparse>;
+  template class Sin<EigenMatrixDenseFloat>;
+  template class Sin<EigenMatrixSparseFloat>;
 
   namespace callback
   {
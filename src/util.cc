@@ -211,6 +211,24 @@ namespace roboptim
     return GenericFunctionTraits<EigenMatrixDense>::matrix_t (m);
   }
 
+  GenericFunctionTraits<EigenMatrixDenseFloat>::gradient_t
+  toDense (GenericFunctionTraits<EigenMatrixSparseFloat>::const_gradient_ref m)
+  {
+    return GenericFunctionTraits<EigenMatrixDenseFloat>::gradient_t (m);
+  }
+
+  GenericFunctionTraits<EigenMatrixDenseFloat>::const_matrix_ref
+  toDense (GenericFunctionTraits<EigenMatrixDenseFloat>::const_matrix_ref m)
+  {
+    return m;
+  }
+
+  GenericFunctionTraits<EigenMatrixDenseFloat>::matrix_t
+  toDense (GenericFunctionTraits<EigenMatrixSparseFloat>::const_matrix_ref m)
+  {
+    return GenericFunctionTraits<EigenMatrixDenseFloat>::matrix_t (m);
+  }
+
   std::vector<std::string> split (const std::string& s, char d)
   {
     std::vector<std::string> tokens;
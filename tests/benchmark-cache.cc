@@ -0,0 +1,132 @@
+// Copyright (C) 2026 by the RobOptim contributors.
+//
+// This file is part of the roboptim.
+//
+// roboptim is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// roboptim is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with roboptim.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "benchmark.hh"
+
+#include <vector>
+
+#include <roboptim/core/function.hh>
+#include <roboptim/core/cache.hh>
+#include <roboptim/core/decorator/cached-function.hh>
+
+using namespace roboptim;
+using namespace roboptim::benchmark;
+
+typedef Function::argument_t argument_t;
+typedef Function::vector_t vector_t;
+typedef LRUCache<argument_t, vector_t, Hasher> cache_t;
+
+// Hit/miss latency of LRUCache with respect to the cache size.
+void benchmarkCacheSize ()
+{
+  const Function::size_type n = 10;
+  const size_t nIter = 100000;
+  const size_t sizes[] = {1, 10, 100, 500, 1000, 5000};
+
+  printHeader ("LRUCache latency (ns/operation), argument size = 10",
+               "size", "         hit        miss");
+
+  for (size_t s = 0; s < sizeof (sizes) / sizeof (sizes[0]); ++s)
+    {
+      const size_t size = sizes[s];
+      cache_t cache (size);
+
+      // Keys used for hits (all present in the cache) and misses
+      // (never present, each insertion evicts the LRU element).
+      std::vector<argument_t> hits (size, argument_t (n));
+      std::vector<argument_t> misses (size, argument_t (n));
+      for (size_t i = 0; i < size; ++i)
+        {
+          hits[i].setRandom ();
+          misses[i].setRandom ();
+          cache.insert (hits[i], vector_t::Zero (n));
+        }
+
+      // Hits: access all keys in a round-robin fashion, which is the
+      // worst case for the old linear tracker search.
+      Timer timer;
+      for (size_t i = 0; i < nIter; ++i)
+        doNotOptimize (cache[hits[i % size]]);
+      double hit = timer.elapsed () / static_cast<double> (nIter);
+
+      // Misses: alternate between two disjoint sets of keys so that
+      // every access triggers an eviction.
+      timer.restart ();
+      for (size_t i = 0; i < nIter; ++i)
+        {
+          const argument_t& key = ((i / size) % 2 == 0)?
+            misses[i % size] : hits[i % size];
+          doNotOptimize (cache[key]);
+        }
+      double miss = timer.elapsed () / static_cast<double> (nIter);
+
+      std::cout << std::setw (10) << size
+                << std::setw (12) << hit
+                << std::setw (12) << miss << std::endl;
+    }
+}
+
+// Cost of key verification on hit with respect to the argument size.
+void benchmarkKeyVerification ()
+{
+  const size_t size = 100;
+  const size_t nIter = 20000;
+  const Function::size_type sizes[] = {10, 100, 1000, 10000};
+
+  printHeader ("LRUCache hit latency (ns/operation), cache size = 100",
+               "arg. size", "   no verif.      verif.    overhead");
+
+  for (size_t s = 0; s < sizeof (sizes) / sizeof (sizes[0]); ++s)
+    {
+      const Function::size_type n = sizes[s];
+      cache_t cache (size);
+      cache_t verifiedCache (size, true);
+
+      std::vector<argument_t> keys (size, argument_t (n));
+      for (size_t i = 0; i < size; ++i)
+        {
+          keys[i].setRandom ();
+          cache.insert (keys[i], vector_t::Zero (1));
+          verifiedCache.insert (keys[i], vector_t::Zero (1));
+        }
+
+      Timer timer;
+      for (size_t i = 0; i < nIter; ++i)
+        doNotOptimize (*(cache.find (keys[i % size])->second));
+      double unverified = timer.elapsed () / static_cast<double> (nIter);
+
+      timer.restart ();
+      for (size_t i = 0; i < nIter; ++i)
+        doNotOptimize (*(verifiedCache.find (keys[i % size])->second));
+      double verified = timer.elapsed () / static_cast<double> (nIter);
+
+      std::cout << std::setw (10) << n
+                << std::setw (12) << unverified
+                << std::setw (12) << verified
+                << std::setw (11) << 100. * (verified / unverified - 1.)
+                << "%" << std::endl;
+    }
+}
+
+int main ()
+{
+  benchmarkCacheSize ();
+  std::cout << std::endl;
+  benchmarkKeyVerification ();
+
+  return 0;
+}
@@ -0,0 +1,165 @@
+// Copyright (C) 2026 by the RobOptim contributors.
+//
+// This file is part of the roboptim.
+//
+// roboptim is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// roboptim is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with roboptim.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "benchmark.hh"
+
+#include <cmath>
+
+#include <boost/make_shared.hpp>
+
+#include <roboptim/core/differentiable-function.hh>
+#include <roboptim/core/numeric-linear-function.hh>
+#include <roboptim/core/operator/chain.hh>
+
+using namespace roboptim;
+using namespace roboptim::benchmark;
+
+// x -> sin (x) exp (x) (component-wise), with a dense jacobian
+// computation.
+struct Inner : public DifferentiableFunction
+{
+  explicit Inner (size_type n)
+    : DifferentiableFunction (n, n, "inner")
+  {}
+
+  void impl_compute (result_ref res, const_argument_ref x) const
+  {
+    for (size_type i = 0; i < inputSize (); ++i)
+      res[i] = std::sin (x[i]) * std::exp (x[i]);
+  }
+
+  void impl_gradient (gradient_ref grad, const_argument_ref x,
+                      size_type i) const
+  {
+    grad.setZero ();
+    grad[i] = (std::cos (x[i]) + std::sin (x[i])) * std::exp (x[i]);
+  }
+
+  void impl_jacobian (jacobian_ref jac, const_argument_ref x) const
+  {
+    jac.setZero ();
+    for (size_type i = 0; i < inputSize (); ++i)
+      jac (i, i) = (std::cos (x[i]) + std::sin (x[i])) * std::exp (x[i]);
+  }
+};
+
+// Previous implementation of the Chain gradient: the right jacobian is
+// computed for each gradient.
+struct LegacyChain : public DifferentiableFunction
+{
+  LegacyChain (boost::shared_ptr<DifferentiableFunction> left,
+               boost::shared_ptr<DifferentiableFunction> right)
+    : DifferentiableFunction (right->inputSize (), left->outputSize (),
+                              "legacy chain"),
+      left_ (left),
+      right_ (right),
+      rightResult_ (right->outputSize ()),
+      gradientLeft_ (left->inputSize ()),
+      jacobianRight_ (right->outputSize (), right->inputSize ())
+  {}
+
+  void impl_compute (result_ref, const_argument_ref) const
+  {}
+
+  void impl_gradient (gradient_ref gradient, const_argument_ref x,
+                      size_type functionId) const
+  {
+    (*right_) (rightResult_, x);
+    left_->gradient (gradientLeft_, rightResult_, functionId);
+    right_->jacobian (jacobianRight_, x);
+    gradient.noalias () = gradientLeft_ * jacobianRight_;
+  }
+
+  boost::shared_ptr<DifferentiableFunction> left_;
+  boost::shared_ptr<DifferentiableFunction> right_;
+  mutable result_t rightResult_;
+  mutable gradient_t gradientLeft_;
+  mutable jacobian_t jacobianRight_;
+};
+
+// Time needed to compute all the gradients of a function.
+template <typename F>
+double timeGradients (const F& f, const Function::argument_t& x,
+                      size_t nIter)
+{
+  DifferentiableFunction::gradient_t grad (f.inputSize ());
+  Timer timer;
+  for (size_t k = 0; k < nIter; ++k)
+    for (Function::size_type i = 0; i < f.outputSize (); ++i)
+      {
+        f.gradient (grad, x, i);
+        doNotOptimize (grad);
+      }
+  return timer.elapsed () * 1e-6 / static_cast<double> (nIter);
+}
+
+// Gradients of A g(x), with respect to the number of outputs.
+void benchmarkGradients (Function::size_type n, size_t nIter)
+{
+  typedef Chain<DifferentiableFunction, DifferentiableFunction> chain_t;
+
+  boost::shared_ptr<DifferentiableFunction> inner =
+    boost::make_shared<Inner> (n);
+
+  printHeader ("All chain gradients (ms/operation)", "outputs",
+               "      legacy      cached     speedup");
+
+  Function::argument_t x (n);
+  x.setRandom ();
+
+  for (Function::size_type m = 8; m <= 128; m *= 2)
+    {
+      Function::matrix_t A (m, n);
+      A.setRandom ();
+      Function::vector_t b (m);
+      b.setZero ();
+      boost::shared_ptr<DifferentiableFunction> outer =
+        boost::make_shared<NumericLinearFunction> (A, b);
+
+      LegacyChain legacy (outer, inner);
+      boost::shared_ptr<chain_t> f =
+        chain<DifferentiableFunction, DifferentiableFunction> (outer, inner);
+      f->cacheRightJacobian () = true;
+
+      // The cache is only valid at a fixed argument: it is invalidated
+      // between iterations to time a full sweep of the gradients.
+      const double reference = timeGradients (legacy, x, nIter);
+      Timer timer;
+      DifferentiableFunction::gradient_t grad (n);
+      for (size_t k = 0; k < nIter; ++k)
+        {
+          (*f) (x);
+          for (Function::size_type i = 0; i < m; ++i)
+            {
+              f->gradient (grad, x, i);
+              doNotOptimize (grad);
+            }
+        }
+      const double t = timer.elapsed () * 1e-6 / static_cast<double> (nIter);
+
+      std::cout << std::setw (10) << m
+                << std::setw (12) << reference
+                << std::setw (12) << t
+                << std::setw (12) << reference / t << std::endl;
+    }
+}
+
+int main ()
+{
+  benchmarkGradients (200, 20);
+  return 0;
+}
@@ -0,0 +1,332 @@
+// Copyright (C) 2026 by the RobOptim contributors.
+//
+// This file is part of the roboptim.
+//
+// roboptim is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// roboptim is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with roboptim.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "benchmark.hh"
+
+#include <cmath>
+#include <cstdlib>
+
+#include <boost/make_shared.hpp>
+#include <boost/thread/thread.hpp>
+
+#include <roboptim/core/differentiable-function.hh>
+#include <roboptim/core/decorator/finite-difference-gradient.hh>
+#include <roboptim/core/decorator/forward-mode-differentiation.hh>
+#include <roboptim/core/decorator/reverse-mode-differentiation.hh>
+
+using namespace roboptim;
+using namespace roboptim::benchmark;
+
+typedef finiteDifferenceGradientPolicies::Simple<EigenMatrixDense> simple_t;
+typedef finiteDifferenceGradientPolicies::Parallel<EigenMatrixDense>
+parallel_t;
+typedef finiteDifferenceGradientPolicies::ComplexStep<EigenMatrixDense>
+complexStep_t;
+
+// Costly black-box function: each output sums a few transcendental terms
+// over all the inputs.
+struct CostlyF : public Function
+{
+  CostlyF (size_type n, size_type m, size_type cost)
+    : Function (n, m, "costly function"),
+      cost_ (cost)
+  {}
+
+  void impl_compute (result_ref res, const_argument_ref x) const
+  {
+    for (size_type i = 0; i < outputSize (); ++i)
+      {
+        res[i] = 0.;
+        for (size_type k = 0; k < cost_; ++k)
+          for (size_type j = 0; j < inputSize (); ++j)
+            res[i] += std::sin (static_cast<double> (i + k + 1) * x[j]);
+      }
+  }
+
+  size_type cost_;
+};
+
+// Jacobian and gradient computation time with respect to the number of
+// threads of the Parallel policy.
+void benchmarkParallel (size_t maxThreads)
+{
+  const Function::size_type n = 200;
+  const Function::size_type m = 10;
+  const size_t nIter = 10;
+
+  boost::shared_ptr<CostlyF> f = boost::make_shared<CostlyF> (n, m, 5);
+  GenericFiniteDifferenceGradient<EigenMatrixDense, simple_t> fdSimple (f);
+  GenericFiniteDifferenceGradient<EigenMatrixDense, parallel_t> fdParallel (f);
+
+  Function::argument_t x (n);
+  x.setRandom ();
+  Function::matrix_t jac (m, n);
+  DifferentiableFunction::gradient_t grad (n);
+
+  printHeader ("Finite-difference Jacobian/gradient (ms/operation), "
+               "n = 200, m = 10",
+               "threads", "    jacobian     speedup    gradient     speedup");
+
+  Timer timer;
+  for (size_t i = 0; i < nIter; ++i)
+    fdSimple.jacobian (jac, x);
+  const double simpleJac = timer.elapsed () * 1e-6 / static_cast<double> (nIter);
+
+  timer.restart ();
+  for (size_t i = 0; i < nIter; ++i)
+    fdSimple.gradient (grad, x, 0);
+  const double simpleGrad =
+    timer.elapsed () * 1e-6 / static_cast<double> (nIter);
+
+  std::cout << std::setw (10) << "simple"
+            << std::setw (12) << simpleJac
+            << std::setw (12) << 1.
+            << std::setw (12) << simpleGrad
+            << std::setw (12) << 1. << std::endl;
+
+  for (size_t threads = 1; threads <= maxThreads; ++threads)
+    {
+      fdParallel.setThreads (threads);
+
+      timer.restart ();
+      for (size_t i = 0; i < nIter; ++i)
+        fdParallel.jacobian (jac, x);
+      const double parallelJac =
+        timer.elapsed () * 1e-6 / static_cast<double> (nIter);
+
+      timer.restart ();
+      for (size_t i = 0; i < nIter; ++i)
+        fdParallel.gradient (grad, x, 0);
+      const double parallelGrad =
+        timer.elapsed () * 1e-6 / static_cast<double> (nIter);
+
+      std::cout << std::setw (10) << threads
+                << std::setw (12) << parallelJac
+                << std::setw (12) << simpleJac / parallelJac
+                << std::setw (12) << parallelGrad
+                << std::setw (12) << simpleGrad / parallelGrad << std::endl;
+    }
+}
+
+// Same kind of function, written generically over the scalar type so
+// that it can be differentiated automatically.
+struct CostlyKernel
+{
+  template <typename R, typename A>
+  void operator () (R& res, const A& x) const
+  {
+    using std::sin;
+    for (typename A::Index i = 0; i < res.size (); ++i)
+      {
+        res[i] = 0.;
+        for (typename A::Index j = 0; j < x.size (); ++j)
+          res[i] += sin (static_cast<double> (i + 1) * x[j]);
+      }
+  }
+};
+
+template <typename F>
+double timeJacobian (const F& f, Function::const_argument_ref x,
+                     size_t nIter)
+{
+  Function::matrix_t jac (f.outputSize (), f.inputSize ());
+
+  Timer timer;
+  for (size_t i = 0; i < nIter; ++i)
+    {
+      f.jacobian (jac, x);
+      doNotOptimize (jac);
+    }
+  return timer.elapsed () * 1e-3 / static_cast<double> (nIter);
+}
+
+// Jacobian computation time of the forward-mode automatic
+// differentiation, with respect to the number of directions per sweep.
+template <int N>
+void benchmarkForwardMode (Function::const_argument_ref x,
+                           Function::size_type m, double reference,
+                           size_t nIter)
+{
+  GenericForwardModeDifferentiation<EigenMatrixDense, CostlyKernel, N>
+    f (CostlyKernel (), x.size (), m);
+  const double t = timeJacobian (f, x, nIter);
+
+  std::cout << std::setw (10) << N
+            << std::setw (12) << t
+            << std::setw (12) << reference / t << std::endl;
+}
+
+void benchmarkAutomaticDifferentiation ()
+{
+  const Function::size_type n = 32;
+  const Function::size_type m = 8;
+  const size_t nIter = 1000;
+
+  Function::argument_t x (n);
+  x.setRandom ();
+
+  boost::shared_ptr<GenericForwardModeDifferentiation
+                    <EigenMatrixDense, CostlyKernel> > f =
+    forwardModeDifferentiation<EigenMatrixDense> (CostlyKernel (), n, m);
+  GenericFiniteDifferenceGradient<EigenMatrixDense, simple_t> fdSimple (f);
+  GenericFiniteDifferenceGradient<EigenMatrixDense> fdFivePoints (f);
+
+  printHeader ("Jacobian (us/operation), n = 32, m = 8",
+               "method", "        time     speedup");
+
+  const double simple = timeJacobian (fdSimple, x, nIter);
+  std::cout << std::setw (10) << "simple"
+            << std::setw (12) << simple
+            << std::setw (12) << 1. << std::endl;
+
+  const double fivePoints = timeJacobian (fdFivePoints, x, nIter);
+  std::cout << std::setw (10) << "5-points"
+            << std::setw (12) << fivePoints
+            << std::setw (12) << simple / fivePoints << std::endl;
+
+  // Forward mode, for several numbers of directions per sweep.
+  benchmarkForwardMode<1> (x, m, simple, nIter);
+  benchmarkForwardMode<4> (x, m, simple, nIter);
+  benchmarkForwardMode<8> (x, m, simple, nIter);
+  benchmarkForwardMode<16> (x, m, simple, nIter);
+
+  // Reverse mode: one sweep per output.
+  GenericReverseModeDifferentiation<EigenMatrixDense, CostlyKernel>
+    reverse (CostlyKernel (), n, m);
+  const double t = timeJacobian (reverse, x, nIter);
+  std::cout << std::setw (10) << "reverse"
+            << std::setw (12) << t
+            << std::setw (12) << simple / t << std::endl;
+}
+
+template <typename F>
+double timeGradient (const F& f, Function::const_argument_ref x,
+                     size_t nIter)
+{
+  DifferentiableFunction::gradient_t grad (f.inputSize ());
+
+  Timer timer;
+  for (size_t i = 0; i < nIter; ++i)
+    {
+      f.gradient (grad, x, 0);
+      doNotOptimize (grad);
+    }
+  return timer.elapsed () * 1e-3 / static_cast<double> (nIter);
+}
+
+// Gradient of a scalar objective with many inputs: the cost of the
+// reverse mode does not depend on the input size.
+void benchmarkScalarObjective ()
+{
+  const Function::size_type n = 256;
+  const size_t nIter = 200;
+
+  Function::argument_t x (n);
+  x.setRandom ();
+
+  boost::shared_ptr<GenericReverseModeDifferentiation
+                    <EigenMatrixDense, CostlyKernel> > reverse =
+    reverseModeDifferentiation<EigenMatrixDense> (CostlyKernel (), n);
+  GenericForwardModeDifferentiation<EigenMatrixDense, CostlyKernel, 16>
+    forward (CostlyKernel (), n);
+  GenericFiniteDifferenceGradient<EigenMatrixDense, simple_t> fdSimple
+    (reverse);
+
+  printHeader ("Gradient (us/operation), n = 256, m = 1",
+               "method", "        time     speedup");
+
+  const double simple = timeGradient (fdSimple, x, nIter);
+  std::cout << std::setw (10) << "simple"
+            << std::setw (12) << simple
+            << std::setw (12) << 1. << std::endl;
+
+  const double tForward = timeGradient (forward, x, nIter);
+  std::cout << std::setw (10) << "forward"
+            << std::setw (12) << tForward
+            << std::setw (12) << simple / tForward << std::endl;
+
+  const double tReverse = timeGradient (*reverse, x, nIter);
+  std::cout << std::setw (10) << "reverse"
+            << std::setw (12) << tReverse
+            << std::setw (12) << simple / tReverse << std::endl;
+}
+
+// Accuracy and cost of the complex-step policy, with respect to the
+// finite difference rules.
+template <typename F>
+void benchmarkAccuracy (const char* method, const F& f,
+                        Function::const_argument_ref x,
+                        const Function::matrix_t& exact, double reference,
+                        size_t nIter)
+{
+  const double t = timeJacobian (f, x, nIter);
+  const double error = (f.jacobian (x) - exact).cwiseAbs ().maxCoeff ();
+
+  std::cout << std::setw (10) << method
+            << std::setw (12) << t
+            << std::setw (12) << reference / t
+            << std::setw (12) << error << std::endl;
+}
+
+void benchmarkComplexStep ()
+{
+  const Function::size_type n = 32;
+  const Function::size_type m = 8;
+  const size_t nIter = 1000;
+
+  Function::argument_t x (n);
+  x.setRandom ();
+
+  Function::matrix_t exact (m, n);
+  for (Function::size_type i = 0; i < m; ++i)
+    for (Function::size_type j = 0; j < n; ++j)
+      exact (i, j) = static_cast<double> (i + 1)
+        * std::cos (static_cast<double> (i + 1) * x[j]);
+
+  boost::shared_ptr<GenericComplexStepFunction
+                    <EigenMatrixDense, CostlyKernel> > f =
+    complexStepFunction<EigenMatrixDense> (CostlyKernel (), n, m);
+  GenericFiniteDifferenceGradient<EigenMatrixDense, simple_t> fdSimple (f);
+  GenericFiniteDifferenceGradient<EigenMatrixDense> fdFivePoints (f);
+  GenericFiniteDifferenceGradient<EigenMatrixDense, complexStep_t>
+    fdComplex (f);
+
+  printHeader ("Jacobian accuracy (us/operation), n = 32, m = 8",
+               "method", "        time     speedup   max error");
+
+  const double simple = timeJacobian (fdSimple, x, nIter);
+  benchmarkAccuracy ("simple", fdSimple, x, exact, simple, nIter);
+  benchmarkAccuracy ("5-points", fdFivePoints, x, exact, simple, nIter);
+  benchmarkAccuracy ("complex", fdComplex, x, exact, simple, nIter);
+}
+
+int main (int argc, char** argv)
+{
+  // The maximum number of threads can be given on the command line.
+  size_t maxThreads = boost::thread::hardware_concurrency ();
+  if (argc > 1)
+    maxThreads = static_cast<size_t> (std::atoi (argv[1]));
+  if (maxThreads == 0)
+    maxThreads = 1;
+
+  benchmarkParallel (maxThreads);
+  benchmarkAutomaticDifferentiation ();
+  benchmarkScalarObjective ();
+  benchmarkComplexStep ();
+
+  return 0;
+}
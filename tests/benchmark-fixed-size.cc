@@ -0,0 +1,132 @@
+// Copyright (C) 2026 by the RobOptim contributors.
+//
+// This file is part of the roboptim.
+//
+// roboptim is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// roboptim is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with roboptim.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "benchmark.hh"
+
+#include <cmath>
+
+#include <roboptim/core/differentiable-function.hh>
+
+using namespace roboptim;
+using namespace roboptim::benchmark;
+
+// Position of the end effector of a planar arm with unit links, with
+// respect to the joint angles.
+template <typename T>
+struct PlanarArm : public GenericDifferentiableFunction<T>
+{
+  ROBOPTIM_DIFFERENTIABLE_FUNCTION_FWD_TYPEDEFS_
+  (GenericDifferentiableFunction<T>);
+
+  explicit PlanarArm (size_type n)
+    : GenericDifferentiableFunction<T> (n, 2, "planar arm")
+  {}
+
+  void impl_compute (result_ref res, const_argument_ref q) const
+  {
+    value_type angle = 0.;
+    res.setZero ();
+    for (size_type i = 0; i < q.size (); ++i)
+      {
+        angle += q[i];
+        res[0] += std::cos (angle);
+        res[1] += std::sin (angle);
+      }
+  }
+
+  void impl_gradient (gradient_ref grad, const_argument_ref q,
+                      size_type functionId) const
+  {
+    // Walk the links backward, starting from the absolute angle of the
+    // last one.
+    value_type angle = q.sum ();
+    value_type acc = 0.;
+    for (size_type i = q.size () - 1; i >= 0; --i)
+      {
+        acc += (functionId == 0)? -std::sin (angle) : std::cos (angle);
+        grad[i] = acc;
+        angle -= q[i];
+      }
+  }
+
+  void impl_jacobian (jacobian_ref jac, const_argument_ref q) const
+  {
+    value_type angle = q.sum ();
+    value_type accX = 0.;
+    value_type accY = 0.;
+    for (size_type i = q.size () - 1; i >= 0; --i)
+      {
+        accX -= std::sin (angle);
+        accY += std::cos (angle);
+        jac (0, i) = accX;
+        jac (1, i) = accY;
+        angle -= q[i];
+      }
+  }
+};
+
+// Time of a value and jacobian evaluation, in ns/operation.
+template <typename F>
+double timeEvaluation (typename F::size_type n, size_t nIter)
+{
+  F f (n);
+
+  typename F::argument_t q (n);
+  q.setRandom ();
+  typename F::result_t res (f.outputSize ());
+  typename F::jacobian_t jac (f.outputSize (), n);
+
+  Timer timer;
+  for (size_t i = 0; i < nIter; ++i)
+    {
+      q[0] += 1e-9;
+      f (res, q);
+      f.jacobian (jac, q);
+      doNotOptimize (res);
+      doNotOptimize (jac);
+    }
+  return timer.elapsed () / static_cast<double> (nIter);
+}
+
+template <int N>
+void benchmarkArm (size_t nIter)
+{
+  const double dynamicTime =
+    timeEvaluation<PlanarArm<EigenMatrixDense> > (N, nIter);
+  const double fixedTime =
+    timeEvaluation<PlanarArm<EigenMatrixFixed<N, 2> > > (N, nIter);
+
+  std::cout << std::setw (10) << N
+            << std::setw (12) << dynamicTime
+            << std::setw (12) << fixedTime
+            << std::setw (12) << dynamicTime / fixedTime << std::endl;
+}
+
+int main ()
+{
+  const size_t nIter = 1000000;
+
+  printHeader ("Planar arm value + jacobian (ns/operation)",
+               "joints", "     dynamic       fixed     speedup");
+
+  benchmarkArm<2> (nIter);
+  benchmarkArm<3> (nIter);
+  benchmarkArm<6> (nIter);
+  benchmarkArm<12> (nIter);
+
+  return 0;
+}
@@ -0,0 +1,178 @@
+// Copyright (C) 2026 by the RobOptim contributors.
+//
+// This file is part of the roboptim.
+//
+// roboptim is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// roboptim is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with roboptim.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "benchmark.hh"
+
+#include <cmath>
+#include <cstdlib>
+
+#include <boost/make_shared.hpp>
+#include <boost/thread/thread.hpp>
+
+#include <roboptim/core/differentiable-function.hh>
+#include <roboptim/core/operator/map.hh>
+
+using namespace roboptim;
+using namespace roboptim::benchmark;
+
+// Per-timestep dynamics constraint: s' = s + dt * g(s, u), with a state
+// s and a control u of size 6.
+template <typename T>
+struct Dynamics : public GenericDifferentiableFunction<T>
+{
+  ROBOPTIM_DIFFERENTIABLE_FUNCTION_FWD_TYPEDEFS_
+  (GenericDifferentiableFunction<T>);
+
+  Dynamics ()
+    : GenericDifferentiableFunction<T> (12, 6, "dynamics")
+  {}
+
+  void impl_compute (result_ref res, const_argument_ref x) const
+  {
+    for (size_type i = 0; i < 6; ++i)
+      res[i] = x[i] + dt * std::sin (x[i]) * std::exp (x[6 + i]);
+  }
+
+  void impl_gradient (gradient_ref grad, const_argument_ref x,
+                      size_type i) const
+  {
+    grad.coeffRef (i) = 1. + dt * std::cos (x[i]) * std::exp (x[6 + i]);
+    grad.coeffRef (6 + i) = dt * std::sin (x[i]) * std::exp (x[6 + i]);
+  }
+
+  static const double dt;
+};
+
+template <typename T>
+const double Dynamics<T>::dt = 1e-2;
+
+// Previous implementation of the Map Jacobian: sequential evaluation of
+// the repeats, and entry by entry copy of the blocks.
+template <typename T>
+struct LegacyMap : public GenericDifferentiableFunction<T>
+{
+  ROBOPTIM_DIFFERENTIABLE_FUNCTION_FWD_TYPEDEFS_
+  (GenericDifferentiableFunction<T>);
+
+  LegacyMap (boost::shared_ptr<GenericDifferentiableFunction<T> > origin,
+             size_type repeat)
+    : GenericDifferentiableFunction<T>
+      (origin->inputSize () * repeat, origin->outputSize () * repeat,
+       "legacy map"),
+      origin_ (origin),
+      repeat_ (repeat),
+      x_ (origin->inputSize ()),
+      jacobian_ (origin->outputSize (), origin->inputSize ())
+  {}
+
+  void impl_compute (result_ref, const_argument_ref) const
+  {}
+
+  void impl_gradient (gradient_ref, const_argument_ref, size_type) const
+  {}
+
+  void impl_jacobian (jacobian_ref jacobian, const_argument_ref x) const
+  {
+    for (size_type i = 0; i < repeat_; ++i)
+      {
+        x_ = x.segment (i * origin_->inputSize (), origin_->inputSize ());
+        origin_->jacobian (jacobian_, x_);
+
+        for (size_type idx_i = 0; idx_i < origin_->outputSize (); ++idx_i)
+          for (size_type idx_j = 0; idx_j < origin_->inputSize (); ++idx_j)
+            jacobian.coeffRef
+              (i * origin_->outputSize () + idx_i,
+               i * origin_->inputSize () + idx_j) =
+              jacobian_.coeffRef (idx_i, idx_j);
+      }
+  }
+
+  boost::shared_ptr<GenericDifferentiableFunction<T> > origin_;
+  size_type repeat_;
+  mutable argument_t x_;
+  mutable jacobian_t jacobian_;
+};
+
+template <typename F>
+double timeJacobian (const F& f, typename F::const_argument_ref x,
+                     typename F::jacobian_t& jac, size_t nIter)
+{
+  Timer timer;
+  for (size_t i = 0; i < nIter; ++i)
+    {
+      f.jacobian (jac, x);
+      doNotOptimize (jac);
+    }
+  return timer.elapsed () * 1e-6 / static_cast<double> (nIter);
+}
+
+// Jacobian computation time of the previous implementation and of the
+// block-wise one, with respect to the number of threads.
+template <typename T>
+void benchmarkMap (const std::string& title,
+                   typename GenericFunction<T>::size_type repeat,
+                   size_t maxThreads, size_t nIter)
+{
+  typedef GenericDifferentiableFunction<T> function_t;
+
+  boost::shared_ptr<function_t> dynamics =
+    boost::make_shared<Dynamics<T> > ();
+  LegacyMap<T> legacy (dynamics, repeat);
+  boost::shared_ptr<Map<function_t> > f = map (dynamics, repeat);
+  f->reuseJacobianStructure () = true;
+
+  typename function_t::argument_t x (f->inputSize ());
+  x.setRandom ();
+
+  // Both implementations start from the Jacobian structure, as given to
+  // solvers.
+  typename function_t::jacobian_t jac (f->outputSize (), f->inputSize ());
+  jac = f->jacobianStructure ();
+
+  printHeader (title, "threads", "      legacy       block     speedup");
+
+  const double reference = timeJacobian (legacy, x, jac, nIter);
+  for (size_t threads = 1; threads <= maxThreads; threads *= 2)
+    {
+      f->setThreads (threads);
+      const double t = timeJacobian (*f, x, jac, nIter);
+
+      std::cout << std::setw (10) << threads
+                << std::setw (12) << reference
+                << std::setw (12) << t
+                << std::setw (12) << reference / t << std::endl;
+    }
+}
+
+int main (int argc, char** argv)
+{
+  // The maximum number of threads can be given on the command line.
+  size_t maxThreads = boost::thread::hardware_concurrency ();
+  if (argc > 1)
+    maxThreads = static_cast<size_t> (std::atoi (argv[1]));
+  if (maxThreads == 0)
+    maxThreads = 1;
+
+  benchmarkMap<EigenMatrixSparse>
+    ("Sparse map Jacobian (ms/operation), 2000 repeats",
+     2000, maxThreads, 20);
+  benchmarkMap<EigenMatrixDense>
+    ("Dense map Jacobian (ms/operation), 200 repeats",
+     200, maxThreads, 20);
+
+  return 0;
+}
@@ -0,0 +1,220 @@
+// Copyright (C) 2026 by the RobOptim contributors.
+//
+// This file is part of the roboptim.
+//
+// roboptim is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// roboptim is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with roboptim.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "benchmark.hh"
+
+#include <cmath>
+#include <cstdlib>
+#include <vector>
+
+#include <boost/bind.hpp>
+#include <boost/make_shared.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/thread.hpp>
+
+#include <roboptim/core/differentiable-function.hh>
+#include <roboptim/core/cache.hh>
+#include <roboptim/core/sharded-cache.hh>
+#include <roboptim/core/decorator/cached-function.hh>
+
+using namespace roboptim;
+using namespace roboptim::benchmark;
+
+typedef Function::argument_t argument_t;
+typedef Function::vector_t vector_t;
+
+typedef CachedFunction<DifferentiableFunction> exactF_t;
+typedef CachedFunction<DifferentiableFunction,
+                       cachedFunctionPolicies::Concurrent<EigenMatrixDense> >
+concurrentF_t;
+
+// Number of operations per thread.
+static const size_t nIter = 200000;
+
+// Keys shared by all the threads.
+static std::vector<argument_t> keys;
+
+// Sequence of accessed keys.
+static std::vector<size_t> accesses;
+
+// Key accessed by a given thread at a given iteration.
+static const argument_t& key (size_t id, size_t i)
+{
+  return keys[accesses[(i + id * 7919) % accesses.size ()]];
+}
+
+// Costly function, e.g. forward kinematics of a robot.
+struct KinematicsF : public DifferentiableFunction
+{
+  KinematicsF (size_type n)
+    : DifferentiableFunction (n, 3, "kinematics")
+  {}
+
+  void impl_compute (result_ref res, const_argument_ref x) const
+  {
+    res.setZero ();
+    for (size_type i = 0; i < x.size (); ++i)
+      {
+        res[0] += std::cos (x[i]);
+        res[1] += std::sin (x[i]);
+        res[2] += std::cos (x[i]) * std::sin (x[i]);
+      }
+  }
+
+  void impl_gradient (gradient_ref grad, const_argument_ref x,
+                      size_type) const
+  {
+    grad = -x.array ().sin ();
+  }
+};
+
+// LRUCache shared by all the threads, protected by a single mutex.
+struct LockedCache
+{
+  LockedCache (size_t size)
+    : cache (size)
+  {}
+
+  void run (size_t id)
+  {
+    for (size_t i = 0; i < nIter; ++i)
+      {
+        boost::mutex::scoped_lock lock (mutex);
+        doNotOptimize (cache[key (id, i)]);
+      }
+  }
+
+  LRUCache<argument_t, vector_t, Hasher> cache;
+  boost::mutex mutex;
+};
+
+// ShardedLRUCache shared by all the threads.
+struct ShardedCache
+{
+  ShardedCache (size_t size)
+    : cache (size)
+  {}
+
+  void run (size_t id)
+  {
+    vector_t value (3);
+    for (size_t i = 0; i < nIter; ++i)
+      {
+        if (!cache.get (key (id, i), value))
+          cache.insert (key (id, i), value);
+        doNotOptimize (value);
+      }
+  }
+
+  ShardedLRUCache<argument_t, vector_t, Hasher> cache;
+};
+
+// Function shared by all the threads.
+struct SharedFunction
+{
+  SharedFunction (const DifferentiableFunction& f)
+    : f (f)
+  {}
+
+  void run (size_t id)
+  {
+    vector_t value (3);
+    for (size_t i = 0; i < nIter / 10; ++i)
+      {
+        f (value, key (id, i));
+        doNotOptimize (value);
+      }
+  }
+
+  const DifferentiableFunction& f;
+};
+
+// Throughput in millions of operations per second.
+template <typename B>
+double throughput (B& b, size_t nThreads, size_t nOps)
+{
+  boost::thread_group threads;
+  Timer timer;
+  for (size_t i = 0; i < nThreads; ++i)
+    threads.create_thread (boost::bind (&B::run, &b, i));
+  threads.join_all ();
+
+  return 1e3 * static_cast<double> (nThreads * nOps) / timer.elapsed ();
+}
+
+int main ()
+{
+  const Function::size_type n = 30;
+  const size_t size = 128;
+  const size_t nThreads[] = {1, 2, 4, 8};
+
+  // 90% of the accesses target a hot set of keys that fits in the
+  // caches, the others are spread over a large set of cold keys.
+  const size_t hot = 3 * size / 4;
+  keys.resize (10 * size, argument_t (n));
+  for (size_t i = 0; i < keys.size (); ++i)
+    keys[i].setRandom ();
+
+  std::srand (42);
+  accesses.resize (nIter);
+  for (size_t i = 0; i < accesses.size (); ++i)
+    accesses[i] = (std::rand () % 10 != 0)?
+      static_cast<size_t> (std::rand ()) % hot :
+      hot + static_cast<size_t> (std::rand ()) % (keys.size () - hot);
+
+  boost::shared_ptr<KinematicsF> f = boost::make_shared<KinematicsF> (n);
+
+  printHeader ("Cache throughput (Mop/s), cache size = 128, argument size = 30",
+               "threads", "     locked     sharded");
+
+  for (size_t t = 0; t < sizeof (nThreads) / sizeof (nThreads[0]); ++t)
+    {
+      LockedCache locked (size);
+      ShardedCache sharded (size);
+      std::cout << std::setw (10) << nThreads[t]
+                << std::setw (11) << throughput (locked, nThreads[t], nIter)
+                << std::setw (12) << throughput (sharded, nThreads[t], nIter)
+                << std::endl;
+    }
+
+  std::cout << std::endl;
+  printHeader ("Cached function throughput (Mop/s), same parameters",
+               "threads", "   uncached        exact  concurrent");
+
+  for (size_t t = 0; t < sizeof (nThreads) / sizeof (nThreads[0]); ++t)
+    {
+      // Exact (non thread-safe) caching is only measured with one thread.
+      exactF_t exactCachedF (f, size);
+      concurrentF_t concurrentCachedF (f, size);
+      SharedFunction uncachedF (*f);
+      SharedFunction exactF (exactCachedF);
+      SharedFunction concurrentF (concurrentCachedF);
+
+      std::cout << std::setw (10) << nThreads[t]
+                << std::setw (11)
+                << throughput (uncachedF, nThreads[t], nIter / 10);
+      if (nThreads[t] == 1)
+        std::cout << std::setw (13) << throughput (exactF, 1, nIter / 10);
+      else
+        std::cout << std::setw (13) << "-";
+      std::cout << std::setw (12)
+                << throughput (concurrentF, nThreads[t], nIter / 10)
+                << std::endl;
+    }
+
+  return 0;
+}
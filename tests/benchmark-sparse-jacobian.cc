@@ -0,0 +1,121 @@
+// Copyright (C) 2026 by the RobOptim contributors.
+//
+// This file is part of the roboptim.
+//
+// roboptim is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// roboptim is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with roboptim.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "benchmark.hh"
+
+#include <algorithm>
+
+#include <boost/make_shared.hpp>
+
+#include <roboptim/core/differentiable-function.hh>
+#include <roboptim/core/decorator/in-place-jacobian.hh>
+
+using namespace roboptim;
+using namespace roboptim::benchmark;
+
+typedef DifferentiableSparseFunction::size_type size_type;
+
+// Sparse function with a banded jacobian, relying on the default jacobian
+// computation from the gradients.
+struct Banded : public DifferentiableSparseFunction
+{
+  Banded (size_type n, size_type bandwidth)
+    : DifferentiableSparseFunction (n, n, "banded function"),
+      bandwidth_ (bandwidth)
+  {}
+
+  void impl_compute (result_ref res, const_argument_ref x) const
+  {
+    for (size_type i = 0; i < outputSize (); ++i)
+      {
+        res[i] = 0.;
+        for (size_type j = begin (i); j < end (i); ++j)
+          res[i] += x[j] * x[j];
+      }
+  }
+
+  void impl_gradient (gradient_ref grad, const_argument_ref x,
+                      size_type functionId) const
+  {
+    for (size_type j = begin (functionId); j < end (functionId); ++j)
+      grad.insert (j) = 2. * x[j];
+  }
+
+  size_type begin (size_type i) const
+  {
+    return std::max<size_type> (0, i - bandwidth_);
+  }
+
+  size_type end (size_type i) const
+  {
+    return std::min<size_type> (inputSize (), i + bandwidth_ + 1);
+  }
+
+  size_type bandwidth_;
+};
+
+// Jacobian computation time with and without in-place assembly, with
+// respect to the number of rows.
+void benchmarkAssembly ()
+{
+  const size_type sizes[] = {100, 1000, 5000, 10000};
+  const size_type bandwidth = 2;
+  const size_t nIter = 20;
+
+  printHeader ("Sparse jacobian assembly (ms/operation), bandwidth = 2",
+               "rows", "    triplets    in-place     speedup");
+
+  for (size_t s = 0; s < sizeof (sizes) / sizeof (sizes[0]); ++s)
+    {
+      const size_type n = sizes[s];
+      boost::shared_ptr<Banded> f = boost::make_shared<Banded> (n, bandwidth);
+
+      DifferentiableSparseFunction::argument_t x (n);
+      x.setRandom ();
+      DifferentiableSparseFunction::jacobian_t jac (n, n);
+
+      Timer timer;
+      for (size_t i = 0; i < nIter; ++i)
+        f->jacobian (jac, x);
+      const double triplets =
+        timer.elapsed () * 1e-6 / static_cast<double> (nIter);
+
+      // The first call records the structure.
+      boost::shared_ptr<InPlaceJacobian<EigenMatrixSparse> > g =
+        inPlaceJacobian (f);
+      g->jacobian (jac, x);
+
+      timer.restart ();
+      for (size_t i = 0; i < nIter; ++i)
+        g->jacobian (jac, x);
+      const double inPlace =
+        timer.elapsed () * 1e-6 / static_cast<double> (nIter);
+      doNotOptimize (jac);
+
+      std::cout << std::setw (10) << n
+                << std::setw (12) << triplets
+                << std::setw (12) << inPlace
+                << std::setw (12) << triplets / inPlace << std::endl;
+    }
+}
+
+int main ()
+{
+  benchmarkAssembly ();
+
+  return 0;
+}
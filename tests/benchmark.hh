@@ -0,0 +1,82 @@
+// Copyright (C) 2026 by the RobOptim contributors.
+//
+// This file is part of the roboptim.
+//
+// roboptim is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// roboptim is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with roboptim.  If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef ROBOPTIM_CORE_TESTS_BENCHMARK_HH
+# define ROBOPTIM_CORE_TESTS_BENCHMARK_HH
+
+# include <iomanip>
+# include <iostream>
+# include <string>
+
+# include <boost/date_time/posix_time/posix_time.hpp>
+
+namespace roboptim
+{
+  namespace benchmark
+  {
+    /// \brief Simple wall-clock timer used by the benchmarks.
+    class Timer
+    {
+    public:
+      Timer ()
+        : start_ (now ())
+      {}
+
+      /// \brief Restart the timer.
+      void restart ()
+      {
+        start_ = now ();
+      }
+
+      /// \brief Elapsed time since the last restart, in nanoseconds.
+      double elapsed () const
+      {
+        return static_cast<double>
+          ((now () - start_).total_microseconds ()) * 1e3;
+      }
+
+    private:
+      static boost::posix_time::ptime now ()
+      {
+        return boost::posix_time::microsec_clock::universal_time ();
+      }
+
+    private:
+      boost::posix_time::ptime start_;
+    };
+
+    /// \brief Print the header of a result table.
+    inline void printHeader (const std::string& title,
+                             const std::string& parameter,
+                             const std::string& columns)
+    {
+      std::cout << "# " << title << std::endl
+                << std::setw (10) << parameter << columns << std::endl;
+    }
+
+    /// \brief Prevent the compiler from optimizing a result away.
+    template <typename T>
+    inline void doNotOptimize (const T& value)
+    {
+      static const void* volatile sink = 0;
+      sink = &value;
+      (void) sink;
+    }
+  } // end of namespace benchmark
+} // end of namespace roboptim
+
+#endif //! ROBOPTIM_CORE_TESTS_BENCHMARK_HH
@@ -18,6 +18,7 @@
 #include "shared-tests/fixture.hh"
 
 #include <iostream>
+#include <sstream>
 
 #include <roboptim/core/io.hh>
 #include <roboptim/core/cache.hh>
@@ -71,6 +72,21 @@ BOOST_AUTO_TEST_CASE (cache)
   cache.insert ("x₀", 37.);
   (*output) << cache << std::endl;
 
+  // Resizing the cache discards the cached values
+  cache.resize (2);
+  BOOST_CHECK_EQUAL (cache.size (), 2);
+  BOOST_CHECK (cache.find ("x₀") == cache.cend ());
+
+  cache.insert ("x₀", 0.);
+  cache.insert ("x₁", 1.);
+  BOOST_CHECK_EQUAL (cache["x₀"], 0.);
+
+  // x₂ overwrites x₁'s cached value (LRU)
+  cache.insert ("x₂", 2.);
+  BOOST_CHECK (cache.find ("x₀") != cache.cend ());
+  BOOST_CHECK (cache.find ("x₁") == cache.cend ());
+  BOOST_CHECK_EQUAL (cache["x₂"], 2.);
+
   // Test for heap memory
   // #1: fixed size matrices
   typedef Eigen::Matrix<double, 100, 100> matrix_t;
@@ -96,5 +112,138 @@ BOOST_AUTO_TEST_CASE (cache)
   BOOST_CHECK (output->match_pattern ());
 }
 
+// Hasher generating collisions for every key.
+template <typename K>
+struct CollidingHasher
+{
+  std::size_t operator() (typename detail::const_ref<K>::type) const
+  {
+    return 0;
+  }
+};
+
+BOOST_AUTO_TEST_CASE (cache_verify_keys)
+{
+  size_t cache_size = 5;
+
+  // #1: keys are not verified, collisions lead to wrong values
+  LRUCache<std::string, float, CollidingHasher<std::string> >
+    unsafe_cache (cache_size);
+  BOOST_CHECK (!unsafe_cache.verifyKeys ());
+
+  unsafe_cache.insert ("x₀", 0.);
+  BOOST_CHECK (unsafe_cache.find ("x₁") != unsafe_cache.cend ());
+  BOOST_CHECK_EQUAL (unsafe_cache["x₁"], 0.);
+
+  // #2: keys are verified, the last key replaces the cached one
+  LRUCache<std::string, float, CollidingHasher<std::string> >
+    safe_cache (cache_size, true);
+  BOOST_CHECK (safe_cache.verifyKeys ());
+
+  safe_cache.insert ("x₀", 0.);
+  BOOST_CHECK (safe_cache.find ("x₀") != safe_cache.cend ());
+  BOOST_CHECK (safe_cache.find ("x₁") == safe_cache.cend ());
+
+  safe_cache.insert ("x₁", 1.);
+  BOOST_CHECK (safe_cache.find ("x₀") == safe_cache.cend ());
+  BOOST_CHECK_EQUAL (safe_cache["x₁"], 1.);
+
+  // #3: dense vectors stored in the key arena
+  typedef Eigen::VectorXd key_t;
+  LRUCache<key_t, double, CollidingHasher<key_t> > vec_cache (cache_size, true);
+
+  key_t x0 = key_t::Zero (100);
+  key_t x1 = key_t::Zero (100);
+  x1[99] = 1.;
+
+  vec_cache.insert (x0, 0.);
+  BOOST_CHECK (vec_cache.find (x0) != vec_cache.cend ());
+  BOOST_CHECK (vec_cache.find (x1) == vec_cache.cend ());
+  BOOST_CHECK (vec_cache.find (x0.head (50)) == vec_cache.cend ());
+
+  vec_cache.insert (x1, 1.);
+  BOOST_CHECK (vec_cache.find (x0) == vec_cache.cend ());
+  BOOST_CHECK_EQUAL (vec_cache[x1], 1.);
+
+  // Keys of a different size clear the cache
+  vec_cache.insert (x0.head (50), 2.);
+  BOOST_CHECK (vec_cache.find (x1) == vec_cache.cend ());
+  BOOST_CHECK_EQUAL (vec_cache[x0.head (50)], 2.);
+
+  // #4: copies are independent
+  LRUCache<key_t, double, CollidingHasher<key_t> > vec_cache_copy (vec_cache);
+  vec_cache_copy.insert (x0, 3.);
+  BOOST_CHECK_EQUAL (vec_cache[x0.head (50)], 2.);
+  BOOST_CHECK_EQUAL (vec_cache_copy[x0], 3.);
+  BOOST_CHECK (vec_cache_copy.find (x0.head (50)) == vec_cache_copy.cend ());
+}
+
+struct VectorHasher
+{
+  std::size_t operator () (const Eigen::VectorXd& x) const
+  {
+    return boost::hash_range (x.data (), x.data () + x.size ());
+  }
+};
+
+BOOST_AUTO_TEST_CASE (cache_statistics)
+{
+  typedef Eigen::VectorXd key_t;
+  typedef Eigen::VectorXd value_t;
+
+  LRUCache<key_t, value_t, VectorHasher> cache (2, true);
+  CacheStatistics stats = cache.statistics ();
+  BOOST_CHECK_EQUAL (stats.size, 2);
+  BOOST_CHECK_EQUAL (stats.elements, 0);
+  BOOST_CHECK_EQUAL (stats.bytes, 0);
+  BOOST_CHECK_EQUAL (stats.hitRate (), 0.);
+
+  key_t x0 = key_t::Zero (10);
+  key_t x1 = key_t::Ones (10);
+  key_t x2 = key_t::Constant (10, 2.);
+
+  cache.insert (x0, value_t::Zero (3));
+  cache.insert (x1, value_t::Zero (3));
+  // Update: not an insertion
+  cache.insert (x1, value_t::Ones (3));
+  // Eviction of x0
+  cache.insert (x2, value_t::Zero (3));
+
+  BOOST_CHECK (cache.find (x0) == cache.cend ());
+  BOOST_CHECK (cache.find (x1) != cache.cend ());
+
+  stats = cache.statistics ();
+  BOOST_CHECK_EQUAL (stats.elements, 2);
+  BOOST_CHECK_EQUAL (stats.hits, 1);
+  BOOST_CHECK_EQUAL (stats.misses, 1);
+  BOOST_CHECK_EQUAL (stats.insertions, 3);
+  BOOST_CHECK_EQUAL (stats.evictions, 1);
+  BOOST_CHECK_EQUAL (stats.hitRate (), 0.5);
+  // 2 values of size 3 and 2 keys of size 10
+  BOOST_CHECK_EQUAL (stats.bytes, (2 * 3 + 2 * 10) * sizeof (double));
+
+  // Accumulate statistics
+  stats += cache.statistics ();
+  BOOST_CHECK_EQUAL (stats.size, 4);
+  BOOST_CHECK_EQUAL (stats.evictions, 2);
+
+  std::ostringstream ss;
+  ss << stats;
+  BOOST_CHECK_EQUAL (ss.str (),
+		     "size: 4, elements: 4, hits: 2, misses: 2, insertions: 6,"
+		     " evictions: 2, bytes: 416");
+
+  // Clearing the cache is not an eviction
+  cache.clear ();
+  BOOST_CHECK_EQUAL (cache.evictions (), 1);
+
+  cache.resetStatistics ();
+  stats = cache.statistics ();
+  BOOST_CHECK_EQUAL (stats.hits, 0);
+  BOOST_CHECK_EQUAL (stats.misses, 0);
+  BOOST_CHECK_EQUAL (stats.insertions, 0);
+  BOOST_CHECK_EQUAL (stats.evictions, 0);
+}
+
 BOOST_AUTO_TEST_SUITE_END ()
 
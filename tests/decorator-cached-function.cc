@@ -19,12 +19,15 @@
 
 #include <iostream>
 
+#include <boost/bind.hpp>
 #include <boost/make_shared.hpp>
+#include <boost/thread/thread.hpp>
 
 #include <roboptim/core/io.hh>
 #include <roboptim/core/differentiable-function.hh>
 #include <roboptim/core/numeric-linear-function.hh>
 #include <roboptim/core/util.hh>
+#include <roboptim/core/function/cos.hh>
 #include <roboptim/core/decorator/cached-function.hh>
 
 using namespace roboptim;
@@ -206,6 +209,13 @@ BOOST_AUTO_TEST_CASE (cached_function)
   cachedSparseF.reset ();
   loopCachedFunction (dense_f, cachedDenseF, sparse_f, cachedSparseF, x, 1e5);
 
+  // Verify keys on hit
+  CachedFunction<DifferentiableFunction> verifiedDenseF (dense_f, 10, true);
+  CachedFunction<DifferentiableSparseFunction>
+    verifiedSparseF (sparse_f, 10, true);
+  loopCachedFunction (dense_f, verifiedDenseF, sparse_f, verifiedSparseF,
+                      x, 1e4);
+
   NumericLinearFunction::matrix_t a (3, 3);
   NumericLinearFunction::vector_t b (3);
   a.setZero ();
@@ -223,4 +233,298 @@ BOOST_AUTO_TEST_CASE (cached_function)
   BOOST_CHECK (output->match_pattern ());
 }
 
+BOOST_AUTO_TEST_CASE (cached_function_tolerance)
+{
+  typedef cachedFunctionPolicies::Quantized<EigenMatrixDense> quantized_t;
+  typedef cachedFunctionPolicies::EpsilonBall<EigenMatrixDense> epsilonBall_t;
+
+  boost::shared_ptr<DenseF> f (new DenseF (false));
+
+  CachedFunction<DifferentiableFunction> exactF (f);
+  CachedFunction<DifferentiableFunction, quantized_t> quantizedF (f);
+  CachedFunction<DifferentiableFunction, epsilonBall_t> epsilonBallF (f);
+  quantizedF.tolerance () = 1e-6;
+  epsilonBallF.tolerance () = 1e-6;
+
+  Function::vector_t x (2);
+  x << 1., 2.;
+  Function::vector_t res = (*f) (x);
+
+  BOOST_CHECK_EQUAL (exactF (x)[0], res[0]);
+  BOOST_CHECK_EQUAL (quantizedF (x)[0], res[0]);
+  BOOST_CHECK_EQUAL (epsilonBallF (x)[0], res[0]);
+
+  // Slightly perturbed point: the cached value is returned, except for
+  // exact caching.
+  x[0] += 1e-9;
+  BOOST_CHECK_NE (exactF (x)[0], res[0]);
+  BOOST_CHECK_EQUAL (quantizedF (x)[0], res[0]);
+  BOOST_CHECK_EQUAL (epsilonBallF (x)[0], res[0]);
+
+  // Point outside of the tolerance: new computation.
+  x[0] += 1e-3;
+  BOOST_CHECK_EQUAL (quantizedF (x)[0], (*f) (x)[0]);
+  BOOST_CHECK_EQUAL (epsilonBallF (x)[0], (*f) (x)[0]);
+
+  // Same thing for the Jacobian.
+  x << 1., 2.;
+  Function::matrix_t jac = f->jacobian (x);
+  BOOST_CHECK (quantizedF.jacobian (x) == jac);
+  BOOST_CHECK (epsilonBallF.jacobian (x) == jac);
+  x[0] += 1e-9;
+  BOOST_CHECK (quantizedF.jacobian (x) == jac);
+  BOOST_CHECK (epsilonBallF.jacobian (x) == jac);
+
+  BOOST_CHECK_EQUAL (exactF.hits (), 0);
+  BOOST_CHECK_EQUAL (exactF.misses (), 2);
+  BOOST_CHECK_EQUAL (quantizedF.hits (), 2);
+  BOOST_CHECK_EQUAL (quantizedF.misses (), 3);
+  BOOST_CHECK_EQUAL (epsilonBallF.hits (), 2);
+  BOOST_CHECK_EQUAL (epsilonBallF.misses (), 3);
+
+  quantizedF.resetStatistics ();
+  BOOST_CHECK_EQUAL (quantizedF.hits (), 0);
+  BOOST_CHECK_EQUAL (quantizedF.misses (), 0);
+}
+
+BOOST_AUTO_TEST_CASE (cached_function_epsilon_ball_entry)
+{
+  typedef cachedFunctionPolicies::EpsilonBall<EigenMatrixDense> epsilonBall_t;
+
+  boost::shared_ptr<DenseF> f (new DenseF (false));
+  CachedFunction<DifferentiableFunction, epsilonBall_t> cachedF (f);
+  cachedF.tolerance () = 1e-6;
+
+  Function::vector_t x (2);
+  x << 1., 2.;
+  cachedF (x);
+
+  // The Jacobian of a nearby point is missing from the entry found: it is
+  // added to this entry, rather than to a new one.
+  Function::vector_t y = x;
+  y[0] += 1e-9;
+  Function::matrix_t jac = f->jacobian (y);
+  BOOST_CHECK (cachedF.jacobian (y) == jac);
+  BOOST_CHECK_EQUAL (cachedF.statistics ().cache.elements, 1);
+
+  // Both points now get the Jacobian from this entry.
+  BOOST_CHECK (cachedF.jacobian (x) == jac);
+  BOOST_CHECK_EQUAL (cachedF.statistics ().jacobian.hits, 1);
+}
+
+BOOST_AUTO_TEST_CASE (cached_function_quantized_hessian)
+{
+  typedef cachedFunctionPolicies::Quantized<EigenMatrixDense> quantized_t;
+
+  boost::shared_ptr<Cos<EigenMatrixDense> > f =
+    boost::make_shared<Cos<EigenMatrixDense> > ();
+  CachedFunction<TwiceDifferentiableFunction, quantized_t> cachedF (f);
+  cachedF.tolerance () = 1e-6;
+
+  Function::vector_t x (1);
+  x[0] = 0.3 + 1e-9;
+  cachedF (x);
+
+  // The Hessian is stored in the entry of the quantized argument.
+  BOOST_CHECK (cachedF.hessian (x, 0) == f->hessian (x, 0));
+  BOOST_CHECK_EQUAL (cachedF.statistics ().cache.elements, 1);
+}
+
+BOOST_AUTO_TEST_CASE (cached_function_statistics)
+{
+  boost::shared_ptr<DenseF> f (new DenseF (false));
+  CachedFunction<DifferentiableFunction> cachedF (f, 2);
+
+  Function::vector_t x (2);
+  for (int i = 0; i < 3; ++i)
+    {
+      x << i, 0.;
+      cachedF (x);
+      cachedF (x);
+      cachedF.gradient (x, 0);
+    }
+  cachedF.jacobian (x);
+
+  // Gradients are extracted from the cached Jacobian
+  Function::vector_t y (2);
+  y << 3., 1.;
+  Function::matrix_t jac = cachedF.jacobian (y);
+  BOOST_CHECK (cachedF.gradient (y, 0) == jac.row (0));
+
+  CachedFunctionStatistics stats = cachedF.statistics ();
+  BOOST_CHECK_EQUAL (stats.function.hits, 3);
+  BOOST_CHECK_EQUAL (stats.function.misses, 3);
+  BOOST_CHECK_EQUAL (stats.function.insertions, 3);
+  BOOST_CHECK_EQUAL (stats.gradient.hits, 1);
+  BOOST_CHECK_EQUAL (stats.gradient.misses, 3);
+  BOOST_CHECK_EQUAL (stats.gradient.insertions, 3);
+  BOOST_CHECK_EQUAL (stats.jacobian.hits, 0);
+  BOOST_CHECK_EQUAL (stats.jacobian.misses, 2);
+  BOOST_CHECK_EQUAL (stats.jacobian.insertions, 2);
+  BOOST_CHECK_EQUAL (stats.hessian.insertions, 0);
+
+  // All the data computed at the same point shares the same entry
+  BOOST_CHECK_EQUAL (stats.cache.size, 2);
+  BOOST_CHECK_EQUAL (stats.cache.elements, 2);
+  BOOST_CHECK_EQUAL (stats.cache.insertions, 4);
+  BOOST_CHECK_EQUAL (stats.cache.evictions, 2);
+  BOOST_CHECK_EQUAL (stats.cache.hits, cachedF.hits ());
+  BOOST_CHECK_EQUAL (stats.cache.misses, cachedF.misses ());
+  // Storage of evicted entries is reused: each entry has room for a
+  // value, a gradient and a Jacobian.
+  BOOST_CHECK_EQUAL (stats.cache.bytes, 2 * (1 + 2 + 2) * sizeof (double));
+
+  cachedF.resetStatistics ();
+  BOOST_CHECK_EQUAL (cachedF.hits (), 0);
+  BOOST_CHECK_EQUAL (cachedF.statistics ().cache.insertions, 0);
+}
+
+BOOST_AUTO_TEST_CASE (cached_function_value_and_jacobian)
+{
+  boost::shared_ptr<DenseF> f (new DenseF (false));
+  CachedFunction<DifferentiableFunction> cachedF (f, 2);
+
+  Function::vector_t x (2);
+  x << 1., 2.;
+  Function::vector_t res (1);
+  Function::matrix_t jac (1, 2);
+
+  // Both the value and the Jacobian are computed and cached.
+  cachedF.valueAndJacobian (res, jac, x);
+  BOOST_CHECK_EQUAL (res, (*f) (x));
+  BOOST_CHECK_EQUAL (jac, f->jacobian (x));
+  BOOST_CHECK_EQUAL (cachedF (x), res);
+  BOOST_CHECK_EQUAL (cachedF.jacobian (x), jac);
+
+  // Only the missing Jacobian is computed.
+  x << 3., 4.;
+  cachedF (x);
+  cachedF.valueAndJacobian (res, jac, x);
+  BOOST_CHECK_EQUAL (res, (*f) (x));
+  BOOST_CHECK_EQUAL (jac, f->jacobian (x));
+
+  CachedFunctionStatistics stats = cachedF.statistics ();
+  BOOST_CHECK_EQUAL (stats.function.hits, 2);
+  BOOST_CHECK_EQUAL (stats.function.misses, 2);
+  BOOST_CHECK_EQUAL (stats.function.insertions, 2);
+  BOOST_CHECK_EQUAL (stats.jacobian.hits, 1);
+  BOOST_CHECK_EQUAL (stats.jacobian.misses, 2);
+  BOOST_CHECK_EQUAL (stats.jacobian.insertions, 2);
+}
+
+typedef CachedFunction<DifferentiableFunction,
+                       cachedFunctionPolicies::Concurrent<EigenMatrixDense> >
+concurrentF_t;
+
+static void evaluate (const concurrentF_t& f, size_t id, size_t& errors)
+{
+  Function::vector_t x (2);
+  Function::vector_t res (1);
+  Function::matrix_t jac (1, 2);
+
+  for (size_t i = 0; i < 1000; ++i)
+    {
+      x << static_cast<double> (i % 10), static_cast<double> (id % 2);
+      f (res, x);
+      if (res[0] != 2. * x[0] * x[0] + x[1])
+        ++errors;
+      f.jacobian (jac, x);
+      if (jac (0, 0) != 4. * x[0] || jac (0, 1) != 1.)
+        ++errors;
+    }
+}
+
+BOOST_AUTO_TEST_CASE (cached_function_concurrent)
+{
+  const size_t nThreads = 4;
+  boost::shared_ptr<DenseF> f (new DenseF (false));
+  concurrentF_t cachedF (f, 20);
+
+  std::vector<size_t> errors (nThreads, 0);
+  boost::thread_group threads;
+  for (size_t i = 0; i < nThreads; ++i)
+    threads.create_thread (boost::bind (&evaluate, boost::cref (cachedF),
+                                        i, boost::ref (errors[i])));
+  threads.join_all ();
+
+  for (size_t i = 0; i < nThreads; ++i)
+    BOOST_CHECK_EQUAL (errors[i], 0);
+
+  // Each thread evaluates 1000 values and 1000 Jacobians.
+  BOOST_CHECK_EQUAL (cachedF.hits () + cachedF.misses (), 2000 * nThreads);
+  BOOST_CHECK (cachedF.hits () > 0);
+}
+
+// Evaluation buffers of a thread, allocated beforehand.
+struct EvaluationBuffers
+{
+  EvaluationBuffers ()
+    : x (2),
+      res (1),
+      jac (1, 2)
+  {}
+
+  Function::vector_t x;
+  Function::vector_t res;
+  Function::matrix_t jac;
+};
+
+// Evaluate the function through its public methods, which update the
+// allocation flag of the calling thread.
+static void evaluateTask (const concurrentF_t& f, size_t id,
+                          EvaluationBuffers& buffers, size_t& errors)
+{
+  Function::vector_t& x = buffers.x;
+  Function::vector_t& res = buffers.res;
+  Function::matrix_t& jac = buffers.jac;
+
+  set_is_malloc_allowed (false);
+
+  for (size_t i = 0; i < 1000; ++i)
+    {
+      // Mostly new arguments, so that most evaluations are stored.
+      x << static_cast<double> (i), static_cast<double> (id);
+      f (res, x);
+      if (res[0] != 2. * x[0] * x[0] + x[1])
+        ++errors;
+      f.jacobian (jac, x);
+      if (jac (0, 0) != 4. * x[0] || jac (0, 1) != 1.)
+        ++errors;
+    }
+
+  // The stores of the other threads did not allow allocations here.
+  if (is_malloc_allowed ())
+    ++errors;
+  set_is_malloc_allowed (true);
+}
+
+BOOST_AUTO_TEST_CASE (cached_function_concurrent_allocation_flag)
+{
+  const size_t nThreads = 4;
+  boost::shared_ptr<DenseF> f (new DenseF (false));
+  concurrentF_t cachedF (f, 20);
+
+  std::vector<EvaluationBuffers> buffers (nThreads);
+  std::vector<size_t> errors (nThreads, 0);
+
+  // Allocation checks enabled, as during a solver iteration.
+  bool cur_malloc_allowed = is_malloc_allowed ();
+  set_is_malloc_allowed (false);
+
+  boost::thread_group threads;
+  for (size_t i = 0; i < nThreads; ++i)
+    threads.create_thread (boost::bind (&evaluateTask, boost::cref (cachedF),
+                                        i, boost::ref (buffers[i]),
+                                        boost::ref (errors[i])));
+  threads.join_all ();
+
+  // The concurrent stores did not leave allocations allowed.
+  BOOST_CHECK (!is_malloc_allowed ());
+  set_is_malloc_allowed (cur_malloc_allowed);
+
+  for (size_t i = 0; i < nThreads; ++i)
+    BOOST_CHECK_EQUAL (errors[i], 0);
+  BOOST_CHECK (cachedF.statistics ().function.insertions > 0);
+}
+
 BOOST_AUTO_TEST_SUITE_END ()
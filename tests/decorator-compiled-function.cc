@@ -0,0 +1,161 @@
+// Copyright (C) 2026 by the RobOptim contributors.
+//
+// This file is part of the roboptim.
+//
+// roboptim is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// roboptim is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with roboptim.  If not, see <http://www.gnu.org/licenses/>.
+
+#include <cmath>
+#include <vector>
+
+#include <boost/optional.hpp>
+
+#include "shared-tests/fixture.hh"
+
+#include <roboptim/core/io.hh>
+#include <roboptim/core/operator/bind.hh>
+#include <roboptim/core/operator/chain.hh>
+#include <roboptim/core/operator/concatenate.hh>
+#include <roboptim/core/operator/minus.hh>
+#include <roboptim/core/operator/plus.hh>
+#include <roboptim/core/operator/product.hh>
+#include <roboptim/core/operator/scalar.hh>
+#include <roboptim/core/operator/selection.hh>
+#include <roboptim/core/operator/selection-by-id.hh>
+#include <roboptim/core/decorator/compiled-function.hh>
+
+using namespace roboptim;
+
+// x -> sin (A x), counting its evaluations.
+struct SinOfLinear : public DifferentiableFunction
+{
+  SinOfLinear (size_type inputSize, size_type outputSize, value_type seed)
+    : DifferentiableFunction (inputSize, outputSize, "sin (A x)"),
+      a_ (outputSize, inputSize),
+      computes (0)
+  {
+    for (size_type i = 0; i < outputSize; ++i)
+      for (size_type j = 0; j < inputSize; ++j)
+	a_ (i, j) = std::cos (seed + static_cast<value_type> (3 * i + j));
+  }
+
+  void impl_compute (result_ref result, const_argument_ref x) const
+  {
+    ++computes;
+    result.noalias () = a_ * x;
+    result = result.array ().sin ().matrix ();
+  }
+
+  void impl_gradient (gradient_ref gradient, const_argument_ref x,
+		      size_type functionId) const
+  {
+    gradient = std::cos (a_.row (functionId).dot (x)) * a_.row (functionId);
+  }
+
+  matrix_t a_;
+  mutable size_type computes;
+};
+
+BOOST_FIXTURE_TEST_SUITE (core, TestSuiteConfiguration)
+
+BOOST_AUTO_TEST_CASE (compiled_function)
+{
+  typedef DifferentiableFunction function_t;
+  typedef function_t::value_type value_type;
+
+  boost::shared_ptr<SinOfLinear> f =
+    boost::make_shared<SinOfLinear> (3, 2, 0.);
+  boost::shared_ptr<SinOfLinear> g =
+    boost::make_shared<SinOfLinear> (3, 3, 1.);
+  boost::shared_ptr<SinOfLinear> h =
+    boost::make_shared<SinOfLinear> (2, 2, 2.);
+
+  // c = h o g[1:3] is shared.
+  boost::shared_ptr<function_t> c =
+    chain<function_t, function_t>
+    (h, selection<function_t> (g, 1, 2));
+  boost::shared_ptr<function_t> p =
+    product<function_t, function_t> (c, f);
+  boost::shared_ptr<function_t> d =
+    minus<function_t, function_t> (2. * p, c);
+  boost::shared_ptr<function_t> e =
+    plus<function_t, function_t>
+    (concatenate<function_t, function_t> (d, f),
+     concatenate<function_t, function_t> (c, c));
+
+  std::vector<bool> selector (4, true);
+  selector[1] = false;
+  std::vector<boost::optional<value_type> > boundValues (3);
+  boundValues[1] = 0.3;
+  boost::shared_ptr<function_t> root =
+    roboptim::bind<function_t> (selectionById<function_t> (e, selector),
+				boundValues);
+
+  boost::shared_ptr<CompiledFunction> compiled = compiledFunction (root);
+  boost::shared_ptr<CompiledFunction> cached = compiledFunction (root, true);
+  BOOST_CHECK (!compiled->cacheJacobian ());
+  BOOST_CHECK (cached->cacheJacobian ());
+
+  BOOST_CHECK_EQUAL (compiled->inputSize (), 2);
+  BOOST_CHECK_EQUAL (compiled->outputSize (), 3);
+
+  function_t::argument_t x (2);
+  function_t::result_t result (3);
+  function_t::jacobian_t jacobian (3, 2);
+
+  for (int i = 0; i < 5; ++i)
+    {
+      x[0] = 0.4 * i - 0.9;
+      x[1] = 1.1 - 0.3 * i;
+
+      function_t::result_t expected = (*root) (x);
+      function_t::jacobian_t expectedJacobian = root->jacobian (x);
+
+      // The shared subexpression is only evaluated once.
+      h->computes = 0;
+      BOOST_CHECK (allclose ((*compiled) (x), expected));
+      BOOST_CHECK_EQUAL (h->computes, 1);
+
+      BOOST_CHECK (allclose (compiled->jacobian (x), expectedJacobian));
+
+      result.setZero ();
+      jacobian.setZero ();
+      compiled->valueAndJacobian (result, jacobian, x);
+      BOOST_CHECK (allclose (result, expected));
+      BOOST_CHECK (allclose (jacobian, expectedJacobian));
+
+      // Without caching, each gradient runs the instructions.
+      h->computes = 0;
+      for (function_t::size_type k = 0; k < 3; ++k)
+	BOOST_CHECK (allclose (compiled->gradient (x, k),
+			       expectedJacobian.row (k)));
+      BOOST_CHECK_EQUAL (h->computes, 3);
+
+      // With caching, the gradients of all the outputs come from a
+      // single run.
+      (*cached) (x);
+      h->computes = 0;
+      for (function_t::size_type k = 0; k < 3; ++k)
+	BOOST_CHECK (allclose (cached->gradient (x, k),
+			       expectedJacobian.row (k)));
+      BOOST_CHECK_EQUAL (h->computes, 1);
+
+      // Invalidating the cache forces a new run.
+      cached->invalidate ();
+      BOOST_CHECK (allclose (cached->gradient (x, 0),
+			     expectedJacobian.row (0)));
+      BOOST_CHECK_EQUAL (h->computes, 2);
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END ()
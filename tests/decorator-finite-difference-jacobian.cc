@@ -158,6 +158,94 @@ FBad<T>::impl_jacobian
   jacobian(1,1) = 3. * argument[0] * argument[0];
 }
 
+// Define a function with a tridiagonal Jacobian, that counts its
+// evaluations.
+template <typename T>
+struct FBanded : public GenericFunction<T>
+{
+  ROBOPTIM_FUNCTION_FWD_TYPEDEFS_ (GenericFunction<T>);
+
+  explicit FBanded (size_type n)
+    : GenericFunction<T> (n, n, "x_{i-1} * x_i + sin (x_{i+1})"),
+      evaluations (0)
+  {}
+
+  void impl_compute (result_ref result,
+		     const_argument_ref argument) const
+  {
+    ++evaluations;
+    const size_type n = this->inputSize ();
+    for (size_type i = 0; i < n; ++i)
+      {
+	result[i] = 0.;
+	if (i > 0)
+	  result[i] += argument[i - 1] * argument[i];
+	if (i < n - 1)
+	  result[i] += std::sin (argument[i + 1]);
+      }
+  }
+
+  mutable size_t evaluations;
+};
+
+// Define a function that is linear or mildly nonlinear with respect to
+// the first inputs, and strongly nonlinear with respect to the last one.
+template <typename T>
+struct FStiff : public GenericFunction<T>
+{
+  ROBOPTIM_FUNCTION_FWD_TYPEDEFS_ (GenericFunction<T>);
+
+  FStiff ()
+    : GenericFunction<T> (3, 2, "3 * x + y * y, x * y + exp (5 * z)"),
+      evaluations (0)
+  {}
+
+  void impl_compute (result_ref result,
+		     const_argument_ref argument) const
+  {
+    ++evaluations;
+    result[0] = 3. * argument[0] + argument[1] * argument[1];
+    result[1] = argument[0] * argument[1] + std::exp (5. * argument[2]);
+  }
+
+  mutable size_t evaluations;
+};
+
+// Same function as FStiff, written generically over the scalar type.
+struct StiffKernel
+{
+  template <typename R, typename A>
+  void operator () (R& result, const A& x) const
+  {
+    using std::exp;
+    result[0] = 3. * x[0] + x[1] * x[1];
+    result[1] = x[0] * x[1] + exp (5. * x[2]);
+  }
+};
+
+// Define a function with a dense Jacobian, that can be evaluated
+// concurrently.
+template <typename T>
+struct FDense : public GenericFunction<T>
+{
+  ROBOPTIM_FUNCTION_FWD_TYPEDEFS_ (GenericFunction<T>);
+
+  FDense (size_type n, size_type m)
+    : GenericFunction<T> (n, m, "sum_j sin ((i + 1) * x_j)")
+  {}
+
+  void impl_compute (result_ref result,
+		     const_argument_ref argument) const
+  {
+    for (size_type i = 0; i < this->outputSize (); ++i)
+      {
+	result[i] = 0.;
+	for (size_type j = 0; j < this->inputSize (); ++j)
+	  result[i] += std::sin (static_cast<double> (i + 1) * argument[j]);
+      }
+  }
+};
+
 
 template <typename T>
 void displayJacobian
@@ -240,4 +328,386 @@ BOOST_AUTO_TEST_CASE_TEMPLATE (finite_difference_jacobian, T, functionTypes_t)
   //BOOST_CHECK (output->match_pattern ());
 }
 
+BOOST_AUTO_TEST_CASE_TEMPLATE (finite_difference_jacobian_coloring, T,
+			       functionTypes_t)
+{
+  typedef finiteDifferenceGradientPolicies::ColumnColoring<T> coloring_t;
+  typedef finiteDifferenceGradientPolicies::Simple<T> simple_t;
+  typedef typename GenericFiniteDifferenceGradient<T>::size_type size_type;
+  typedef typename coloring_t::pattern_t pattern_t;
+
+  const size_type n = 50;
+
+  boost::shared_ptr<FBanded<T> > f = boost::make_shared<FBanded<T> > (n);
+  GenericFiniteDifferenceGradient<T, simple_t> fdSimple (f);
+  GenericFiniteDifferenceGradient<T, coloring_t> fdColoring (f);
+
+  typename FBanded<T>::vector_t x (n);
+  x.setLinSpaced (n, -1., 2.);
+
+  typename GenericFiniteDifferenceGradient<T, simple_t>::jacobian_t
+    simpleJac = fdSimple.jacobian (x);
+
+  // First evaluation: detection of the sparsity pattern.
+  BOOST_CHECK (!fdColoring.hasSparsityPattern ());
+  f->evaluations = 0;
+  typename GenericFiniteDifferenceGradient<T, coloring_t>::jacobian_t
+    coloringJac = fdColoring.jacobian (x);
+  BOOST_CHECK_EQUAL (f->evaluations, static_cast<size_t> (n + 1));
+  BOOST_CHECK (fdColoring.hasSparsityPattern ());
+  BOOST_CHECK (allclose (toDense (simpleJac), toDense (coloringJac)));
+
+  // Tridiagonal Jacobian: 3 structurally orthogonal groups of columns.
+  BOOST_CHECK_EQUAL (fdColoring.colors (), 3);
+  for (size_type j = 0; j < n; ++j)
+    BOOST_CHECK_EQUAL (fdColoring.coloring ()[static_cast<size_t> (j)],
+		       j % 3);
+
+  // Next evaluations: one evaluation per color.
+  x.setLinSpaced (n, 0.5, 1.5);
+  simpleJac = fdSimple.jacobian (x);
+  f->evaluations = 0;
+  coloringJac = fdColoring.jacobian (x);
+  BOOST_CHECK_EQUAL (f->evaluations, static_cast<size_t> (3 + 1));
+  BOOST_CHECK (allclose (toDense (simpleJac), toDense (coloringJac)));
+
+  // Known sparsity pattern: the full lower triangle is given, which leads to
+  // one color per column, but values are still correct.
+  pattern_t pattern (n, n);
+  for (size_type i = 0; i < n; ++i)
+    for (size_type j = 0; j <= i; ++j)
+      pattern.insert (i, j) = 1.;
+  for (size_type i = 0; i < n - 1; ++i)
+    pattern.insert (i, i + 1) = 1.;
+  fdColoring.setSparsityPattern (pattern);
+  BOOST_CHECK_EQUAL (fdColoring.colors (), n);
+  f->evaluations = 0;
+  coloringJac = fdColoring.jacobian (x);
+  BOOST_CHECK_EQUAL (f->evaluations, static_cast<size_t> (n + 1));
+  BOOST_CHECK (allclose (toDense (simpleJac), toDense (coloringJac)));
+
+  // Reset: the pattern is detected again.
+  fdColoring.resetSparsityPattern ();
+  BOOST_CHECK (!fdColoring.hasSparsityPattern ());
+  coloringJac = fdColoring.jacobian (x);
+  BOOST_CHECK_EQUAL (fdColoring.colors (), 3);
+  BOOST_CHECK (allclose (toDense (simpleJac), toDense (coloringJac)));
+}
+
+typedef boost::mpl::list<EigenMatrixDenseFloat,
+			 EigenMatrixSparseFloat> floatTypes_t;
+
+BOOST_AUTO_TEST_CASE_TEMPLATE (finite_difference_jacobian_coloring_float, T,
+			       floatTypes_t)
+{
+  typedef finiteDifferenceGradientPolicies::ColumnColoring<T> coloring_t;
+  typedef finiteDifferenceGradientPolicies::Simple<T> simple_t;
+  typedef GenericFiniteDifferenceGradient<T, coloring_t> fd_t;
+  typedef typename fd_t::size_type size_type;
+  typedef typename coloring_t::pattern_t pattern_t;
+
+  const size_type n = 20;
+  const typename fd_t::value_type epsilon = 1e-3f;
+
+  boost::shared_ptr<FBanded<T> > f = boost::make_shared<FBanded<T> > (n);
+  GenericFiniteDifferenceGradient<T, simple_t> fdSimple (f, epsilon);
+  fd_t fdColoring (f, epsilon);
+
+  typename fd_t::vector_t x (n);
+  x.setLinSpaced (n, -1., 2.);
+
+  // Detection of the sparsity pattern, then one evaluation per color.
+  typename fd_t::jacobian_t simpleJac = fdSimple.jacobian (x);
+  typename fd_t::jacobian_t coloringJac = fdColoring.jacobian (x);
+  BOOST_CHECK_EQUAL (fdColoring.colors (), 3);
+  BOOST_CHECK (toDense (simpleJac) == toDense (coloringJac));
+
+  f->evaluations = 0;
+  coloringJac = fdColoring.jacobian (x);
+  BOOST_CHECK_EQUAL (f->evaluations, static_cast<size_t> (3 + 1));
+  BOOST_CHECK (toDense (simpleJac) == toDense (coloringJac));
+
+  // The pattern has the precision of the function.
+  pattern_t pattern (n, n);
+  for (size_type i = 0; i < n; ++i)
+    pattern.insert (i, i) = 1.f;
+  fdColoring.setSparsityPattern (pattern);
+  BOOST_CHECK_EQUAL (fdColoring.colors (), 1);
+}
+
+// Compare the derivatives of FStiff computed with a finite difference
+// policy in single precision with the analytical ones.
+template <typename T, typename P>
+void checkFloatPolicy ()
+{
+  typedef GenericFiniteDifferenceGradient<T, P> fd_t;
+
+  boost::shared_ptr<FStiff<T> > f = boost::make_shared<FStiff<T> > ();
+  fd_t fd (f, 1e-3f);
+
+  typename fd_t::vector_t x (3);
+  x << 1.f, 2.f, 0.1f;
+
+  Eigen::MatrixXd expected (2, 3);
+  expected << 3., 4., 0.,
+    2., 1., 5. * std::exp (0.5);
+
+  typename fd_t::jacobian_t jac = fd.jacobian (x);
+  BOOST_CHECK (allclose (toDense (jac).template cast<double> (), expected,
+			 1e-2, 1e-2));
+
+  for (typename fd_t::size_type i = 0; i < 2; ++i)
+    {
+      typename fd_t::gradient_t grad = fd.gradient (x, i);
+      BOOST_CHECK (allclose (toDense (grad).template cast<double> (),
+			     expected.row (i), 1e-2, 1e-2));
+    }
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE (finite_difference_jacobian_policies_float, T,
+			       floatTypes_t)
+{
+  checkFloatPolicy<T, finiteDifferenceGradientPolicies::FivePointsRule<T> > ();
+  checkFloatPolicy<T, finiteDifferenceGradientPolicies::Parallel<T> > ();
+  checkFloatPolicy<T, finiteDifferenceGradientPolicies::Adaptive<T> > ();
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE (finite_difference_jacobian_parallel, T,
+			       functionTypes_t)
+{
+  typedef finiteDifferenceGradientPolicies::Parallel<T> parallel_t;
+  typedef finiteDifferenceGradientPolicies::Simple<T> simple_t;
+  typedef typename GenericFiniteDifferenceGradient<T>::size_type size_type;
+
+  const size_type n = 23;
+  const size_type m = 7;
+
+  boost::shared_ptr<FDense<T> > f = boost::make_shared<FDense<T> > (n, m);
+  GenericFiniteDifferenceGradient<T, simple_t> fdSimple (f);
+  GenericFiniteDifferenceGradient<T, parallel_t> fdParallel (f);
+  BOOST_CHECK (fdParallel.threads () > 0);
+
+  typename FDense<T>::vector_t x (n);
+  x.setLinSpaced (n, -1., 2.);
+
+  typename GenericFiniteDifferenceGradient<T, simple_t>::jacobian_t
+    simpleJac = fdSimple.jacobian (x);
+  typename GenericFiniteDifferenceGradient<T, simple_t>::gradient_t
+    simpleGrad = fdSimple.gradient (x, m - 1);
+
+  // Results do not depend on the number of threads, and are identical to
+  // the ones of the Simple policy.
+  for (size_t threads = 1; threads <= 4; ++threads)
+    {
+      fdParallel.setThreads (threads);
+      BOOST_CHECK_EQUAL (fdParallel.threads (), threads);
+
+      for (int k = 0; k < 3; ++k)
+	{
+	  typename GenericFiniteDifferenceGradient<T, parallel_t>::jacobian_t
+	    parallelJac = fdParallel.jacobian (x);
+	  typename GenericFiniteDifferenceGradient<T, parallel_t>::gradient_t
+	    parallelGrad = fdParallel.gradient (x, m - 1);
+
+	  BOOST_CHECK (toDense (simpleJac) == toDense (parallelJac));
+	  BOOST_CHECK (toDense (simpleGrad) == toDense (parallelGrad));
+	}
+    }
+}
+
+template <typename P>
+void checkReuseSparsityPattern ()
+{
+  typedef GenericFiniteDifferenceGradient<EigenMatrixSparse, P> fd_t;
+  typedef finiteDifferenceGradientPolicies::Simple<EigenMatrixSparse> simple_t;
+  typedef typename fd_t::size_type size_type;
+
+  const size_type n = 30;
+
+  boost::shared_ptr<FBanded<EigenMatrixSparse> > f =
+    boost::make_shared<FBanded<EigenMatrixSparse> > (n);
+  GenericFiniteDifferenceGradient<EigenMatrixSparse, simple_t> fdSimple (f);
+  fd_t fdReuse (f);
+  fdReuse.reuseSparsityPattern () = true;
+  fdReuse.sparseEpsilon () = 0.;
+
+  typename fd_t::vector_t x (n);
+  x.setLinSpaced (n, -1., 2.);
+
+  // First evaluation: the structure is computed and recorded.
+  typename fd_t::jacobian_t jac (n, n);
+  fdReuse.jacobian (jac, x);
+  BOOST_CHECK (jac.isCompressed ());
+  BOOST_CHECK_EQUAL (jac.nonZeros (), 3 * n - 3);
+  BOOST_CHECK (allclose (toDense (fdSimple.jacobian (x)), toDense (jac)));
+
+  // Next evaluations: the values are updated in place.
+  const typename fd_t::value_type* values = jac.valuePtr ();
+  const int* inner = jac.innerIndexPtr ();
+
+  for (int k = 0; k < 3; ++k)
+    {
+      x.setLinSpaced (n, 0.5 + k, 1.5 + 2. * k);
+
+      set_is_malloc_allowed (false);
+      fdReuse.jacobian (jac, x);
+      set_is_malloc_allowed (true);
+
+      BOOST_CHECK_EQUAL (jac.valuePtr (), values);
+      BOOST_CHECK_EQUAL (jac.innerIndexPtr (), inner);
+      BOOST_CHECK_EQUAL (jac.nonZeros (), 3 * n - 3);
+      BOOST_CHECK (allclose (toDense (fdSimple.jacobian (x)), toDense (jac)));
+    }
+
+  // A matrix with a different structure is filled as usual.
+  typename fd_t::jacobian_t other (n, n);
+  fdReuse.jacobian (other, x);
+  BOOST_CHECK_EQUAL (other.nonZeros (), 3 * n - 3);
+  BOOST_CHECK (allclose (toDense (jac), toDense (other)));
+}
+
+BOOST_AUTO_TEST_CASE (finite_difference_jacobian_reuse_pattern)
+{
+  checkReuseSparsityPattern<finiteDifferenceGradientPolicies::
+			    Simple<EigenMatrixSparse> > ();
+  checkReuseSparsityPattern<finiteDifferenceGradientPolicies::
+			    ColumnColoring<EigenMatrixSparse> > ();
+}
+
+BOOST_AUTO_TEST_CASE (finite_difference_jacobian_reuse_coloring_pattern)
+{
+  typedef finiteDifferenceGradientPolicies::ColumnColoring<EigenMatrixSparse>
+    coloring_t;
+  typedef GenericFiniteDifferenceGradient<EigenMatrixSparse, coloring_t> fd_t;
+  typedef coloring_t::pattern_t pattern_t;
+
+  boost::shared_ptr<FBanded<EigenMatrixSparse> > f =
+    boost::make_shared<FBanded<EigenMatrixSparse> > (3);
+  fd_t fdReuse (f);
+  fdReuse.reuseSparsityPattern () = true;
+  fd_t fdFresh (f);
+
+  fd_t::vector_t x (3);
+  x << 0.5, -1., 2.;
+
+  // Two patterns with the same rows, once sorted by column, but different
+  // columns.
+  pattern_t first (3, 3);
+  first.insert (0, 0) = 1.;
+  first.insert (1, 0) = 1.;
+  first.insert (1, 2) = 1.;
+  pattern_t second (3, 3);
+  second.insert (0, 0) = 1.;
+  second.insert (1, 1) = 1.;
+  second.insert (1, 2) = 1.;
+
+  fd_t::jacobian_t jac (3, 3);
+  fdReuse.setSparsityPattern (first);
+  fdReuse.jacobian (jac, x);
+
+  // The Jacobian recorded with the first pattern is not reused.
+  fdReuse.setSparsityPattern (second);
+  fdFresh.setSparsityPattern (second);
+  fdReuse.jacobian (jac, x);
+  BOOST_CHECK_EQUAL (jac.coeff (1, 0), 0.);
+  BOOST_CHECK (allclose (toDense (fdFresh.jacobian (x)), toDense (jac)));
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE (finite_difference_jacobian_adaptive, T,
+			       functionTypes_t)
+{
+  typedef finiteDifferenceGradientPolicies::Adaptive<T> adaptive_t;
+  typedef GenericFiniteDifferenceGradient<T, adaptive_t> fd_t;
+
+  boost::shared_ptr<FStiff<T> > f = boost::make_shared<FStiff<T> > ();
+  fd_t fd (f);
+
+  typename fd_t::vector_t x (3);
+  x << 1., 2., 1.;
+
+  GenericFunctionTraits<EigenMatrixDense>::matrix_t expected (2, 3);
+  expected << 3., 2. * x[1], 0.,
+    x[1], x[0], 5. * std::exp (5. * x[2]);
+
+  // First evaluation: the steps are chosen.
+  typename fd_t::jacobian_t jac = fd.jacobian (x);
+  BOOST_CHECK (allclose (toDense (jac), expected, 1e-6, 1e-6));
+
+  // Forward differences are accurate enough for the first inputs.
+  BOOST_CHECK (!fd.centralDifference (0));
+  BOOST_CHECK (!fd.centralDifference (1));
+  BOOST_CHECK (fd.centralDifference (2));
+  for (typename fd_t::size_type j = 0; j < 3; ++j)
+    {
+      BOOST_CHECK (fd.steps ()[j] > 0.);
+      BOOST_CHECK (fd.errors ()[j] > 0.);
+    }
+  BOOST_CHECK (fd.errors ()[0] <= fd.tolerance ());
+  BOOST_CHECK (fd.errors ()[1] <= fd.tolerance ());
+
+  // Next evaluations: the steps are reused, which costs one evaluation for
+  // f(x), one per forward difference and four per five-point rule.
+  typename fd_t::vector_t steps = fd.steps ();
+  f->evaluations = 0;
+  jac = fd.jacobian (x);
+  BOOST_CHECK_EQUAL (f->evaluations, static_cast<size_t> (1 + 1 + 1 + 4));
+  BOOST_CHECK (steps == fd.steps ());
+  BOOST_CHECK (allclose (toDense (jac), expected, 1e-6, 1e-6));
+
+  typename fd_t::gradient_t grad = fd.gradient (x, 1);
+  BOOST_CHECK (allclose (toDense (grad), expected.row (1), 1e-6, 1e-6));
+
+  // A lower tolerance leads to the five-point rule for all inputs.
+  fd.tolerance () = 0.;
+  fd.resetSteps ();
+  BOOST_CHECK (fd.steps ().isZero ());
+  jac = fd.jacobian (x);
+  for (typename fd_t::size_type j = 0; j < 3; ++j)
+    BOOST_CHECK (fd.centralDifference (j));
+  BOOST_CHECK (allclose (toDense (jac), expected, 1e-6, 1e-6));
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE (finite_difference_jacobian_complex_step, T,
+			       functionTypes_t)
+{
+  typedef finiteDifferenceGradientPolicies::ComplexStep<T> complexStep_t;
+  typedef finiteDifferenceGradientPolicies::Simple<T> simple_t;
+  typedef GenericFiniteDifferenceGradient<T, complexStep_t> fd_t;
+
+  boost::shared_ptr<GenericComplexStepFunction<T, StiffKernel> > f =
+    complexStepFunction<T> (StiffKernel (), 3, 2, "stiff");
+  fd_t fd (f);
+  GenericFiniteDifferenceGradient<T, simple_t> fdSimple (f);
+
+  typename fd_t::vector_t x (3);
+  x << 1., 2., 1.;
+  FStiff<T> stiff;
+  BOOST_CHECK (allclose (fd (x), stiff (x)));
+
+  GenericFunctionTraits<EigenMatrixDense>::matrix_t expected (2, 3);
+  expected << 3., 2. * x[1], 0.,
+    x[1], x[0], 5. * std::exp (5. * x[2]);
+
+  // Derivatives are accurate up to machine precision, contrary to
+  // forward differences.
+  typename fd_t::jacobian_t jac = fd.jacobian (x);
+  BOOST_CHECK (allclose (toDense (jac), expected, 1e-15, 0.));
+  BOOST_CHECK (!allclose (toDense (fdSimple.jacobian (x)), expected,
+			  1e-8, 0.));
+
+  for (typename fd_t::size_type i = 0; i < 2; ++i)
+    {
+      typename fd_t::gradient_t grad = fd.gradient (x, i);
+      BOOST_CHECK (allclose (toDense (grad), expected.row (i), 1e-15, 0.));
+    }
+
+  // The step does not need to be tuned.
+  fd.step () = 1e-100;
+  BOOST_CHECK (allclose (toDense (fd.jacobian (x)), expected, 1e-15, 0.));
+
+  // The wrapped function has to support complex arguments.
+  boost::shared_ptr<FStiff<T> > real = boost::make_shared<FStiff<T> > ();
+  BOOST_CHECK_THROW (fd_t fdReal (real), std::runtime_error);
+}
+
 BOOST_AUTO_TEST_SUITE_END ()
@@ -0,0 +1,99 @@
+// Copyright (C) 2026 by the RobOptim contributors.
+//
+// This file is part of the roboptim.
+//
+// roboptim is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// roboptim is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with roboptim.  If not, see <http://www.gnu.org/licenses/>.
+
+// The allocation checks are enabled whatever the build options, so that
+// the workers of the thread pool run under them.
+#undef ROBOPTIM_DO_NOT_CHECK_ALLOCATION
+#ifndef EIGEN_RUNTIME_NO_MALLOC
+# define EIGEN_RUNTIME_NO_MALLOC
+#endif //! EIGEN_RUNTIME_NO_MALLOC
+
+#include "shared-tests/fixture.hh"
+
+#include <boost/make_shared.hpp>
+
+#include <roboptim/core/decorator/finite-difference-gradient.hh>
+
+using namespace roboptim;
+
+// Dense function without any allocation in its evaluation.
+struct F : public Function
+{
+  F (size_type n, size_type m)
+    : Function (n, m, "sum_j sin ((i + 1) * x_j)")
+  {}
+
+  void impl_compute (result_ref result, const_argument_ref argument) const
+  {
+    for (size_type i = 0; i < outputSize (); ++i)
+      {
+	result[i] = 0.;
+	for (size_type j = 0; j < inputSize (); ++j)
+	  result[i] += std::sin (static_cast<double> (i + 1) * argument[j]);
+      }
+  }
+};
+
+BOOST_FIXTURE_TEST_SUITE (core, TestSuiteConfiguration)
+
+BOOST_AUTO_TEST_CASE (finite_difference_parallel_allocation)
+{
+  typedef finiteDifferenceGradientPolicies::Parallel<EigenMatrixDense>
+    parallel_t;
+  typedef finiteDifferenceGradientPolicies::Simple<EigenMatrixDense>
+    simple_t;
+  typedef GenericFiniteDifferenceGradient<EigenMatrixDense, parallel_t>
+    fdParallel_t;
+
+  const F::size_type n = 23;
+  const F::size_type m = 7;
+
+  boost::shared_ptr<F> f = boost::make_shared<F> (n, m);
+  GenericFiniteDifferenceGradient<EigenMatrixDense, simple_t> fdSimple (f);
+  fdParallel_t fdParallel (f);
+
+  F::vector_t x (n);
+  x.setLinSpaced (n, -1., 2.);
+
+  fdParallel_t::jacobian_t simpleJac = fdSimple.jacobian (x);
+  fdParallel_t::gradient_t simpleGrad = fdSimple.gradient (x, m - 1);
+
+  fdParallel_t::jacobian_t jac (m, n);
+  fdParallel_t::gradient_t grad (n);
+
+  for (size_t threads = 2; threads <= 4; ++threads)
+    {
+      fdParallel.setThreads (threads);
+
+      // The evaluations do not allocate, in any of the threads.
+      for (int k = 0; k < 3; ++k)
+	{
+	  jac.setZero ();
+	  grad.setZero ();
+	  fdParallel.jacobian (jac, x);
+	  fdParallel.gradient (grad, x, m - 1);
+
+	  BOOST_CHECK (jac == simpleJac);
+	  BOOST_CHECK (grad == simpleGrad);
+	}
+    }
+
+  // The flag of the calling thread is restored.
+  BOOST_CHECK (is_malloc_allowed ());
+}
+
+BOOST_AUTO_TEST_SUITE_END ()
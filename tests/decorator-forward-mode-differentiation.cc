@@ -0,0 +1,116 @@
+// Copyright (C) 2026 by the RobOptim contributors.
+//
+// This file is part of the roboptim.
+//
+// roboptim is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// roboptim is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with roboptim.  If not, see <http://www.gnu.org/licenses/>.
+
+#include <cmath>
+
+#include <boost/mpl/list.hpp>
+
+#include "shared-tests/fixture.hh"
+
+#include <boost/test/test_case_template.hpp>
+
+#include <roboptim/core/io.hh>
+#include <roboptim/core/util.hh>
+#include <roboptim/core/decorator/forward-mode-differentiation.hh>
+
+using namespace roboptim;
+
+
+typedef boost::mpl::list< ::roboptim::EigenMatrixDense,
+			  ::roboptim::EigenMatrixSparse> functionTypes_t;
+
+// f(x) = (x0 sin(x1) + exp(x2), x0 x3 x4, sqrt(x4^2 + 1))
+struct Kernel
+{
+  template <typename R, typename A>
+  void operator () (R& result, const A& x) const
+  {
+    using std::sin;
+    using std::exp;
+    using std::sqrt;
+
+    result[0] = x[0] * sin (x[1]) + exp (x[2]);
+    result[1] = x[0] * x[3] * x[4];
+    result[2] = sqrt (x[4] * x[4] + 1.);
+  }
+};
+
+template <typename M, typename V>
+void expectedJacobian (M& jac, const V& x)
+{
+  jac.setZero ();
+  jac (0, 0) = std::sin (x[1]);
+  jac (0, 1) = x[0] * std::cos (x[1]);
+  jac (0, 2) = std::exp (x[2]);
+  jac (1, 0) = x[3] * x[4];
+  jac (1, 3) = x[0] * x[4];
+  jac (1, 4) = x[0] * x[3];
+  jac (2, 4) = x[4] / std::sqrt (x[4] * x[4] + 1.);
+}
+
+template <typename F>
+void checkFunction (const F& f)
+{
+  typedef typename F::argument_t argument_t;
+  typedef typename F::jacobian_t jacobian_t;
+  typedef typename F::result_t result_t;
+
+  Eigen::MatrixXd expected (3, 5);
+
+  argument_t x (5);
+  for (int i = 0; i < 10; ++i)
+    {
+      x.setRandom ();
+      expectedJacobian (expected, x);
+
+      // Derivatives are exact, up to rounding errors.
+      BOOST_CHECK (allclose (toDense (f.jacobian (x)), expected, 1e-12));
+      for (typename F::size_type j = 0; j < f.outputSize (); ++j)
+	BOOST_CHECK (allclose (toDense (f.gradient (x, j)),
+			       Eigen::MatrixXd (expected.row (j)), 1e-12));
+
+      // Fused evaluation.
+      result_t res (f.outputSize ());
+      jacobian_t jac (f.outputSize (), f.inputSize ());
+      f.valueAndJacobian (res, jac, x);
+      BOOST_CHECK (allclose (res, f (x)));
+      BOOST_CHECK (allclose (toDense (jac), expected, 1e-12));
+    }
+
+  // Structural zeros are not stored.
+  BOOST_CHECK_EQUAL (f.jacobian (x).nonZeros (),
+		     StorageTraits<typename F::traits_t>::isDense? 15 : 7);
+}
+
+BOOST_FIXTURE_TEST_SUITE (core, TestSuiteConfiguration)
+
+BOOST_AUTO_TEST_CASE_TEMPLATE (forward_mode_differentiation, T,
+			       functionTypes_t)
+{
+  // Default number of directions: two sweeps, the second one partial.
+  boost::shared_ptr<GenericForwardModeDifferentiation<T, Kernel> > f =
+    forwardModeDifferentiation<T> (Kernel (), 5, 3, "kernel");
+  checkFunction (*f);
+
+  // One direction per sweep, and all the directions in a single sweep.
+  checkFunction (GenericForwardModeDifferentiation<T, Kernel, 1>
+		 (Kernel (), 5, 3));
+  checkFunction (GenericForwardModeDifferentiation<T, Kernel, 8>
+		 (Kernel (), 5, 3));
+}
+
+BOOST_AUTO_TEST_SUITE_END ()
@@ -0,0 +1,276 @@
+// Copyright (C) 2026 by the RobOptim contributors.
+//
+// This file is part of the roboptim.
+//
+// roboptim is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// roboptim is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with roboptim.  If not, see <http://www.gnu.org/licenses/>.
+
+#include <cmath>
+
+#include <boost/mpl/list.hpp>
+#include <boost/thread/thread.hpp>
+
+#include "shared-tests/fixture.hh"
+
+#include <boost/test/test_case_template.hpp>
+
+#include <roboptim/core/io.hh>
+#include <roboptim/core/operator/chain.hh>
+#include <roboptim/core/operator/minus.hh>
+#include <roboptim/core/operator/plus.hh>
+#include <roboptim/core/operator/product.hh>
+#include <roboptim/core/decorator/function-graph.hh>
+
+using namespace roboptim;
+
+
+typedef boost::mpl::list< ::roboptim::EigenMatrixDense,
+			  ::roboptim::EigenMatrixSparse> functionTypes_t;
+
+// x -> (sin (x0) x1 + a, x0 + a x1^2), counting its evaluations.
+template <typename T>
+struct Counted : public GenericDifferentiableFunction<T>
+{
+  ROBOPTIM_DIFFERENTIABLE_FUNCTION_FWD_TYPEDEFS_
+  (GenericDifferentiableFunction<T>);
+
+  explicit Counted (value_type a)
+    : GenericDifferentiableFunction<T> (2, 2, "counted"),
+      a_ (a),
+      computes (0),
+      gradients (0)
+  {}
+
+  void impl_compute (result_ref result, const_argument_ref x) const
+  {
+    ++computes;
+    result[0] = std::sin (x[0]) * x[1] + a_;
+    result[1] = x[0] + a_ * x[1] * x[1];
+  }
+
+  void impl_gradient (gradient_ref gradient, const_argument_ref x,
+		      size_type functionId) const
+  {
+    ++gradients;
+    if (functionId == 0)
+      {
+	gradient.coeffRef (0) = std::cos (x[0]) * x[1];
+	gradient.coeffRef (1) = std::sin (x[0]);
+      }
+    else
+      {
+	gradient.coeffRef (0) = 1.;
+	gradient.coeffRef (1) = 2. * a_ * x[1];
+      }
+  }
+
+  void reset ()
+  {
+    computes = 0;
+    gradients = 0;
+  }
+
+  value_type a_;
+  mutable size_type computes;
+  mutable size_type gradients;
+};
+
+BOOST_FIXTURE_TEST_SUITE (core, TestSuiteConfiguration)
+
+BOOST_AUTO_TEST_CASE_TEMPLATE (function_graph, T, functionTypes_t)
+{
+  typedef GenericDifferentiableFunction<T> function_t;
+  typedef GenericFunctionGraph<T> graph_t;
+
+  boost::shared_ptr<Counted<T> > f = boost::make_shared<Counted<T> > (1.);
+  boost::shared_ptr<Counted<T> > g = boost::make_shared<Counted<T> > (2.);
+  boost::shared_ptr<Counted<T> > h = boost::make_shared<Counted<T> > (3.);
+
+  // e = s + s * h, with s = f - g shared.
+  boost::shared_ptr<function_t> s =
+    minus<function_t, function_t> (f, g);
+  boost::shared_ptr<function_t> e =
+    plus<function_t, function_t>
+    (s, product<function_t, function_t> (s, h));
+
+  boost::shared_ptr<graph_t> graph = functionGraph<T> (e);
+
+  BOOST_CHECK_EQUAL (graph->nodes (), 6);
+  BOOST_REQUIRE_EQUAL (graph->sharedNodes ().size (), 1);
+  BOOST_CHECK (graph->sharedNodes ()[0] == s.get ());
+
+  // The graph evaluates its own copy of the operators: the expression
+  // is left untouched, and can belong to several graphs.
+  typename detail::GenericExpressionNode<T>::children_t children;
+  detail::GraphTraversal::children (*e, children);
+  BOOST_REQUIRE_EQUAL (children.size (), 2);
+  BOOST_CHECK (children[0] == s.get ());
+  boost::shared_ptr<graph_t> other = functionGraph<T> (e);
+  BOOST_CHECK_EQUAL (other->nodes (), 6);
+
+  typename function_t::argument_t x (2);
+  typename function_t::result_t expected (2);
+  typename function_t::result_t result (2);
+  typename function_t::jacobian_t expectedJacobian (2, 2);
+  typename function_t::jacobian_t jacobian (2, 2);
+
+  for (int i = 0; i < 5; ++i)
+    {
+      x[0] = 0.3 * i - 0.5;
+      x[1] = 1.2 - 0.2 * i;
+
+      // Outside of the graph, the shared node is evaluated twice.
+      f->reset ();
+      expected = (*e) (x);
+      BOOST_CHECK_EQUAL (f->computes, 2);
+
+      f->reset ();
+      expectedJacobian = e->jacobian (x);
+      BOOST_CHECK_EQUAL (f->gradients, 4);
+
+      // The graph only evaluates it once.
+      f->reset ();
+      (*graph) (result, x);
+      BOOST_CHECK_EQUAL (f->computes, 1);
+      BOOST_CHECK (allclose (result, expected));
+
+      f->reset ();
+      jacobian = graph->jacobian (x);
+      BOOST_CHECK_EQUAL (f->gradients, 2);
+      BOOST_CHECK (allclose (jacobian, expectedJacobian));
+
+      f->reset ();
+      result.setZero ();
+      graph->valueAndJacobian (result, jacobian, x);
+      BOOST_CHECK_EQUAL (f->computes, 1);
+      BOOST_CHECK_EQUAL (f->gradients, 2);
+      BOOST_CHECK (allclose (result, expected));
+      BOOST_CHECK (allclose (jacobian, expectedJacobian));
+
+      // Gradients are read from the memoized jacobian.
+      for (typename function_t::size_type k = 0; k < 2; ++k)
+	BOOST_CHECK (allclose (graph->gradient (x, k),
+			       e->gradient (x, k)));
+    }
+  BOOST_CHECK (graph->memoHits () > 0);
+
+  f->reset ();
+  BOOST_CHECK (allclose ((*other) (x), expected));
+  BOOST_CHECK_EQUAL (f->computes, 1);
+}
+
+template <typename F>
+struct Evaluate
+{
+  Evaluate (const F& f, const typename F::argument_t& x,
+	    typename F::result_t& result)
+    : f_ (f), x_ (x), result_ (result)
+  {}
+
+  void operator () ()
+  {
+    for (int i = 0; i < 100; ++i)
+      f_ (result_, x_);
+  }
+
+  const F& f_;
+  const typename F::argument_t& x_;
+  typename F::result_t& result_;
+};
+
+BOOST_AUTO_TEST_CASE (function_graph_threads)
+{
+  typedef DifferentiableFunction function_t;
+
+  boost::shared_ptr<Counted<EigenMatrixDense> > f =
+    boost::make_shared<Counted<EigenMatrixDense> > (1.);
+  boost::shared_ptr<Counted<EigenMatrixDense> > g =
+    boost::make_shared<Counted<EigenMatrixDense> > (2.);
+
+  boost::shared_ptr<function_t> s = minus<function_t, function_t> (f, g);
+  boost::shared_ptr<function_t> e =
+    plus<function_t, function_t> (s, product<function_t, function_t> (s, s));
+  boost::shared_ptr<FunctionGraph> graph = functionGraph (e);
+
+  function_t::argument_t x (2);
+  x << 0.4, -0.7;
+  function_t::argument_t y (2);
+  y << -1.1, 0.3;
+  function_t::result_t expectedX = (*e) (x);
+  function_t::result_t expectedY = (*e) (y);
+
+  // The graph and the expression are evaluated concurrently: only the
+  // thread evaluating the graph uses the memos.
+  function_t::result_t resultGraph (2);
+  function_t::result_t resultExpression (2);
+  boost::thread tGraph
+    (Evaluate<FunctionGraph> (*graph, x, resultGraph));
+  boost::thread tExpression
+    (Evaluate<function_t> (*e, y, resultExpression));
+  tGraph.join ();
+  tExpression.join ();
+
+  BOOST_CHECK (allclose (resultGraph, expectedX));
+  BOOST_CHECK (allclose (resultExpression, expectedY));
+}
+
+BOOST_AUTO_TEST_CASE (function_graph_chain)
+{
+  typedef DifferentiableFunction function_t;
+  typedef Chain<function_t, function_t> chain_t;
+
+  boost::shared_ptr<Counted<EigenMatrixDense> > f =
+    boost::make_shared<Counted<EigenMatrixDense> > (1.);
+  boost::shared_ptr<Counted<EigenMatrixDense> > g =
+    boost::make_shared<Counted<EigenMatrixDense> > (2.);
+  boost::shared_ptr<Counted<EigenMatrixDense> > h =
+    boost::make_shared<Counted<EigenMatrixDense> > (3.);
+
+  // e = c + c * h, with c = f o g shared.
+  boost::shared_ptr<function_t> c =
+    chain<function_t, function_t> (f, g);
+  boost::static_pointer_cast<chain_t> (c)->cacheRightJacobian () = true;
+  boost::shared_ptr<function_t> e =
+    plus<function_t, function_t>
+    (c, product<function_t, function_t> (c, h));
+
+  boost::shared_ptr<FunctionGraph> graph = functionGraph (e);
+  BOOST_REQUIRE_EQUAL (graph->sharedNodes ().size (), 1);
+  BOOST_CHECK (graph->sharedNodes ()[0] == c.get ());
+
+  function_t::argument_t x (2);
+  x << 0.4, -0.7;
+
+  f->reset ();
+  g->reset ();
+  function_t::result_t expected = (*e) (x);
+  function_t::jacobian_t expectedJacobian = e->jacobian (x);
+
+  f->reset ();
+  g->reset ();
+  BOOST_CHECK (allclose ((*graph) (x), expected));
+  BOOST_CHECK_EQUAL (f->computes, 1);
+  BOOST_CHECK_EQUAL (g->computes, 1);
+
+  f->reset ();
+  g->reset ();
+  BOOST_CHECK (allclose (graph->jacobian (x), expectedJacobian));
+  BOOST_CHECK_EQUAL (f->gradients, 2);
+  BOOST_CHECK_EQUAL (g->gradients, 2);
+
+  // The right jacobian cache of the chain does not interfere.
+  boost::static_pointer_cast<chain_t> (c)->cacheRightJacobian () = false;
+  BOOST_CHECK (allclose (graph->jacobian (x), expectedJacobian));
+}
+
+BOOST_AUTO_TEST_SUITE_END ()
@@ -0,0 +1,106 @@
+// Copyright (C) 2026 by the RobOptim contributors.
+//
+// This file is part of the roboptim.
+//
+// roboptim is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// roboptim is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with roboptim.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "shared-tests/fixture.hh"
+
+#include <boost/make_shared.hpp>
+
+#include <roboptim/core/differentiable-function.hh>
+#include <roboptim/core/decorator/in-place-jacobian.hh>
+
+using namespace roboptim;
+
+// Sparse function whose last entry only exists for positive x[0].
+struct Banded : public DifferentiableSparseFunction
+{
+  Banded (size_type n) : DifferentiableSparseFunction (n, n, "banded")
+  {}
+
+  void impl_compute (result_ref res, const_argument_ref x) const
+  {
+    for (size_type i = 0; i < outputSize (); ++i)
+      res[i] = x[i] * x[i];
+    if (x[0] > 0.)
+      res[outputSize () - 1] += x[0] * x[0];
+  }
+
+  void impl_gradient (gradient_ref grad, const_argument_ref x,
+		      size_type functionId) const
+  {
+    if (functionId == outputSize () - 1 && x[0] > 0.)
+      grad.insert (0) = 2. * x[0];
+    grad.insert (functionId) = 2. * x[functionId];
+  }
+};
+
+BOOST_FIXTURE_TEST_SUITE (core, TestSuiteConfiguration)
+
+BOOST_AUTO_TEST_CASE (in_place_jacobian)
+{
+  const Banded::size_type n = 5;
+  boost::shared_ptr<Banded> origin = boost::make_shared<Banded> (n);
+  boost::shared_ptr<InPlaceJacobian<EigenMatrixSparse> > f =
+    inPlaceJacobian (origin);
+
+  Banded::argument_t x (n);
+  x << -1., 2., 3., 4., 5.;
+
+  BOOST_CHECK ((*f) (x) == (*origin) (x));
+
+  // First call: the jacobian is assembled from scratch.
+  Banded::jacobian_t jac (n, n);
+  f->jacobian (jac, x);
+  BOOST_CHECK_EQUAL (jac.nonZeros (), n);
+  BOOST_CHECK_EQUAL (f->structureChanges (), 0);
+
+  // Same structure: the values are updated in place.
+  const double* values = jac.valuePtr ();
+  x << -2., 1., 1., 1., 1.;
+  f->jacobian (jac, x);
+  BOOST_CHECK_EQUAL (jac.valuePtr (), values);
+  BOOST_CHECK (jac.isApprox (origin->jacobian (x)));
+  BOOST_CHECK_EQUAL (f->structureChanges (), 0);
+
+  // New entry: the change is detected and the jacobian is rebuilt.
+  x[0] = 1.;
+  f->jacobian (jac, x);
+  BOOST_CHECK_EQUAL (jac.nonZeros (), n + 1);
+  BOOST_CHECK (jac.isApprox (origin->jacobian (x)));
+  BOOST_CHECK_EQUAL (f->structureChanges (), 1);
+
+  // Missing entry: the structure is kept and the entry is set to zero.
+  x[0] = -1.;
+  f->jacobian (jac, x);
+  BOOST_CHECK_EQUAL (jac.nonZeros (), n + 1);
+  BOOST_CHECK_EQUAL (jac.coeff (n - 1, 0), 0.);
+  BOOST_CHECK (jac.isApprox (origin->jacobian (x)));
+  BOOST_CHECK_EQUAL (f->structureChanges (), 1);
+
+  // The structure query can be used to preallocate the jacobian.
+  Banded::jacobian_t full = f->jacobianStructure ();
+  f->jacobian (full, x);
+  BOOST_CHECK_EQUAL (full.nonZeros (), n * n);
+  BOOST_CHECK (full.isApprox (origin->jacobian (x)));
+  BOOST_CHECK_EQUAL (f->structureChanges (), 1);
+
+  // The wrapped function keeps assembling the jacobian from scratch.
+  Banded::jacobian_t fresh = f->jacobianStructure ();
+  origin->jacobian (fresh, x);
+  BOOST_CHECK_EQUAL (fresh.nonZeros (), n);
+}
+
+BOOST_AUTO_TEST_SUITE_END ()
@@ -0,0 +1,201 @@
+// Copyright (C) 2026 by the RobOptim contributors.
+//
+// This file is part of the roboptim.
+//
+// roboptim is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// roboptim is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with roboptim.  If not, see <http://www.gnu.org/licenses/>.
+
+#include <cmath>
+
+#include <boost/mpl/list.hpp>
+
+#include "shared-tests/fixture.hh"
+
+#include <boost/test/test_case_template.hpp>
+
+#include <roboptim/core/io.hh>
+#include <roboptim/core/function/cos.hh>
+#include <roboptim/core/function/identity.hh>
+#include <roboptim/core/function/sin.hh>
+#include <roboptim/core/operator/bind.hh>
+#include <roboptim/core/operator/chain.hh>
+#include <roboptim/core/operator/concatenate.hh>
+#include <roboptim/core/operator/map.hh>
+#include <roboptim/core/operator/minus.hh>
+#include <roboptim/core/operator/plus.hh>
+#include <roboptim/core/operator/product.hh>
+#include <roboptim/core/operator/scalar.hh>
+#include <roboptim/core/operator/selection.hh>
+#include <roboptim/core/operator/selection-by-id.hh>
+#include <roboptim/core/decorator/precision-adapter.hh>
+
+using namespace roboptim;
+
+
+typedef boost::mpl::list< ::roboptim::EigenMatrixDense,
+			  ::roboptim::EigenMatrixSparse> functionTypes_t;
+
+// x -> (2 cos (x0) (x1 + b) - sin (x0), x0 + a, x1 + b, cos (x0),
+//       cos (x1)), built with most operators.
+template <typename T>
+boost::shared_ptr<GenericDifferentiableFunction<T> > operators ()
+{
+  typedef GenericDifferentiableFunction<T> function_t;
+  typedef boost::shared_ptr<function_t> functionShPtr_t;
+
+  typename function_t::vector_t offset (2);
+  offset << 0.1f, -0.2f;
+  functionShPtr_t id =
+    boost::make_shared<GenericIdentityFunction<T> > (offset);
+
+  std::vector<bool> selector (2, false);
+  selector[1] = true;
+  functionShPtr_t x1 = selectionById (id, selector);
+
+  functionShPtr_t cos = map (boost::make_shared<Cos<T> > (), 2);
+  functionShPtr_t sin = map (boost::make_shared<Sin<T> > (), 2);
+  functionShPtr_t cos0 = selection (cos, 0, 1);
+  functionShPtr_t sin0 = selection (sin, 0, 1);
+  functionShPtr_t p =
+    boost::make_shared<Scalar<function_t> > (product (cos0, x1), 2.f);
+
+  functionShPtr_t cat = concatenate (minus (p, sin0), id);
+  return concatenate (cat, cos);
+}
+
+// x -> cos (x0 + a), dense only: Chain does not support sparse functions.
+template <typename T>
+boost::shared_ptr<GenericDifferentiableFunction<T> > chainOperator ()
+{
+  typedef GenericDifferentiableFunction<T> function_t;
+  typedef boost::shared_ptr<function_t> functionShPtr_t;
+
+  typename function_t::vector_t offset (2);
+  offset << 0.1f, -0.2f;
+  functionShPtr_t id =
+    boost::make_shared<GenericIdentityFunction<T> > (offset);
+
+  functionShPtr_t cos = boost::make_shared<Cos<T> > ();
+  functionShPtr_t x0 = selection (id, 0, 1);
+  return chain (cos, x0);
+}
+
+typedef boost::mpl::list< ::roboptim::EigenMatrixDenseFloat,
+			  ::roboptim::EigenMatrixSparseFloat> floatTypes_t;
+
+BOOST_FIXTURE_TEST_SUITE (core, TestSuiteConfiguration)
+
+BOOST_AUTO_TEST_CASE_TEMPLATE (precision_adapter, T, functionTypes_t)
+{
+  typedef GenericDifferentiableFunction<T> function_t;
+  typedef typename StorageTraits<T>::singlePrecision_t floatTraits_t;
+  typedef GenericDifferentiableFunction<floatTraits_t> floatFunction_t;
+
+  // f(x) = cos(x) + sin(x), in double precision.
+  boost::shared_ptr<function_t> f =
+    plus (boost::make_shared<Cos<T> > (), boost::make_shared<Sin<T> > ());
+
+  // Same function, in single precision.
+  boost::shared_ptr<floatFunction_t> g = toSinglePrecision (f);
+  BOOST_CHECK_EQUAL (g->inputSize (), f->inputSize ());
+  BOOST_CHECK_EQUAL (g->outputSize (), f->outputSize ());
+
+  // Operators work on single-precision functions: h(x) = f(x) + cos(x),
+  // converted back to double precision.
+  boost::shared_ptr<function_t> h =
+    toDoublePrecision (plus (g, boost::make_shared<Cos<floatTraits_t> > ()));
+
+  typename function_t::argument_t x (1);
+  typename floatFunction_t::argument_t xf (1);
+
+  for (int i = -5; i <= 5; ++i)
+    {
+      x[0] = 0.3 * i;
+      xf[0] = static_cast<float> (x[0]);
+
+      BOOST_CHECK_SMALL ((*g) (xf)[0] - static_cast<float> ((*f) (x)[0]),
+			 1e-6f);
+      BOOST_CHECK_SMALL (g->gradient (xf, 0).coeff (0)
+			 - static_cast<float> (f->gradient (x, 0).coeff (0)),
+			 1e-6f);
+
+      BOOST_CHECK_SMALL ((*h) (x)[0] - (2. * std::cos (x[0]) + std::sin (x[0])),
+			 1e-5);
+      BOOST_CHECK_SMALL (h->jacobian (x).coeff (0, 0)
+			 - (-2. * std::sin (x[0]) + std::cos (x[0])),
+			 1e-5);
+    }
+
+  // Sparsity patterns do not depend on the precision.
+  BOOST_CHECK_EQUAL (h->jacobianStructure ().nonZeros (), 1);
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE (float_operators, T, floatTypes_t)
+{
+  typedef typename StorageTraits<T>::doublePrecision_t doubleTraits_t;
+  typedef GenericDifferentiableFunction<T> function_t;
+  typedef GenericDifferentiableFunction<doubleTraits_t> doubleFunction_t;
+
+  boost::shared_ptr<function_t> f = operators<T> ();
+  boost::shared_ptr<doubleFunction_t> g = operators<doubleTraits_t> ();
+  BOOST_REQUIRE_EQUAL (f->inputSize (), 2);
+  BOOST_REQUIRE_EQUAL (f->outputSize (), 5);
+
+  typename function_t::argument_t x (2);
+  typename doubleFunction_t::argument_t xd (2);
+
+  for (int i = -3; i <= 3; ++i)
+    {
+      x << 0.3f * static_cast<float> (i), 0.5f - 0.2f * static_cast<float> (i);
+      xd = x.template cast<double> ();
+
+      typename function_t::result_t result = (*f) (x);
+      typename doubleFunction_t::result_t expected = (*g) (xd);
+      BOOST_CHECK ((result.template cast<double> () - expected)
+		   .template lpNorm<Eigen::Infinity> () < 1e-5);
+
+      Eigen::MatrixXd jacobian =
+	toDense (f->jacobian (x)).template cast<double> ();
+      Eigen::MatrixXd expectedJacobian = toDense (g->jacobian (xd));
+      BOOST_CHECK ((jacobian - expectedJacobian)
+		   .template lpNorm<Eigen::Infinity> () < 1e-5);
+    }
+
+  // Bound arguments, in single precision.
+  typename Bind<function_t>::boundValues_t bound (2);
+  bound[1] = 0.5f;
+  boost::shared_ptr<function_t> b = roboptim::bind<function_t> (f, bound);
+  typename function_t::argument_t y (1);
+  y << 0.3f;
+  x << 0.3f, 0.5f;
+  BOOST_CHECK ((*b) (y) == (*f) (x));
+}
+
+BOOST_AUTO_TEST_CASE (float_chain)
+{
+  typedef GenericDifferentiableFunction<EigenMatrixDenseFloat> function_t;
+
+  boost::shared_ptr<function_t> f = chainOperator<EigenMatrixDenseFloat> ();
+  boost::shared_ptr<DifferentiableFunction> g =
+    chainOperator<EigenMatrixDense> ();
+
+  function_t::argument_t x (2);
+  x << 0.4f, -0.3f;
+  Function::argument_t xd = x.cast<double> ();
+
+  BOOST_CHECK_SMALL (static_cast<double> ((*f) (x)[0]) - (*g) (xd)[0], 1e-6);
+  BOOST_CHECK_SMALL (static_cast<double> (f->gradient (x, 0)[0])
+		     - g->gradient (xd, 0)[0], 1e-6);
+}
+
+BOOST_AUTO_TEST_SUITE_END ()
@@ -0,0 +1,228 @@
+// Copyright (C) 2026 by the RobOptim contributors.
+//
+// This file is part of the roboptim.
+//
+// roboptim is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// roboptim is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with roboptim.  If not, see <http://www.gnu.org/licenses/>.
+
+#include <cmath>
+
+#include <boost/mpl/list.hpp>
+
+#include "shared-tests/fixture.hh"
+
+#include <boost/test/test_case_template.hpp>
+
+#include <roboptim/core/io.hh>
+#include <roboptim/core/util.hh>
+#include <roboptim/core/decorator/reverse-mode-differentiation.hh>
+
+using namespace roboptim;
+
+
+typedef boost::mpl::list< ::roboptim::EigenMatrixDense,
+			  ::roboptim::EigenMatrixSparse> functionTypes_t;
+
+// f(x) = (x0 sin(x1) + exp(x2), x0 x3 x4, sqrt(x4^2 + 1))
+struct Kernel
+{
+  template <typename R, typename A>
+  void operator () (R& result, const A& x) const
+  {
+    using std::sin;
+    using std::exp;
+    using std::sqrt;
+
+    result[0] = x[0] * sin (x[1]) + exp (x[2]);
+    result[1] = x[0] * x[3] * x[4];
+    result[2] = sqrt (x[4] * x[4] + 1.);
+  }
+};
+
+template <typename M, typename V>
+void expectedJacobian (M& jac, const V& x)
+{
+  jac.setZero ();
+  jac (0, 0) = std::sin (x[1]);
+  jac (0, 1) = x[0] * std::cos (x[1]);
+  jac (0, 2) = std::exp (x[2]);
+  jac (1, 0) = x[3] * x[4];
+  jac (1, 3) = x[0] * x[4];
+  jac (1, 4) = x[0] * x[3];
+  jac (2, 4) = x[4] / std::sqrt (x[4] * x[4] + 1.);
+}
+
+// Extended Rosenbrock function: a scalar objective with many inputs.
+struct Rosenbrock
+{
+  template <typename R, typename A>
+  void operator () (R& result, const A& x) const
+  {
+    typedef typename A::Scalar scalar_t;
+
+    scalar_t sum = 0.;
+    for (typename A::Index i = 0; i + 1 < x.size (); ++i)
+      {
+	const scalar_t a = x[i + 1] - x[i] * x[i];
+	const scalar_t b = 1. - x[i];
+	sum += 100. * a * a + b * b;
+      }
+    result[0] = sum;
+  }
+};
+
+template <typename V>
+Eigen::VectorXd rosenbrockGradient (const V& x)
+{
+  Eigen::VectorXd g = Eigen::VectorXd::Zero (x.size ());
+  for (int i = 0; i + 1 < x.size (); ++i)
+    {
+      const double a = x[i + 1] - x[i] * x[i];
+      g[i] += -400. * x[i] * a - 2. * (1. - x[i]);
+      g[i + 1] += 200. * a;
+    }
+  return g;
+}
+
+// f(x) = |x0| x1 + (x1 > 0.5 ? x1^3 : 1 / x1), written with branches.
+struct Branching
+{
+  template <typename R, typename A>
+  void operator () (R& result, const A& x) const
+  {
+    using std::pow;
+
+    if (x[0] < 0.)
+      result[0] = -x[0] * x[1];
+    else
+      result[0] = x[0] * x[1];
+
+    if (0.5 < x[1])
+      result[0] += pow (x[1], 3.);
+    else
+      result[0] += 1. / x[1];
+  }
+};
+
+template <typename F>
+void checkFunction (const F& f)
+{
+  typedef typename F::argument_t argument_t;
+  typedef typename F::jacobian_t jacobian_t;
+  typedef typename F::result_t result_t;
+
+  Eigen::MatrixXd expected (3, 5);
+
+  argument_t x (5);
+  for (int i = 0; i < 10; ++i)
+    {
+      x.setRandom ();
+      expectedJacobian (expected, x);
+
+      // Derivatives are exact, up to rounding errors.
+      BOOST_CHECK (allclose (toDense (f.jacobian (x)), expected, 1e-12));
+      for (typename F::size_type j = 0; j < f.outputSize (); ++j)
+	BOOST_CHECK (allclose (toDense (f.gradient (x, j)),
+			       Eigen::MatrixXd (expected.row (j)), 1e-12));
+
+      // Fused evaluation.
+      result_t res (f.outputSize ());
+      jacobian_t jac (f.outputSize (), f.inputSize ());
+      f.valueAndJacobian (res, jac, x);
+      BOOST_CHECK (allclose (res, f (x)));
+      BOOST_CHECK (allclose (toDense (jac), expected, 1e-12));
+    }
+
+  // Structural zeros are not stored.
+  BOOST_CHECK_EQUAL (f.jacobian (x).nonZeros (),
+		     StorageTraits<typename F::traits_t>::isDense? 15 : 7);
+
+  // No control flow: the tape is recorded once and replayed afterwards.
+  BOOST_CHECK_EQUAL (f.recordings (), 1);
+}
+
+BOOST_FIXTURE_TEST_SUITE (core, TestSuiteConfiguration)
+
+BOOST_AUTO_TEST_CASE_TEMPLATE (reverse_mode_differentiation, T,
+			       functionTypes_t)
+{
+  boost::shared_ptr<GenericReverseModeDifferentiation<T, Kernel> > f =
+    reverseModeDifferentiation<T> (Kernel (), 5, 3, "kernel");
+  checkFunction (*f);
+
+  // Vector-jacobian product: a single reverse sweep.
+  typename GenericFunction<T>::vector_t w (3);
+  w << 1., -2., 0.5;
+  Eigen::MatrixXd expected (3, 5);
+  typename GenericFunction<T>::argument_t y (5);
+  y.setRandom ();
+  expectedJacobian (expected, y);
+  BOOST_CHECK (allclose (toDense (f->vectorJacobianProduct (y, w)),
+			 Eigen::MatrixXd (w.transpose () * expected), 1e-12));
+  BOOST_CHECK_EQUAL (f->recordings (), 1);
+
+  // Scalar objective with many inputs: one reverse sweep per gradient.
+  const int n = 100;
+  GenericReverseModeDifferentiation<T, Rosenbrock> rosenbrock
+    (Rosenbrock (), n);
+
+  typename GenericFunction<T>::argument_t x (n);
+  for (int i = 0; i < 10; ++i)
+    {
+      x.setRandom ();
+      BOOST_CHECK (allclose (toDense (rosenbrock.gradient (x, 0)),
+			     Eigen::MatrixXd
+			     (rosenbrockGradient (x).transpose ()), 1e-10));
+    }
+  BOOST_CHECK_EQUAL (rosenbrock.recordings (), 1);
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE (reverse_mode_differentiation_branches, T,
+			       functionTypes_t)
+{
+  typedef GenericReverseModeDifferentiation<T, Branching> function_t;
+  function_t f (Branching (), 2);
+
+  typename function_t::argument_t x (2);
+  Eigen::MatrixXd expected (1, 2);
+
+  // Same branches: the tape is replayed.
+  x << 1., 2.;
+  expected << 2., 1. + 12.;
+  BOOST_CHECK (allclose (toDense (f.gradient (x, 0)), expected));
+  x << 3., 1.;
+  expected << 1., 3. + 3.;
+  BOOST_CHECK (allclose (toDense (f.gradient (x, 0)), expected));
+  BOOST_CHECK_EQUAL (f.recordings (), 1);
+
+  // First branch changes: the tape is recorded again.
+  x << -3., 1.;
+  expected << -1., 3. + 3.;
+  BOOST_CHECK (allclose (toDense (f.gradient (x, 0)), expected));
+  BOOST_CHECK_EQUAL (f.recordings (), 2);
+
+  // Second branch changes.
+  x << -3., 0.25;
+  expected << -0.25, 3. - 16.;
+  BOOST_CHECK (allclose (toDense (f.gradient (x, 0)), expected));
+  BOOST_CHECK_EQUAL (f.recordings (), 3);
+
+  // Values are still computed with plain scalars.
+  typename function_t::result_t res (1);
+  res[0] = 3. * 0.25 + 4.;
+  BOOST_CHECK (allclose (f (x), res));
+  BOOST_CHECK (allclose (toDense (f.jacobian (x)), expected));
+  BOOST_CHECK_EQUAL (f.recordings (), 3);
+}
+
+BOOST_AUTO_TEST_SUITE_END ()
@@ -19,12 +19,15 @@
 
 #include <boost/mpl/list.hpp>
 #include <boost/test/test_case_template.hpp>
+#include <boost/static_assert.hpp>
 
 #include <iostream>
 
 #include <roboptim/core/io.hh>
 #include <roboptim/core/differentiable-function.hh>
 #include <roboptim/core/util.hh>
+#include <roboptim/core/problem.hh>
+#include <roboptim/core/decorator/precision-adapter.hh>
 
 using namespace roboptim;
 
@@ -262,4 +265,87 @@ BOOST_AUTO_TEST_CASE_TEMPLATE (jacobian_check, T, functionTypes_t)
   BOOST_CHECK_SMALL (f (x)[0] - f (full_x.segment (2,4))[0], 1e-6);
 }
 
+BOOST_AUTO_TEST_CASE_TEMPLATE (vector_jacobian_product, T, functionTypes_t)
+{
+  F<T> f;
+  typename F<T>::argument_t x (4);
+  x << 10., -1., 7., 2.;
+
+  typename F<T>::vector_t w (2);
+  w << 2., -3.;
+
+  Eigen::MatrixXd expected (1, 4);
+  expected << -2., 20., -6., -21.;
+  BOOST_CHECK (allclose (toDense (f.vectorJacobianProduct (x, w)),
+			 expected));
+
+  // Outputs with a zero weight are skipped.
+  w[0] = 0.;
+  expected << 0., 0., -6., -21.;
+  typename F<T>::gradient_t product (4);
+  f.vectorJacobianProduct (product, x, w);
+  BOOST_CHECK (allclose (toDense (product), expected));
+}
+
+// Fixed-size function: f(x) = (x0 * x1, x1 + x2).
+struct Fixed : public GenericDifferentiableFunction<EigenMatrixFixed<3, 2> >
+{
+  Fixed (size_type n = 3, size_type m = 2)
+    : GenericDifferentiableFunction<EigenMatrixFixed<3, 2> > (n, m, "fixed")
+  {}
+
+  void impl_compute (result_ref res, const_argument_ref x) const
+  {
+    res[0] = x[0] * x[1];
+    res[1] = x[1] + x[2];
+  }
+
+  void impl_gradient (gradient_ref grad, const_argument_ref x,
+		      size_type functionId) const
+  {
+    if (functionId == 0)
+      grad << x[1], x[0], 0.;
+    else
+      grad << 0., 1., 1.;
+  }
+};
+
+BOOST_AUTO_TEST_CASE (fixed_size)
+{
+  // Sizes are known at compile time.
+  BOOST_STATIC_ASSERT (Fixed::argument_t::SizeAtCompileTime == 3);
+  BOOST_STATIC_ASSERT (Fixed::result_t::SizeAtCompileTime == 2);
+  BOOST_STATIC_ASSERT (Fixed::gradient_t::SizeAtCompileTime == 3);
+  BOOST_STATIC_ASSERT (Fixed::jacobian_t::RowsAtCompileTime == 2);
+  BOOST_STATIC_ASSERT (Fixed::jacobian_t::ColsAtCompileTime == 3);
+
+  boost::shared_ptr<Fixed> f = boost::make_shared<Fixed> ();
+
+  Fixed::argument_t x;
+  x << 1., 2., 3.;
+
+  Fixed::result_t res = (*f) (x);
+  BOOST_CHECK_EQUAL (res[0], 2.);
+  BOOST_CHECK_EQUAL (res[1], 5.);
+
+  Fixed::jacobian_t jac = f->jacobian (x);
+  Fixed::jacobian_t expectedJac;
+  expectedJac << 2., 1., 0.,
+                 0., 1., 1.;
+  BOOST_CHECK (jac == expectedJac);
+
+  // Fixed-size functions can be used where dynamic sizes are expected.
+  boost::shared_ptr<DifferentiableFunction> g = toDynamicSize (f);
+  DifferentiableFunction::argument_t xd = x;
+  BOOST_CHECK (allclose ((*g) (xd), res));
+  BOOST_CHECK (allclose (g->jacobian (xd), jac));
+
+  Problem<EigenMatrixDense> pb (g);
+  BOOST_CHECK_EQUAL (pb.function ().inputSize (), 3);
+
+  // Sizes must match the compile-time ones.
+  BOOST_CHECK_THROW (Fixed (4, 2), std::runtime_error);
+  BOOST_CHECK_THROW (Fixed (3, 1), std::runtime_error);
+}
+
 BOOST_AUTO_TEST_SUITE_END ()
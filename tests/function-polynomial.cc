@@ -116,6 +116,23 @@ BOOST_AUTO_TEST_CASE_TEMPLATE (polynomial_test, T, functionTypes_t)
 	    << "Hessian:" << std::endl
 	    << fct->hessian (x) << std::endl;
 
+  // Test batched evaluation
+  typename Polynomial<T>::batch_t xs (1, 5);
+  typename Polynomial<T>::batch_t ys (1, 5);
+  xs << -2, -1, 0, 1, 3;
+  fct->evaluateBatch (ys, xs);
+  for (typename Polynomial<T>::size_type i = 0; i < 5; ++i)
+    BOOST_CHECK_EQUAL (ys (0, i), (*fct) (xs.col (i))[0]);
+
+  // Test second-order products
+  typename Polynomial<T>::vector_t v (1);
+  v[0] = 0.5;
+  BOOST_CHECK_CLOSE (fct->hessianVectorProduct (x, v)[0],
+		     0.5 * fct->hessian (x).coeff (0, 0), 1e-8);
+  v[0] = -2.;
+  BOOST_CHECK_CLOSE (fct->lagrangianHessian (x, v).coeff (0, 0),
+		     -2. * fct->hessian (x).coeff (0, 0), 1e-8);
+
   // Test exceptions
   coefficients.resize (0);
   BOOST_CHECK_THROW (fct = boost::make_shared<Polynomial<T> > (coefficients),
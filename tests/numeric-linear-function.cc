@@ -76,6 +76,22 @@ BOOST_AUTO_TEST_CASE_TEMPLATE (numeric_linear_function, T, functionTypes_t)
 			 numericLinearFunctionRebuilt.A ()));
   BOOST_CHECK_EQUAL (numericLinearFunction.b (), numericLinearFunctionRebuilt.b ());
 
+  // The jacobian structure is the pattern of A.
+  typename GenericNumericLinearFunction<T>::sparsityPattern_t
+    pattern = f.jacobianStructure ();
+  BOOST_CHECK_EQUAL (pattern.rows (), 1);
+  BOOST_CHECK_EQUAL (pattern.cols (), 5);
+  BOOST_CHECK_EQUAL (pattern.nonZeros (), 4);
+  BOOST_CHECK_EQUAL (pattern.coeff (0, 4), 0.);
+
+  // Batched evaluation must match point-wise evaluation.
+  typename GenericNumericLinearFunction<T>::batch_t xs (5, 4);
+  typename GenericNumericLinearFunction<T>::batch_t ys (1, 4);
+  xs.setRandom ();
+  f.evaluateBatch (ys, xs);
+  for (typename GenericNumericLinearFunction<T>::size_type i = 0; i < 4; ++i)
+    BOOST_CHECK (allclose (ys.col (i), f (xs.col (i))));
+
   std::cout << output->str () << std::endl;
   BOOST_CHECK (output->match_pattern ());
 }
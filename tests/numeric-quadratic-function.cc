@@ -93,9 +93,27 @@ BOOST_AUTO_TEST_CASE_TEMPLATE (numeric_quadratic_function, T, functionTypes_t)
       BOOST_CHECK (allclose (f.jacobian (x), J));
       BOOST_CHECK (allclose (f.hessian (x, 0), 2*a));
 
+      // Native second-order products.
+      typename GenericNumericQuadraticFunction<T>::vector_t v (5);
+      typename GenericNumericQuadraticFunction<T>::vector_t lambda (1);
+      typename GenericNumericQuadraticFunction<T>::vector_t hv (5);
+      v.setRandom ();
+      lambda[0] = 0.5;
+      hv = 2 * a * v;
+      BOOST_CHECK (allclose (f.hessianVectorProduct (x, v), hv));
+      BOOST_CHECK (allclose (f.lagrangianHessian (x, lambda), a));
+
       BOOST_CHECK (checkGradient (f, 0, x));
       BOOST_CHECK (checkJacobian (f, x));
     }
+
+  // Batched evaluation must match point-wise evaluation.
+  typename GenericNumericQuadraticFunction<T>::batch_t xs (5, 4);
+  typename GenericNumericQuadraticFunction<T>::batch_t ys (1, 4);
+  xs.setRandom ();
+  f.evaluateBatch (ys, xs);
+  for (typename GenericNumericQuadraticFunction<T>::size_type i = 0; i < 4; ++i)
+    BOOST_CHECK (allclose (ys.col (i), f (xs.col (i))));
 }
 
 typedef boost::mpl::list< ::roboptim::EigenMatrixSparse> sparseOnly_t;
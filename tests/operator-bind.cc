@@ -18,6 +18,7 @@
 #include <boost/mpl/list.hpp>
 
 #include "shared-tests/fixture.hh"
+#include "operator-checks.hh"
 
 #include <boost/test/test_case_template.hpp>
 
@@ -25,6 +26,7 @@
 
 #include <roboptim/core/io.hh>
 #include <roboptim/core/operator/bind.hh>
+#include <roboptim/core/util.hh>
 
 #include <roboptim/core/differentiable-function.hh>
 #include <roboptim/core/function/constant.hh>
@@ -124,6 +126,15 @@ BOOST_AUTO_TEST_CASE_TEMPLATE (chain_test, T, functionTypes_t)
 
     BOOST_CHECK (fct->inputSize () == n-1);
 
+    // The column of the bound variable is removed.
+    typename linearFunction_t::sparsityPattern_t
+      pattern = fct->jacobianStructure ();
+    BOOST_CHECK_EQUAL (pattern.rows (), n);
+    BOOST_CHECK_EQUAL (pattern.cols (), n-1);
+    BOOST_CHECK_EQUAL (pattern.nonZeros (), n-1);
+    for (size_type j = 0; j < n-1; ++j)
+      BOOST_CHECK (pattern.coeff (j+1, j) != 0.);
+
     typename identityFunction_t::vector_t x (n-1);
     x.setZero ();
     (*output)
@@ -167,4 +178,27 @@ BOOST_AUTO_TEST_CASE_TEMPLATE (chain_test, T, functionTypes_t)
   BOOST_CHECK (output->match_pattern ());
 }
 
+BOOST_AUTO_TEST_CASE_TEMPLATE (bind_value_and_jacobian, T, functionTypes_t)
+{
+  typedef GenericDifferentiableFunction<T> differentiableFunction_t;
+  typedef typename differentiableFunction_t::value_type value_type;
+  typedef typename differentiableFunction_t::size_type size_type;
+  size_type n = 5;
+
+  std::vector<boost::optional<value_type> > boundValues
+    (static_cast<size_t> (n), boost::optional<value_type> ());
+  boundValues[1] = 12.;
+  boundValues[3] = -2.;
+
+  boost::shared_ptr<F<T> > norm = boost::make_shared<F<T> > (n);
+  boost::shared_ptr<differentiableFunction_t>
+    fct = boost::make_shared<Bind<differentiableFunction_t> >
+    (norm, boundValues);
+
+  typename differentiableFunction_t::vector_t x (n-2);
+  x << 0.5, 1., -1.5;
+
+  testing::checkValueAndJacobian<T> (*fct, x);
+}
+
 BOOST_AUTO_TEST_SUITE_END ()
@@ -19,6 +19,7 @@
 #include <boost/mpl/list.hpp>
 
 #include "shared-tests/fixture.hh"
+#include "operator-checks.hh"
 
 #include <boost/test/test_case_template.hpp>
 #include <boost/format.hpp>
@@ -28,6 +29,7 @@
 #include <roboptim/core/decorator/finite-difference-gradient.hh>
 #include <roboptim/core/io.hh>
 #include <roboptim/core/operator/chain.hh>
+#include <roboptim/core/util.hh>
 #include <roboptim/core/operator/selection.hh>
 #include <roboptim/core/numeric-linear-function.hh>
 #include <roboptim/core/numeric-quadratic-function.hh>
@@ -38,6 +40,46 @@
 using namespace roboptim;
 
 
+// x -> x^2 (component-wise), counting its evaluations.
+template <typename T>
+class CountedSquare : public GenericDifferentiableFunction<T>
+{
+public:
+  ROBOPTIM_DIFFERENTIABLE_FUNCTION_FWD_TYPEDEFS_
+  (GenericDifferentiableFunction<T>);
+
+  explicit CountedSquare (size_type n)
+    : GenericDifferentiableFunction<T> (n, n, "x^2"),
+      computations (0),
+      jacobians (0)
+  {}
+
+  mutable int computations;
+  mutable int jacobians;
+
+protected:
+  void impl_compute (result_ref result, const_argument_ref x) const
+  {
+    ++computations;
+    result = x.cwiseProduct (x);
+  }
+
+  void impl_gradient (gradient_ref gradient, const_argument_ref x,
+		      size_type i) const
+  {
+    gradient.setZero ();
+    gradient.coeffRef (i) = 2. * x[i];
+  }
+
+  void impl_jacobian (jacobian_ref jacobian, const_argument_ref x) const
+  {
+    ++jacobians;
+    jacobian.setZero ();
+    for (size_type i = 0; i < this->inputSize (); ++i)
+      jacobian.coeffRef (i, i) = 2. * x[i];
+  }
+};
+
 // FIXME: sparse matrices not supported yet.
 // ::roboptim::EigenMatrixSparse
 typedef boost::mpl::list< ::roboptim::EigenMatrixDense> functionTypes_t;
@@ -210,4 +252,128 @@ BOOST_AUTO_TEST_CASE_TEMPLATE (chain_jacobian_test, T, functionTypes_t)
     }
 }
 
+BOOST_AUTO_TEST_CASE_TEMPLATE (chain_value_and_jacobian_test, T,
+			       functionTypes_t)
+{
+  typedef typename GenericNumericLinearFunction<T>::matrix_t matrix_t;
+  typedef typename GenericNumericLinearFunction<T>::vector_t vector_t;
+
+  matrix_t A (1, 3);
+  A.setZero ();
+  A.coeffRef (0, 0) = 1.;
+  A.coeffRef (0, 1) = -2.;
+  A.coeffRef (0, 2) = 3.;
+  vector_t b (1);
+  b.setOnes ();
+
+  boost::shared_ptr<GenericNumericLinearFunction<T> > f =
+    boost::make_shared<GenericNumericLinearFunction<T> > (A, b);
+  boost::shared_ptr<CountedSquare<T> > g =
+    boost::make_shared<CountedSquare<T> > (3);
+
+  boost::shared_ptr<GenericDifferentiableFunction<T> > h =
+    chain<
+      GenericDifferentiableFunction<T>,
+      GenericDifferentiableFunction<T> >
+  (f, g);
+
+  vector_t x (3);
+  x << 1., 2., 3.;
+
+  // The inner function is evaluated once by the fused call.
+  typename GenericDifferentiableFunction<T>::result_t result (1);
+  typename GenericDifferentiableFunction<T>::jacobian_t jacobian (1, 3);
+  jacobian.setZero ();
+  h->valueAndJacobian (result, jacobian, x);
+  BOOST_CHECK_EQUAL (g->computations, 1);
+  BOOST_CHECK_EQUAL (g->jacobians, 1);
+
+  // Separate calls evaluate it twice.
+  BOOST_CHECK (allclose (result, (*h) (x)));
+  BOOST_CHECK (allclose (jacobian, h->jacobian (x)));
+  BOOST_CHECK_EQUAL (g->computations, 3);
+  BOOST_CHECK_EQUAL (g->jacobians, 2);
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE (chain_gradient_test, T, functionTypes_t)
+{
+  typedef typename GenericNumericLinearFunction<T>::matrix_t matrix_t;
+  typedef typename GenericNumericLinearFunction<T>::vector_t vector_t;
+  typedef typename GenericDifferentiableFunction<T>::size_type size_type;
+
+  matrix_t A (3, 4);
+  A << 1., -2., 3., 0.,
+    0., 4., -1., 2.,
+    5., 0., 0., -3.;
+  vector_t b (3);
+  b << 1., 2., 3.;
+
+  boost::shared_ptr<GenericNumericLinearFunction<T> > f =
+    boost::make_shared<GenericNumericLinearFunction<T> > (A, b);
+  boost::shared_ptr<CountedSquare<T> > g =
+    boost::make_shared<CountedSquare<T> > (4);
+
+  boost::shared_ptr<Chain<GenericDifferentiableFunction<T>,
+			  GenericDifferentiableFunction<T> > > h =
+    chain<
+      GenericDifferentiableFunction<T>,
+      GenericDifferentiableFunction<T> >
+  (f, g);
+  BOOST_CHECK (!h->cacheRightJacobian ());
+  h->cacheRightJacobian () = true;
+
+  vector_t x (4);
+  x << 1., -2., 3., 0.5;
+
+  // Expected jacobian: A diag (2 x).
+  matrix_t expected = A * (2. * x).asDiagonal ();
+
+  // All the gradients share a single right jacobian.
+  for (size_type i = 0; i < h->outputSize (); ++i)
+    BOOST_CHECK (allclose (h->gradient (x, i), expected.row (i)));
+  BOOST_CHECK_EQUAL (g->jacobians, 1);
+
+  // New argument: the right jacobian is computed again.
+  x[0] = 2.;
+  expected = A * (2. * x).asDiagonal ();
+  for (size_type i = 0; i < h->outputSize (); ++i)
+    BOOST_CHECK (allclose (h->gradient (x, i), expected.row (i)));
+  BOOST_CHECK_EQUAL (g->jacobians, 2);
+
+  // The jacobian and the gradients share the right jacobian as well.
+  BOOST_CHECK (allclose (h->jacobian (x), expected));
+  BOOST_CHECK_EQUAL (g->jacobians, 2);
+
+  // Vector-jacobian product, with and without a cached right jacobian.
+  vector_t w (3);
+  w << 0.5, -1., 2.;
+  BOOST_CHECK (allclose (h->vectorJacobianProduct (x, w),
+			 w.transpose () * expected));
+  BOOST_CHECK_EQUAL (g->jacobians, 2);
+
+  // A value computation invalidates the cache: the product is composed
+  // from the products of both functions, without any jacobian.
+  (*h) (x);
+  BOOST_CHECK (allclose (h->vectorJacobianProduct (x, w),
+			 w.transpose () * expected));
+  BOOST_CHECK_EQUAL (g->jacobians, 2);
+
+  // Without the cache, each gradient computes the right jacobian.
+  h->cacheRightJacobian () = false;
+  for (size_type i = 0; i < h->outputSize (); ++i)
+    BOOST_CHECK (allclose (h->gradient (x, i), expected.row (i)));
+  BOOST_CHECK_EQUAL (g->jacobians, 5);
+
+  CHECK_GRADIENT (*h, 0, x);
+  CHECK_JACOBIAN (*h, x);
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE (chain_jacobian_structure, T, functionTypes_t)
+{
+  typedef GenericDifferentiableFunction<T> function_t;
+  testing::LinearOperands<T> o (3, 4);
+  testing::checkJacobianStructure<T> (*chain<function_t, function_t>
+				      (o.f, o.g));
+}
+
 BOOST_AUTO_TEST_SUITE_END ()
@@ -0,0 +1,113 @@
+// Copyright (C) 2026 by the RobOptim contributors.
+//
+// This file is part of the roboptim.
+//
+// roboptim is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// roboptim is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with roboptim.  If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef ROBOPTIM_CORE_TESTS_OPERATOR_CHECKS_HH
+# define ROBOPTIM_CORE_TESTS_OPERATOR_CHECKS_HH
+
+# include <boost/make_shared.hpp>
+# include <boost/shared_ptr.hpp>
+# include <boost/test/unit_test.hpp>
+
+# include <roboptim/core/differentiable-function.hh>
+# include <roboptim/core/numeric-linear-function.hh>
+# include <roboptim/core/util.hh>
+
+namespace roboptim
+{
+  namespace testing
+  {
+    /// \brief Sparse linear operands of an operator.
+    ///
+    /// Linear functions whose structure is the nonzeros of their matrix:
+    /// the left one is 2x3, the right one has the given size.
+    template <typename T>
+    struct LinearOperands
+    {
+      typedef GenericNumericLinearFunction<T> linearFunction_t;
+      typedef typename linearFunction_t::matrix_t matrix_t;
+      typedef typename linearFunction_t::vector_t vector_t;
+      typedef typename linearFunction_t::size_type size_type;
+
+      LinearOperands (size_type rows, size_type cols)
+      {
+	matrix_t a (2, 3);
+	a.setZero ();
+	a.coeffRef (0, 0) = 1.;
+	a.coeffRef (1, 2) = -2.;
+	vector_t b (2);
+	b.setOnes ();
+	matrix_t c (rows, cols);
+	c.setZero ();
+	c.coeffRef (0, 1) = 3.;
+	c.coeffRef (1, 2) = 0.5;
+	vector_t d (rows);
+	d.setOnes ();
+
+	f = boost::make_shared<linearFunction_t> (a, b);
+	g = boost::make_shared<linearFunction_t> (c, d);
+      }
+
+      boost::shared_ptr<linearFunction_t> f;
+      boost::shared_ptr<linearFunction_t> g;
+    };
+
+    /// \brief Check that every nonzero of the jacobian is in the
+    /// jacobian structure, and that the structure is not full.
+    template <typename T>
+    void checkJacobianStructure (const GenericDifferentiableFunction<T>& fct)
+    {
+      typedef GenericDifferentiableFunction<T> function_t;
+      typedef typename function_t::size_type size_type;
+
+      typename function_t::vector_t x (fct.inputSize ());
+      for (size_type i = 0; i < x.size (); ++i)
+	x[i] = 0.5 + static_cast<double> (i);
+
+      typename function_t::sparsityPattern_t
+	pattern = fct.jacobianStructure ();
+      Eigen::MatrixXd jacobian = toDense (fct.jacobian (x));
+      BOOST_CHECK_EQUAL (pattern.rows (), jacobian.rows ());
+      BOOST_CHECK_EQUAL (pattern.cols (), jacobian.cols ());
+      BOOST_CHECK (pattern.nonZeros () < jacobian.size ());
+      for (size_type i = 0; i < jacobian.rows (); ++i)
+	for (size_type j = 0; j < jacobian.cols (); ++j)
+	  if (jacobian (i, j) != 0.)
+	    BOOST_CHECK (pattern.coeff (i, j) != 0.);
+    }
+
+    /// \brief Check that the fused evaluation of the value and the
+    /// jacobian matches separate calls.
+    template <typename T>
+    void checkValueAndJacobian
+    (const GenericDifferentiableFunction<T>& fct,
+     typename GenericDifferentiableFunction<T>::const_argument_ref x)
+    {
+      typedef GenericDifferentiableFunction<T> function_t;
+
+      typename function_t::result_t value (fct.outputSize ());
+      typename function_t::jacobian_t
+	jacobian (fct.outputSize (), fct.inputSize ());
+      value.setZero ();
+      jacobian.setZero ();
+      fct.valueAndJacobian (value, jacobian, x);
+      BOOST_CHECK (allclose (value, fct (x)));
+      BOOST_CHECK (allclose (toDense (jacobian), toDense (fct.jacobian (x))));
+    }
+  } // end of namespace testing
+} // end of namespace roboptim
+
+#endif //! ROBOPTIM_CORE_TESTS_OPERATOR_CHECKS_HH
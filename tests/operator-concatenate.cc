@@ -15,9 +15,12 @@
 // You should have received a copy of the GNU Lesser General Public License
 // along with roboptim.  If not, see <http://www.gnu.org/licenses/>.
 
+#include <cmath>
+
 #include <boost/mpl/list.hpp>
 
 #include "shared-tests/fixture.hh"
+#include "operator-checks.hh"
 
 #include <boost/test/test_case_template.hpp>
 
@@ -25,6 +28,8 @@
 
 #include <roboptim/core/io.hh>
 #include <roboptim/core/operator/concatenate.hh>
+#include <roboptim/core/numeric-linear-function.hh>
+#include <roboptim/core/util.hh>
 
 #include <roboptim/core/function/cos.hh>
 #include <roboptim/core/function/sin.hh>
@@ -68,4 +73,46 @@ BOOST_AUTO_TEST_CASE_TEMPLATE (concatenate_test, T, functionTypes_t)
                      std::runtime_error);
 }
 
+BOOST_AUTO_TEST_CASE_TEMPLATE (concatenate_offset, T, functionTypes_t)
+{
+  // The output size of the left function differs from its input size.
+  typename GenericConstantFunction<T>::result_t offset (3);
+  offset << 1., 2., 3.;
+  boost::shared_ptr<GenericConstantFunction<T> > constant =
+    boost::make_shared<GenericConstantFunction<T> > (1, offset);
+  boost::shared_ptr<Cos<T> > cosinus = boost::make_shared<Cos<T> > ();
+
+  boost::shared_ptr<GenericDifferentiableFunction<T> >
+    fct = concatenate (constant, cosinus);
+  BOOST_REQUIRE_EQUAL (fct->outputSize (), 4);
+
+  typename GenericDifferentiableFunction<T>::vector_t x (1);
+  x[0] = 0.5;
+  typename GenericDifferentiableFunction<T>::result_t expected (4);
+  expected << 1., 2., 3., std::cos (0.5);
+
+  // The right result follows the whole left result.
+  BOOST_CHECK ((*fct) (x) == expected);
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE (concatenate_value_and_jacobian, T, functionTypes_t)
+{
+  boost::shared_ptr<Cos<T> > cosinus = boost::make_shared<Cos<T> > ();
+  boost::shared_ptr<Sin<T> > sinus = boost::make_shared<Sin<T> > ();
+
+  boost::shared_ptr<GenericDifferentiableFunction<T> >
+    fct = concatenate (cosinus, sinus);
+
+  typename GenericDifferentiableFunction<T>::vector_t x (1);
+  x[0] = 0.5;
+
+  testing::checkValueAndJacobian<T> (*fct, x);
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE (concatenate_jacobian_structure, T, functionTypes_t)
+{
+  testing::LinearOperands<T> o (3, 3);
+  testing::checkJacobianStructure<T> (*concatenate (o.f, o.g));
+}
+
 BOOST_AUTO_TEST_SUITE_END ()
@@ -18,6 +18,7 @@
 #include <boost/mpl/list.hpp>
 
 #include "shared-tests/fixture.hh"
+#include "operator-checks.hh"
 
 #include <boost/test/test_case_template.hpp>
 
@@ -25,11 +26,46 @@
 
 #include <roboptim/core/io.hh>
 #include <roboptim/core/operator/map.hh>
+#include <roboptim/core/util.hh>
 
 #include <roboptim/core/function/cos.hh>
 
 using namespace roboptim;
 
+// f(x) = (x0 x1, sin (x0), x1^2)
+template <typename T>
+struct Step : public GenericDifferentiableFunction<T>
+{
+  ROBOPTIM_DIFFERENTIABLE_FUNCTION_FWD_TYPEDEFS_
+  (GenericDifferentiableFunction<T>);
+
+  Step () : GenericDifferentiableFunction<T> (2, 3, "step")
+  {}
+
+  void impl_compute (result_ref result, const_argument_ref x) const
+  {
+    result[0] = x[0] * x[1];
+    result[1] = std::sin (x[0]);
+    result[2] = x[1] * x[1];
+  }
+
+  void impl_gradient (gradient_ref grad, const_argument_ref x,
+		      size_type functionId) const
+  {
+    switch (functionId)
+      {
+      case 0:
+	grad.coeffRef (0) = x[1];
+	grad.coeffRef (1) = x[0];
+	break;
+      case 1:
+	grad.coeffRef (0) = std::cos (x[0]);
+	break;
+      default:
+	grad.coeffRef (1) = 2. * x[1];
+      }
+  }
+};
 
 typedef boost::mpl::list< ::roboptim::EigenMatrixDense,
 			  ::roboptim::EigenMatrixSparse> functionTypes_t;
@@ -53,6 +89,109 @@ BOOST_AUTO_TEST_CASE_TEMPLATE (map_test, T, functionTypes_t)
     << (*fct) (x) << "\n"
     << fct->gradient (x, 0) << "\n"
     << fct->jacobian (x) << std::endl;
+
+  // The jacobian structure is block-diagonal.
+  typename GenericDifferentiableFunction<T>::sparsityPattern_t
+    pattern = fct->jacobianStructure ();
+  BOOST_CHECK_EQUAL (pattern.rows (), 10);
+  BOOST_CHECK_EQUAL (pattern.cols (), 10);
+  BOOST_CHECK_EQUAL (pattern.nonZeros (), 10);
+  for (typename Cos<T>::size_type i = 0; i < 10; ++i)
+    BOOST_CHECK (pattern.coeff (i, i) != 0.);
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE (map_block_jacobian, T, functionTypes_t)
+{
+  typedef Map<GenericDifferentiableFunction<T> > map_t;
+  typedef typename map_t::size_type size_type;
+
+  const size_type repeat = 50;
+  boost::shared_ptr<GenericDifferentiableFunction<T> > step =
+    boost::make_shared<Step<T> > ();
+  boost::shared_ptr<map_t> fct = map (step, repeat);
+
+  typename map_t::vector_t x (2 * repeat);
+  x.setRandom ();
+
+  Eigen::MatrixXd expected = Eigen::MatrixXd::Zero (3 * repeat, 2 * repeat);
+  typename map_t::vector_t expectedValue (3 * repeat);
+  for (size_type i = 0; i < repeat; ++i)
+    {
+      const double x0 = x[2 * i];
+      const double x1 = x[2 * i + 1];
+      expectedValue.segment (3 * i, 3) << x0 * x1, std::sin (x0), x1 * x1;
+      expected (3 * i, 2 * i) = x1;
+      expected (3 * i, 2 * i + 1) = x0;
+      expected (3 * i + 1, 2 * i) = std::cos (x0);
+      expected (3 * i + 2, 2 * i + 1) = 2. * x1;
+    }
+
+  // In-place update of a preset structure, for sparse functions.
+  fct->reuseJacobianStructure () = true;
+  typename map_t::jacobian_t jac (3 * repeat, 2 * repeat);
+  jac = fct->jacobianStructure ();
+
+  for (size_t threads = 1; threads <= 4; ++threads)
+    {
+      fct->setThreads (threads);
+      BOOST_CHECK_EQUAL (fct->threads (), threads);
+
+      BOOST_CHECK (allclose ((*fct) (x), expectedValue));
+
+      fct->jacobian (jac, x);
+      BOOST_CHECK (allclose (toDense (jac), expected));
+      BOOST_CHECK (allclose (toDense (fct->jacobian (x)), expected));
+
+      typename map_t::result_t value (3 * repeat);
+      fct->valueAndJacobian (value, jac, x);
+      BOOST_CHECK (allclose (value, expectedValue));
+      BOOST_CHECK (allclose (toDense (jac), expected));
+
+      // Each output only depends on its repeat.
+      for (size_type i = 0; i < 3 * repeat; i += 7)
+	BOOST_CHECK (allclose (toDense (fct->gradient (x, i)),
+			       Eigen::MatrixXd (expected.row (i))));
+
+      // Reusing one gradient buffer across outputs of different repeats.
+      typename map_t::gradient_t grad (2 * repeat);
+      grad.setZero ();
+      for (size_type i = 0; i < 3 * repeat; i += 5)
+	{
+	  fct->gradient (grad, x, i);
+	  BOOST_CHECK (allclose (toDense (grad),
+				 Eigen::MatrixXd (expected.row (i))));
+	}
+    }
+
+  // The preset structure is kept.
+  BOOST_CHECK_EQUAL (fct->jacobianStructureChanges (), 0);
+  BOOST_CHECK_EQUAL (jac.nonZeros (), StorageTraits<T>::isDense?
+		     6 * repeat * repeat : 6 * repeat);
+
+  // A structure missing an entry is detected, and the Jacobian is
+  // assembled again.
+  Eigen::MatrixXd partial = expected;
+  partial (0, 0) = 0.;
+  jac = partial.sparseView ();
+  fct->jacobian (jac, x);
+  BOOST_CHECK (allclose (toDense (jac), expected));
+  BOOST_CHECK_EQUAL (fct->jacobianStructureChanges (),
+		     StorageTraits<T>::isDense? 0 : 1);
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE (map_value_and_jacobian, T, functionTypes_t)
+{
+  boost::shared_ptr<Cos<T> > cosinus =
+    boost::make_shared<Cos<T> > ();
+
+  boost::shared_ptr<GenericDifferentiableFunction<T> >
+    fct = map (cosinus, 10);
+
+  typename Cos<T>::vector_t x (10);
+  for (typename Cos<T>::size_type i = 0; i < x.size (); ++i)
+    x[i] = 0.3 * static_cast<double> (i);
+
+  testing::checkValueAndJacobian<T> (*fct, x);
 }
 
 BOOST_AUTO_TEST_SUITE_END ()
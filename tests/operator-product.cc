@@ -18,6 +18,7 @@
 #include <boost/mpl/list.hpp>
 
 #include "shared-tests/fixture.hh"
+#include "operator-checks.hh"
 
 #include <boost/test/test_case_template.hpp>
 
@@ -25,6 +26,9 @@
 
 #include <roboptim/core/io.hh>
 #include <roboptim/core/operator/product.hh>
+#include <roboptim/core/numeric-linear-function.hh>
+#include <roboptim/core/util.hh>
+#include <roboptim/core/operator/selection.hh>
 
 #include <roboptim/core/function/constant.hh>
 #include <roboptim/core/function/identity.hh>
@@ -107,8 +111,43 @@ BOOST_AUTO_TEST_CASE_TEMPLATE (product_test, T, functionTypes_t)
                          Function::matrix_t (fd_fct2.jacobian (x)),
                          eps, eps));
 
+  // Gradients of outputs that do not match the inputs.
+  boost::shared_ptr<GenericDifferentiableFunction<T> > fct3 =
+    product<GenericDifferentiableFunction<T>, GenericDifferentiableFunction<T> >
+    (selection<GenericDifferentiableFunction<T> > (fct2, 0, 3),
+     selection<GenericDifferentiableFunction<T> > (fct, 0, 3));
+  Function::matrix_t jac3 = Function::matrix_t (fct3->jacobian (x));
+  for (typename GenericFunction<T>::size_type i = 0; i < 3; ++i)
+    BOOST_CHECK (allclose (Function::matrix_t (fct3->gradient (x, i)),
+                           Function::matrix_t (jac3.row (i)), eps, eps));
+
   std::cout << output->str () << std::endl;
   BOOST_CHECK (output->match_pattern ());
 }
 
+BOOST_AUTO_TEST_CASE_TEMPLATE (product_value_and_jacobian, T, functionTypes_t)
+{
+  typename GenericIdentityFunction<T>::result_t offset (5);
+  offset.setZero ();
+  boost::shared_ptr<GenericIdentityFunction<T> > identity =
+    boost::make_shared<GenericIdentityFunction<T> > (offset);
+  offset << 1., -2., 3., 0.5, 2.;
+  boost::shared_ptr<GenericConstantFunction<T> > constant =
+    boost::make_shared<GenericConstantFunction<T> > (offset);
+
+  boost::shared_ptr<GenericLinearFunction<T> > u = identity * constant;
+  boost::shared_ptr<GenericDifferentiableFunction<T> > fct = u * u;
+
+  typename GenericIdentityFunction<T>::argument_t x (5);
+  x << 0.5, 1., -1.5, 2., 3.;
+
+  testing::checkValueAndJacobian<T> (*fct, x);
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE (product_jacobian_structure, T, functionTypes_t)
+{
+  testing::LinearOperands<T> o (2, 3);
+  testing::checkJacobianStructure<T> (*(o.f * o.g));
+}
+
 BOOST_AUTO_TEST_SUITE_END ()
@@ -18,6 +18,7 @@
 #include <boost/mpl/list.hpp>
 
 #include "shared-tests/fixture.hh"
+#include "operator-checks.hh"
 
 #include <boost/test/test_case_template.hpp>
 
@@ -149,4 +150,15 @@ BOOST_AUTO_TEST_CASE_TEMPLATE (scalar_test, T, functionTypes_t)
   BOOST_CHECK (output->match_pattern ());
 }
 
+BOOST_AUTO_TEST_CASE_TEMPLATE (scalar_value_and_jacobian, T, functionTypes_t)
+{
+  boost::shared_ptr<F<T> > f = boost::make_shared<F<T> > ();
+  boost::shared_ptr<GenericDifferentiableFunction<T> > fct = 2. * f;
+
+  typename F<T>::vector_t x (1);
+  x[0] = 1.5;
+
+  testing::checkValueAndJacobian<T> (*fct, x);
+}
+
 BOOST_AUTO_TEST_SUITE_END ()
@@ -59,6 +59,14 @@ BOOST_AUTO_TEST_CASE_TEMPLATE (chain_test, T, functionTypes_t)
     << fct->gradient (x, 0) << "\n"
     << fct->jacobian (x) << std::endl;
 
+  // Only the selected row of the identity is kept.
+  typename GenericLinearFunction<T>::sparsityPattern_t
+    pattern = fct->jacobianStructure ();
+  BOOST_CHECK_EQUAL (pattern.rows (), 1);
+  BOOST_CHECK_EQUAL (pattern.cols (), 5);
+  BOOST_CHECK_EQUAL (pattern.nonZeros (), 1);
+  BOOST_CHECK (pattern.coeff (0, 2) != 0.);
+
   typename GenericIdentityFunction<T>::result_t offset_throw (6);
   offset_throw.setZero ();
   boost::shared_ptr<GenericIdentityFunction<T> > identity_throw =
@@ -18,6 +18,7 @@
 #include <boost/mpl/list.hpp>
 
 #include "shared-tests/fixture.hh"
+#include "operator-checks.hh"
 
 #include <boost/test/test_case_template.hpp>
 
@@ -25,6 +26,7 @@
 
 #include <roboptim/core/io.hh>
 #include <roboptim/core/operator/selection.hh>
+#include <roboptim/core/util.hh>
 
 #include <roboptim/core/function/constant.hh>
 #include <roboptim/core/function/identity.hh>
@@ -60,4 +62,20 @@ BOOST_AUTO_TEST_CASE_TEMPLATE (chain_test, T, functionTypes_t)
   BOOST_CHECK_THROW (fct = selection (identity, 0, 10), std::runtime_error);
 }
 
+BOOST_AUTO_TEST_CASE_TEMPLATE (selection_value_and_jacobian, T, functionTypes_t)
+{
+  typename GenericIdentityFunction<T>::result_t offset (5);
+  offset << 1., -2., 3., 0.5, 2.;
+  boost::shared_ptr<GenericIdentityFunction<T> > identity =
+    boost::make_shared<GenericIdentityFunction<T> > (offset);
+
+  boost::shared_ptr<GenericLinearFunction<T> >
+    fct = selection (identity, 1, 3);
+
+  typename GenericIdentityFunction<T>::vector_t x (5);
+  x << 0.5, 1., -1.5, 2., 3.;
+
+  testing::checkValueAndJacobian<T> (*fct, x);
+}
+
 BOOST_AUTO_TEST_SUITE_END ()
@@ -21,10 +21,17 @@
 
 #include <iostream>
 
+#include <boost/bind.hpp>
+#include <boost/mpl/list.hpp>
+#include <boost/test/test_case_template.hpp>
+#include <boost/thread/thread.hpp>
+
 #include <roboptim/core/io.hh>
 #include <roboptim/core/differentiable-function.hh>
+#include <roboptim/core/problem.hh>
 #include <roboptim/core/util.hh>
 #include <roboptim/core/operator/split.hh>
+#include <roboptim/core/decorator/function-graph.hh>
 
 using namespace roboptim;
 
@@ -48,8 +55,184 @@ struct F : public DifferentiableFunction
   }
 };
 
+// f_n (x) = x_0^n + x_1, counting its evaluations.
+template <typename T>
+struct Counted : public GenericDifferentiableFunction<T>
+{
+  ROBOPTIM_DIFFERENTIABLE_FUNCTION_FWD_TYPEDEFS_
+  (GenericDifferentiableFunction<T>);
+
+  explicit Counted (size_type m)
+    : GenericDifferentiableFunction<T> (2, m, "f_n (x) = x_0^n + x_1"),
+      computations (0),
+      gradients (0)
+  {}
+
+  void impl_compute (result_ref res, const_argument_ref x) const
+  {
+    ++computations;
+    for (size_type i = 0; i < this->outputSize (); ++i)
+      res[i] = std::pow (x[0], static_cast<value_type> (i)) + x[1];
+  }
+
+  void impl_gradient (gradient_ref grad, const_argument_ref x,
+		      size_type i) const
+  {
+    ++gradients;
+    if (i > 0)
+      grad.coeffRef (0) =
+	static_cast<value_type> (i)
+	* std::pow (x[0], static_cast<value_type> (i - 1));
+    grad.coeffRef (1) = 1.;
+  }
+
+  mutable int computations;
+  mutable int gradients;
+};
+
+// FIXME: sparse matrices not supported yet.
+// ::roboptim::EigenMatrixSparse
+typedef boost::mpl::list< ::roboptim::EigenMatrixDense> functionTypes_t;
+
+template <typename S>
+void evaluateSplits (const std::vector<boost::shared_ptr<S> >* splits,
+		     const typename S::argument_t* x, bool* ok)
+{
+  for (std::size_t i = 0; i < splits->size (); ++i)
+    {
+      typename S::result_t res = (*(*splits)[i]) (*x);
+      typename S::value_type expected =
+	std::pow ((*x)[0], static_cast<double> (i)) + (*x)[1];
+      if (std::abs (res[0] - expected) > 1e-12)
+	*ok = false;
+    }
+}
+
 BOOST_FIXTURE_TEST_SUITE (core, TestSuiteConfiguration)
 
+BOOST_AUTO_TEST_CASE_TEMPLATE (split_group, T, functionTypes_t)
+{
+  typedef GenericDifferentiableFunction<T> function_t;
+  typedef Split<function_t> split_t;
+
+  const typename function_t::size_type m = 6;
+  boost::shared_ptr<Counted<T> > f = boost::make_shared<Counted<T> > (m);
+  std::vector<boost::shared_ptr<split_t> > splits =
+    splitGroup<function_t> (f);
+  BOOST_REQUIRE_EQUAL (splits.size (), m);
+
+  typename function_t::argument_t x (2);
+  x << 2., 1.;
+
+  // One evaluation of the function for all the splits.
+  Eigen::MatrixXd jac = toDense (f->jacobian (x));
+  f->gradients = 0;
+  for (std::size_t i = 0; i < splits.size (); ++i)
+    {
+      BOOST_CHECK_CLOSE ((*splits[i]) (x)[0], std::pow (2., double (i)) + 1.,
+			 1e-10);
+      BOOST_CHECK (allclose (toDense (splits[i]->gradient (x, 0)),
+			     Eigen::MatrixXd (jac.row (long (i)))));
+    }
+  BOOST_CHECK_EQUAL (f->computations, 1);
+  BOOST_CHECK_EQUAL (f->gradients, m);
+  BOOST_CHECK_EQUAL (splits[0]->group ()->evaluations (), 1);
+  BOOST_CHECK_EQUAL (splits[0]->group ()->jacobianEvaluations (), 1);
+
+  // New argument: evaluated again, once.
+  x[0] = 3.;
+  for (std::size_t i = 0; i < splits.size (); ++i)
+    (*splits[i]) (x);
+  BOOST_CHECK_EQUAL (f->computations, 2);
+
+  // Explicit invalidation.
+  splits[0]->group ()->invalidate ();
+  (*splits[m - 1]) (x);
+  BOOST_CHECK_EQUAL (f->computations, 3);
+
+  // Splits built without a group evaluate the function each time.
+  split_t alone (f, 2);
+  BOOST_CHECK (!alone.group ());
+  alone (x);
+  alone (x);
+  BOOST_CHECK_EQUAL (f->computations, 5);
+
+  // Concurrent evaluations of the siblings.
+  std::vector<typename function_t::argument_t> points (4, x);
+  bool ok[4] = {true, true, true, true};
+  boost::thread_group threads;
+  for (std::size_t k = 0; k < points.size (); ++k)
+    {
+      points[k][0] = 1. + 0.5 * static_cast<double> (k % 2);
+      threads.create_thread
+	(boost::bind (&evaluateSplits<split_t>, &splits, &points[k], &ok[k]));
+    }
+  threads.join_all ();
+  for (std::size_t k = 0; k < points.size (); ++k)
+    BOOST_CHECK (ok[k]);
+
+  // A copy has its own group: replacing its operand leaves the group
+  // untouched.
+  boost::shared_ptr<Counted<T> > g = boost::make_shared<Counted<T> > (m);
+  typename detail::GenericExpressionNode<T>::childShPtr_t
+    copy = detail::GraphTraversal::clone (*splits[1]);
+  BOOST_REQUIRE (copy);
+  BOOST_CHECK (detail::GraphTraversal::replaceChild (*copy, f.get (), g));
+  BOOST_CHECK (splits[2]->group ()->function () == f);
+
+  // Replacing the operand of a split replaces it for the whole group.
+  BOOST_CHECK (detail::GraphTraversal::replaceChild
+	       (*splits[1], f.get (), g));
+  BOOST_CHECK (splits[2]->group ()->function () == g);
+  typename detail::GenericExpressionNode<T>::children_t children;
+  detail::GraphTraversal::children (*splits[2], children);
+  BOOST_REQUIRE_EQUAL (children.size (), 1);
+  BOOST_CHECK (children[0] == g.get ());
+
+  f->computations = 0;
+  g->computations = 0;
+  for (std::size_t i = 0; i < splits.size (); ++i)
+    BOOST_CHECK_CLOSE ((*splits[i]) (x)[0],
+		       std::pow (3., double (i)) + 1., 1e-10);
+  BOOST_CHECK_EQUAL (f->computations, 0);
+  BOOST_CHECK_EQUAL (g->computations, 1);
+}
+
+BOOST_AUTO_TEST_CASE (add_non_scalar_constraint)
+{
+  typedef Problem<EigenMatrixDense> problem_t;
+  typedef Split<DifferentiableFunction> split_t;
+
+  boost::shared_ptr<DifferentiableFunction> f (new F ());
+  boost::shared_ptr<split_t> cost (new split_t (f, 0));
+  std::vector<Function::interval_t>
+    intervals (10, Function::makeInterval (0., 1.));
+
+  // Independent splits by default.
+  problem_t pb (cost);
+  addNonScalarConstraint (pb, f, intervals);
+  BOOST_REQUIRE_EQUAL (pb.constraints ().size (), 10);
+  for (std::size_t i = 0; i < pb.constraints ().size (); ++i)
+    {
+      boost::shared_ptr<split_t> split =
+	boost::dynamic_pointer_cast<split_t> (pb.constraints ()[i]);
+      BOOST_REQUIRE (split);
+      BOOST_CHECK (!split->group ());
+    }
+
+  // Splits sharing the evaluations of the function.
+  problem_t shared (cost);
+  addNonScalarConstraint (shared, f, intervals,
+			  std::vector<Function::value_type> (), true);
+  BOOST_REQUIRE_EQUAL (shared.constraints ().size (), 10);
+  boost::shared_ptr<split_t> first =
+    boost::dynamic_pointer_cast<split_t> (shared.constraints ()[0]);
+  BOOST_REQUIRE (first && first->group ());
+  for (std::size_t i = 1; i < shared.constraints ().size (); ++i)
+    BOOST_CHECK (boost::dynamic_pointer_cast<split_t>
+		 (shared.constraints ()[i])->group () == first->group ());
+}
+
 BOOST_AUTO_TEST_CASE (split)
 {
   boost::shared_ptr<boost::test_tools::output_test_stream>
@@ -31,6 +31,9 @@ using namespace roboptim;
 typedef boost::mpl::list< ::roboptim::EigenMatrixDense,
 			  ::roboptim::EigenMatrixSparse> functionTypes_t;
 
+typedef boost::mpl::list< ::roboptim::EigenMatrixDenseFloat,
+			  ::roboptim::EigenMatrixSparseFloat> floatTypes_t;
+
 boost::shared_ptr<boost::test_tools::output_test_stream> output;
 
 // Define a simple function.
@@ -263,4 +266,45 @@ BOOST_AUTO_TEST_CASE_TEMPLATE (problem, T, functionTypes_t)
   BOOST_CHECK (output->match_pattern ());
 }
 
+BOOST_AUTO_TEST_CASE_TEMPLATE (problem_float, T, floatTypes_t)
+{
+  typedef Problem<T> problem_t;
+  typedef typename problem_t::function_t function_t;
+  typedef typename problem_t::intervals_t intervals_t;
+  typedef typename problem_t::scaling_t scaling_t;
+
+  typedef GenericConstantFunction<T> constantFunction_t;
+  typedef GenericNumericLinearFunction<T> numericLinearFunction_t;
+
+  typename constantFunction_t::vector_t v (2);
+  v.setZero ();
+  problem_t pb (boost::make_shared<constantFunction_t> (v));
+  pb.argumentBounds ()[0] = function_t::makeInterval (-5.f, 5.f);
+
+  typename numericLinearFunction_t::matrix_t a (2, 2);
+  typename numericLinearFunction_t::vector_t b (2);
+  a.setZero ();
+  a.coeffRef (0, 0) = 10.f;
+  a.coeffRef (1, 1) = -0.5f;
+  b << 2.f, 3.f;
+
+  intervals_t intervals (2, function_t::makeLowerInterval (0.f));
+  scaling_t scaling (2, 1.f);
+  pb.addConstraint (boost::make_shared<numericLinearFunction_t> (a, b),
+		    intervals, scaling);
+
+  typename function_t::argument_t x (2);
+  x << 8.f, 10.f;
+
+  // The problem Jacobian is the one of its single constraint.
+  BOOST_CHECK (toDense (pb.jacobian (x)) == toDense (a));
+
+  // Argument violation 3, constraint violation -(-0.5 * 10 + 3) = 2.
+  typename function_t::vector_t violations = pb.constraintsViolationVector (x);
+  BOOST_CHECK_EQUAL (violations.size (), 4);
+  BOOST_CHECK_EQUAL (violations[0], 3.f);
+  BOOST_CHECK_EQUAL (violations[3], -2.f);
+  BOOST_CHECK_EQUAL (pb.template constraintsViolation<1> (x), 5.f);
+}
+
 BOOST_AUTO_TEST_SUITE_END ()
@@ -0,0 +1,121 @@
+// Copyright (C) 2026 by the RobOptim contributors.
+//
+// This file is part of the roboptim.
+//
+// roboptim is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// roboptim is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with roboptim.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "shared-tests/fixture.hh"
+
+#include <sstream>
+
+#include <boost/bind.hpp>
+#include <boost/thread/thread.hpp>
+
+#include <roboptim/core/io.hh>
+#include <roboptim/core/sharded-cache.hh>
+
+using namespace roboptim;
+
+typedef ShardedLRUCache<std::string, double> cache_t;
+
+// Each worker reads and writes its own keys as well as keys shared
+// with the other workers. Cached values are a function of the key, so
+// that any value returned by the cache can be checked.
+static void worker (cache_t& cache, size_t id, size_t nIter, size_t& errors)
+{
+  for (size_t i = 0; i < nIter; ++i)
+    {
+      size_t k = (i % 2 == 0)? i % 50 : 1000 * (id + 1) + i % 20;
+      std::stringstream ss;
+      ss << "x" << k;
+
+      double value = -1.;
+      if (cache.get (ss.str (), value))
+	{
+	  if (value != static_cast<double> (k))
+	    ++errors;
+	}
+      else
+	cache.insert (ss.str (), static_cast<double> (k));
+    }
+}
+
+BOOST_FIXTURE_TEST_SUITE (core, TestSuiteConfiguration)
+
+BOOST_AUTO_TEST_CASE (sharded_cache)
+{
+  cache_t cache (20, false, 4);
+  BOOST_CHECK_EQUAL (cache.size (), 20);
+  BOOST_CHECK_EQUAL (cache.shards (), 4);
+  BOOST_CHECK (!cache.verifyKeys ());
+
+  double value = 0.;
+  BOOST_CHECK (!cache.get ("x₀", value));
+
+  cache.insert ("x₀", 42.);
+  BOOST_CHECK (cache.get ("x₀", value));
+  BOOST_CHECK_EQUAL (value, 42.);
+
+  cache.insert ("x₀", 0.);
+  BOOST_CHECK (cache.get ("x₀", value));
+  BOOST_CHECK_EQUAL (value, 0.);
+  BOOST_CHECK_EQUAL (cache.hits (), 2);
+  BOOST_CHECK_EQUAL (cache.misses (), 1);
+
+  // Copies are independent
+  cache_t copy (cache);
+  copy.insert ("x₁", 1.);
+  BOOST_CHECK (copy.get ("x₀", value));
+  BOOST_CHECK (!cache.get ("x₁", value));
+
+  cache.resetStatistics ();
+  BOOST_CHECK_EQUAL (cache.hits (), 0);
+  BOOST_CHECK_EQUAL (cache.misses (), 0);
+
+  cache.clear ();
+  BOOST_CHECK (!cache.get ("x₀", value));
+
+  // The number of shards cannot exceed the size of the cache
+  cache_t small (2, true, 8);
+  BOOST_CHECK_EQUAL (small.shards (), 2);
+  BOOST_CHECK (small.verifyKeys ());
+
+  // Shards do not hold more elements than requested
+  cache_t uneven (10, false, 4);
+  BOOST_CHECK_EQUAL (uneven.shards (), 4);
+  BOOST_CHECK_EQUAL (uneven.size (), 10);
+}
+
+BOOST_AUTO_TEST_CASE (sharded_cache_threads)
+{
+  const size_t nThreads = 8;
+  const size_t nIter = 10000;
+
+  cache_t cache (64, true, 8);
+  std::vector<size_t> errors (nThreads, 0);
+
+  boost::thread_group threads;
+  for (size_t i = 0; i < nThreads; ++i)
+    threads.create_thread (boost::bind (&worker, boost::ref (cache),
+                                        i, nIter, boost::ref (errors[i])));
+  threads.join_all ();
+
+  for (size_t i = 0; i < nThreads; ++i)
+    BOOST_CHECK_EQUAL (errors[i], 0);
+
+  BOOST_CHECK_EQUAL (cache.hits () + cache.misses (), nThreads * nIter);
+  BOOST_CHECK (cache.hits () > 0);
+}
+
+BOOST_AUTO_TEST_SUITE_END ()
@@ -21,6 +21,12 @@
 
 #include <roboptim/core/io.hh>
 #include <roboptim/core/twice-differentiable-function.hh>
+#include <roboptim/core/numeric-linear-function.hh>
+#include <roboptim/core/numeric-quadratic-function.hh>
+#include <roboptim/core/operator/minus.hh>
+#include <roboptim/core/operator/plus.hh>
+#include <roboptim/core/operator/scalar.hh>
+#include <roboptim/core/operator/split.hh>
 #include <roboptim/core/util.hh>
 
 using namespace roboptim;
@@ -71,6 +77,56 @@ struct NoTitle : public TwiceDifferentiableFunction
   }
 };
 
+// f(x) = (x0^2 x1, x0 x1^2)
+template <typename T>
+struct GenericTwoOutputs : public GenericTwiceDifferentiableFunction<T>
+{
+  ROBOPTIM_TWICE_DIFFERENTIABLE_FUNCTION_FWD_TYPEDEFS_
+  (GenericTwiceDifferentiableFunction<T>);
+
+  GenericTwoOutputs ()
+    : GenericTwiceDifferentiableFunction<T> (2, 2, "two outputs")
+  {}
+
+  void impl_compute (result_ref res, const_argument_ref x) const
+  {
+    res[0] = x[0] * x[0] * x[1];
+    res[1] = x[0] * x[1] * x[1];
+  }
+
+  void impl_gradient (gradient_ref grad, const_argument_ref x,
+		      size_type functionId) const
+  {
+    if (functionId == 0)
+      {
+	grad.coeffRef (0) = 2. * x[0] * x[1];
+	grad.coeffRef (1) = x[0] * x[0];
+      }
+    else
+      {
+	grad.coeffRef (0) = x[1] * x[1];
+	grad.coeffRef (1) = 2. * x[0] * x[1];
+      }
+  }
+
+  void impl_hessian (hessian_ref h, const_argument_ref x,
+		     size_type functionId) const
+  {
+    if (functionId == 0)
+      {
+	h.coeffRef (0, 0) = 2. * x[1];
+	h.coeffRef (0, 1) = h.coeffRef (1, 0) = 2. * x[0];
+      }
+    else
+      {
+	h.coeffRef (0, 1) = h.coeffRef (1, 0) = 2. * x[1];
+	h.coeffRef (1, 1) = 2. * x[0];
+      }
+  }
+};
+
+typedef GenericTwoOutputs<EigenMatrixDense> TwoOutputs;
+
 BOOST_FIXTURE_TEST_SUITE (core, TestSuiteConfiguration)
 
 BOOST_AUTO_TEST_CASE (twice_derivable_function)
@@ -145,4 +201,121 @@ BOOST_AUTO_TEST_CASE (twice_derivable_function)
   BOOST_CHECK (output->match_pattern ());
 }
 
+BOOST_AUTO_TEST_CASE (hessian_vector_product)
+{
+  typedef TwiceDifferentiableFunction::vector_t vector_t;
+  typedef TwiceDifferentiableFunction::matrix_t matrix_t;
+
+  vector_t x (2);
+  x << 1.5, -2.;
+  vector_t v (2);
+  v << 0.3, 0.7;
+  vector_t lambda (2);
+  lambda << 2., -0.5;
+
+  // Default implementations, relying on the hessians.
+  TwoOutputs f;
+  BOOST_CHECK (allclose (f.hessianVectorProduct (x, v, 1),
+			 f.hessian (x, 1) * v));
+  matrix_t expected = lambda[0] * f.hessian (x, 0)
+    + lambda[1] * f.hessian (x, 1);
+  BOOST_CHECK (allclose (f.lagrangianHessian (x, lambda), expected));
+
+  // Inactive outputs are skipped.
+  lambda[1] = 0.;
+  BOOST_CHECK (allclose (f.lagrangianHessian (x, lambda),
+			 lambda[0] * f.hessian (x, 0)));
+
+  // Split operator: only the selected output is evaluated.
+  boost::shared_ptr<TwoOutputs> g = boost::make_shared<TwoOutputs> ();
+  Split<TwiceDifferentiableFunction> split (g, 1);
+  vector_t mu (1);
+  mu[0] = 3.;
+  BOOST_CHECK (allclose (split.hessianVectorProduct (x, v),
+			 g->hessian (x, 1) * v));
+  BOOST_CHECK (allclose (split.lagrangianHessian (x, mu),
+			 mu[0] * g->hessian (x, 1)));
+
+  // Operators on quadratic and linear functions.
+  matrix_t a (2, 2);
+  a << 2., 1., 1., 3.;
+  matrix_t c (1, 2);
+  c << 1., -1.;
+  vector_t b (2);
+  b << 1., 0.;
+  vector_t d (1);
+  d << 0.5;
+
+  boost::shared_ptr<NumericQuadraticFunction> q1 =
+    boost::make_shared<NumericQuadraticFunction> (a, b);
+  boost::shared_ptr<NumericQuadraticFunction> q2 =
+    boost::make_shared<NumericQuadraticFunction> (2. * a, b);
+  boost::shared_ptr<NumericLinearFunction> l =
+    boost::make_shared<NumericLinearFunction> (c, d);
+
+  vector_t hv = 6. * a * v;
+  BOOST_CHECK (allclose (plus (q1, q2)->hessianVectorProduct (x, v), hv));
+  BOOST_CHECK (allclose (plus (q1, q2)->hessian (x), 6. * a));
+  BOOST_CHECK (allclose (minus (q1, q2)->lagrangianHessian (x, mu),
+			 -6. * a));
+  BOOST_CHECK (allclose (plus (q1, l)->lagrangianHessian (x, mu),
+			 6. * a));
+  BOOST_CHECK (allclose ((0.5 * q2)->hessianVectorProduct (x, v),
+			 2. * a * v));
+  BOOST_CHECK (allclose (l->hessianVectorProduct (x, v),
+			 vector_t::Zero (2)));
+}
+
+BOOST_AUTO_TEST_CASE (hessian_vector_product_sparse)
+{
+  typedef GenericTwiceDifferentiableFunction<EigenMatrixSparse>
+    sparseFunction_t;
+  typedef sparseFunction_t::vector_t vector_t;
+  typedef sparseFunction_t::hessian_t hessian_t;
+  typedef GenericFunctionTraits<EigenMatrixDense>::matrix_t denseMatrix_t;
+  typedef GenericNumericQuadraticFunction<EigenMatrixSparse> quadratic_t;
+
+  vector_t x (2);
+  x << 1.5, -2.;
+  vector_t v (2);
+  v << 0.3, 0.7;
+  vector_t lambda (2);
+  lambda << 2., -0.5;
+
+  // Default lagrangian hessian, summing sparse hessians.
+  GenericTwoOutputs<EigenMatrixSparse> f;
+  BOOST_CHECK (allclose (f.hessianVectorProduct (x, v, 1),
+			 toDense (f.hessian (x, 1)) * v));
+  denseMatrix_t expected = lambda[0] * toDense (f.hessian (x, 0))
+    + lambda[1] * toDense (f.hessian (x, 1));
+  BOOST_CHECK (allclose (toDense (f.lagrangianHessian (x, lambda)),
+			 expected));
+
+  // Plus and Minus on sparse quadratic functions.
+  denseMatrix_t a (2, 2);
+  a << 2., 1., 1., 3.;
+  vector_t b (2);
+  b << 1., 0.;
+  vector_t mu (1);
+  mu[0] = 3.;
+
+  hessian_t sparseA = a.sparseView ();
+  hessian_t sparseA2 = (2. * a).sparseView ();
+  boost::shared_ptr<quadratic_t> q1 =
+    boost::make_shared<quadratic_t> (sparseA, b);
+  boost::shared_ptr<quadratic_t> q2 =
+    boost::make_shared<quadratic_t> (sparseA2, b);
+
+  BOOST_CHECK (allclose (toDense (plus (q1, q2)->hessian (x)), 6. * a));
+  BOOST_CHECK (allclose (toDense (minus (q1, q2)->hessian (x)), -2. * a));
+  BOOST_CHECK (allclose (plus (q1, q2)->hessianVectorProduct (x, v),
+			 6. * a * v));
+  BOOST_CHECK (allclose (minus (q1, q2)->hessianVectorProduct (x, v),
+			 -2. * a * v));
+  BOOST_CHECK (allclose (toDense (plus (q1, q2)->lagrangianHessian (x, mu)),
+			 18. * a));
+  BOOST_CHECK (allclose (toDense (minus (q1, q2)->lagrangianHessian (x, mu)),
+			 -6. * a));
+}
+
 BOOST_AUTO_TEST_SUITE_END ()